@@ -0,0 +1,76 @@
+#include "amenities.hpp"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+
+struct AmenityName {
+    Amenities::Bit mBit;
+    const char *mName;
+};
+
+const AmenityName AMENITY_NAMES[] = {
+    { Amenities::POWER_30A, "power-30a" },
+    { Amenities::POWER_50A, "power-50a" },
+    { Amenities::POWER_100A, "power-100a" },
+    { Amenities::WATER, "water" },
+    { Amenities::PUMP_OUT, "pump-out" },
+    { Amenities::FUEL, "fuel" },
+    { Amenities::WIFI, "wifi" },
+    { Amenities::LIFT, "lift" }
+};
+
+}
+
+Amenities::Mask Amenities::parse(const std::string &list){
+    Mask mask = 0;
+    size_t start = 0;
+    
+    while (start <= list.size()){
+        size_t end = list.find(';', start);
+        
+        if (end == std::string::npos){
+            end = list.size();
+        }
+        
+        std::string name;
+        
+        for (size_t i = start; i < end; ++i){
+            if (!std::isspace(static_cast<unsigned char>(list[i]))){
+                name += static_cast<char>(std::tolower(static_cast<unsigned char>(list[i])));
+            }
+        }
+        
+        if (!name.empty()){
+            auto it = std::find_if(std::begin(AMENITY_NAMES), std::end(AMENITY_NAMES),
+                                   [&name](const AmenityName &amenity){ return name == amenity.mName; });
+            
+            if (it == std::end(AMENITY_NAMES)){
+                throw std::invalid_argument("Invalid amenity: " + name);
+            }
+            
+            mask |= it->mBit;
+        }
+        
+        start = end + 1;
+    }
+    
+    return mask;
+}
+
+std::string Amenities::toString(Mask mask){
+    std::string names;
+    
+    for (const auto &amenity : AMENITY_NAMES){
+        if (mask & amenity.mBit){
+            if (!names.empty()){
+                names += ";";
+            }
+            
+            names += amenity.mName;
+        }
+    }
+    
+    return names;
+}
@@ -0,0 +1,37 @@
+#ifndef AMENITIES_H
+#define AMENITIES_H
+
+#include <cstdint>
+#include <string>
+
+// Slip amenities and member requirements as a fixed-width bitmask.
+//
+// Amenity names are parsed into bits when the input is loaded, so matching
+// a boat's requirements against a slip is a single AND and compare.
+class Amenities {
+public:
+    using Mask = uint32_t;
+
+    enum Bit : Mask {
+        POWER_30A  = 1u << 0,
+        POWER_50A  = 1u << 1,
+        POWER_100A = 1u << 2,
+        WATER      = 1u << 3,
+        PUMP_OUT   = 1u << 4,
+        FUEL       = 1u << 5,
+        WIFI       = 1u << 6,
+        LIFT       = 1u << 7
+    };
+
+    // True if every required amenity is provided
+    static bool provides(Mask provided, Mask required){ return (provided & required) == required; }
+
+    // Parse a ';'-separated list of amenity names (case-insensitive, spaces
+    // ignored). Throws std::invalid_argument for an unknown name.
+    static Mask parse(const std::string &list);
+
+    // ';'-separated amenity names, in bit order
+    static std::string toString(Mask mask);
+};
+
+#endif
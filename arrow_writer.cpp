@@ -0,0 +1,539 @@
+#include "arrow_writer.hpp"
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+// Arrow stores numbers little-endian; they are written in host order
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "The Arrow writer needs a little-endian host");
+
+static const char MAGIC[8] = { 'A', 'R', 'R', 'O', 'W', '1', 0, 0 };
+
+// Format.fbs, Message.fbs and Schema.fbs enums
+static const int16_t METADATA_V5 = 4;
+static const uint8_t HEADER_SCHEMA = 1;
+static const uint8_t HEADER_DICTIONARY_BATCH = 2;
+static const uint8_t HEADER_RECORD_BATCH = 3;
+static const uint8_t TYPE_INT = 2;
+static const uint8_t TYPE_FLOATING_POINT = 3;
+static const uint8_t TYPE_UTF8 = 5;
+static const uint8_t TYPE_BOOL = 6;
+static const int16_t PRECISION_DOUBLE = 2;
+
+enum ColumnKind {
+    TEXT,
+    DICTIONARY,
+    INT32,
+    FLOAT64,
+    BOOL
+};
+
+struct ColumnSpec {
+    const char *mName;
+    ColumnKind mKind;
+    bool mNullable;
+    int64_t mDictionary;
+};
+
+enum ColumnIndex {
+    MEMBER_ID,
+    ASSIGNED_SLIP,
+    STATUS,
+    DOCK_STATUS,
+    BOAT_LENGTH,
+    BOAT_WIDTH,
+    PRICE,
+    UPGRADED,
+    COMMENT,
+    COLUMN_COUNT
+};
+
+static const ColumnSpec COLUMNS[COLUMN_COUNT] = {
+    { "member_id", TEXT, false, -1 },
+    { "assigned_slip", TEXT, true, -1 },
+    { "status", DICTIONARY, false, 0 },
+    { "dock_status", DICTIONARY, false, 1 },
+    { "boat_length_inches", INT32, false, -1 },
+    { "boat_width_inches", INT32, false, -1 },
+    { "price", FLOAT64, true, -1 },
+    { "upgraded", BOOL, false, -1 },
+    { "comment", TEXT, false, -1 }
+};
+
+namespace {
+
+// A flatbuffer object: a table, a string, a vector of tables or a vector
+// of structs. Built as a tree, then serialized parents first so that every
+// offset points forward, as flatbuffers requires.
+struct Flat {
+    enum Kind {
+        TABLE,
+        STRING,
+        TABLES,
+        STRUCTS
+    };
+
+    struct Field {
+        int mSize = 0;
+        uint64_t mValue = 0;
+        std::shared_ptr<Flat> mChild;
+    };
+
+    Kind mKind;
+    // Table fields by field id; size 0 is absent
+    std::vector<Field> mFields;
+    // String text, or struct vector elements
+    std::string mBytes;
+    uint32_t mCount = 0;
+    std::vector<std::shared_ptr<Flat>> mItems;
+
+    explicit Flat(Kind kind)
+        : mKind(kind){
+    }
+
+    Flat &scalar(size_t id, int size, uint64_t value){
+        field(id).mSize = size;
+        field(id).mValue = value;
+        return *this;
+    }
+
+    Flat &child(size_t id, std::shared_ptr<Flat> object){
+        field(id).mSize = 4;
+        field(id).mChild = std::move(object);
+        return *this;
+    }
+
+private:
+    Field &field(size_t id){
+        if (mFields.size() <= id){
+            mFields.resize(id + 1);
+        }
+
+        return mFields[id];
+    }
+};
+
+using FlatPtr = std::shared_ptr<Flat>;
+
+FlatPtr table(){
+    return std::make_shared<Flat>(Flat::TABLE);
+}
+
+FlatPtr text(const std::string &value){
+    FlatPtr object = std::make_shared<Flat>(Flat::STRING);
+    object->mBytes = value;
+    return object;
+}
+
+FlatPtr tables(std::vector<FlatPtr> items){
+    FlatPtr object = std::make_shared<Flat>(Flat::TABLES);
+    object->mItems = std::move(items);
+    return object;
+}
+
+// Structs with 8-byte fields, laid out by the caller
+FlatPtr structs(std::string bytes, uint32_t count){
+    FlatPtr object = std::make_shared<Flat>(Flat::STRUCTS);
+    object->mBytes = std::move(bytes);
+    object->mCount = count;
+    return object;
+}
+
+class FlatWriter {
+    std::string mBuffer;
+
+    void pad(size_t alignment){
+        mBuffer.append((alignment - mBuffer.size() % alignment) % alignment, '\0');
+    }
+
+    template <typename T>
+    void put(T value){
+        mBuffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    void patch(size_t at, T value){
+        std::memcpy(&mBuffer[at], &value, sizeof(value));
+    }
+
+    // Append an object and its children; returns the object's position
+    size_t write(const Flat &object){
+        switch (object.mKind){
+            case Flat::STRING: {
+                pad(4);
+                size_t at = mBuffer.size();
+                put(static_cast<uint32_t>(object.mBytes.size()));
+                mBuffer += object.mBytes;
+                mBuffer.push_back('\0');
+                return at;
+            }
+            case Flat::STRUCTS: {
+                // Elements start 8-aligned, after the count
+                pad(4);
+
+                if ((mBuffer.size() + 4) % 8 != 0){
+                    put(uint32_t(0));
+                }
+
+                size_t at = mBuffer.size();
+                put(object.mCount);
+                mBuffer += object.mBytes;
+                return at;
+            }
+            case Flat::TABLES: {
+                pad(4);
+                size_t at = mBuffer.size();
+                put(static_cast<uint32_t>(object.mItems.size()));
+                mBuffer.append(object.mItems.size() * 4, '\0');
+
+                for (size_t i = 0; i < object.mItems.size(); ++i){
+                    size_t slot = at + 4 + i * 4;
+                    patch(slot, static_cast<uint32_t>(write(*object.mItems[i]) - slot));
+                }
+
+                return at;
+            }
+            case Flat::TABLE:
+                break;
+        }
+
+        // Fields after the vtable offset, largest first, each aligned to its size
+        std::vector<uint16_t> offsets(object.mFields.size(), 0);
+        size_t size = 4;
+
+        for (int width : { 8, 4, 2, 1 }){
+            for (size_t id = 0; id < object.mFields.size(); ++id){
+                if (object.mFields[id].mSize == width){
+                    size = (size + width - 1) / width * width;
+                    offsets[id] = static_cast<uint16_t>(size);
+                    size += width;
+                }
+            }
+        }
+
+        pad(2);
+        size_t vtable = mBuffer.size();
+        put(static_cast<uint16_t>(4 + 2 * offsets.size()));
+        put(static_cast<uint16_t>(size));
+
+        for (uint16_t offset : offsets){
+            put(offset);
+        }
+
+        pad(8);
+        size_t at = mBuffer.size();
+        mBuffer.append(size, '\0');
+        patch(at, static_cast<int32_t>(at - vtable));
+
+        for (size_t id = 0; id < object.mFields.size(); ++id){
+            const Flat::Field &field = object.mFields[id];
+
+            if (field.mSize > 0 && !field.mChild){
+                std::memcpy(&mBuffer[at + offsets[id]], &field.mValue, static_cast<size_t>(field.mSize));
+            }
+        }
+
+        for (size_t id = 0; id < object.mFields.size(); ++id){
+            if (object.mFields[id].mChild){
+                size_t slot = at + offsets[id];
+                patch(slot, static_cast<uint32_t>(write(*object.mFields[id].mChild) - slot));
+            }
+        }
+
+        return at;
+    }
+
+public:
+    // The root offset, then the objects, padded to 8 bytes
+    static std::string serialize(const Flat &root){
+        FlatWriter writer;
+        writer.put(uint32_t(0));
+        writer.patch(0, static_cast<uint32_t>(writer.write(root)));
+        writer.pad(8);
+        return writer.mBuffer;
+    }
+};
+
+FlatPtr intType(int bits){
+    FlatPtr type = table();
+    type->scalar(0, 4, static_cast<uint32_t>(bits)).scalar(1, 1, 1);
+    return type;
+}
+
+FlatPtr schema(){
+    std::vector<FlatPtr> fields;
+
+    for (const ColumnSpec &column : COLUMNS){
+        FlatPtr field = table();
+        FlatPtr type = table();
+        uint8_t typeId = TYPE_UTF8;
+
+        if (column.mKind == INT32){
+            type = intType(32);
+            typeId = TYPE_INT;
+        }
+        else if (column.mKind == FLOAT64){
+            type->scalar(0, 2, static_cast<uint16_t>(PRECISION_DOUBLE));
+            typeId = TYPE_FLOATING_POINT;
+        }
+        else if (column.mKind == BOOL){
+            typeId = TYPE_BOOL;
+        }
+
+        field->child(0, text(column.mName)).scalar(1, 1, column.mNullable ? 1 : 0).scalar(2, 1, typeId);
+        field->child(3, type).child(5, tables({}));
+
+        // The field's type is the dictionary's value type
+        if (column.mKind == DICTIONARY){
+            FlatPtr encoding = table();
+            encoding->scalar(0, 8, static_cast<uint64_t>(column.mDictionary)).child(1, intType(8));
+            field->child(4, encoding);
+        }
+
+        fields.push_back(field);
+    }
+
+    FlatPtr result = table();
+    result->scalar(0, 2, 0).child(1, tables(fields));
+    return result;
+}
+
+FlatPtr message(uint8_t headerType, FlatPtr header, size_t bodyBytes){
+    FlatPtr result = table();
+    result->scalar(0, 2, static_cast<uint16_t>(METADATA_V5)).scalar(1, 1, headerType).child(2, header);
+    result->scalar(3, 8, bodyBytes);
+    return result;
+}
+
+template <typename T>
+void append(std::string &bytes, T value){
+    bytes.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// The record batch of columns and its body: each buffer padded to 8 bytes
+FlatPtr recordBatch(const std::vector<ArrowWriter::Column> &columns, const std::vector<ColumnKind> &kinds, size_t rows,
+                    std::string &body){
+    std::string nodes;
+    std::string buffers;
+    uint32_t bufferCount = 0;
+
+    auto addBuffer = [&](const void *data, size_t size){
+        append(buffers, static_cast<int64_t>(body.size()));
+        append(buffers, static_cast<int64_t>(size));
+        body.append(static_cast<const char *>(data), size);
+        body.append((8 - body.size() % 8) % 8, '\0');
+        ++bufferCount;
+    };
+
+    for (size_t c = 0; c < columns.size(); ++c){
+        const ArrowWriter::Column &column = columns[c];
+        append(nodes, static_cast<int64_t>(rows));
+        append(nodes, static_cast<int64_t>(column.mNulls));
+
+        // A column without nulls needs no validity bitmap
+        addBuffer(column.mValidity.data(), column.mNulls > 0 ? column.mValidity.size() : 0);
+
+        if (kinds[c] == TEXT){
+            addBuffer(column.mOffsets.data(), column.mOffsets.size() * sizeof(int32_t));
+        }
+
+        addBuffer(column.mValues.data(), column.mValues.size());
+    }
+
+    FlatPtr batch = table();
+    batch->scalar(0, 8, rows).child(1, structs(nodes, static_cast<uint32_t>(columns.size())));
+    batch->child(2, structs(buffers, bufferCount));
+    return batch;
+}
+
+void appendText(ArrowWriter::Column &column, size_t row, const std::string &value, bool valid){
+    if (row % 8 == 0){
+        column.mValidity.push_back(0);
+    }
+
+    if (valid){
+        column.mValidity.back() |= static_cast<uint8_t>(1 << (row % 8));
+        column.mValues += value;
+    }
+    else{
+        ++column.mNulls;
+    }
+
+    column.mOffsets.push_back(static_cast<int32_t>(column.mValues.size()));
+}
+
+template <typename T>
+void appendValue(ArrowWriter::Column &column, size_t row, T value, bool valid){
+    if (row % 8 == 0){
+        column.mValidity.push_back(0);
+    }
+
+    if (valid){
+        column.mValidity.back() |= static_cast<uint8_t>(1 << (row % 8));
+    }
+    else{
+        ++column.mNulls;
+    }
+
+    append(column.mValues, valid ? value : T());
+}
+
+void appendBit(ArrowWriter::Column &column, size_t row, bool value){
+    if (row % 8 == 0){
+        column.mValidity.push_back(0xff);
+        column.mValues.push_back('\0');
+    }
+
+    if (value){
+        column.mValues.back() = static_cast<char>(column.mValues.back() | (1 << (row % 8)));
+    }
+}
+
+}
+
+ArrowWriter::ArrowWriter(std::ostream &out, size_t batchRows)
+    : mOut(out), mBatchRows(batchRows), mPosition(0), mFinished(false), mRows(0), mColumns(COLUMN_COUNT){
+    if (batchRows == 0){
+        throw std::invalid_argument("Invalid Arrow batch size: must be more than zero");
+    }
+
+    for (int c = 0; c < COLUMN_COUNT; ++c){
+        if (COLUMNS[c].mKind == TEXT){
+            mColumns[c].mOffsets.push_back(0);
+        }
+    }
+
+    emit(MAGIC, sizeof(MAGIC));
+    writeMessage(FlatWriter::serialize(*message(HEADER_SCHEMA, schema(), 0)), "", nullptr);
+
+    // Dictionaries hold every status up front, so batches never add to them
+    std::vector<std::vector<std::string>> dictionaries = {
+        { Assignment::statusToString(Assignment::Status::PERMANENT), Assignment::statusToString(Assignment::Status::SAME),
+          Assignment::statusToString(Assignment::Status::TEMPORARY), Assignment::statusToString(Assignment::Status::UNASSIGNED) },
+        { Member::dockStatusToString(Member::DockStatus::PERMANENT), Member::dockStatusToString(Member::DockStatus::YEAR_OFF),
+          Member::dockStatusToString(Member::DockStatus::WAITING_LIST), Member::dockStatusToString(Member::DockStatus::TEMPORARY),
+          Member::dockStatusToString(Member::DockStatus::UNASSIGNED) }
+    };
+
+    for (size_t id = 0; id < dictionaries.size(); ++id){
+        std::vector<Column> values(1);
+        values[0].mOffsets.push_back(0);
+
+        for (size_t i = 0; i < dictionaries[id].size(); ++i){
+            appendText(values[0], i, dictionaries[id][i], true);
+        }
+
+        std::string body;
+        FlatPtr batch = table();
+        batch->scalar(0, 8, id).child(1, recordBatch(values, { TEXT }, dictionaries[id].size(), body));
+        writeMessage(FlatWriter::serialize(*message(HEADER_DICTIONARY_BATCH, batch, body.size())), body, &mDictionaries);
+    }
+}
+
+void ArrowWriter::emit(const void *data, size_t size){
+    mOut.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+
+    if (!mOut){
+        throw std::runtime_error("Cannot write Arrow output");
+    }
+
+    mPosition += size;
+}
+
+void ArrowWriter::writeMessage(const std::string &metadata, const std::string &body, std::vector<Block> *blocks){
+    uint32_t continuation = 0xffffffff;
+    int32_t metadataBytes = static_cast<int32_t>(metadata.size());
+
+    if (blocks){
+        blocks->push_back(Block{ static_cast<int64_t>(mPosition), metadataBytes + 8, static_cast<int64_t>(body.size()) });
+    }
+
+    emit(&continuation, sizeof(continuation));
+    emit(&metadataBytes, sizeof(metadataBytes));
+    emit(metadata.data(), metadata.size());
+    emit(body.data(), body.size());
+}
+
+void ArrowWriter::write(const Assignment &assignment){
+    size_t row = mRows;
+    appendText(mColumns[MEMBER_ID], row, assignment.memberId(), true);
+    appendText(mColumns[ASSIGNED_SLIP], row, assignment.slipId(), assignment.assigned());
+    appendValue(mColumns[STATUS], row, static_cast<int8_t>(assignment.status()), true);
+    appendValue(mColumns[DOCK_STATUS], row, static_cast<int8_t>(assignment.dockStatus()), true);
+    appendValue(mColumns[BOAT_LENGTH], row, static_cast<int32_t>(assignment.boatDimensions().lengthInches()), true);
+    appendValue(mColumns[BOAT_WIDTH], row, static_cast<int32_t>(assignment.boatDimensions().widthInches()), true);
+    appendValue(mColumns[PRICE], row, assignment.price(), assignment.price() > 0.0);
+    appendBit(mColumns[UPGRADED], row, assignment.upgraded());
+    appendText(mColumns[COMMENT], row, assignment.comment(), true);
+
+    if (++mRows == mBatchRows){
+        writeBatch();
+    }
+}
+
+void ArrowWriter::write(const std::vector<Assignment> &assignments){
+    for (const auto &assignment : assignments){
+        write(assignment);
+    }
+}
+
+void ArrowWriter::writeBatch(){
+    std::vector<ColumnKind> kinds;
+
+    for (const ColumnSpec &column : COLUMNS){
+        kinds.push_back(column.mKind);
+    }
+
+    std::string body;
+    FlatPtr batch = recordBatch(mColumns, kinds, mRows, body);
+    writeMessage(FlatWriter::serialize(*message(HEADER_RECORD_BATCH, batch, body.size())), body, &mBatches);
+
+    for (int c = 0; c < COLUMN_COUNT; ++c){
+        mColumns[c] = Column();
+
+        if (COLUMNS[c].mKind == TEXT){
+            mColumns[c].mOffsets.push_back(0);
+        }
+    }
+
+    mRows = 0;
+}
+
+void ArrowWriter::finish(){
+    if (mFinished){
+        return;
+    }
+
+    mFinished = true;
+
+    // An empty table still has one (empty) batch
+    if (mRows > 0 || mBatches.empty()){
+        writeBatch();
+    }
+
+    uint32_t endOfStream[2] = { 0xffffffff, 0 };
+    emit(endOfStream, sizeof(endOfStream));
+
+    auto blocks = [](const std::vector<Block> &list){
+        std::string bytes;
+
+        for (const Block &block : list){
+            append(bytes, block.mOffset);
+            append(bytes, block.mMetadataBytes);
+            append(bytes, int32_t(0));
+            append(bytes, block.mBodyBytes);
+        }
+
+        return structs(bytes, static_cast<uint32_t>(list.size()));
+    };
+
+    FlatPtr footer = table();
+    footer->scalar(0, 2, static_cast<uint16_t>(METADATA_V5)).child(1, schema());
+    footer->child(2, blocks(mDictionaries)).child(3, blocks(mBatches));
+
+    std::string bytes = FlatWriter::serialize(*footer);
+    int32_t footerBytes = static_cast<int32_t>(bytes.size());
+    emit(bytes.data(), bytes.size());
+    emit(&footerBytes, sizeof(footerBytes));
+    emit(MAGIC, 6);
+    mOut.flush();
+}
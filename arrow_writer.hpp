@@ -0,0 +1,75 @@
+#ifndef ARROW_WRITER_H
+#define ARROW_WRITER_H
+
+#include "assignment.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Writes assignments in the Arrow IPC file format (also called Feather
+// version 2), which pyarrow, polars and pandas open without conversion.
+// The flatbuffer metadata is encoded here, so no Arrow library is needed.
+//
+// Columns:
+//   member_id                         utf8
+//   assigned_slip                     utf8, null when unassigned
+//   status, dock_status               dictionary<int8, utf8>
+//   boat_length_inches, boat_width_inches   int32
+//   price                             float64, null when not priced
+//   upgraded                          bool
+//   comment                           utf8
+//
+// Rows are collected into record batches of batchRows and each batch is
+// written as soon as it is full, so memory stays bounded however many rows
+// are written and the output can be a pipe. The file footer that indexes
+// the batches is written by finish(), which must be called.
+class ArrowWriter {
+public:
+    // Position and size of one message in the file, for the footer
+    struct Block {
+        int64_t mOffset;
+        int32_t mMetadataBytes;
+        int64_t mBodyBytes;
+    };
+
+    // One column of the batch being collected
+    struct Column {
+        std::vector<uint8_t> mValidity;
+        size_t mNulls = 0;
+        std::vector<int32_t> mOffsets;
+        std::string mValues;
+    };
+
+private:
+    std::ostream &mOut;
+    size_t mBatchRows;
+    uint64_t mPosition;
+    bool mFinished;
+    size_t mRows;
+    std::vector<Column> mColumns;
+    std::vector<Block> mDictionaries;
+    std::vector<Block> mBatches;
+
+    void emit(const void *data, size_t size);
+    // An encapsulated message: serialized Message flatbuffer, then the body
+    void writeMessage(const std::string &metadata, const std::string &body, std::vector<Block> *blocks);
+    void writeBatch();
+
+public:
+    // Writes the file header, schema and dictionaries. Throws
+    // std::invalid_argument for a batch size of zero.
+    explicit ArrowWriter(std::ostream &out, size_t batchRows = 65536);
+
+    ArrowWriter(const ArrowWriter &) = delete;
+    ArrowWriter &operator=(const ArrowWriter &) = delete;
+
+    void write(const Assignment &assignment);
+    void write(const std::vector<Assignment> &assignments);
+
+    // Write the last batch and the footer. Throws std::runtime_error when
+    // the output fails.
+    void finish();
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include "assignment.hpp"
 #include <algorithm>
 #include <cmath>
+#include <stdexcept>
 
 Assignment::Assignment(const std::string &memberId, const std::string &slipId,
                        Status status, const Dimensions &boatDimensions, 
@@ -10,6 +11,12 @@ Assignment::Assignment(const std::string &memberId, const std::string &slipId,
       mBoatDimensions(boatDimensions), mSlipDimensions(slipDimensions), 
       mComment(comment), mPrice(0.0), mUpgraded(upgraded), mDockStatus(dockStatus){
     
+    if (!comment.empty()){
+        Reason note;
+        note.mText = comment;
+        mReasons.push_back(std::move(note));
+    }
+    
     if (pricePerSqFt > 0.0 && status != Status::UNASSIGNED){
         // Calculate square footage (convert from square inches to square feet)
         double boatSqFt = (boatDimensions.lengthInches() * boatDimensions.widthInches()) / 144.0;
@@ -18,11 +25,86 @@ Assignment::Assignment(const std::string &memberId, const std::string &slipId,
         // Use the larger of boat or slip
         double billableSqFt = std::max(boatSqFt, slipSqFt);
         
-        // Calculate price and round to 2 decimal places
-        mPrice = std::round(billableSqFt * pricePerSqFt * 100.0) / 100.0;
+        mPrice = price(billableSqFt, pricePerSqFt);
     }
 }
 
+double Assignment::price(double billableSqFt, double pricePerSqFt){
+    // Round to 2 decimal places
+    return std::round(billableSqFt * pricePerSqFt * 100.0) / 100.0;
+}
+
+std::string Assignment::Reason::text() const{
+    switch (mCode){
+        case Code::NOTE:
+            return mText;
+        case Code::DOES_NOT_FIT:
+            return "NOTE: Boat does not fit in assigned slip";
+        case Code::SLIP_LACKS_AMENITIES:
+            return "NOTE: Assigned slip lacks " + Amenities::toString(mAmenities);
+        case Code::LONGER_THAN_SLIP:
+        case Code::SHORTER_THAN_SLIP: {
+            int feet = mCount / 12;
+            int inches = mCount % 12;
+            std::string length;
+            
+            if (feet > 0 && inches > 0){
+                length = std::to_string(feet) + "' " + std::to_string(inches) + "\"";
+            }
+            else if (feet > 0){
+                length = std::to_string(feet) + "'";
+            }
+            else{
+                length = std::to_string(inches) + "\"";
+            }
+            
+            return "NOTE: boat is " + length + (mCode == Code::LONGER_THAN_SLIP ? " longer than slip" : " shorter than slip");
+        }
+        case Code::TIGHT_FIT:
+            return "TIGHT FIT";
+        case Code::YEAR_OFF:
+            return "Year off - not assigned";
+        case Code::SHARES_SLIP: {
+            std::string members;
+            
+            for (const auto &member : mMembers){
+                members += (members.empty() ? "" : ", ") + member;
+            }
+            
+            return "Shares slip with " + members;
+        }
+        case Code::NO_SLIP_WITH_AMENITIES:
+            return "No large enough slip provides " + Amenities::toString(mAmenities);
+        case Code::TOO_LARGE:
+            return mEvicted ? "Evicted - boat too large for all available slips" : "Boat too large for all available slips";
+        case Code::SLIP_REMOVED:
+            return "Evicted - previous slip no longer exists";
+        case Code::SLIPS_TAKEN:
+            if (!mEvicted){
+                return "All " + std::to_string(mCount) + " suitable slips taken by higher priority members";
+            }
+            
+            if (mByPermanent){
+                return "Evicted - previous slip taken by permanent member, all " + std::to_string(mCount) + " suitable slips taken";
+            }
+            
+            return "Evicted - outranked by higher priority member(s), all " + std::to_string(mCount) + " suitable slips taken";
+    }
+    return mText;
+}
+
+void Assignment::addReason(const Reason &reason){
+    std::string note = reason.text();
+    mComment = mComment.empty() ? note : mComment + "; " + note;
+    mReasons.push_back(reason);
+}
+
+void Assignment::appendComment(const std::string &note){
+    Reason reason;
+    reason.mText = note;
+    addReason(reason);
+}
+
 bool Assignment::assigned() const{
     return !mSlipId.empty();
 }
@@ -40,3 +122,21 @@ std::string Assignment::statusToString(Status status){
     }
     return "UNKNOWN";
 }
+
+Assignment::Status Assignment::stringToStatus(const std::string &str){
+    if (str == "PERMANENT"){
+        return Status::PERMANENT;
+    }
+    else if (str == "SAME"){
+        return Status::SAME;
+    }
+    else if (str == "TEMPORARY"){
+        return Status::TEMPORARY;
+    }
+    else if (str == "UNASSIGNED"){
+        return Status::UNASSIGNED;
+    }
+    else{
+        throw std::invalid_argument("Invalid assignment status: " + str);
+    }
+}
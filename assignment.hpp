@@ -1,9 +1,11 @@
 #ifndef ASSIGNMENT_H
 #define ASSIGNMENT_H
 
+#include "amenities.hpp"
 #include "dimensions.hpp"
 #include "member.hpp"
 #include <string>
+#include <vector>
 
 class Assignment {
 public:
@@ -13,6 +15,39 @@ public:
         TEMPORARY,
         UNASSIGNED
     };
+    
+    // One note in the comment, kept with the values it was written from so
+    // other output formats do not have to read them back out of the text
+    struct Reason {
+        enum class Code {
+            NOTE,                   // Free text in mText
+            DOES_NOT_FIT,
+            SLIP_LACKS_AMENITIES,   // mAmenities the slip lacks
+            LONGER_THAN_SLIP,       // mCount inches
+            SHORTER_THAN_SLIP,      // mCount inches
+            TIGHT_FIT,
+            YEAR_OFF,
+            SHARES_SLIP,            // mMembers sharing the slip
+            NO_SLIP_WITH_AMENITIES, // mAmenities required
+            TOO_LARGE,              // mEvicted
+            SLIP_REMOVED,           // Always evicted
+            SLIPS_TAKEN             // mEvicted, mByPermanent, mCount suitable slips
+        };
+        
+        Code mCode = Code::NOTE;
+        bool mEvicted = false;
+        bool mByPermanent = false;
+        int mCount = 0;
+        Amenities::Mask mAmenities = 0;
+        std::vector<std::string> mMembers;
+        std::string mText;
+        
+        Reason() = default;
+        explicit Reason(Code code) : mCode(code){}
+        
+        // The note as it reads in the comment
+        std::string text() const;
+    };
 
 private:
     std::string mMemberId;
@@ -21,6 +56,7 @@ private:
     Dimensions mBoatDimensions;
     Dimensions mSlipDimensions;
     std::string mComment;
+    std::vector<Reason> mReasons;
     double mPrice;
     bool mUpgraded;
     Member::DockStatus mDockStatus;
@@ -37,7 +73,11 @@ public:
     const Dimensions &boatDimensions() const { return mBoatDimensions; }
     const Dimensions &slipDimensions() const { return mSlipDimensions; }
     const std::string &comment() const { return mComment; }
+    // The notes in the comment, in order. A comment given to the
+    // constructor is one NOTE, however many notes its text holds.
+    const std::vector<Reason> &reasons() const { return mReasons; }
     double price() const { return mPrice; }
+    void setPrice(double price){ mPrice = price; }
     bool upgraded() const { return mUpgraded; }
     Member::DockStatus dockStatus() const { return mDockStatus; }
     
@@ -48,9 +88,21 @@ public:
         }
     }
     
+    // Add a note to the comment, separated from any existing text by "; "
+    void addReason(const Reason &reason);
+    
+    // Add free text to the comment as a NOTE
+    void appendComment(const std::string &note);
+    
     bool assigned() const;
     
+    // Price of a billable area at a rate per square foot, rounded to cents
+    static double price(double billableSqFt, double pricePerSqFt);
+    
     static std::string statusToString(Status status);
+    
+    // Inverse of statusToString(); throws std::invalid_argument for anything else
+    static Status stringToStatus(const std::string &str);
 };
 
 #endif
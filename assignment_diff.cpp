@@ -0,0 +1,211 @@
+#include "assignment_diff.hpp"
+#include <cmath>
+#include <unordered_map>
+
+AssignmentRecord::AssignmentRecord(const std::string &memberId, const std::string &slipId,
+                                   const std::string &status, double price, bool priced,
+                                   const std::string &dockStatus)
+    : mMemberId(memberId), mSlipId(slipId), mStatus(status), mPrice(price), mPriced(priced),
+      mDockStatus(dockStatus){
+}
+
+AssignmentChange::AssignmentChange(Kind kind, const Assignment *current, const AssignmentRecord *previous)
+    : mKind(kind), mCurrent(current), mPrevious(previous){
+}
+
+std::string AssignmentChange::kindToString(Kind kind){
+    switch (kind){
+        case Kind::ADDED:
+            return "ADDED";
+        case Kind::REMOVED:
+            return "REMOVED";
+        case Kind::ASSIGNED:
+            return "ASSIGNED";
+        case Kind::VACATED:
+            return "VACATED";
+        case Kind::MOVED:
+            return "MOVED";
+        case Kind::STATUS_CHANGED:
+            return "STATUS";
+        case Kind::PRICE_CHANGED:
+            return "PRICE";
+        case Kind::UNCHANGED:
+            return "UNCHANGED";
+    }
+    return "UNKNOWN";
+}
+
+// Classify a member present in both files. Slip changes take precedence
+// over status changes, which take precedence over price changes. Prices
+// are left out when either side was not priced, since every row would
+// otherwise differ.
+static AssignmentChange::Kind classify(const AssignmentRecord &previous, const Assignment &current, bool comparePrices){
+    if (previous.slipId() != current.slipId()){
+        if (previous.slipId().empty()){
+            return AssignmentChange::Kind::ASSIGNED;
+        }
+
+        if (current.slipId().empty()){
+            return AssignmentChange::Kind::VACATED;
+        }
+
+        return AssignmentChange::Kind::MOVED;
+    }
+
+    if (previous.status() != Assignment::statusToString(current.status())){
+        return AssignmentChange::Kind::STATUS_CHANGED;
+    }
+
+    if (!comparePrices || !previous.priced()){
+        return AssignmentChange::Kind::UNCHANGED;
+    }
+
+    // Prices are published rounded to cents; compare at that precision
+    if (std::llround(previous.price() * 100.0) != std::llround(current.price() * 100.0)){
+        return AssignmentChange::Kind::PRICE_CHANGED;
+    }
+
+    return AssignmentChange::Kind::UNCHANGED;
+}
+
+AssignmentDiff::AssignmentDiff(const std::vector<AssignmentRecord> &previous,
+                               const std::vector<Assignment> &current, bool keepUnchanged,
+                               bool comparePrices)
+    : mUnchangedCount(0){
+    // Hash index on member ID makes the join linear in the roster size
+    std::unordered_map<std::string, size_t> previousIndex;
+    previousIndex.reserve(previous.size());
+
+    for (size_t i = 0; i < previous.size(); ++i){
+        previousIndex.emplace(previous[i].memberId(), i);
+    }
+
+    std::vector<bool> matched(previous.size(), false);
+
+    for (const auto &assignment : current){
+        auto it = previousIndex.find(assignment.memberId());
+
+        if (it == previousIndex.end()){
+            mChanges.emplace_back(AssignmentChange::Kind::ADDED, &assignment, nullptr);
+            continue;
+        }
+
+        const AssignmentRecord &record = previous[it->second];
+        matched[it->second] = true;
+        AssignmentChange::Kind kind = classify(record, assignment, comparePrices);
+
+        if (kind == AssignmentChange::Kind::UNCHANGED){
+            mUnchangedCount++;
+
+            if (!keepUnchanged){
+                continue;
+            }
+        }
+
+        mChanges.emplace_back(kind, &assignment, &record);
+    }
+
+    for (size_t i = 0; i < previous.size(); ++i){
+        if (!matched[i]){
+            mChanges.emplace_back(AssignmentChange::Kind::REMOVED, nullptr, &previous[i]);
+        }
+    }
+}
+
+size_t AssignmentDiff::count(AssignmentChange::Kind kind) const{
+    if (kind == AssignmentChange::Kind::UNCHANGED){
+        return mUnchangedCount;
+    }
+
+    size_t total = 0;
+
+    for (const auto &change : mChanges){
+        if (change.kind() == kind){
+            total++;
+        }
+    }
+
+    return total;
+}
+
+bool RosterDelta::sameMember(const Member &a, const Member &b){
+    const Dimensions &boatA = a.boatDimensions();
+    const Dimensions &boatB = b.boatDimensions();
+
+    if (a.id() != b.id() || a.dockStatus() != b.dockStatus() || a.currentSlip() != b.currentSlip() ||
+        a.preferredDock() != b.preferredDock() || a.requiredAmenities() != b.requiredAmenities() ||
+        a.slipPreferences() != b.slipPreferences()){
+        return false;
+    }
+
+    if (boatA.lengthInches() != boatB.lengthInches() || boatA.widthInches() != boatB.widthInches() ||
+        boatA.draftInches() != boatB.draftInches() || boatA.airDraftInches() != boatB.airDraftInches()){
+        return false;
+    }
+
+    if (a.awayDates().size() != b.awayDates().size()){
+        return false;
+    }
+
+    for (size_t i = 0; i < a.awayDates().size(); ++i){
+        if (a.awayDates()[i].from() != b.awayDates()[i].from() || a.awayDates()[i].to() != b.awayDates()[i].to()){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+RosterDelta::RosterDelta(const std::vector<Member> &previous, const std::vector<Member> &current)
+    : mReordered(false){
+    // Most saves change a few rows in place; check row by row first
+    if (previous.size() == current.size()){
+        bool same = true;
+
+        for (size_t i = 0; i < previous.size() && same; ++i){
+            same = sameMember(previous[i], current[i]);
+        }
+
+        if (same){
+            return;
+        }
+    }
+
+    // First row wins for duplicate IDs
+    std::unordered_map<std::string, size_t> previousIndex;
+    previousIndex.reserve(previous.size());
+
+    for (size_t i = 0; i < previous.size(); ++i){
+        previousIndex.emplace(previous[i].id(), i);
+    }
+
+    std::vector<bool> matched(previous.size(), false);
+
+    for (const auto &member : current){
+        auto it = previousIndex.find(member.id());
+
+        if (it == previousIndex.end()){
+            mAdded.push_back(member.id());
+            continue;
+        }
+
+        if (matched[it->second]){
+            continue;
+        }
+
+        matched[it->second] = true;
+
+        if (!sameMember(previous[it->second], member)){
+            mChanged.push_back(member.id());
+        }
+    }
+
+    for (size_t i = 0; i < previous.size(); ++i){
+        if (!matched[i] && previousIndex.at(previous[i].id()) == i){
+            mRemoved.push_back(previous[i].id());
+        }
+    }
+
+    // The rows differ, but no member does
+    mReordered = size() == 0;
+}
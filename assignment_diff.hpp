@@ -0,0 +1,116 @@
+#ifndef ASSIGNMENT_DIFF_H
+#define ASSIGNMENT_DIFF_H
+
+#include "assignment.hpp"
+#include "member.hpp"
+#include <string>
+#include <vector>
+
+// One row of a previously published assignment file (e.g. last season's output).
+// Only the columns needed to detect changes are kept.
+class AssignmentRecord {
+    std::string mMemberId;
+    std::string mSlipId;
+    std::string mStatus;
+    double mPrice;
+    bool mPriced;
+    std::string mDockStatus;
+
+public:
+    // priced is false when the file has no price column, and dockStatus is
+    // empty when it has no dock_status column
+    AssignmentRecord(const std::string &memberId, const std::string &slipId,
+                     const std::string &status, double price, bool priced = true,
+                     const std::string &dockStatus = "");
+
+    const std::string &memberId() const{ return mMemberId; }
+    const std::string &slipId() const{ return mSlipId; }
+    const std::string &status() const{ return mStatus; }
+    double price() const{ return mPrice; }
+    bool priced() const{ return mPriced; }
+    const std::string &dockStatus() const{ return mDockStatus; }
+};
+
+// Difference between a member's previous and current assignment.
+class AssignmentChange {
+public:
+    enum class Kind {
+        ADDED,          // Member not in previous file
+        REMOVED,        // Member no longer on the roster
+        ASSIGNED,       // Had no slip, now has one
+        VACATED,        // Had a slip, now has none
+        MOVED,          // Slip changed
+        STATUS_CHANGED, // Same slip, different status
+        PRICE_CHANGED,  // Same slip and status, different price
+        UNCHANGED
+    };
+
+private:
+    Kind mKind;
+    const Assignment *mCurrent;
+    const AssignmentRecord *mPrevious;
+
+public:
+    AssignmentChange(Kind kind, const Assignment *current, const AssignmentRecord *previous);
+
+    Kind kind() const{ return mKind; }
+
+    // Null for REMOVED
+    const Assignment *current() const{ return mCurrent; }
+
+    // Null for ADDED
+    const AssignmentRecord *previous() const{ return mPrevious; }
+
+    static std::string kindToString(Kind kind);
+};
+
+// Join of current assignments against a previous assignment file on member ID.
+//
+// Changes reference the input vectors, which must outlive the diff.
+// Current rows keep their output order; removed members follow in the
+// order they appeared in the previous file.
+class AssignmentDiff {
+    std::vector<AssignmentChange> mChanges;
+    size_t mUnchangedCount;
+
+public:
+    // keepUnchanged includes UNCHANGED rows, producing a full merged table.
+    // Prices are compared only when comparePrices is set (the current run
+    // is priced) and the previous row came from a file with prices.
+    AssignmentDiff(const std::vector<AssignmentRecord> &previous,
+                   const std::vector<Assignment> &current, bool keepUnchanged = false,
+                   bool comparePrices = true);
+
+    const std::vector<AssignmentChange> &changes() const{ return mChanges; }
+    size_t unchangedCount() const{ return mUnchangedCount; }
+    size_t count(AssignmentChange::Kind kind) const;
+};
+
+// Members added, removed and changed between two loads of a roster, by
+// member ID, as when the roster file is edited between runs.
+class RosterDelta {
+    std::vector<std::string> mAdded;
+    std::vector<std::string> mRemoved;
+    std::vector<std::string> mChanged;
+    bool mReordered;
+
+public:
+    RosterDelta(const std::vector<Member> &previous, const std::vector<Member> &current);
+
+    // In the current roster's order; removed members in the previous order
+    const std::vector<std::string> &added() const{ return mAdded; }
+    const std::vector<std::string> &removed() const{ return mRemoved; }
+    const std::vector<std::string> &changed() const{ return mChanged; }
+
+    // The same members in a different order, which can change the output
+    // order and which of two members with the same ID goes first
+    bool reordered() const{ return mReordered; }
+
+    bool empty() const{ return mAdded.empty() && mRemoved.empty() && mChanged.empty() && !mReordered; }
+    size_t size() const{ return mAdded.size() + mRemoved.size() + mChanged.size(); }
+
+    // Whether two rows describe the same member, boat and requests
+    static bool sameMember(const Member &a, const Member &b);
+};
+
+#endif
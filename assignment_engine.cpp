@@ -1,10 +1,72 @@
 #include "assignment_engine.hpp"
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <iomanip>
 #include <limits>
 #include <iostream>
+#include <numeric>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
 
 AssignmentEngine::AssignmentEngine(std::vector<Member> members, std::vector<Slip> slips)
-    : mMembers(std::move(members)), mSlips(std::move(slips)), mVerbose(false), mIgnoreLength(false), mPricePerSqFt(0.0){
+    : AssignmentEngine(std::make_shared<SharedInputs>(std::move(members), std::make_shared<SlipInputs>(std::move(slips)))){
+}
+
+AssignmentEngine::AssignmentEngine(std::shared_ptr<SharedInputs> inputs)
+    : mInputs(std::move(inputs)), mMembers(mInputs->mMembers), mSlips(mInputs->mSlipInputs->mSlips),
+      mSlipPositions(mInputs->mSlipInputs->mSlipPositions), mAllSlips(mInputs->mSlipInputs->mAllSlips),
+      mDockIndexes(mInputs->mSlipInputs->mDockIndexes),
+      mVerbose(false), mIgnoreLength(false), mPricePerSqFt(0.0), mDiagnostics(true), mRecordDecisions(false),
+      mCurrentPhase(0), mCurrentPass(0), mThreads(1), mStableMatching(false), mFixedRowsStale(false),
+      mJournaling(false), mImproveMs(0), mMaximizeRevenue(false), mSeniorityArchive(nullptr),
+      mNaturalOrder(false){
+    rankMembers();
+}
+
+AssignmentEngine::SharedInputs::SharedInputs(std::vector<Member> members, std::shared_ptr<SlipInputs> slipInputs)
+    : mMembers(std::move(members)), mSlipInputs(std::move(slipInputs)){
+    mPreferenceOffsets.reserve(mMembers.size() + 1);
+    mPreferenceOffsets.push_back(0);
+    
+    for (const auto &member : mMembers){
+        for (const auto &slipId : member.slipPreferences()){
+            auto it = mSlipInputs->mSlipPositions.find(slipId);
+            
+            if (it != mSlipInputs->mSlipPositions.end()){
+                mPreferenceTargets.push_back(it->second);
+            }
+        }
+        
+        mPreferenceOffsets.push_back(static_cast<uint32_t>(mPreferenceTargets.size()));
+    }
+}
+
+// Build the slip ID lookup, the whole-marina index and one index per dock.
+AssignmentEngine::SlipInputs::SlipInputs(std::vector<Slip> slips)
+    : mSlips(std::move(slips)){
+    std::vector<uint32_t> allPositions;
+    std::map<std::string, std::vector<uint32_t>> dockPositions;
+    
+    for (uint32_t i = 0; i < mSlips.size(); ++i){
+        // First slip wins for duplicate IDs, matching a front-to-back scan
+        mSlipPositions.emplace(mSlips[i].id(), i);
+        allPositions.push_back(i);
+        dockPositions[mSlips[i].dock()].push_back(i);
+    }
+    
+    mAllSlips = SlipIndex(mSlips, std::move(allPositions));
+    
+    for (auto &entry : dockPositions){
+        mDockIndexes.emplace(entry.first, SlipIndex(mSlips, std::move(entry.second)));
+    }
 }
 
 // Main assignment algorithm entry point.
@@ -14,9 +76,47 @@ AssignmentEngine::AssignmentEngine(std::vector<Member> members, std::vector<Slip
 std::vector<Assignment> AssignmentEngine::assign(){
     std::vector<Assignment> assignments;
     
-    assignPermanentMembers(assignments);
-    processYearOffMembers(assignments);
-    assignRemainingMembers(assignments);
+    // A prepared engine carries on from its permanent and year-off phases,
+    // unless a change reached them or their decisions and output are wanted
+    bool resume = mFixedRows && !mFixedRowsStale && !mRecordDecisions && !mVerbose;
+    
+    if (resume){
+        assignments = *mFixedRows;
+    }
+    else if (mFixedRows){
+        mSlipOccupants.clear();
+        mMemberAssignment.clear();
+    }
+    
+    mFixedRows.reset();
+    mImprovement = ImprovementStats();
+    orderByPriority();
+    mRevenue = RevenueStats();
+    
+    if (mRecordDecisions){
+        mDecisionLog.reset(mMembers.size());
+        mPhaseNames.clear();
+    }
+    
+    if (!resume){
+        mJournal.clear();
+        
+        if (assignDockGroupsInParallel(assignments)){
+            return assignments;
+        }
+        
+        assignPermanentMembers(assignments);
+        processYearOffMembers(assignments);
+    }
+    
+    if (mStableMatching){
+        assignByStableMatching(assignments);
+    }
+    else{
+        assignRemainingMembers(assignments);
+    }
+    
+    addCoTenantNotes(assignments);
     
     // Final pass: upgrade SAME status to PERMANENT
     for (auto &assignment : assignments){
@@ -32,6 +132,333 @@ std::vector<Assignment> AssignmentEngine::assign(){
     return assignments;
 }
 
+// Run phases 1 and 2 and freeze the occupancy they leave, so that forks
+// share it instead of copying it.
+void AssignmentEngine::prepare(){
+    std::vector<Assignment> assignments;
+    mSlipOccupants.clear();
+    mMemberAssignment.clear();
+    mJournal.clear();
+    orderByPriority();
+    
+    if (mRecordDecisions){
+        mDecisionLog.reset(mMembers.size());
+        mPhaseNames.clear();
+    }
+    
+    assignPermanentMembers(assignments);
+    processYearOffMembers(assignments);
+    
+    mSlipOccupants.freeze();
+    mMemberAssignment.freeze();
+    mFixedRows = std::make_shared<const std::vector<Assignment>>(std::move(assignments));
+    mFixedRowsStale = false;
+}
+
+AssignmentEngine AssignmentEngine::fork() const{
+    if (!mFixedRows){
+        throw std::logic_error("fork() needs a prepared engine that has not been assigned");
+    }
+    
+    AssignmentEngine branch(mInputs);
+    branch.mVerbose = mVerbose;
+    branch.mIgnoreLength = mIgnoreLength;
+    branch.mPricePerSqFt = mPricePerSqFt;
+    branch.mDiagnostics = mDiagnostics;
+    branch.mRecordDecisions = mRecordDecisions;
+    branch.mThreads = mThreads;
+    branch.mStableMatching = mStableMatching;
+    branch.mJournaling = mJournaling;
+    branch.mImproveMs = mImproveMs;
+    branch.mMaximizeRevenue = mMaximizeRevenue;
+    branch.mSeniorityArchive = mSeniorityArchive;
+    branch.mSeniorityWeights = mSeniorityWeights;
+    branch.mSeniority = mSeniority;
+    branch.mNaturalOrder = mNaturalOrder;
+    branch.mRanking = mRanking;
+    branch.mStatusOverrides = mStatusOverrides;
+    branch.mClosedSlips = mClosedSlips;
+    branch.mSlipOccupants = mSlipOccupants;
+    branch.mMemberAssignment = mMemberAssignment;
+    branch.mFixedRows = mFixedRows;
+    branch.mFixedRowsStale = mFixedRowsStale;
+    return branch;
+}
+
+AssignmentEngine AssignmentEngine::withRoster(std::vector<Member> members) const{
+    return withInputs(std::make_shared<SharedInputs>(std::move(members), mInputs->mSlipInputs));
+}
+
+AssignmentEngine AssignmentEngine::withInputs(std::vector<Member> members, std::vector<Slip> slips) const{
+    return withInputs(std::make_shared<SharedInputs>(std::move(members), std::make_shared<SlipInputs>(std::move(slips))));
+}
+
+AssignmentEngine AssignmentEngine::withInputs(std::shared_ptr<SharedInputs> inputs) const{
+    AssignmentEngine engine(std::move(inputs));
+    engine.mVerbose = mVerbose;
+    engine.mIgnoreLength = mIgnoreLength;
+    engine.mPricePerSqFt = mPricePerSqFt;
+    engine.mDiagnostics = mDiagnostics;
+    engine.mRecordDecisions = mRecordDecisions;
+    engine.mThreads = mThreads;
+    engine.mStableMatching = mStableMatching;
+    engine.mJournaling = mJournaling;
+    engine.mImproveMs = mImproveMs;
+    engine.mMaximizeRevenue = mMaximizeRevenue;
+    engine.mNaturalOrder = mNaturalOrder;
+    
+    // Closed slips are slip positions, which only hold for the same slips
+    if (engine.mInputs->mSlipInputs == mInputs->mSlipInputs){
+        engine.mClosedSlips = mClosedSlips;
+    }
+    
+    if (mSeniorityArchive){
+        engine.setSeniority(*mSeniorityArchive, mSeniorityWeights);
+    }
+    else if (mNaturalOrder){
+        engine.rankMembers();
+    }
+    
+    return engine;
+}
+
+void AssignmentEngine::setSeniority(const SeniorityArchive &archive, const SeniorityWeights &weights){
+    mSeniorityArchive = &archive;
+    mSeniorityWeights = weights;
+    mSeniority.resize(mMembers.size());
+    
+    for (size_t m = 0; m < mMembers.size(); ++m){
+        mSeniority[m] = archive.seniority(mMembers[m].id(), weights);
+    }
+    
+    // The permanent phase's evictions depend on the order
+    rankMembers();
+    mFixedRowsStale = true;
+}
+
+void AssignmentEngine::setNaturalOrder(bool naturalOrder){
+    if (naturalOrder != mNaturalOrder){
+        mNaturalOrder = naturalOrder;
+        rankMembers();
+        mFixedRowsStale = true;
+    }
+}
+
+// Compare two IDs taking each run of digits as a number. A run is compared
+// by its length once leading zeros are skipped and then digit by digit, so
+// runs too long for an integer still compare by value.
+static int compareNatural(const std::string &a, const std::string &b){
+    auto digit = [](char c){ return std::isdigit(static_cast<unsigned char>(c)) != 0; };
+    size_t i = 0;
+    size_t j = 0;
+    
+    while (i < a.size() && j < b.size()){
+        if (!digit(a[i]) || !digit(b[j])){
+            if (a[i] != b[j]){
+                return static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[j]) ? -1 : 1;
+            }
+            
+            ++i;
+            ++j;
+            continue;
+        }
+        
+        while (i < a.size() && a[i] == '0'){
+            ++i;
+        }
+        
+        while (j < b.size() && b[j] == '0'){
+            ++j;
+        }
+        
+        size_t endA = i;
+        size_t endB = j;
+        
+        while (endA < a.size() && digit(a[endA])){
+            ++endA;
+        }
+        
+        while (endB < b.size() && digit(b[endB])){
+            ++endB;
+        }
+        
+        if (endA - i != endB - j){
+            return endA - i < endB - j ? -1 : 1;
+        }
+        
+        int order = a.compare(i, endA - i, b, j, endB - j);
+        
+        if (order != 0){
+            return order < 0 ? -1 : 1;
+        }
+        
+        i = endA;
+        j = endB;
+    }
+    
+    if (i < a.size() || j < b.size()){
+        return i < a.size() ? 1 : -1;
+    }
+    
+    return 0;
+}
+
+// Rank members within a dock status: by seniority when ordering by it, then
+// by member ID.
+void AssignmentEngine::rankMembers(){
+    auto ranking = std::make_shared<Ranking>();
+    ranking->mOrder.resize(mMembers.size());
+    std::iota(ranking->mOrder.begin(), ranking->mOrder.end(), 0u);
+    
+    auto goesBefore = [this](uint32_t a, uint32_t b){
+        if (!mSeniority.empty() && mSeniority[a] != mSeniority[b]){
+            return mSeniority[a] > mSeniority[b];
+        }
+        
+        const std::string &idA = mMembers[a].id();
+        const std::string &idB = mMembers[b].id();
+        
+        if (mNaturalOrder){
+            int order = compareNatural(idA, idB);
+            
+            if (order != 0){
+                return order < 0;
+            }
+        }
+        
+        return idA < idB;
+    };
+    
+    std::sort(ranking->mOrder.begin(), ranking->mOrder.end(), goesBefore);
+    ranking->mRanks.resize(mMembers.size());
+    uint32_t rank = 0;
+    
+    for (size_t i = 0; i < ranking->mOrder.size(); ++i){
+        if (i > 0 && goesBefore(ranking->mOrder[i - 1], ranking->mOrder[i])){
+            ++rank;
+        }
+        
+        ranking->mRanks[ranking->mOrder[i]] = rank;
+    }
+    
+    mRanking = std::move(ranking);
+}
+
+// Order members by priority key with a counting sort over the dock status
+// tiers, taking members in rank order so that each tier stays ranked.
+void AssignmentEngine::orderByPriority(){
+    const int TIERS = 5;
+    mTierStarts.assign(TIERS + 1, 0);
+    
+    for (const auto &member : mMembers){
+        ++mTierStarts[getDockStatusPriority(dockStatus(&member)) + 1];
+    }
+    
+    for (int tier = 0; tier < TIERS; ++tier){
+        mTierStarts[tier + 1] += mTierStarts[tier];
+    }
+    
+    std::vector<uint32_t> next(mTierStarts.begin(), mTierStarts.end() - 1);
+    mPriorityOrder.resize(mMembers.size());
+    
+    for (uint32_t m : mRanking->mOrder){
+        mPriorityOrder[next[getDockStatusPriority(dockStatus(&mMembers[m]))]++] = m;
+    }
+}
+
+void AssignmentEngine::closeSlip(const std::string &slipId){
+    auto it = mSlipPositions.find(slipId);
+    
+    if (it == mSlipPositions.end()){
+        throw std::invalid_argument("Unknown slip: " + slipId);
+    }
+    
+    // Only permanent members hold slips before phase 3
+    if (mSlipOccupants.find(slipId)){
+        mFixedRowsStale = true;
+    }
+    
+    mClosedSlips.insert(it->second);
+}
+
+void AssignmentEngine::closeDock(const std::string &dock){
+    auto it = mDockIndexes.find(dock);
+    
+    if (it == mDockIndexes.end()){
+        throw std::invalid_argument("Unknown dock: " + dock);
+    }
+    
+    for (uint32_t position : it->second.positions()){
+        if (mSlipOccupants.find(mSlips[position].id())){
+            mFixedRowsStale = true;
+        }
+        
+        mClosedSlips.insert(position);
+    }
+}
+
+void AssignmentEngine::setDockStatus(const std::string &memberId, Member::DockStatus status){
+    const Member *member = findMemberById(memberId);
+    
+    if (!member){
+        throw std::invalid_argument("Unknown member: " + memberId);
+    }
+    
+    auto settledEarly = [](Member::DockStatus value){
+        return value == Member::DockStatus::PERMANENT || value == Member::DockStatus::YEAR_OFF;
+    };
+    
+    if (settledEarly(dockStatus(member)) || settledEarly(status)){
+        mFixedRowsStale = true;
+    }
+    
+    if (status == dockStatus(member)){
+        mStatusOverrides.erase(member);
+    }
+    else{
+        mStatusOverrides[member] = status;
+    }
+}
+
+// Assign engines on worker threads, each taking the next unassigned engine.
+std::vector<std::vector<Assignment>> AssignmentEngine::assignAll(std::vector<AssignmentEngine> &engines, unsigned threads){
+    std::vector<std::vector<Assignment>> results(engines.size());
+    std::vector<std::exception_ptr> errors(engines.size());
+    std::atomic<size_t> nextEngine(0);
+    
+    auto worker = [&](){
+        for (size_t e = nextEngine++; e < engines.size(); e = nextEngine++){
+            try{
+                results[e] = engines[e].assign();
+            }
+            catch (...){
+                errors[e] = std::current_exception();
+            }
+        }
+    };
+    
+    unsigned threadCount = std::min<unsigned>(std::max(threads, 1u), static_cast<unsigned>(engines.size()));
+    std::vector<std::thread> workers;
+    
+    for (unsigned t = 1; t < threadCount; ++t){
+        workers.emplace_back(worker);
+    }
+    
+    worker();
+    
+    for (auto &thread : workers){
+        thread.join();
+    }
+    
+    for (const auto &error : errors){
+        if (error){
+            std::rethrow_exception(error);
+        }
+    }
+    
+    return results;
+}
+
 // Phase 1: Assign permanent members to their designated slips.
 // 
 // Permanent members have guaranteed assignments that cannot be evicted by
@@ -44,71 +471,69 @@ std::vector<Assignment> AssignmentEngine::assign(){
 // - The slip is marked as occupied and unavailable for other members
 // - If a permanent member has no current slip, they are skipped
 void AssignmentEngine::assignPermanentMembers(std::vector<Assignment> &assignments){
+    beginPhase(1, "permanent");
+    
     if (mVerbose){
         std::cout << "\n===== PHASE 1: Permanent Member Assignments =====\n";
     }
     
     for (auto &member : mMembers){
         // Skip non-permanent members - handled in later phases
-        if (member.dockStatus() != Member::DockStatus::PERMANENT){
+        if (dockStatus(&member) != Member::DockStatus::PERMANENT){
             continue;
         }
 
         // Permanent members without a designated slip cannot be assigned
         if (!member.currentSlip().has_value()){
+            recordDecision(DecisionLog::Event::PERMANENT_NO_SLIP, &member);
             continue;
         }
 
         const std::string &slipId = member.currentSlip().value();
         Slip *slip = findSlipById(slipId);
 
-        if (slip){
+        if (!slip){
+            recordDecision(DecisionLog::Event::PERMANENT_NO_SLIP, &member);
+        }
+        else{
+            recordDecision(DecisionLog::Event::PERMANENT_LOCKED, &member, slip);
+
             // Mark this slip as occupied by this permanent member
             // This prevents any other member from taking it
             assignMemberToSlip(&member, slipId);
-            std::string comment = "";
+            assignments.emplace_back(member.id(), slipId, 
+                                    Assignment::Status::PERMANENT, 
+                                    member.boatDimensions(),
+                                    slip->billedDimensions(member.boatDimensions()), dockStatus(&member),
+                                    "", mPricePerSqFt);
+            Assignment &assignment = assignments.back();
 
             // Check if boat actually fits - add note if not
             // Note: still assign it since it's permanent, but flag the issue
             if (!slipFits(slip, member.boatDimensions())){
-                comment = "NOTE: Boat does not fit in assigned slip";
+                assignment.addReason(Assignment::Reason(Assignment::Reason::Code::DOES_NOT_FIT));
+            }
+            else if (!Amenities::provides(slip->amenities(), member.requiredAmenities())){
+                Assignment::Reason lacks(Assignment::Reason::Code::SLIP_LACKS_AMENITIES);
+                lacks.mAmenities = member.requiredAmenities() & ~slip->amenities();
+                assignment.addReason(lacks);
             }
             
-            // Add length difference comment if ignoring length
-            std::string lengthComment = generateLengthComment(slip, member.boatDimensions());
-            
-            if (!lengthComment.empty()){
-                if (!comment.empty()){
-                    comment += "; " + lengthComment;
-                }
-                else{
-                    comment = lengthComment;
-                }
+            // Add length difference note if ignoring length
+            if (auto reason = lengthReason(slip, member.boatDimensions())){
+                assignment.addReason(*reason);
             }
             
             // Add tight fit note if boat is within 6 inches of slip width
-            std::string widthNote = generateWidthMarginNote(slip, member.boatDimensions());
-            
-            if (!widthNote.empty()){
-                if (!comment.empty()){
-                    comment += "; " + widthNote;
-                }
-                else{
-                    comment = widthNote;
-                }
+            if (auto reason = widthMarginReason(slip, member.boatDimensions())){
+                assignment.addReason(*reason);
             }
-
-            assignments.emplace_back(member.id(), slipId, 
-                                    Assignment::Status::PERMANENT, 
-                                    member.boatDimensions(),
-                                    slip->maxDimensions(), member.dockStatus(),
-                                    comment, mPricePerSqFt);
             
             if (mVerbose){
                 std::cout << "  Member " << member.id() << " -> Slip " << slipId << " (PERMANENT)";
                 
-                if (!comment.empty()){
-                    std::cout << " [" << comment << "]";
+                if (!assignment.comment().empty()){
+                    std::cout << " [" << assignment.comment() << "]";
                 }
                 
                 std::cout << "\n";
@@ -119,24 +544,28 @@ void AssignmentEngine::assignPermanentMembers(std::vector<Assignment> &assignmen
 
 // Phase 2: Process year-off members - they don't get slip assignments.
 void AssignmentEngine::processYearOffMembers(std::vector<Assignment> &assignments){
+    beginPhase(2, "year-off");
+    
     if (mVerbose){
         std::cout << "\n===== PHASE 2: Year-Off Members =====\n";
     }
     
     for (auto &member : mMembers){
-        if (member.dockStatus() != Member::DockStatus::YEAR_OFF){
+        if (dockStatus(&member) != Member::DockStatus::YEAR_OFF){
             continue;
         }
         
         Dimensions emptyDimensions(0, 0, 0, 0);
         std::string previousSlip = member.currentSlip().value_or("");
+        recordDecision(DecisionLog::Event::YEAR_OFF, &member);
         
         // Year-off members get no slip assignment
         assignments.emplace_back(member.id(), "", 
                                 Assignment::Status::UNASSIGNED, 
                                 member.boatDimensions(),
-                                emptyDimensions, member.dockStatus(),
-                                "Year off - not assigned", mPricePerSqFt);
+                                emptyDimensions, dockStatus(&member),
+                                "", mPricePerSqFt);
+        assignments.back().addReason(Assignment::Reason(Assignment::Reason::Code::YEAR_OFF));
         
         if (mVerbose){
             std::cout << "  Member " << member.id() << " (YEAR-OFF)";
@@ -177,29 +606,26 @@ void AssignmentEngine::assignRemainingMembers(std::vector<Assignment> &assignmen
     
     for (Member::DockStatus currentStatus : statusOrder){
         // Build list of members with this dock status
+        // Already in priority order: lower member ID (or more seniority)
+        // first, so that higher-priority members are processed first and
+        // can evict lower-priority members from desired slips
+        int tier = getDockStatusPriority(currentStatus);
         std::vector<Member *> assignableMembers;
 
-        for (auto &member : mMembers){
-            if (member.dockStatus() == currentStatus){
-                assignableMembers.push_back(&member);
-            }
+        for (uint32_t i = mTierStarts[tier]; i < mTierStarts[tier + 1]; ++i){
+            assignableMembers.push_back(&mMembers[mPriorityOrder[i]]);
         }
         
         if (assignableMembers.empty()){
             continue;
         }
 
-        // Sort by priority: lower member ID = higher priority
-        // This ensures higher-priority members are processed first and can
-        // evict lower-priority members from desired slips
-        std::sort(assignableMembers.begin(), assignableMembers.end(),
-                  [](const Member *a, const Member *b){ return *a < *b; });
-
         // Iterative assignment loop
         // Keep processing until no changes occur (no evictions)
         // This ensures evicted members get reconsidered for alternative slips
         bool changesMade = true;
         int passNumber = 1;
+        beginPhase(phaseNumber, Member::dockStatusToString(currentStatus));
         
         if (mVerbose){
             std::cout << "\n===== PHASE " << phaseNumber << ": " 
@@ -209,6 +635,7 @@ void AssignmentEngine::assignRemainingMembers(std::vector<Assignment> &assignmen
 
         while (changesMade){
             changesMade = false;
+            mCurrentPass = passNumber;
             
             if (mVerbose){
                 std::cout << "\n--- Pass " << passNumber << " ---\n";
@@ -226,6 +653,7 @@ void AssignmentEngine::assignRemainingMembers(std::vector<Assignment> &assignmen
                 bool canEvict = canMemberEvict(member);
 
                 std::string assignedSlipId;
+                Slip *assignedSlip = nullptr;
 
                 // STEP 1: Try to assign member to their current/preferred slip
                 // This minimizes disruption by keeping members where they are
@@ -234,24 +662,47 @@ void AssignmentEngine::assignRemainingMembers(std::vector<Assignment> &assignmen
                     Slip *currentSlip = findSlipById(currentSlipId);
 
                     // Check if current slip exists and boat fits
-                    if (currentSlip && slipFits(currentSlip, member->boatDimensions())){
-                        auto occupantIt = mSlipOccupant.find(currentSlipId);
+                    if (!currentSlip){
+                        recordDecision(DecisionLog::Event::CURRENT_SLIP_MISSING, member);
+                    }
+                    else if (!slipFits(currentSlip, member->boatDimensions())){
+                        recordDecision(DecisionLog::Event::CURRENT_SLIP_TOO_SMALL, member, currentSlip);
+                    }
+                    else if (!Amenities::provides(currentSlip->amenities(), member->requiredAmenities())){
+                        recordDecision(DecisionLog::Event::CURRENT_SLIP_LACKS_AMENITIES, member, currentSlip);
+                    }
+                    else if (currentSlip->shared()){
+                        // Shared slip: make room beside the boats already there
+                        if (claimSharedSlip(member, currentSlip, canEvict, DecisionLog::Event::CURRENT_SLIP_BLOCKED, changesMade)){
+                            assignedSlipId = currentSlipId;
+                            assignedSlip = currentSlip;
+                        }
+                    }
+                    else{
+                        const Member *occupant = slipOccupant(currentSlipId);
 
                         // Case 1: Slip is available (not occupied)
-                        if (occupantIt == mSlipOccupant.end()){
+                        if (!occupant){
                             assignedSlipId = currentSlipId;
+                            assignedSlip = currentSlip;
                         }
-                        else if (canEvict && canEvictMember(member, occupantIt->second)){
+                        else if (canEvict && canEvictMember(member, occupant)){
                             // Case 2: Slip is occupied by lower-priority member
                             // Evict them if possible (based on dock status priority)
                             // Evict the lower-priority member
                             // They'll be reconsidered in the next iteration
-                            unassignMember(occupantIt->second);
+                            recordDecision(DecisionLog::Event::EVICTED, member, currentSlip, occupant);
+                            recordDecision(DecisionLog::Event::WAS_EVICTED, occupant, currentSlip, member);
+                            unassignMember(occupant);
                             assignedSlipId = currentSlipId;
+                            assignedSlip = currentSlip;
                             changesMade = true;  // Signal need for another iteration
                         }
-                        // Case 3: Slip occupied by permanent or higher-priority member
-                        // Cannot evict them - will try to find alternative slip below
+                        else{
+                            // Case 3: Slip occupied by permanent or higher-priority member
+                            // Cannot evict them - will try to find alternative slip below
+                            recordDecision(DecisionLog::Event::CURRENT_SLIP_BLOCKED, member, currentSlip, occupant);
+                        }
                     }
                 }
 
@@ -262,26 +713,43 @@ void AssignmentEngine::assignRemainingMembers(std::vector<Assignment> &assignmen
                     std::string excludeSlip = member->currentSlip().value_or("");
                     Slip *bestSlip = findBestAvailableSlip(member->boatDimensions(), member, excludeSlip);
 
-                    if (bestSlip){
-                        auto occupantIt = mSlipOccupant.find(bestSlip->id());
+                    if (!bestSlip){
+                        recordDecision(DecisionLog::Event::NO_CANDIDATE, member);
+                    }
+                    else if (bestSlip->shared()){
+                        if (claimSharedSlip(member, bestSlip, canEvict, DecisionLog::Event::BEST_FIT_BLOCKED, changesMade)){
+                            assignedSlipId = bestSlip->id();
+                            assignedSlip = bestSlip;
+                        }
+                    }
+                    else{
+                        const Member *occupant = slipOccupant(bestSlip->id());
 
                         // Case 1: Slip is available (not occupied) - take it
-                        if (occupantIt == mSlipOccupant.end()){
+                        if (!occupant){
                             assignedSlipId = bestSlip->id();
+                            assignedSlip = bestSlip;
                         }
-                        else if (canEvict && canEvictMember(member, occupantIt->second)){
+                        else if (canEvict && canEvictMember(member, occupant)){
                             // Case 2: Slip is occupied, try to evict if higher priority
-                            unassignMember(occupantIt->second);
+                            recordDecision(DecisionLog::Event::EVICTED, member, bestSlip, occupant);
+                            recordDecision(DecisionLog::Event::WAS_EVICTED, occupant, bestSlip, member);
+                            unassignMember(occupant);
                             assignedSlipId = bestSlip->id();
+                            assignedSlip = bestSlip;
                             changesMade = true;
                         }
-                        // Case 3: Slip occupied by higher priority - cannot take it
+                        else{
+                            // Case 3: Slip occupied by higher priority - cannot take it
+                            recordDecision(DecisionLog::Event::BEST_FIT_BLOCKED, member, bestSlip, occupant);
+                        }
                     }
                 }
 
                 // STEP 3: Assign member to slip if one was found
                 if (!assignedSlipId.empty()){
                     assignMemberToSlip(member, assignedSlipId);
+                    recordDecision(DecisionLog::Event::ASSIGNED, member, assignedSlip);
                     
                     if (mVerbose){
                         std::cout << "  Member " << member->id() << " -> Slip " << assignedSlipId;
@@ -311,15 +779,30 @@ void AssignmentEngine::assignRemainingMembers(std::vector<Assignment> &assignmen
         phaseNumber++;
     }
 
+    improveAssignments();
+    maximizeRevenue();
+    addRemainingAssignments(assignments);
+}
+
+// Generate output rows for all non-permanent, non-year-off members once
+// their slips are settled: assigned members first, then unassigned ones.
+void AssignmentEngine::addRemainingAssignments(std::vector<Assignment> &assignments){
     // STEP 4: Generate output for all assigned members
     // Determine if they kept their slip (SAME) or got a new one (NEW)
-    for (const auto &entry : mMemberAssignment){
-        const Member *member = entry.first;
-        const std::string &slipId = entry.second;
+    // Assigned members in roster order
+    for (const auto &rosterMember : mMembers){
+        const Member *member = &rosterMember;
+        const std::string *assignedSlipId = mMemberAssignment.find(member);
+        
+        if (!assignedSlipId){
+            continue;
+        }
+        
+        const std::string &slipId = *assignedSlipId;
 
         // Skip permanent and year-off members - already added to output in phases 1 and 2
-        if (member->dockStatus() == Member::DockStatus::PERMANENT || 
-            member->dockStatus() == Member::DockStatus::YEAR_OFF){
+        if (dockStatus(member) == Member::DockStatus::PERMANENT || 
+            dockStatus(member) == Member::DockStatus::YEAR_OFF){
             continue;
         }
 
@@ -327,39 +810,26 @@ void AssignmentEngine::assignRemainingMembers(std::vector<Assignment> &assignmen
         // Exception: UNASSIGNED members always get TEMPORARY status (even if they kept their slip)
         Assignment::Status status = Assignment::Status::TEMPORARY;
         
-        if (member->dockStatus() != Member::DockStatus::UNASSIGNED &&
+        if (dockStatus(member) != Member::DockStatus::UNASSIGNED &&
             member->currentSlip().has_value() && member->currentSlip().value() == slipId){
             status = Assignment::Status::SAME;
         }
         
-        // Add length difference comment if ignoring length
         Slip *assignedSlip = findSlipById(slipId);
-        std::string comment = "";
-        
-        if (assignedSlip){
-            std::string lengthComment = generateLengthComment(assignedSlip, member->boatDimensions());
-            
-            if (!lengthComment.empty()){
-                comment = lengthComment;
-            }
-            
-            // Add tight fit note if boat is within 6 inches of slip width
-            std::string widthNote = generateWidthMarginNote(assignedSlip, member->boatDimensions());
-            
-            if (!widthNote.empty()){
-                if (!comment.empty()){
-                    comment += "; " + widthNote;
-                }
-                else{
-                    comment = widthNote;
-                }
-            }
-        }
-
         assignments.emplace_back(member->id(), slipId, status, 
                                 member->boatDimensions(), 
-                                assignedSlip->maxDimensions(), member->dockStatus(),
-                                comment, mPricePerSqFt);
+                                assignedSlip->billedDimensions(member->boatDimensions()), dockStatus(member),
+                                "", mPricePerSqFt);
+        
+        // Add length difference note if ignoring length
+        if (auto reason = lengthReason(assignedSlip, member->boatDimensions())){
+            assignments.back().addReason(*reason);
+        }
+        
+        // Add tight fit note if boat is within 6 inches of slip width
+        if (auto reason = widthMarginReason(assignedSlip, member->boatDimensions())){
+            assignments.back().addReason(*reason);
+        }
     }
 
     // STEP 5: Generate output for all unassigned members (not permanent or year-off)
@@ -368,65 +838,1435 @@ void AssignmentEngine::assignRemainingMembers(std::vector<Assignment> &assignmen
     // - All suitable slips occupied by higher-priority members
     // - Evicted and no alternative slip found
     for (auto &member : mMembers){
-        if (member.dockStatus() != Member::DockStatus::PERMANENT && 
-            member.dockStatus() != Member::DockStatus::YEAR_OFF &&
+        if (dockStatus(&member) != Member::DockStatus::PERMANENT && 
+            dockStatus(&member) != Member::DockStatus::YEAR_OFF &&
             !isMemberAssigned(&member)){
-            std::string comment = generateUnassignedComment(&member);
             Dimensions emptyDimensions(0, 0, 0, 0);
             assignments.emplace_back(member.id(), "", Assignment::Status::UNASSIGNED, 
-                                    member.boatDimensions(), emptyDimensions, member.dockStatus(),
-                                    comment, mPricePerSqFt);
+                                    member.boatDimensions(), emptyDimensions, dockStatus(&member),
+                                    "", mPricePerSqFt);
+            
+            if (mDiagnostics){
+                assignments.back().addReason(unassignedReason(&member));
+            }
         }
     }
 }
 
-// Find a slip by its ID.
-// Returns pointer to slip if found, nullptr otherwise.
-Slip *AssignmentEngine::findSlipById(const std::string &slipId) const{
-    for (const auto &slip : mSlips){
-        if (slip.id() == slipId){
-            return const_cast<Slip *>(&slip);
+// Phase 3 (stable matching mode): deferred acceptance over ranked preferences.
+//
+// Each non-permanent, non-year-off member's candidates are, in order: their
+// ranked slip preferences, their current slip, then the best-fit order
+// (preferred dock first, then the whole marina) - the same order the
+// iterative engine tries. Slips prefer members by dock status tier, then
+// member ID. Slips held by permanent members are never available.
+//
+// Because every slip ranks members the same way, deferred acceptance
+// reduces to letting members choose in priority order: a proposal accepted
+// by a slip can only be displaced by a higher-priority member, and all of
+// those have already chosen. The result is the unique stable matching - no
+// member and slip both prefer each other to what they ended up with - and
+// no proposal is ever rejected after being accepted.
+//
+// Each ranked list is read once, only up to the first free slip that fits,
+// and not at all once no free slip fits the boat. Slip state lives in flat
+// arrays indexed by slip position; best-fit queries use the index's width
+// buckets and skip taken slips through next-free links, so each taken slip
+// is stepped over only once per bucket order.
+void AssignmentEngine::assignByStableMatching(std::vector<Assignment> &assignments){
+    const uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    beginPhase(3, "stable matching");
+    mCurrentPass = 1;
+    
+    if (mVerbose){
+        std::cout << "\n===== PHASE 3: Stable Matching =====\n";
+    }
+    
+    // In priority order
+    std::vector<uint32_t> participants;
+    
+    for (uint32_t m : mPriorityOrder){
+        Member::DockStatus status = dockStatus(&mMembers[m]);
+        
+        if (status != Member::DockStatus::PERMANENT && status != Member::DockStatus::YEAR_OFF){
+            participants.push_back(m);
         }
     }
-    return nullptr;
-}
-
-// Find a member by their ID.
-// Returns pointer to member if found, nullptr otherwise.
-Member *AssignmentEngine::findMemberById(const std::string &memberId){
-    for (auto &member : mMembers){
-        if (member.id() == memberId){
-            return &member;
+    
+    // Occupancy is tracked per slip ID, so duplicate IDs share the first slip
+    std::vector<uint32_t> canonical(mSlips.size());
+    std::vector<bool> taken(mSlips.size(), false);
+    // Boats and width used in shared slips
+    std::vector<int> sharedCount(mSlips.size(), 0);
+    std::vector<int> sharedWidth(mSlips.size(), 0);
+    
+    for (uint32_t i = 0; i < mSlips.size(); ++i){
+        canonical[i] = mSlipPositions.at(mSlips[i].id());
+        const Occupancy *occupancy = mSlipOccupants.find(mSlips[i].id());
+        
+        if (occupancy){
+            taken[canonical[i]] = true;
+            sharedCount[canonical[i]] = static_cast<int>(occupancy->mMembers.size());
+            sharedWidth[canonical[i]] = occupancy->mWidthUsed;
+        }
+        
+        // Closed slips are marked full
+        if (slipClosed(&mSlips[i])){
+            taken[i] = true;
+            sharedCount[i] = mSlips[i].capacity();
         }
     }
-    return nullptr;
-}
-
-// Assign a member to a slip.
-// Updates both the slip occupancy map (slip -> member) and
-// member assignment map (member -> slip) to maintain bidirectional tracking.
+    
+    // Free width of a slip for a boat, or -1 if the boat cannot be placed
+    auto room = [&](uint32_t slip, const Dimensions &boat) -> int{
+        const Slip &target = mSlips[slip];
+        
+        if (!target.shared()){
+            return taken[slip] ? -1 : target.maxDimensions().widthInches();
+        }
+        
+        int free = target.maxDimensions().widthInches() - sharedWidth[slip];
+        return sharedCount[slip] < target.capacity() && boat.widthInches() <= free ? free : -1;
+    };
+    
+    const std::vector<uint32_t> &preferenceOffsets = mInputs->mPreferenceOffsets;
+    const std::vector<uint32_t> &preferenceTargets = mInputs->mPreferenceTargets;
+    
+    // Next-free links over a bucket order: link[i] == i while the slip at
+    // offset i may still be free; taken slips are unlinked when walked over
+    struct FreeLinks {
+        std::vector<uint32_t> mLink;
+        
+        uint32_t find(uint32_t i){
+            while (mLink[i] != i){
+                mLink[i] = mLink[mLink[i]];
+                i = mLink[i];
+            }
+            return i;
+        }
+    };
+    
+    // Links for each width bucket of a clearance group, for both length orders
+    struct GroupLinks {
+        std::vector<FreeLinks> mShortestFirst;
+        std::vector<FreeLinks> mLongestFirst;
+    };
+    
+    std::map<const SlipIndex::FitGroup *, GroupLinks> groupLinks;
+    
+    auto linksFor = [&groupLinks](const SlipIndex::FitGroup *group) -> GroupLinks &{
+        GroupLinks &links = groupLinks[group];
+        
+        if (links.mShortestFirst.empty()){
+            for (const auto &bucket : group->mWidthBuckets){
+                FreeLinks free;
+                free.mLink.resize(bucket.mShortestFirst.size() + 1);
+                std::iota(free.mLink.begin(), free.mLink.end(), 0);
+                links.mShortestFirst.push_back(free);
+                links.mLongestFirst.push_back(free);
+            }
+        }
+        
+        return links;
+    };
+    
+    // Offset of the first slip in an order, from a start offset, that is not taken
+    auto firstFree = [&](const std::vector<uint32_t> &order, FreeLinks &links, size_t start) -> uint32_t{
+        for (uint32_t i = links.find(static_cast<uint32_t>(start)); i < order.size(); i = links.find(i + 1)){
+            if (!taken[canonical[order[i]]]){
+                return i;
+            }
+            
+            links.mLink[i] = i + 1;
+        }
+        
+        return NONE;
+    };
+    
+    // Best-fit choice within one index, matching findBestSlipInIndex(). In
+    // each fit group that admits the boat, each bucket wide enough
+    // offers its shortest free slip that is long enough; the smallest area
+    // wins, then the wider slip, then the earlier position. In ignore-length
+    // mode, when nothing is long enough, each bucket offers its longest free
+    // slip instead and the least overhang wins.
+    auto bestFit = [&](const SlipIndex *index, const Dimensions &boat, Amenities::Mask required) -> uint32_t{
+        uint32_t best = NONE;
+        long long bestArea = 0;
+        int bestWidth = 0;
+        
+        auto beatsBest = [&](uint32_t position, long long area, int width){
+            return best == NONE || area < bestArea ||
+                   (area == bestArea && (width > bestWidth || (width == bestWidth && position < best)));
+        };
+        
+        for (const auto &group : index->groups()){
+            if (!group.admits(boat, required)){
+                continue;
+            }
+            
+            size_t wideEnough = group.bucketsAtLeast(boat.widthInches());
+            GroupLinks &links = linksFor(&group);
+            
+            for (size_t b = 0; b < wideEnough; ++b){
+                const auto &bucket = group.mWidthBuckets[b];
+                uint32_t offset = firstFree(bucket.mShortestFirst, links.mShortestFirst[b],
+                                            bucket.firstAtLeast(boat.lengthInches()));
+                
+                // Free slips a mixed group holds without the amenities stay linked for other boats
+                while (offset != NONE && !group.provides(mSlips[bucket.mShortestFirst[offset]].amenities(), required)){
+                    offset = firstFree(bucket.mShortestFirst, links.mShortestFirst[b], offset + 1);
+                }
+                
+                if (offset == NONE){
+                    continue;
+                }
+                
+                uint32_t position = bucket.mShortestFirst[offset];
+                long long area = static_cast<long long>(bucket.mLengthsAscending[offset]) * bucket.mWidth;
+                
+                if (beatsBest(position, area, bucket.mWidth)){
+                    best = position;
+                    bestArea = area;
+                    bestWidth = bucket.mWidth;
+                }
+            }
+        }
+        
+        // Shared slips are few, and ranked by the width they have free
+        for (uint32_t position : index->sharedPositions()){
+            const Slip &slip = mSlips[position];
+            int free = room(canonical[position], boat);
+            
+            if (free < 0 || !Amenities::provides(slip.amenities(), required) || !boat.fitsIn(slip.maxDimensions())){
+                continue;
+            }
+            
+            long long area = static_cast<long long>(slip.maxDimensions().lengthInches()) * free;
+            
+            if (beatsBest(position, area, free)){
+                best = position;
+                bestArea = area;
+                bestWidth = free;
+            }
+        }
+        
+        if (best != NONE || !mIgnoreLength){
+            return best == NONE ? NONE : canonical[best];
+        }
+        
+        int bestLength = 0;
+        
+        for (const auto &group : index->groups()){
+            if (!group.admits(boat, required)){
+                continue;
+            }
+            
+            size_t wideEnough = group.bucketsAtLeast(boat.widthInches());
+            GroupLinks &links = linksFor(&group);
+            
+            for (size_t b = 0; b < wideEnough; ++b){
+                const auto &bucket = group.mWidthBuckets[b];
+                uint32_t offset = firstFree(bucket.mLongestFirst, links.mLongestFirst[b],
+                                            bucket.firstShorterThan(boat.lengthInches()));
+                
+                while (offset != NONE && !group.provides(mSlips[bucket.mLongestFirst[offset]].amenities(), required)){
+                    offset = firstFree(bucket.mLongestFirst, links.mLongestFirst[b], offset + 1);
+                }
+                
+                if (offset == NONE){
+                    continue;
+                }
+                
+                uint32_t position = bucket.mLongestFirst[offset];
+                int length = bucket.mLengthsDescending[offset];
+                long long area = static_cast<long long>(length) * bucket.mWidth;
+                
+                if (best == NONE || length > bestLength || (length == bestLength && beatsBest(position, area, bucket.mWidth))){
+                    best = position;
+                    bestLength = length;
+                    bestArea = area;
+                    bestWidth = bucket.mWidth;
+                }
+            }
+        }
+        
+        for (uint32_t position : index->sharedPositions()){
+            const Slip &slip = mSlips[position];
+            int free = room(canonical[position], boat);
+            
+            if (free < 0 || !Amenities::provides(slip.amenities(), required) || !boat.fitsInWidthOnly(slip.maxDimensions())){
+                continue;
+            }
+            
+            int length = slip.maxDimensions().lengthInches();
+            long long area = static_cast<long long>(length) * free;
+            
+            if (best == NONE || length > bestLength || (length == bestLength && beatsBest(position, area, free))){
+                best = position;
+                bestLength = length;
+                bestArea = area;
+                bestWidth = free;
+            }
+        }
+        
+        return best == NONE ? NONE : canonical[best];
+    };
+    
+    for (uint32_t m : participants){
+        Member *member = &mMembers[m];
+        const Dimensions &boat = member->boatDimensions();
+        // The unranked choice; when there is none, no free slip fits the
+        // boat and its ranked list does not need to be read
+        uint32_t fallback = bestFit(&mAllSlips, boat, member->requiredAmenities());
+        uint32_t chosen = NONE;
+        
+        if (fallback == NONE){
+            recordDecision(DecisionLog::Event::NO_CANDIDATE, member);
+            continue;
+        }
+        
+        // Ranked slips, then the current slip, are proposed to in order
+        auto propose = [&](uint32_t slip){
+            if (room(slip, boat) >= 0 && slipFits(&mSlips[slip], member)){
+                chosen = slip;
+            }
+        };
+        
+        for (uint32_t p = preferenceOffsets[m]; p < preferenceOffsets[m + 1] && chosen == NONE; ++p){
+            propose(preferenceTargets[p]);
+        }
+        
+        if (chosen == NONE && member->currentSlip().has_value()){
+            auto current = mSlipPositions.find(member->currentSlip().value());
+            
+            if (current != mSlipPositions.end()){
+                propose(current->second);
+            }
+        }
+        
+        if (chosen == NONE && member->preferredDock().has_value()){
+            auto dockIt = mDockIndexes.find(member->preferredDock().value());
+            
+            if (dockIt != mDockIndexes.end()){
+                chosen = bestFit(&dockIt->second, boat, member->requiredAmenities());
+            }
+        }
+        
+        if (chosen == NONE){
+            chosen = fallback;
+        }
+        
+        taken[chosen] = true;
+        sharedCount[chosen]++;
+        sharedWidth[chosen] += boat.widthInches();
+        assignMemberToSlip(member, mSlips[chosen].id());
+        recordDecision(DecisionLog::Event::ASSIGNED, member, &mSlips[chosen]);
+        
+        if (mVerbose){
+            std::cout << "  Member " << member->id() << " -> Slip " << mSlips[chosen].id() << "\n";
+        }
+    }
+    
+    improveAssignments();
+    maximizeRevenue();
+    addRemainingAssignments(assignments);
+}
+
+// Occupancy of the slips the post-assignment passes may change. A slip is
+// in play if it is the first with its ID, open and not shared; contenders
+// are the non-permanent, non-year-off members who are unassigned or hold a
+// slip in play, in priority order.
+AssignmentEngine::Rearrangement AssignmentEngine::rearrangement() const{
+    Rearrangement state;
+    state.mInPlay.assign(mSlips.size(), false);
+    state.mOccupant.assign(mSlips.size(), Rearrangement::NONE);
+    state.mSlipOf.assign(mMembers.size(), Rearrangement::NONE);
+    state.mMovable.assign(mMembers.size(), false);
+    
+    for (uint32_t i = 0; i < mSlips.size(); ++i){
+        if (mSlipPositions.at(mSlips[i].id()) != i || mSlips[i].shared() || slipClosed(&mSlips[i])){
+            continue;
+        }
+        
+        state.mInPlay[i] = true;
+        const Occupancy *occupancy = mSlipOccupants.find(mSlips[i].id());
+        
+        if (occupancy && !occupancy->mMembers.empty()){
+            state.mOccupant[i] = static_cast<uint32_t>(occupancy->mMembers.front() - mMembers.data());
+        }
+    }
+    
+    // Contenders in priority order
+    for (uint32_t m : mPriorityOrder){
+        const Member *member = &mMembers[m];
+        Member::DockStatus status = dockStatus(member);
+        
+        if (status == Member::DockStatus::PERMANENT || status == Member::DockStatus::YEAR_OFF){
+            continue;
+        }
+        
+        const std::string *slipId = mMemberAssignment.find(member);
+        
+        if (slipId){
+            uint32_t position = mSlipPositions.at(*slipId);
+            
+            if (!state.mInPlay[position]){
+                continue;
+            }
+            
+            state.mSlipOf[m] = position;
+            state.mMovable[m] = mayLeaveSlip(member, &mSlips[position]);
+        }
+        
+        state.mContenders.push_back(m);
+    }
+    
+    return state;
+}
+
+// Members who kept their current slip, and in stable matching mode members
+// with ranked preferences, stay where the assignment phases put them.
+bool AssignmentEngine::mayLeaveSlip(const Member *member, const Slip *slip) const{
+    return !(member->currentSlip().has_value() && member->currentSlip().value() == slip->id()) &&
+           !(mStableMatching && hasPreferences(member));
+}
+
+// A member in their preferred dock stays in it, and no boat moves to a slip
+// it overhangs more.
+bool AssignmentEngine::mayRelocate(const Member *member, const Slip *from, const Slip *to) const{
+    if (member->preferredDock().has_value() && from->dock() == member->preferredDock().value() &&
+        to->dock() != from->dock()){
+        return false;
+    }
+    
+    if (!mIgnoreLength){
+        return true;
+    }
+    
+    const Dimensions &boat = member->boatDimensions();
+    return std::max(0, to->lengthDifference(boat)) <= std::max(0, from->lengthDifference(boat));
+}
+
+// Call visit with the position of every slip, shared ones aside, that the
+// member's boat fits and that provides its amenities, using the
+// whole-marina index's groups and width buckets.
+template <typename Visit>
+void AssignmentEngine::forEachFittingSlip(const Member *member, Visit visit) const{
+    const Dimensions &boat = member->boatDimensions();
+    
+    for (const auto &group : mAllSlips.groups()){
+        if (!group.admits(boat, member->requiredAmenities())){
+            continue;
+        }
+        
+        for (size_t b = 0; b < group.bucketsAtLeast(boat.widthInches()); ++b){
+            const SlipIndex::WidthBucket &bucket = group.mWidthBuckets[b];
+            size_t first = mIgnoreLength ? 0 : bucket.firstAtLeast(boat.lengthInches());
+            
+            for (size_t i = first; i < bucket.mShortestFirst.size(); ++i){
+                uint32_t position = bucket.mShortestFirst[i];
+                
+                if (group.provides(mSlips[position].amenities(), member->requiredAmenities())){
+                    visit(position);
+                }
+            }
+        }
+    }
+}
+
+// Square inches as square feet to one decimal place
+static std::string squareFeet(long long squareInches){
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << squareInches / 144.0;
+    return out.str();
+}
+
+// A change in area with its sign
+static std::string signedSquareFeet(long long squareInches){
+    return (squareInches < 0 ? "-" : "+") + squareFeet(squareInches < 0 ? -squareInches : squareInches);
+}
+
+// An amount of money to the cent
+static std::string dollars(double amount){
+    std::ostringstream out;
+    out << "$" << std::fixed << std::setprecision(2) << amount;
+    return out.str();
+}
+
+// Phase 6 (optional): local search for a better result within a time budget.
+//
+// The greedy phases can leave a boat unplaced, or in a larger slip than it
+// needs, when moving other boats would fix it. This pass searches ejection
+// chains over the fit graph: a boat takes a slip, that slip's boat moves on
+// to another, and so on until the last one moves into a free slip. A chain
+// either places an unassigned member, starting at a slip the member fits,
+// or recovers area, starting from a movable member's slip and ending in a
+// smaller free slip. Swaps and cycles never change which slips are in use,
+// so only chains that end in a free slip are searched.
+//
+// What may move keeps the priority rules intact: permanent members, members
+// who kept their current slip, boats in shared slips and, in stable matching
+// mode, members with ranked preferences stay put; a member in their
+// preferred dock only moves within it; and no boat moves to a slip it
+// overhangs more. Nobody loses a slip, and unassigned members are placed in
+// priority order.
+//
+// Each round searches a chain for every candidate on worker threads against
+// the state the round started from, then applies the chains in priority
+// order, skipping any that an earlier one invalidated (they are searched
+// again next round). A chain's gain depends only on its two ends, so it is
+// evaluated without rescoring the marina. Rounds run until one finds nothing
+// or the budget runs out; every applied chain keeps the result feasible, so
+// the current result is always the best found.
+void AssignmentEngine::improveAssignments(){
+    if (mImproveMs == 0){
+        return;
+    }
+    
+    const uint32_t NONE = Rearrangement::NONE;
+    // Longest chain searched, and slips expanded per search
+    const size_t MAX_CHAIN = 4;
+    const size_t MAX_EXPANSIONS = 64;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(mImproveMs);
+    beginPhase(6, "improvement");
+    
+    if (mVerbose){
+        std::cout << "\n===== PHASE 6: Improvement =====\n";
+    }
+    
+    Rearrangement state = rearrangement();
+    std::vector<uint32_t> &occupant = state.mOccupant;
+    std::vector<uint32_t> &slipOf = state.mSlipOf;
+    std::vector<bool> &movable = state.mMovable;
+    
+    auto area = [this](uint32_t slip){
+        const Dimensions &limits = mSlips[slip].maxDimensions();
+        return static_cast<long long>(limits.lengthInches()) * limits.widthInches();
+    };
+    
+    // Whether member m may move from slip from (NONE when unassigned) to
+    // slip to, a slip the boat fits
+    auto canMove = [&](uint32_t m, uint32_t from, uint32_t to){
+        if (to == from || !state.mInPlay[to]){
+            return false;
+        }
+        
+        return from == NONE || mayRelocate(&mMembers[m], &mSlips[from], &mSlips[to]);
+    };
+    
+    // A chain's slips and the members moving into them: the candidate takes
+    // the first slip, each slip's occupant takes the next, and the last slip
+    // is free
+    struct Chain {
+        uint32_t mFrom;
+        std::vector<uint32_t> mSlips;
+        std::vector<uint32_t> mMovers;
+        long long mGain = 0;
+    };
+    
+    // Per-thread visit marks and BFS parents over slip positions
+    struct Scratch {
+        std::vector<uint32_t> mVisited;
+        std::vector<uint32_t> mParent;
+        uint32_t mStamp = 0;
+    };
+    
+    // Best chain for a candidate against the round's state: for an unassigned
+    // member the shortest chain, ending in the smallest free slip; for an
+    // assigned one the chain recovering the most area, if any
+    auto search = [&](uint32_t m, Scratch &scratch){
+        if (scratch.mVisited.empty()){
+            scratch.mVisited.assign(mSlips.size(), 0);
+            scratch.mParent.assign(mSlips.size(), NONE);
+        }
+        
+        uint32_t stamp = ++scratch.mStamp;
+        uint32_t from = slipOf[m];
+        bool placing = from == NONE;
+        long long released = placing ? 0 : area(from);
+        uint32_t bestEnd = NONE;
+        long long bestGain = 0;
+        size_t expansions = 0;
+        
+        if (!placing){
+            scratch.mVisited[from] = stamp;
+        }
+        
+        // Slips entered at this depth, with the member entering each
+        std::vector<std::pair<uint32_t, uint32_t>> layer;
+        std::vector<std::pair<uint32_t, uint32_t>> next;
+        
+        // Queue or score the slips the mover's boat fits and may move to
+        auto enter = [&](uint32_t mover, uint32_t moverFrom, uint32_t parent){
+            forEachFittingSlip(&mMembers[mover], [&](uint32_t to){
+                if (scratch.mVisited[to] == stamp || !canMove(mover, moverFrom, to)){
+                    return;
+                }
+                
+                uint32_t holder = occupant[to];
+                
+                if (holder != NONE && !movable[holder]){
+                    return;
+                }
+                
+                scratch.mVisited[to] = stamp;
+                scratch.mParent[to] = parent;
+                
+                if (holder != NONE){
+                    next.emplace_back(to, holder);
+                    return;
+                }
+                
+                long long gain = placing ? -area(to) : released - area(to);
+                
+                if (bestEnd == NONE || gain > bestGain){
+                    bestEnd = to;
+                    bestGain = gain;
+                }
+            });
+        };
+        
+        enter(m, from, NONE);
+        
+        for (size_t depth = 1; depth < MAX_CHAIN && !next.empty() && expansions < MAX_EXPANSIONS; ++depth){
+            // Placements take the shortest chain found
+            if (placing && bestEnd != NONE){
+                break;
+            }
+            
+            layer.swap(next);
+            next.clear();
+            
+            for (const auto &entry : layer){
+                if (expansions++ == MAX_EXPANSIONS){
+                    break;
+                }
+                
+                enter(entry.second, entry.first, entry.first);
+            }
+        }
+        
+        Chain chain;
+        chain.mFrom = from;
+        
+        if (bestEnd == NONE || (!placing && bestGain <= 0)){
+            return chain;
+        }
+        
+        for (uint32_t slip = bestEnd; slip != NONE; slip = scratch.mParent[slip]){
+            chain.mSlips.push_back(slip);
+        }
+        
+        std::reverse(chain.mSlips.begin(), chain.mSlips.end());
+        chain.mMovers.push_back(m);
+        
+        for (size_t i = 0; i + 1 < chain.mSlips.size(); ++i){
+            chain.mMovers.push_back(occupant[chain.mSlips[i]]);
+        }
+        
+        chain.mGain = placing ? 0 : bestGain;
+        return chain;
+    };
+    
+    unsigned threadCount = std::max(1u, mThreads);
+    std::vector<Scratch> scratches(threadCount);
+    bool improved = true;
+    
+    while (improved && !mImprovement.mTimedOut){
+        improved = false;
+        mCurrentPass = static_cast<int>(++mImprovement.mRounds);
+        
+        // Unassigned members first, then movable ones, each in priority order
+        std::vector<uint32_t> candidates;
+        
+        for (uint32_t m : state.mContenders){
+            if (slipOf[m] == NONE){
+                candidates.push_back(m);
+            }
+        }
+        
+        for (uint32_t m : state.mContenders){
+            if (slipOf[m] != NONE && movable[m]){
+                candidates.push_back(m);
+            }
+        }
+        
+        std::vector<Chain> chains(candidates.size());
+        std::atomic<size_t> nextCandidate(0);
+        std::atomic<bool> timedOut(false);
+        
+        auto worker = [&](unsigned t){
+            for (size_t c = nextCandidate++; c < candidates.size(); c = nextCandidate++){
+                if (std::chrono::steady_clock::now() >= deadline){
+                    timedOut = true;
+                    return;
+                }
+                
+                chains[c] = search(candidates[c], scratches[t]);
+            }
+        };
+        
+        std::vector<std::thread> workers;
+        
+        for (unsigned t = 1; t < std::min<size_t>(threadCount, candidates.size()); ++t){
+            workers.emplace_back(worker, t);
+        }
+        
+        worker(0);
+        
+        for (auto &thread : workers){
+            thread.join();
+        }
+        
+        mImprovement.mTimedOut = timedOut;
+        
+        // Apply the chains in priority order, each from its free end back
+        for (const Chain &chain : chains){
+            if (chain.mSlips.empty()){
+                continue;
+            }
+            
+            // Skip a chain if an earlier one moved a boat it needs in place
+            uint32_t start = chain.mMovers.front();
+            bool valid = slipOf[start] == chain.mFrom && occupant[chain.mSlips.back()] == NONE;
+            
+            for (size_t i = 0; valid && i + 1 < chain.mSlips.size(); ++i){
+                valid = occupant[chain.mSlips[i]] == chain.mMovers[i + 1];
+            }
+            
+            if (!valid){
+                continue;
+            }
+            
+            for (size_t i = chain.mSlips.size(); i-- > 0;){
+                uint32_t mover = chain.mMovers[i];
+                uint32_t target = chain.mSlips[i];
+                
+                if (slipOf[mover] != NONE){
+                    occupant[slipOf[mover]] = NONE;
+                    unassignMember(&mMembers[mover]);
+                }
+                
+                assignMemberToSlip(&mMembers[mover], mSlips[target].id());
+                occupant[target] = mover;
+                slipOf[mover] = target;
+                recordDecision(DecisionLog::Event::IMPROVED, &mMembers[mover], &mSlips[target],
+                               mover == start ? nullptr : &mMembers[start]);
+            }
+            
+            if (chain.mFrom == NONE){
+                movable[start] = mayLeaveSlip(&mMembers[start], &mSlips[chain.mSlips.front()]);
+                mImprovement.mBoatsPlaced++;
+            }
+            
+            mImprovement.mAreaRecoveredSquareInches += chain.mGain;
+            mImprovement.mChains++;
+            improved = true;
+            
+            if (mVerbose){
+                std::cout << "  Member " << mMembers[start].id() << " -> Slip " << mSlips[chain.mSlips.front()].id();
+                
+                if (chain.mSlips.size() > 1){
+                    std::cout << " (" << chain.mSlips.size() - 1 << " other boat(s) moved)";
+                }
+                
+                if (chain.mGain > 0){
+                    std::cout << ", " << squareFeet(chain.mGain) << " sq ft recovered";
+                }
+                
+                std::cout << "\n";
+            }
+        }
+    }
+}
+
+// Phase 7 (optional): reassign the boats that may move so that the slips
+// bill the most.
+//
+// Rows are the members who may move, placed ones first and then unassigned
+// ones, each in priority order; columns are the slips in play that none of
+// the others hold. This is a rectangular assignment problem, solved by the
+// Hungarian method row by row on the sparse fit graph: each row is added
+// along a shortest augmenting path (Dijkstra over reduced costs), and the
+// potentials keep the matching of least cost for the rows matched so far.
+// An unassigned row is left out when no augmenting path reaches a free
+// slip, which is when no matching covers it and every row ahead of it.
+//
+// Starting from nothing, every row would push the rows before it out of
+// the large slips again, so the search starts from the greedy result
+// instead: slip potentials are set to minus the slip areas, under which
+// each placed boat's own slip is a least-cost edge and can be kept as
+// matched. Those potentials price an empty slip at its area, so filler
+// rows, which take any slip at no cost, are added last, one per slip still
+// empty; where a filler displaces a boat, the boat moves to a slip that
+// bills more. Edges are enumerated from the slip index as rows are
+// expanded rather than stored, and billed areas come from arrays of boat
+// and slip areas.
+void AssignmentEngine::maximizeRevenue(){
+    if (!mMaximizeRevenue){
+        return;
+    }
+    
+    const uint32_t NONE = Rearrangement::NONE;
+    beginPhase(7, "revenue");
+    mCurrentPass = 1;
+    
+    if (mVerbose){
+        std::cout << "\n===== PHASE 7: Revenue =====\n";
+    }
+    
+    Rearrangement state = rearrangement();
+    std::vector<uint32_t> rows;
+    
+    for (uint32_t m : state.mContenders){
+        if (state.mSlipOf[m] != NONE && state.mMovable[m]){
+            rows.push_back(m);
+        }
+    }
+    
+    size_t placedRows = rows.size();
+    
+    for (uint32_t m : state.mContenders){
+        if (state.mSlipOf[m] == NONE){
+            rows.push_back(m);
+        }
+    }
+    
+    // Columns are numbered by slip position; a slip held by a boat that
+    // stays is not one
+    uint32_t memberRows = static_cast<uint32_t>(rows.size());
+    std::vector<bool> column(mSlips.size(), false);
+    
+    for (uint32_t i = 0; i < mSlips.size(); ++i){
+        column[i] = state.mInPlay[i] && (state.mOccupant[i] == NONE || state.mMovable[state.mOccupant[i]]);
+    }
+    
+    std::vector<long long> boatArea(memberRows);
+    std::vector<long long> slipArea(mSlips.size());
+    std::vector<uint32_t> home(memberRows, NONE);
+    
+    for (uint32_t r = 0; r < memberRows; ++r){
+        const Dimensions &boat = mMembers[rows[r]].boatDimensions();
+        boatArea[r] = static_cast<long long>(boat.lengthInches()) * boat.widthInches();
+        home[r] = state.mSlipOf[rows[r]];
+    }
+    
+    for (size_t i = 0; i < mSlips.size(); ++i){
+        const Dimensions &limits = mSlips[i].maxDimensions();
+        slipArea[i] = static_cast<long long>(limits.lengthInches()) * limits.widthInches();
+    }
+    
+    // Billed area decides the cost; a move costs one more unit than staying,
+    // which is less than any difference in area once scaled, so ties go to
+    // the matching that moves the fewest boats. Fillers cost nothing.
+    const long long scale = static_cast<long long>(memberRows) + 1;
+    
+    auto cost = [&](uint32_t r, uint32_t slip){
+        if (r >= memberRows){
+            return 0LL;
+        }
+        
+        return -std::max(boatArea[r], slipArea[slip]) * scale + (slip == home[r] ? 0 : 1);
+    };
+    
+    // Visit the columns row r may take: for a member, their own slip and
+    // the slips their boat fits that they may move to; for a filler, all
+    std::vector<uint32_t> seen(mSlips.size(), 0);
+    uint32_t seenStamp = 0;
+    
+    auto forEachEdge = [&](uint32_t r, auto &&visit){
+        if (r >= memberRows){
+            for (uint32_t slip = 0; slip < mSlips.size(); ++slip){
+                if (column[slip]){
+                    visit(slip);
+                }
+            }
+            
+            return;
+        }
+        
+        uint32_t stamp = ++seenStamp;
+        const Member *member = &mMembers[rows[r]];
+        
+        if (home[r] != NONE){
+            seen[home[r]] = stamp;
+            visit(home[r]);
+        }
+        
+        forEachFittingSlip(member, [&](uint32_t slip){
+            if (seen[slip] == stamp || !column[slip]){
+                return;
+            }
+            
+            seen[slip] = stamp;
+            
+            if (home[r] == NONE || mayRelocate(member, &mSlips[home[r]], &mSlips[slip])){
+                visit(slip);
+            }
+        });
+    };
+    
+    std::vector<long long> rowPotential(memberRows, 0);
+    std::vector<long long> slipPotential(mSlips.size(), 0);
+    std::vector<uint32_t> slipOfRow(memberRows, NONE);
+    std::vector<uint32_t> rowOfSlip(mSlips.size(), NONE);
+    
+    for (uint32_t i = 0; i < mSlips.size(); ++i){
+        slipPotential[i] = -slipArea[i] * scale;
+    }
+    
+    // Keep a placed boat in its own slip unless another edge has a lower
+    // reduced cost, which only an overhanging boat can have
+    for (uint32_t r = 0; r < placedRows; ++r){
+        long long potential = cost(r, home[r]) - slipPotential[home[r]];
+        bool least = true;
+        
+        forEachEdge(r, [&](uint32_t slip){
+            least = least && cost(r, slip) - potential - slipPotential[slip] >= 0;
+        });
+        
+        if (least){
+            rowPotential[r] = potential;
+            slipOfRow[r] = home[r];
+            rowOfSlip[home[r]] = r;
+        }
+    }
+    
+    // Dijkstra state over columns, reset by stamp for each row added
+    std::vector<long long> dist(mSlips.size(), 0);
+    std::vector<uint32_t> reachedFrom(mSlips.size(), NONE);
+    std::vector<uint32_t> reached(mSlips.size(), 0);
+    std::vector<uint32_t> done(mSlips.size(), 0);
+    std::vector<uint32_t> finished;
+    uint32_t stamp = 0;
+    
+    // Slips a failed search reached are all taken, and every row holding
+    // one can only move among them, so no later search can free one
+    std::vector<bool> dead(mSlips.size(), false);
+    
+    // Distance, whether the slip is taken, and the slip: among slips at the
+    // same distance a free one ends the search first
+    using Entry = std::tuple<long long, bool, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    
+    // Add a row along a shortest augmenting path, if there is one
+    auto addRow = [&](uint32_t start){
+        bool hasEdge = false;
+        long long least = 0;
+        
+        forEachEdge(start, [&](uint32_t slip){
+            if (dead[slip]){
+                return;
+            }
+            
+            long long reduced = cost(start, slip) - slipPotential[slip];
+            
+            if (!hasEdge || reduced < least){
+                least = reduced;
+                hasEdge = true;
+            }
+        });
+        
+        if (!hasEdge){
+            return;
+        }
+        
+        rowPotential[start] = least;
+        stamp++;
+        finished.clear();
+        queue = decltype(queue)();
+        
+        // Reduced costs from row r, reached at distance base
+        auto relax = [&](uint32_t r, long long base){
+            forEachEdge(r, [&](uint32_t slip){
+                if (done[slip] == stamp || dead[slip]){
+                    return;
+                }
+                
+                long long next = base + cost(r, slip) - rowPotential[r] - slipPotential[slip];
+                
+                if (reached[slip] != stamp || next < dist[slip]){
+                    reached[slip] = stamp;
+                    dist[slip] = next;
+                    reachedFrom[slip] = r;
+                    queue.emplace(next, rowOfSlip[slip] != NONE, slip);
+                }
+            });
+        };
+        
+        relax(start, 0);
+        uint32_t freeSlip = NONE;
+        
+        while (!queue.empty()){
+            Entry top = queue.top();
+            queue.pop();
+            uint32_t slip = std::get<2>(top);
+            
+            if (done[slip] == stamp || std::get<0>(top) != dist[slip]){
+                continue;
+            }
+            
+            done[slip] = stamp;
+            finished.push_back(slip);
+            
+            if (rowOfSlip[slip] == NONE){
+                freeSlip = slip;
+                break;
+            }
+            
+            // A path through another filler is never shorter than taking
+            // that filler's next slip directly
+            if (rowOfSlip[slip] < memberRows){
+                relax(rowOfSlip[slip], dist[slip]);
+            }
+        }
+        
+        // No free slip is reachable: the rows ahead of this one need them all
+        if (freeSlip == NONE){
+            for (uint32_t slip : finished){
+                dead[slip] = true;
+            }
+            
+            return;
+        }
+        
+        long long total = dist[freeSlip];
+        rowPotential[start] += total;
+        
+        for (uint32_t slip : finished){
+            long long slack = total - dist[slip];
+            slipPotential[slip] -= slack;
+            
+            if (rowOfSlip[slip] != NONE){
+                rowPotential[rowOfSlip[slip]] += slack;
+            }
+        }
+        
+        for (uint32_t slip = freeSlip; slip != NONE;){
+            uint32_t r = reachedFrom[slip];
+            uint32_t previous = slipOfRow[r];
+            slipOfRow[r] = slip;
+            rowOfSlip[slip] = r;
+            slip = previous;
+        }
+    };
+    
+    for (uint32_t r = 0; r < memberRows; ++r){
+        if (slipOfRow[r] == NONE){
+            addRow(r);
+        }
+    }
+    
+    for (uint32_t slip = 0; slip < mSlips.size(); ++slip){
+        if (column[slip] && rowOfSlip[slip] == NONE){
+            rowPotential.push_back(0);
+            slipOfRow.push_back(NONE);
+        }
+    }
+    
+    for (uint32_t r = memberRows; r < slipOfRow.size(); ++r){
+        addRow(r);
+    }
+    
+    auto billed = [&](uint32_t r, uint32_t slip){
+        return slip == NONE ? 0 : std::max(boatArea[r], slipArea[slip]);
+    };
+    
+    auto price = [&](uint32_t r, uint32_t slip){
+        return slip == NONE ? 0.0 : Assignment::price(billed(r, slip) / 144.0, mPricePerSqFt);
+    };
+    
+    for (uint32_t r = 0; r < memberRows; ++r){
+        mRevenue.mGreedyBilledSquareInches += billed(r, home[r]);
+        mRevenue.mBilledSquareInches += billed(r, slipOfRow[r]);
+        mRevenue.mGreedyRevenue += price(r, home[r]);
+        mRevenue.mRevenue += price(r, slipOfRow[r]);
+    }
+    
+    // Clear every slip that changes hands before filling them again
+    for (uint32_t r = 0; r < placedRows; ++r){
+        if (slipOfRow[r] != home[r]){
+            unassignMember(&mMembers[rows[r]]);
+        }
+    }
+    
+    for (uint32_t r = 0; r < memberRows; ++r){
+        if (slipOfRow[r] == home[r] || slipOfRow[r] == NONE){
+            continue;
+        }
+        
+        const Member *member = &mMembers[rows[r]];
+        assignMemberToSlip(member, mSlips[slipOfRow[r]].id());
+        recordDecision(DecisionLog::Event::REVENUE, member, &mSlips[slipOfRow[r]]);
+        
+        if (r < placedRows){
+            mRevenue.mMembersMoved++;
+        }
+        else{
+            mRevenue.mBoatsPlaced++;
+        }
+        
+        if (mVerbose){
+            std::cout << "  Member " << member->id() << " -> Slip " << mSlips[slipOfRow[r]].id();
+            
+            if (home[r] != NONE){
+                std::cout << " (from " << mSlips[home[r]].id() << ")";
+            }
+            
+            std::cout << "\n";
+        }
+    }
+}
+
+// Find a slip by its ID.
+// Returns pointer to slip if found and not closed, nullptr otherwise.
+Slip *AssignmentEngine::findSlipById(const std::string &slipId) const{
+    auto it = mSlipPositions.find(slipId);
+    
+    if (it == mSlipPositions.end() || slipClosed(&mSlips[it->second])){
+        return nullptr;
+    }
+    
+    return &mSlips[it->second];
+}
+
+// Find a member by their ID.
+// Returns pointer to member if found, nullptr otherwise.
+Member *AssignmentEngine::findMemberById(const std::string &memberId){
+    for (auto &member : mMembers){
+        if (member.id() == memberId){
+            return &member;
+        }
+    }
+    return nullptr;
+}
+
+// The member holding a slip - the most recent one for a shared slip.
+// Returns nullptr if the slip is free.
+const Member *AssignmentEngine::slipOccupant(const std::string &slipId) const{
+    const Occupancy *occupancy = mSlipOccupants.find(slipId);
+    return occupancy ? occupancy->mMembers.back() : nullptr;
+}
+
+// Width a shared slip has free for a member's boat.
+//
+// If the boat fits beside the boats already there, nothing is evicted.
+// Otherwise occupants the member outranks are evicted, lowest priority
+// first, until it does; they are added to evictions. Whether the member
+// may evict at all is left to the caller.
+//
+// Returns the free width once the evictions are made, or -1 if the boat
+// cannot be placed even then.
+int AssignmentEngine::sharedSlipRoom(const Slip *slip, const Member *member, std::vector<const Member *> *evictions) const{
+    int boatWidth = member->boatDimensions().widthInches();
+    int room = slip->maxDimensions().widthInches();
+    const Occupancy *occupied = mSlipOccupants.find(slip->id());
+    
+    if (!occupied){
+        return boatWidth <= room ? room : -1;
+    }
+    
+    const Occupancy &occupancy = *occupied;
+    room -= occupancy.mWidthUsed;
+    int boats = static_cast<int>(occupancy.mMembers.size());
+    
+    if (boatWidth <= room && boats < slip->capacity()){
+        return room;
+    }
+    
+    std::vector<const Member *> evictable;
+    
+    for (const Member *occupant : occupancy.mMembers){
+        if (canEvictMember(member, occupant)){
+            evictable.push_back(occupant);
+        }
+    }
+    
+    // Lowest priority first
+    std::sort(evictable.begin(), evictable.end(), [this](const Member *a, const Member *b){
+        return priorityKey(a) > priorityKey(b);
+    });
+    
+    for (const Member *occupant : evictable){
+        if (boatWidth <= room && boats < slip->capacity()){
+            break;
+        }
+        
+        room += occupant->boatDimensions().widthInches();
+        boats--;
+        
+        if (evictions){
+            evictions->push_back(occupant);
+        }
+    }
+    
+    if (boatWidth <= room && boats < slip->capacity()){
+        return room;
+    }
+    
+    if (evictions){
+        evictions->clear();
+    }
+    
+    return -1;
+}
+
+// Make room for a member in a shared slip, evicting lower-priority boats
+// if the member may evict. Records the evictions, or the block when the
+// boat cannot be placed, and returns true if the member can take the slip.
+bool AssignmentEngine::claimSharedSlip(const Member *member, const Slip *slip, bool canEvict,
+                                       DecisionLog::Event blockedEvent, bool &changesMade){
+    std::vector<const Member *> evictions;
+    
+    if (sharedSlipRoom(slip, member, &evictions) < 0 || (!evictions.empty() && !canEvict)){
+        recordDecision(blockedEvent, member, slip, mSlipOccupants.find(slip->id())->mMembers.front());
+        return false;
+    }
+    
+    for (const Member *occupant : evictions){
+        recordDecision(DecisionLog::Event::EVICTED, member, slip, occupant);
+        recordDecision(DecisionLog::Event::WAS_EVICTED, occupant, slip, member);
+        unassignMember(occupant);
+        changesMade = true;
+    }
+    
+    return true;
+}
+
+// Note the other boats in each shared slip on its members' rows.
+void AssignmentEngine::addCoTenantNotes(std::vector<Assignment> &assignments) const{
+    for (auto &assignment : assignments){
+        if (!assignment.assigned()){
+            continue;
+        }
+        
+        const Occupancy *occupancy = mSlipOccupants.find(assignment.slipId());
+        
+        if (!occupancy || occupancy->mMembers.size() < 2){
+            continue;
+        }
+        
+        // Roster order, whatever order the boats arrived in
+        std::vector<const Member *> tenants(occupancy->mMembers);
+        std::sort(tenants.begin(), tenants.end());
+        Assignment::Reason shares(Assignment::Reason::Code::SHARES_SLIP);
+        
+        for (const Member *tenant : tenants){
+            if (tenant->id() != assignment.memberId()){
+                shares.mMembers.push_back(tenant->id());
+            }
+        }
+        
+        assignment.addReason(shares);
+    }
+}
+
+// Assign a member to a slip.
+// Updates both the slip occupancy map (slip -> members) and
+// member assignment map (member -> slip) to maintain bidirectional tracking.
+// A slip that is not shared holds only the latest member assigned to it.
 void AssignmentEngine::assignMemberToSlip(const Member *member, const std::string &slipId){
-    mSlipOccupant[slipId] = member;
+    Occupancy &occupancy = mSlipOccupants[slipId];
+    Slip *slip = findSlipById(slipId);
+    uint32_t memberIndex = static_cast<uint32_t>(member - mMembers.data());
+    uint32_t slipIndex = mJournaling ? mSlipPositions.at(slipId) : OccupancyJournal::NONE;
+    
+    if (!slip || !slip->shared()){
+        if (mJournaling){
+            for (size_t i = occupancy.mMembers.size(); i-- > 0;){
+                mJournal.record(OccupancyJournal::Step::OCCUPANT_REMOVED,
+                                static_cast<uint32_t>(occupancy.mMembers[i] - mMembers.data()), slipIndex,
+                                static_cast<uint32_t>(i));
+            }
+        }
+        
+        occupancy.mMembers.clear();
+        occupancy.mWidthUsed = 0;
+    }
+    
+    occupancy.mMembers.push_back(member);
+    occupancy.mWidthUsed += member->boatDimensions().widthInches();
+    
+    if (mJournaling){
+        const std::string *previous = mMemberAssignment.find(member);
+        mJournal.record(OccupancyJournal::Step::OCCUPANT_ADDED, memberIndex, slipIndex);
+        mJournal.record(OccupancyJournal::Step::ASSIGNMENT_SET, memberIndex, slipIndex,
+                        previous ? mSlipPositions.at(*previous) : OccupancyJournal::NONE);
+    }
+    
     mMemberAssignment[member] = slipId;
 }
 
 // Unassign a member from their current slip.
-// Removes them from both tracking maps, freeing up the slip for others.
+// Removes them from both tracking maps, freeing up their place for others.
 // This is used during eviction - the member will be reconsidered for
 // assignment in subsequent iterations.
 void AssignmentEngine::unassignMember(const Member *member){
-    auto it = mMemberAssignment.find(member);
+    const std::string *slipId = mMemberAssignment.find(member);
+    
+    if (slipId){
+        uint32_t memberIndex = static_cast<uint32_t>(member - mMembers.data());
+        uint32_t slipIndex = mJournaling ? mSlipPositions.at(*slipId) : OccupancyJournal::NONE;
+        Occupancy *occupancy = mSlipOccupants.findMutable(*slipId);
+        
+        if (occupancy){
+            auto memberIt = std::find(occupancy->mMembers.begin(), occupancy->mMembers.end(), member);
+            
+            if (memberIt != occupancy->mMembers.end()){
+                if (mJournaling){
+                    mJournal.record(OccupancyJournal::Step::OCCUPANT_REMOVED, memberIndex, slipIndex,
+                                    static_cast<uint32_t>(memberIt - occupancy->mMembers.begin()));
+                }
+                
+                occupancy->mMembers.erase(memberIt);
+                occupancy->mWidthUsed -= member->boatDimensions().widthInches();
+            }
+            
+            if (occupancy->mMembers.empty()){
+                mSlipOccupants.erase(*slipId);
+            }
+        }
+        
+        if (mJournaling){
+            mJournal.record(OccupancyJournal::Step::ASSIGNMENT_CLEARED, memberIndex, slipIndex);
+        }
+        
+        mMemberAssignment.erase(member);
+    }
+}
+
+// Apply one journal entry to the occupancy maps, or undo it.
+void AssignmentEngine::applyJournalEntry(const OccupancyJournal::Entry &entry, bool undo){
+    const Member *member = &mMembers[entry.mMember];
+    const std::string &slipId = mSlips[entry.mSlip].id();
+    int width = member->boatDimensions().widthInches();
+    OccupancyJournal::Step step = entry.mStep;
+    
+    // Undoing a step is doing its opposite
+    if (undo){
+        switch (step){
+            case OccupancyJournal::Step::OCCUPANT_ADDED:
+                step = OccupancyJournal::Step::OCCUPANT_REMOVED;
+                break;
+            case OccupancyJournal::Step::OCCUPANT_REMOVED:
+                step = OccupancyJournal::Step::OCCUPANT_ADDED;
+                break;
+            case OccupancyJournal::Step::ASSIGNMENT_SET:
+                if (entry.mIndex == OccupancyJournal::NONE){
+                    mMemberAssignment.erase(member);
+                }
+                else{
+                    mMemberAssignment[member] = mSlips[entry.mIndex].id();
+                }
+                return;
+            case OccupancyJournal::Step::ASSIGNMENT_CLEARED:
+                step = OccupancyJournal::Step::ASSIGNMENT_SET;
+                break;
+        }
+    }
+    
+    switch (step){
+        case OccupancyJournal::Step::OCCUPANT_ADDED:{
+            Occupancy &occupancy = mSlipOccupants[slipId];
+            size_t index = undo ? entry.mIndex : occupancy.mMembers.size();
+            occupancy.mMembers.insert(occupancy.mMembers.begin() + index, member);
+            occupancy.mWidthUsed += width;
+            break;
+        }
+        case OccupancyJournal::Step::OCCUPANT_REMOVED:{
+            Occupancy *occupancy = mSlipOccupants.findMutable(slipId);
+            
+            if (!occupancy){
+                throw std::runtime_error("Journal removes " + member->id() + " from empty slip " + slipId);
+            }
+            
+            // Added entries are undone from the back; removals name their index
+            size_t index = undo ? occupancy->mMembers.size() - 1 : entry.mIndex;
+            
+            if (index >= occupancy->mMembers.size() || occupancy->mMembers[index] != member){
+                throw std::runtime_error("Journal does not match occupancy of slip " + slipId);
+            }
+            
+            occupancy->mMembers.erase(occupancy->mMembers.begin() + index);
+            occupancy->mWidthUsed -= width;
+            
+            if (occupancy->mMembers.empty()){
+                mSlipOccupants.erase(slipId);
+            }
+            break;
+        }
+        case OccupancyJournal::Step::ASSIGNMENT_SET:
+            mMemberAssignment[member] = slipId;
+            break;
+        case OccupancyJournal::Step::ASSIGNMENT_CLEARED:
+            mMemberAssignment.erase(member);
+            break;
+    }
+}
+
+void AssignmentEngine::rollback(size_t mark){
+    if (mark > mJournal.size()){
+        throw std::invalid_argument("Journal mark " + std::to_string(mark) + " is past the end of the journal");
+    }
+    
+    const std::vector<OccupancyJournal::Entry> &entries = mJournal.entries();
+    
+    for (size_t i = entries.size(); i-- > mark;){
+        applyJournalEntry(entries[i], true);
+    }
     
-    if (it != mMemberAssignment.end()){
-        mSlipOccupant.erase(it->second);
-        mMemberAssignment.erase(it);
+    mJournal.truncate(mark);
+}
+
+void AssignmentEngine::replay(const OccupancyJournal &journal, size_t steps){
+    const std::vector<OccupancyJournal::Entry> &entries = journal.entries();
+    steps = std::min(steps, entries.size());
+    
+    for (size_t i = 0; i < steps; ++i){
+        applyJournalEntry(entries[i], false);
+        
+        if (mJournaling){
+            mJournal.record(entries[i].mStep, entries[i].mMember, entries[i].mSlip, entries[i].mIndex);
+        }
+    }
+}
+
+void AssignmentEngine::writeJournal(std::ostream &out) const{
+    mJournal.write(out, mMembers, mSlips);
+}
+
+OccupancyJournal AssignmentEngine::readJournal(std::istream &in) const{
+    return OccupancyJournal::read(in, mMembers, mSlips);
+}
+
+std::optional<std::string> AssignmentEngine::assignedSlip(const std::string &memberId) const{
+    for (const auto &member : mMembers){
+        if (member.id() == memberId){
+            const std::string *slipId = mMemberAssignment.find(&member);
+            return slipId ? std::optional<std::string>(*slipId) : std::nullopt;
+        }
+    }
+    
+    throw std::invalid_argument("Unknown member: " + memberId);
+}
+
+std::vector<std::string> AssignmentEngine::occupantsOf(const std::string &slipId) const{
+    std::vector<std::string> members;
+    const Occupancy *occupancy = mSlipOccupants.find(slipId);
+    
+    if (occupancy){
+        for (const Member *member : occupancy->mMembers){
+            members.push_back(member->id());
+        }
     }
+    
+    return members;
 }
 
 // Check if a member has been assigned to a slip.
 // Returns true if member is currently assigned, false otherwise.
 bool AssignmentEngine::isMemberAssigned(const Member *member) const{
-    return mMemberAssignment.find(member) != mMemberAssignment.end();
+    return mMemberAssignment.find(member) != nullptr;
 }
 
 // Check if a member can evict others based on their dock status.
@@ -435,198 +2275,576 @@ bool AssignmentEngine::isMemberAssigned(const Member *member) const{
 bool AssignmentEngine::canMemberEvict(const Member *member) const{
     // UNASSIGNED members have lowest priority and cannot evict anyone
     // (they're looking for their first assignment)
-    return member->dockStatus() != Member::DockStatus::UNASSIGNED;
+    return dockStatus(member) != Member::DockStatus::UNASSIGNED;
 }
 
 // Determine if evictingMember can evict occupant based on dock status and member ID.
 bool AssignmentEngine::canEvictMember(const Member *evictingMember, const Member *occupant) const{
     // Permanent members cannot be evicted
-    if (occupant->dockStatus() == Member::DockStatus::PERMANENT){
+    if (dockStatus(occupant) == Member::DockStatus::PERMANENT){
         return false;
     }
     
     // Year-off members shouldn't be in slips, but if they are, they can be evicted
-    if (occupant->dockStatus() == Member::DockStatus::YEAR_OFF){
+    if (dockStatus(occupant) == Member::DockStatus::YEAR_OFF){
         return true;
     }
     
-    int evictorPriority = getDockStatusPriority(evictingMember->dockStatus());
-    int occupantPriority = getDockStatusPriority(occupant->dockStatus());
+    // Higher dock status priority wins; within the same dock status, lower
+    // member ID (or more seniority) wins
+    return priorityKey(evictingMember) < priorityKey(occupant);
+}
+
+// Get numeric priority for dock status (lower = higher priority).
+int AssignmentEngine::getDockStatusPriority(Member::DockStatus status) const{
+    switch (status){
+        case Member::DockStatus::PERMANENT:
+            return 0;  // Highest priority (cannot be evicted)
+        case Member::DockStatus::WAITING_LIST:
+            return 1;
+        case Member::DockStatus::TEMPORARY:
+            return 2;
+        case Member::DockStatus::UNASSIGNED:
+            return 3;  // Lowest priority
+        case Member::DockStatus::YEAR_OFF:
+            return 4;  // Should not be in slips
+    }
+    return 999;
+}
+
+// Diagnose why a member wasn't assigned.
+// Provides specific reasons to help understand assignment failures.
+Assignment::Reason AssignmentEngine::unassignedReason(const Member *member) const{
+    using Code = Assignment::Reason::Code;
+    
+    // Check if member had a current slip
+    bool hadCurrentSlip = member->currentSlip().has_value();
+    
+    // Check if any slip can fit the boat
+    bool anySlipFits = false;
+    bool anySlipLargeEnough = false;
+    int fittingSlipCount = 0;
+    
+    for (const auto &slip : mSlips){
+        if (slipClosed(&slip)){
+            continue;
+        }
+        
+        if (slipFits(&slip, member->boatDimensions())){
+            anySlipLargeEnough = true;
+            
+            if (Amenities::provides(slip.amenities(), member->requiredAmenities())){
+                anySlipFits = true;
+                fittingSlipCount++;
+            }
+        }
+    }
+    
+    if (!anySlipFits && anySlipLargeEnough){
+        Assignment::Reason reason(Code::NO_SLIP_WITH_AMENITIES);
+        reason.mAmenities = member->requiredAmenities();
+        return reason;
+    }
+    
+    if (!anySlipFits){
+        Assignment::Reason reason(Code::TOO_LARGE);
+        reason.mEvicted = hadCurrentSlip;
+        return reason;
+    }
+    
+    // Boat fits in some slips, check current slip status
+    if (hadCurrentSlip){
+        const std::string &currentSlipId = member->currentSlip().value();
+        Slip *currentSlip = findSlipById(currentSlipId);
+        
+        if (!currentSlip){
+            Assignment::Reason reason(Code::SLIP_REMOVED);
+            reason.mEvicted = true;
+            return reason;
+        }
+        
+        // Check who occupies the current slip
+        // Note: Don't check if boat fits - if they had the slip, they keep it regardless
+        // The only reason for eviction is being bumped by another member
+        const Occupancy *occupancy = mSlipOccupants.find(currentSlipId);
+        
+        if (occupancy){
+            const std::vector<const Member *> &occupants = occupancy->mMembers;
+            bool permanent = std::any_of(occupants.begin(), occupants.end(), [this](const Member *occupant){
+                return dockStatus(occupant) == Member::DockStatus::PERMANENT;
+            });
+            
+            Assignment::Reason reason(Code::SLIPS_TAKEN);
+            reason.mEvicted = true;
+            reason.mByPermanent = permanent;
+            reason.mCount = fittingSlipCount;
+            return reason;
+        }
+    }
+    
+    // Never had a slip, or lost it and no alternatives
+    Assignment::Reason reason(Code::SLIPS_TAKEN);
+    reason.mCount = fittingSlipCount;
+    return reason;
+}
+
+// Find the best available slip for a boat.
+//
+// "Best" is defined based on mode:
+// - Normal mode: smallest slip by area that can fit the boat
+// - Ignore-length mode: slip with minimum length overhang, then by smallest area
+//
+// This minimizes wasted space and helps ensure larger slips remain available
+// for larger boats. In ignore-length mode, it also minimizes boat overhang.
+//
+// Members with a preferred dock search that dock's index first and only
+// fall back to the whole marina when nothing there can be taken.
+//
+// Parameters:
+//   boatDimensions - dimensions of the boat to fit
+//   requestingMember - the member requesting the slip (for priority checking)
+//   excludeSlipId - slip to exclude from search (typically the boat's current slip)
+//
+// Returns:
+//   Pointer to best fitting slip that is either empty or can be taken via eviction
+//   Returns nullptr if no suitable slip exists
+Slip *AssignmentEngine::findBestAvailableSlip(const Dimensions &boatDimensions, const Member *requestingMember, const std::string &excludeSlipId){
+    if (requestingMember->preferredDock().has_value()){
+        auto dockIt = mDockIndexes.find(requestingMember->preferredDock().value());
+        
+        if (dockIt != mDockIndexes.end()){
+            Slip *slip = findBestSlipInIndex(dockIt->second, boatDimensions, requestingMember, excludeSlipId);
+            
+            if (slip){
+                return slip;
+            }
+        }
+    }
+    
+    return findBestSlipInIndex(mAllSlips, boatDimensions, requestingMember, excludeSlipId);
+}
+
+// True if slip a comes before slip b in normal-mode best-fit order: smaller
+// area, then wider, then earlier in the slip list.
+static bool bestFitBefore(const Slip &a, const Slip &b){
+    long long areaA = static_cast<long long>(a.maxDimensions().lengthInches()) * a.maxDimensions().widthInches();
+    long long areaB = static_cast<long long>(b.maxDimensions().lengthInches()) * b.maxDimensions().widthInches();
+    
+    if (areaA != areaB){
+        return areaA < areaB;
+    }
+    
+    if (a.maxDimensions().widthInches() != b.maxDimensions().widthInches()){
+        return a.maxDimensions().widthInches() > b.maxDimensions().widthInches();
+    }
+    
+    return &a < &b;
+}
+
+// Best-fit search within one slip index.
+Slip *AssignmentEngine::findBestSlipInIndex(const SlipIndex &index, const Dimensions &boatDimensions, const Member *requestingMember, const std::string &excludeSlipId){
+    // Skip slips that are excluded, or occupied by a member who cannot be evicted
+    auto available = [&](const Slip &slip){
+        if (slip.id() == excludeSlipId || slipClosed(&slip)){
+            return false;
+        }
+        
+        const Member *occupant = slipOccupant(slip.id());
+        return !occupant || canEvictMember(requestingMember, occupant);
+    };
+    
+    // Shared slips are ranked as if only their free width were there
+    auto sharedRoom = [&](const Slip &slip){
+        if (slip.id() == excludeSlipId || slipClosed(&slip) || !slipFits(&slip, requestingMember)){
+            return -1;
+        }
+        
+        return sharedSlipRoom(&slip, requestingMember, nullptr);
+    };
+    
+    // In normal mode each group's order is the preference order, so the
+    // first slip that fits and is available is the group's best fit, and
+    // the best of those across groups is the best fit
+    if (!mIgnoreLength){
+        long long boatArea = static_cast<long long>(boatDimensions.lengthInches()) * boatDimensions.widthInches();
+        Slip *bestSlip = nullptr;
+        long long bestArea = 0;
+        
+        for (const auto &group : index.groups()){
+            if (!group.admits(boatDimensions, requestingMember->requiredAmenities())){
+                continue;
+            }
+            
+            const std::vector<uint32_t> &order = group.mBestFitOrder;
+            
+            for (size_t i = group.firstWithArea(boatArea); i < order.size(); ++i){
+                // Later slips in this group cannot beat the best so far
+                if (bestSlip && group.mAreas[i] > bestArea){
+                    break;
+                }
+                
+                Slip &slip = mSlips[order[i]];
+                
+                if (!group.provides(slip.amenities(), requestingMember->requiredAmenities())){
+                    continue;
+                }
+                
+                if (slipFits(&slip, boatDimensions) && available(slip)){
+                    if (!bestSlip || bestFitBefore(slip, *bestSlip)){
+                        bestSlip = &slip;
+                        bestArea = group.mAreas[i];
+                    }
+                    
+                    break;
+                }
+            }
+        }
+        
+        int bestWidth = bestSlip ? bestSlip->maxDimensions().widthInches() : 0;
+        
+        for (uint32_t position : index.sharedPositions()){
+            Slip &slip = mSlips[position];
+            int room = sharedRoom(slip);
+            
+            if (room < 0){
+                continue;
+            }
+            
+            long long area = static_cast<long long>(slip.maxDimensions().lengthInches()) * room;
+            
+            if (!bestSlip || area < bestArea || (area == bestArea && (room > bestWidth || (room == bestWidth && &slip < bestSlip)))){
+                bestSlip = &slip;
+                bestArea = area;
+                bestWidth = room;
+            }
+        }
+        
+        return bestSlip;
+    }
+    
+    // In ignore-length mode, prioritize minimum overhang, then minimum area, then max width margin
+    Slip *bestSlip = nullptr;
+    int minOverhang = std::numeric_limits<int>::max();
+    int minArea = std::numeric_limits<int>::max();
+    int maxWidthMargin = -1;
+    
+    // Rank a slip offering the given width against the best so far
+    auto consider = [&](Slip &slip, int width){
+        int area = slip.maxDimensions().lengthInches() * width;
+        int widthMargin = width - boatDimensions.widthInches();
+        
+        // Positive overhang means boat is longer than slip
+        int overhang = std::max(0, slip.lengthDifference(boatDimensions));
+        
+        // Prefer slip with less overhang
+        if (overhang < minOverhang){
+            minOverhang = overhang;
+            minArea = area;
+            maxWidthMargin = widthMargin;
+            bestSlip = &slip;
+        }
+        else if (overhang == minOverhang && area < minArea){
+            // If overhang is the same, prefer smaller area
+            minArea = area;
+            maxWidthMargin = widthMargin;
+            bestSlip = &slip;
+        }
+        else if (overhang == minOverhang && area == minArea && widthMargin > maxWidthMargin){
+            // If overhang and area are the same, prefer max width margin
+            maxWidthMargin = widthMargin;
+            bestSlip = &slip;
+        }
+        else if (overhang == minOverhang && area == minArea && widthMargin == maxWidthMargin && &slip < bestSlip){
+            // Groups are scanned one after another, so keep the earliest slip on a full tie
+            bestSlip = &slip;
+        }
+    };
     
-    // Higher dock status priority wins
-    if (evictorPriority < occupantPriority){
-        return true;
+    for (const auto &group : index.groups()){
+        if (!group.admits(boatDimensions, requestingMember->requiredAmenities())){
+            continue;
+        }
+        
+        for (uint32_t position : group.mPositions){
+            Slip &slip = mSlips[position];
+            
+            if (group.provides(slip.amenities(), requestingMember->requiredAmenities()) &&
+                slipFits(&slip, boatDimensions) && available(slip)){
+                consider(slip, slip.maxDimensions().widthInches());
+            }
+        }
     }
     
-    // Same dock status: lower member ID wins
-    if (evictorPriority == occupantPriority && *evictingMember < *occupant){
-        return true;
+    for (uint32_t position : index.sharedPositions()){
+        Slip &slip = mSlips[position];
+        int room = sharedRoom(slip);
+        
+        if (room >= 0){
+            consider(slip, room);
+        }
     }
     
-    return false;
+    return bestSlip;
 }
 
-// Get numeric priority for dock status (lower = higher priority).
-int AssignmentEngine::getDockStatusPriority(Member::DockStatus status) const{
-    switch (status){
-        case Member::DockStatus::PERMANENT:
-            return 0;  // Highest priority (cannot be evicted)
-        case Member::DockStatus::WAITING_LIST:
-            return 1;
-        case Member::DockStatus::TEMPORARY:
-            return 2;
-        case Member::DockStatus::UNASSIGNED:
-            return 3;  // Lowest priority
-        case Member::DockStatus::YEAR_OFF:
-            return 4;  // Should not be in slips
+// Split the marina into groups of docks that can be assigned independently.
+//
+// A member ties together every dock holding a slip the boat fits (or, when
+// no slip provides its amenities, one the boat is large enough for), the
+// dock of its current slip and its preferred dock; slips sharing an ID are tied
+// together too, since occupancy is tracked by slip ID. Docks are joined
+// with a union-find, and each member goes to the group of its docks.
+// Members that touch no dock (year-off, or a boat too large for every
+// slip) only produce output rows and go to the first group.
+std::vector<AssignmentEngine::DockGroup> AssignmentEngine::partitionDocks() const{
+    std::map<std::string, uint32_t> dockNumbers;
+    
+    for (const auto &entry : mDockIndexes){
+        dockNumbers.emplace(entry.first, static_cast<uint32_t>(dockNumbers.size()));
     }
-    return 999;
-}
-
-// Generate a diagnostic comment explaining why a member wasn't assigned.
-// Provides specific reasons to help understand assignment failures.
-std::string AssignmentEngine::generateUnassignedComment(const Member *member) const{
-    // Check if member had a current slip
-    bool hadCurrentSlip = member->currentSlip().has_value();
     
-    // Check if any slip can fit the boat
-    bool anySlipFits = false;
-    int fittingSlipCount = 0;
+    std::vector<uint32_t> parent(dockNumbers.size());
+    std::iota(parent.begin(), parent.end(), 0);
     
-    for (const auto &slip : mSlips){
-        if (slipFits(&slip, member->boatDimensions())){
-            anySlipFits = true;
-            fittingSlipCount++;
+    auto find = [&parent](uint32_t dock){
+        while (parent[dock] != dock){
+            parent[dock] = parent[parent[dock]];
+            dock = parent[dock];
         }
-    }
+        return dock;
+    };
     
-    if (!anySlipFits){
-        if (hadCurrentSlip){
-            return "Evicted - boat too large for all available slips";
-        }
+    auto unite = [&](uint32_t a, uint32_t b){
+        parent[find(a)] = find(b);
+    };
+    
+    for (uint32_t i = 0; i < mSlips.size(); ++i){
+        uint32_t first = mSlipPositions.at(mSlips[i].id());
         
-        return "Boat too large for all available slips";
+        if (first != i){
+            unite(dockNumbers.at(mSlips[i].dock()), dockNumbers.at(mSlips[first].dock()));
+        }
     }
     
-    // Boat fits in some slips, check current slip status
-    if (hadCurrentSlip){
-        const std::string &currentSlipId = member->currentSlip().value();
-        Slip *currentSlip = findSlipById(currentSlipId);
+    const uint32_t NO_DOCK = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> memberDock(mMembers.size(), NO_DOCK);
+    
+    for (uint32_t m = 0; m < mMembers.size(); ++m){
+        const Member &member = mMembers[m];
         
-        if (!currentSlip){
-            return "Evicted - previous slip no longer exists";
+        if (dockStatus(&member) == Member::DockStatus::YEAR_OFF){
+            continue;
         }
         
-        // Check who occupies the current slip
-        // Note: Don't check if boat fits - if they had the slip, they keep it regardless
-        // The only reason for eviction is being bumped by another member
-        auto occupantIt = mSlipOccupant.find(currentSlipId);
+        auto touch = [&](uint32_t dock){
+            if (memberDock[m] == NO_DOCK){
+                memberDock[m] = dock;
+            }
+            else{
+                unite(memberDock[m], dock);
+            }
+        };
         
-        if (occupantIt != mSlipOccupant.end()){
-            const Member *occupant = occupantIt->second;
+        if (member.currentSlip().has_value()){
+            auto slipIt = mSlipPositions.find(member.currentSlip().value());
             
-            if (occupant->dockStatus() == Member::DockStatus::PERMANENT){
-                return "Evicted - previous slip taken by permanent member, all " + std::to_string(fittingSlipCount) + " suitable slips taken";
+            if (slipIt != mSlipPositions.end()){
+                touch(dockNumbers.at(mSlips[slipIt->second].dock()));
             }
-            
-            return "Evicted - outranked by higher priority member(s), all " + std::to_string(fittingSlipCount) + " suitable slips taken";
         }
-    }
-    
-    // Never had a slip, or lost it and no alternatives
-    return "All " + std::to_string(fittingSlipCount) + " suitable slips taken by higher priority members";
-}
-
-// Find the best available slip for a boat.
-//
-// "Best" is defined based on mode:
-// - Normal mode: smallest slip by area that can fit the boat
-// - Ignore-length mode: slip with minimum length overhang, then by smallest area
-//
-// This minimizes wasted space and helps ensure larger slips remain available
-// for larger boats. In ignore-length mode, it also minimizes boat overhang.
-//
-// Parameters:
-//   boatDimensions - dimensions of the boat to fit
-//   requestingMember - the member requesting the slip (for priority checking)
-//   excludeSlipId - slip to exclude from search (typically the boat's current slip)
-//
-// Returns:
-//   Pointer to best fitting slip that is either empty or can be taken via eviction
-//   Returns nullptr if no suitable slip exists
-Slip *AssignmentEngine::findBestAvailableSlip(const Dimensions &boatDimensions, const Member *requestingMember, const std::string &excludeSlipId){
-    Slip *bestSlip = nullptr;
-    int minOverhang = std::numeric_limits<int>::max();
-    int minArea = std::numeric_limits<int>::max();
-    int maxWidthMargin = -1;
-
-    for (auto &slip : mSlips){
-        // Skip the excluded slip (typically the boat's current slip)
-        if (slip.id() == excludeSlipId){
-            continue;
+        
+        if (member.preferredDock().has_value()){
+            auto dockIt = dockNumbers.find(member.preferredDock().value());
+            
+            if (dockIt != dockNumbers.end()){
+                touch(dockIt->second);
+            }
         }
-
-        // Skip slips that are too small for the boat
-        if (!slipFits(&slip, boatDimensions)){
+        
+        // Permanent members never search beyond their designated slip
+        if (dockStatus(&member) == Member::DockStatus::PERMANENT){
             continue;
         }
         
-        // Skip slips occupied by members cannot evict
-        auto occupantIt = mSlipOccupant.find(slip.id());
+        bool anyFits = false;
         
-        if (occupantIt != mSlipOccupant.end()){
-            if (!canEvictMember(requestingMember, occupantIt->second)){
-                continue;
+        for (const auto &entry : mDockIndexes){
+            if (entry.second.anyFits(member.boatDimensions(), member.requiredAmenities(), mIgnoreLength)){
+                touch(dockNumbers.at(entry.first));
+                anyFits = true;
             }
         }
-
-        // Calculate slip area (length × width)
-        int area = slip.maxDimensions().lengthInches() * slip.maxDimensions().widthInches();
         
-        // Calculate width margin (how much extra width boat has)
-        int widthMargin = slip.maxDimensions().widthInches() - boatDimensions.widthInches();
-        
-        // In ignore-length mode, prioritize minimum overhang, then minimum area, then max width margin
-        if (mIgnoreLength){
-            // Positive overhang means boat is longer than slip
-            int overhang = std::max(0, slip.lengthDifference(boatDimensions));
-            
-            // Prefer slip with less overhang
-            if (overhang < minOverhang){
-                minOverhang = overhang;
-                minArea = area;
-                maxWidthMargin = widthMargin;
-                bestSlip = &slip;
+        // With no slip providing its amenities, the boat ties the docks it
+        // is large enough for, so its group reports the amenities as the reason
+        if (!anyFits && member.requiredAmenities() != 0){
+            for (const auto &entry : mDockIndexes){
+                if (entry.second.anyFits(member.boatDimensions(), 0, mIgnoreLength)){
+                    touch(dockNumbers.at(entry.first));
+                }
             }
-            else if (overhang == minOverhang && area < minArea){
-                // If overhang is the same, prefer smaller area
-                minArea = area;
-                maxWidthMargin = widthMargin;
-                bestSlip = &slip;
+        }
+    }
+    
+    std::vector<DockGroup> groups;
+    std::vector<uint32_t> groupOfRoot(dockNumbers.size(), NO_DOCK);
+    
+    auto groupFor = [&](uint32_t dock){
+        uint32_t root = find(dock);
+        
+        if (groupOfRoot[root] == NO_DOCK){
+            groupOfRoot[root] = static_cast<uint32_t>(groups.size());
+            groups.emplace_back();
+        }
+        
+        return groupOfRoot[root];
+    };
+    
+    for (uint32_t i = 0; i < mSlips.size(); ++i){
+        groups[groupFor(dockNumbers.at(mSlips[i].dock()))].mSlips.push_back(i);
+    }
+    
+    if (groups.empty()){
+        groups.emplace_back();
+    }
+    
+    for (uint32_t m = 0; m < mMembers.size(); ++m){
+        uint32_t group = memberDock[m] == NO_DOCK ? 0 : groupFor(memberDock[m]);
+        groups[group].mMembers.push_back(m);
+    }
+    
+    return groups;
+}
+
+// Assign independent dock groups on worker threads.
+//
+// Each group is assigned by its own engine over just its members and slips.
+// The group results are then merged back into the serial output order:
+// permanent, year-off, assigned and unassigned members, each in roster
+// order. Returns false, leaving the work to the serial path, when threading
+// is off, verbose output, decision recording, journaling, the improvement
+// pass or the revenue pass is on, the engine has what-if changes, member IDs repeat, or the
+// marina does not split into at least two groups.
+bool AssignmentEngine::assignDockGroupsInParallel(std::vector<Assignment> &assignments){
+    if (mThreads < 2 || mVerbose || mRecordDecisions || mJournaling || mStableMatching || mImproveMs > 0 || mMaximizeRevenue || mDockIndexes.size() < 2 ||
+        !mStatusOverrides.empty() || !mClosedSlips.empty()){
+        return false;
+    }
+    
+    std::unordered_map<std::string, uint32_t> memberPositions;
+    memberPositions.reserve(mMembers.size());
+    
+    for (uint32_t m = 0; m < mMembers.size(); ++m){
+        if (!memberPositions.emplace(mMembers[m].id(), m).second){
+            return false;
+        }
+    }
+    
+    std::vector<DockGroup> groups = partitionDocks();
+    
+    if (groups.size() < 2){
+        return false;
+    }
+    
+    std::vector<std::vector<Assignment>> results(groups.size());
+    std::vector<std::exception_ptr> errors(groups.size());
+    std::atomic<size_t> nextGroup(0);
+    
+    auto worker = [&](){
+        for (size_t g = nextGroup++; g < groups.size(); g = nextGroup++){
+            try{
+                std::vector<Member> members;
+                std::vector<Slip> slips;
+                members.reserve(groups[g].mMembers.size());
+                slips.reserve(groups[g].mSlips.size());
+                
+                for (uint32_t m : groups[g].mMembers){
+                    members.push_back(mMembers[m]);
+                }
+                
+                for (uint32_t i : groups[g].mSlips){
+                    slips.push_back(mSlips[i]);
+                }
+                
+                AssignmentEngine engine(std::move(members), std::move(slips));
+                engine.setIgnoreLength(mIgnoreLength);
+                engine.setPricePerSqFt(mPricePerSqFt);
+                engine.setDiagnostics(mDiagnostics);
+                engine.setNaturalOrder(mNaturalOrder);
+                
+                if (mSeniorityArchive){
+                    engine.setSeniority(*mSeniorityArchive, mSeniorityWeights);
+                }
+                
+                results[g] = engine.assign();
             }
-            else if (overhang == minOverhang && area == minArea && widthMargin > maxWidthMargin){
-                // If overhang and area are the same, prefer max width margin
-                maxWidthMargin = widthMargin;
-                bestSlip = &slip;
+            catch (...){
+                errors[g] = std::current_exception();
             }
         }
-        else{
-            // In normal mode, prefer smallest slip by area, then max width margin as tie-breaker
-            // Prefer smaller slip by area
-            if (area < minArea){
-                minArea = area;
-                maxWidthMargin = widthMargin;
-                bestSlip = &slip;
+    };
+    
+    unsigned threadCount = std::min<unsigned>(mThreads, static_cast<unsigned>(groups.size()));
+    std::vector<std::thread> threads;
+    
+    for (unsigned t = 1; t < threadCount; ++t){
+        threads.emplace_back(worker);
+    }
+    
+    worker();
+    
+    for (auto &thread : threads){
+        thread.join();
+    }
+    
+    for (const auto &error : errors){
+        if (error){
+            std::rethrow_exception(error);
+        }
+    }
+    
+    // Order rows by output section, then by roster position
+    struct Row {
+        int mSection;
+        uint32_t mMember;
+        Assignment *mAssignment;
+    };
+    
+    std::vector<Row> rows;
+    
+    for (auto &result : results){
+        for (auto &assignment : result){
+            int section = 3;
+            
+            if (assignment.dockStatus() == Member::DockStatus::PERMANENT){
+                section = 0;
             }
-            else if (area == minArea && widthMargin > maxWidthMargin){
-                // If area is the same, prefer max width margin
-                maxWidthMargin = widthMargin;
-                bestSlip = &slip;
+            else if (assignment.dockStatus() == Member::DockStatus::YEAR_OFF){
+                section = 1;
             }
+            else if (assignment.assigned()){
+                section = 2;
+            }
+            
+            rows.push_back({ section, memberPositions.at(assignment.memberId()), &assignment });
         }
     }
-
-    return bestSlip;
+    
+    std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b){
+        return a.mSection != b.mSection ? a.mSection < b.mSection : a.mMember < b.mMember;
+    });
+    
+    assignments.reserve(assignments.size() + rows.size());
+    
+    for (const auto &row : rows){
+        if (row.mAssignment->assigned()){
+            assignMemberToSlip(&mMembers[row.mMember], row.mAssignment->slipId());
+        }
+        
+        assignments.push_back(std::move(*row.mAssignment));
+    }
+    
+    return true;
 }
 
 // Check if a boat fits in a slip, considering the ignore-length flag.
@@ -637,47 +2855,197 @@ bool AssignmentEngine::slipFits(const Slip *slip, const Dimensions &boatDimensio
     return slip->fits(boatDimensions);
 }
 
-// Generate length difference comment when ignoring length.
-std::string AssignmentEngine::generateLengthComment(const Slip *slip, const Dimensions &boatDimensions) const{
+// Check if a member's boat fits in a slip that provides every amenity the member requires.
+bool AssignmentEngine::slipFits(const Slip *slip, const Member *member) const{
+    return Amenities::provides(slip->amenities(), member->requiredAmenities()) &&
+           slipFits(slip, member->boatDimensions());
+}
+
+// Length difference note when ignoring length.
+std::optional<Assignment::Reason> AssignmentEngine::lengthReason(const Slip *slip, const Dimensions &boatDimensions) const{
     if (!mIgnoreLength){
-        return "";
+        return std::nullopt;
     }
     
     int diffInches = slip->lengthDifference(boatDimensions);
     
     if (diffInches == 0){
-        return "";
+        return std::nullopt;
+    }
+    
+    Assignment::Reason reason(diffInches > 0 ? Assignment::Reason::Code::LONGER_THAN_SLIP : Assignment::Reason::Code::SHORTER_THAN_SLIP);
+    reason.mCount = std::abs(diffInches);
+    return reason;
+}
+
+// Tight fit note if boat is less than 6 inches narrower than slip.
+std::optional<Assignment::Reason> AssignmentEngine::widthMarginReason(const Slip *slip, const Dimensions &boatDimensions) const{
+    int widthMargin = slip->maxDimensions().widthInches() - boatDimensions.widthInches();
+    
+    if (widthMargin >= 0 && widthMargin < 6){
+        return Assignment::Reason(Assignment::Reason::Code::TIGHT_FIT);
+    }
+    
+    return std::nullopt;
+}
+
+// Mark the start of an assignment phase for the decision log.
+void AssignmentEngine::beginPhase(int phaseNumber, const std::string &name){
+    mCurrentPhase = phaseNumber;
+    mCurrentPass = 0;
+    
+    if (mRecordDecisions){
+        if (mPhaseNames.size() <= static_cast<size_t>(phaseNumber)){
+            mPhaseNames.resize(phaseNumber + 1);
+        }
+        
+        mPhaseNames[phaseNumber] = name;
+    }
+}
+
+// Append a decision to the log, translating pointers to vector indices.
+void AssignmentEngine::logDecision(DecisionLog::Event event, const Member *member, const Slip *slip, const Member *other){
+    uint32_t slipIndex = slip ? static_cast<uint32_t>(slip - mSlips.data()) : DecisionLog::NONE;
+    uint32_t otherIndex = other ? static_cast<uint32_t>(other - mMembers.data()) : DecisionLog::NONE;
+    
+    mDecisionLog.record(event, static_cast<uint32_t>(member - mMembers.data()), slipIndex, otherIndex,
+                        mCurrentPhase, mCurrentPass);
+}
+
+// Format dimensions as feet and inches, e.g. 20' 6" x 10' 0".
+static std::string formatDimensions(const Dimensions &dimensions){
+    std::ostringstream out;
+    out << dimensions.lengthInches() / 12 << "' " << dimensions.lengthInches() % 12 << "\" x "
+        << dimensions.widthInches() / 12 << "' " << dimensions.widthInches() % 12 << "\"";
+    return out.str();
+}
+
+// Reconstruct why a member got its result.
+//
+// The decision history comes from the log recorded during assign(). The
+// candidate list is computed here, on demand, so the bulk run never pays
+// for it: every slip the boat fits, smallest first, with its final occupant
+// and whether this member is allowed to evict that occupant.
+std::string AssignmentEngine::explain(const std::string &memberId) const{
+    const Member *member = nullptr;
+    
+    for (const auto &candidate : mMembers){
+        if (candidate.id() == memberId){
+            member = &candidate;
+            break;
+        }
     }
     
-    int feet = std::abs(diffInches) / 12;
-    int inches = std::abs(diffInches) % 12;
-    std::string lengthStr;
+    if (!member){
+        throw std::invalid_argument("Unknown member: " + memberId);
+    }
+    
+    std::ostringstream out;
+    out << "Member " << member->id() << " (" << Member::dockStatusToString(dockStatus(member))
+        << ", boat " << formatDimensions(member->boatDimensions());
     
-    if (feet > 0 && inches > 0){
-        lengthStr = std::to_string(feet) + "' " + std::to_string(inches) + "\"";
+    if (member->currentSlip().has_value()){
+        out << ", current slip " << member->currentSlip().value();
     }
-    else if (feet > 0){
-        lengthStr = std::to_string(feet) + "'";
+    
+    out << ")\n";
+    
+    const std::string *assignedSlipId = mMemberAssignment.find(member);
+    
+    if (assignedSlipId){
+        out << "Result: assigned to slip " << *assignedSlipId << "\n";
     }
     else{
-        lengthStr = std::to_string(inches) + "\"";
+        out << "Result: not assigned\n";
     }
     
-    if (diffInches > 0){
-        return "NOTE: boat is " + lengthStr + " longer than slip";
+    if (!mRecordDecisions){
+        out << "No decision log: enable decision recording before assign()\n";
+    }
+    else{
+        auto entries = mDecisionLog.entriesForMember(static_cast<uint32_t>(member - mMembers.data()));
+        auto describePhase = [this](const DecisionLog::Entry &entry){
+            std::string text = "phase " + std::to_string(entry.mPhase);
+            
+            if (entry.mPhase < mPhaseNames.size()){
+                text += " (" + mPhaseNames[entry.mPhase] + ")";
+            }
+            
+            if (entry.mPass > 0){
+                text += ", pass " + std::to_string(entry.mPass);
+            }
+            
+            return text;
+        };
+        
+        if (!entries.empty()){
+            out << "Decided in " << describePhase(entries.back()) << "\n";
+        }
+        
+        out << "Decisions:\n";
+        
+        for (const auto &entry : entries){
+            out << "  " << describePhase(entry) << ": " << DecisionLog::eventToString(entry.mEvent);
+            
+            if (entry.mSlip != DecisionLog::NONE){
+                out << " - slip " << mSlips[entry.mSlip].id();
+            }
+            
+            if (entry.mOther != DecisionLog::NONE){
+                const Member &other = mMembers[entry.mOther];
+                out << (entry.mSlip != DecisionLog::NONE ? ", " : " - ") << "member " << other.id()
+                    << " (" << Member::dockStatusToString(dockStatus(&other)) << ")";
+            }
+            
+            out << "\n";
+        }
     }
-    return "NOTE: boat is " + lengthStr + " shorter than slip";
-}
-
-// Generate width margin note if boat is less than 6 inches narrower than slip.
-std::string AssignmentEngine::generateWidthMarginNote(const Slip *slip, const Dimensions &boatDimensions) const{
-    int widthMargin = slip->maxDimensions().widthInches() - boatDimensions.widthInches();
     
-    if (widthMargin >= 0 && widthMargin < 6){
-        return "TIGHT FIT";
+    std::vector<const Slip *> candidates;
+    
+    for (const auto &slip : mSlips){
+        if (!slipClosed(&slip) && slipFits(&slip, member)){
+            candidates.push_back(&slip);
+        }
+    }
+    
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Slip *a, const Slip *b){
+        int areaA = a->maxDimensions().lengthInches() * a->maxDimensions().widthInches();
+        int areaB = b->maxDimensions().lengthInches() * b->maxDimensions().widthInches();
+        return areaA < areaB;
+    });
+    
+    out << "Slips the boat fits (" << candidates.size() << "):\n";
+    
+    for (const Slip *slip : candidates){
+        out << "  " << slip->id() << " " << formatDimensions(slip->maxDimensions()) << " - ";
+        const Occupancy *occupancy = mSlipOccupants.find(slip->id());
+        
+        if (!occupancy){
+            out << "free";
+        }
+        else{
+            const char *separator = "";
+            
+            for (const Member *occupant : occupancy->mMembers){
+                out << separator;
+                separator = "; ";
+                
+                if (occupant == member){
+                    out << "assigned to this member";
+                    continue;
+                }
+                
+                bool evictable = canMemberEvict(member) && canEvictMember(member, occupant);
+                out << "occupied by " << occupant->id() << " (" << Member::dockStatusToString(dockStatus(occupant))
+                    << "), " << (evictable ? "can evict" : "cannot evict");
+            }
+        }
+        
+        out << "\n";
     }
     
-    return "";
+    return out.str();
 }
 
 // Print summary statistics for verbose mode.
@@ -715,7 +3083,7 @@ void AssignmentEngine::printStatistics(const std::vector<Assignment> &assignment
     std::vector<const Slip *> emptySlips;
     
     for (const auto &slip : mSlips){
-        if (mSlipOccupant.find(slip.id()) == mSlipOccupant.end()){
+        if (!slipClosed(&slip) && !mSlipOccupants.find(slip.id())){
             emptySlips.push_back(&slip);
         }
     }
@@ -733,9 +3101,43 @@ void AssignmentEngine::printStatistics(const std::vector<Assignment> &assignment
     std::cout << "New assignments:       " << newCount << "\n";
     std::cout << "Total boats placed:    " << totalPlaced << "\n";
     std::cout << "Unassigned boats:      " << unassignedCount << "\n";
+    
+    if (mImproveMs > 0){
+        std::cout << "\n";
+        std::cout << "Placed by improvement: " << mImprovement.mBoatsPlaced << "\n";
+        std::cout << "Area recovered:        " << squareFeet(mImprovement.mAreaRecoveredSquareInches) << " sq ft\n";
+        std::cout << "Improvement chains:    " << mImprovement.mChains << " in " << mImprovement.mRounds << " round(s)";
+        
+        if (mImprovement.mTimedOut){
+            std::cout << ", time budget reached";
+        }
+        
+        std::cout << "\n";
+    }
+    
+    if (mMaximizeRevenue){
+        std::cout << "\n";
+        std::cout << "Moved for revenue:     " << mRevenue.mMembersMoved << "\n";
+        std::cout << "Placed for revenue:    " << mRevenue.mBoatsPlaced << "\n";
+        std::cout << "Billed area:           " << squareFeet(mRevenue.mBilledSquareInches) << " sq ft (greedy "
+                  << squareFeet(mRevenue.mGreedyBilledSquareInches) << ", "
+                  << signedSquareFeet(mRevenue.mBilledSquareInches - mRevenue.mGreedyBilledSquareInches) << ")\n";
+        
+        if (mPricePerSqFt > 0.0){
+            double total = 0.0;
+            
+            for (const auto &assignment : assignments){
+                total += assignment.price();
+            }
+            
+            double delta = mRevenue.mRevenue - mRevenue.mGreedyRevenue;
+            std::cout << "Revenue:               " << dollars(total) << " (greedy " << dollars(total - delta) << ", "
+                      << (delta < 0 ? "-" : "+") << dollars(std::abs(delta)) << ")\n";
+        }
+    }
     std::cout << "\n";
-    std::cout << "Total slips:           " << mSlips.size() << "\n";
-    std::cout << "Occupied slips:        " << mSlipOccupant.size() << "\n";
+    std::cout << "Total slips:           " << mSlips.size() - mClosedSlips.size() << "\n";
+    std::cout << "Occupied slips:        " << mSlipOccupants.size() << "\n";
     std::cout << "Empty slips:           " << emptySlips.size() << "\n";
     
     if (!emptySlips.empty()){
@@ -4,21 +4,183 @@
 #include "member.hpp"
 #include "slip.hpp"
 #include "assignment.hpp"
+#include "decision_log.hpp"
+#include "slip_index.hpp"
+#include "layered_map.hpp"
+#include "occupancy_journal.hpp"
+#include "seniority_archive.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <map>
 
+// What AssignmentEngine's improvement pass changed in one assign() run
+struct ImprovementStats {
+    // Unassigned boats the pass found slips for
+    size_t mBoatsPlaced = 0;
+    // Slip area given back by moving boats into smaller slips
+    long long mAreaRecoveredSquareInches = 0;
+    size_t mChains = 0;
+    size_t mRounds = 0;
+    // The time budget ran out before the search did
+    bool mTimedOut = false;
+};
+
+// What AssignmentEngine's revenue pass changed in one assign() run. Areas
+// and revenue cover only the boats the pass could move or place; the rest
+// are billed the same either way.
+struct RevenueStats {
+    // Billed area and price of those boats as the assignment phases left them
+    long long mGreedyBilledSquareInches = 0;
+    double mGreedyRevenue = 0.0;
+    // And after the pass
+    long long mBilledSquareInches = 0;
+    double mRevenue = 0.0;
+    size_t mMembersMoved = 0;
+    size_t mBoatsPlaced = 0;
+};
+
 class AssignmentEngine {
-    std::vector<Member> mMembers;
-    std::vector<Slip> mSlips;
-    std::map<std::string, const Member *> mSlipOccupant;
-    std::map<const Member *, std::string> mMemberAssignment;
+    // Slips with the lookups built over them
+    struct SlipInputs {
+        std::vector<Slip> mSlips;
+        std::unordered_map<std::string, uint32_t> mSlipPositions;
+        SlipIndex mAllSlips;
+        std::map<std::string, SlipIndex> mDockIndexes;
+        
+        explicit SlipInputs(std::vector<Slip> slips);
+    };
+    
+    // Roster and slips. Never modified once built, so an engine and all of
+    // its forks share one copy, and engines for other rosters over the same
+    // slips share the slip half.
+    struct SharedInputs {
+        std::vector<Member> mMembers;
+        std::shared_ptr<SlipInputs> mSlipInputs;
+        // Ranked slip preferences resolved once to slip positions, in
+        // compressed rows: member m ranks mPreferenceTargets[
+        // mPreferenceOffsets[m] .. mPreferenceOffsets[m + 1]). Unknown slip
+        // IDs are dropped; duplicate IDs resolve to the first slip.
+        std::vector<uint32_t> mPreferenceOffsets;
+        std::vector<uint32_t> mPreferenceTargets;
+        
+        SharedInputs(std::vector<Member> members, std::shared_ptr<SlipInputs> slipInputs);
+    };
+    
+    std::shared_ptr<SharedInputs> mInputs;
+    // Aliases into mInputs
+    std::vector<Member> &mMembers;
+    std::vector<Slip> &mSlips;
+    std::unordered_map<std::string, uint32_t> &mSlipPositions;
+    SlipIndex &mAllSlips;
+    std::map<std::string, SlipIndex> &mDockIndexes;
+    
+    // Members holding a slip and the combined width of their boats; only
+    // shared slips hold more than one
+    struct Occupancy {
+        std::vector<const Member *> mMembers;
+        int mWidthUsed = 0;
+    };
+    
+    // Layered so that forks share the occupancy left by prepare()
+    LayeredMap<std::string, Occupancy> mSlipOccupants;
+    LayeredMap<const Member *, std::string> mMemberAssignment;
     bool mVerbose;
     bool mIgnoreLength;
     double mPricePerSqFt;
+    bool mDiagnostics;
+    bool mRecordDecisions;
+    DecisionLog mDecisionLog;
+    std::vector<std::string> mPhaseNames;
+    int mCurrentPhase;
+    int mCurrentPass;
+    unsigned mThreads;
+    bool mStableMatching;
+    // What-if changes for this engine: dock status overrides and slips
+    // taken out of use, by slip position
+    std::unordered_map<const Member *, Member::DockStatus> mStatusOverrides;
+    std::unordered_set<uint32_t> mClosedSlips;
+    // Output rows of the permanent and year-off phases, set by prepare();
+    // stale once a change reaches members or slips those phases settled
+    std::shared_ptr<const std::vector<Assignment>> mFixedRows;
+    bool mFixedRowsStale;
+    bool mJournaling;
+    OccupancyJournal mJournal;
+    unsigned mImproveMs;
+    ImprovementStats mImprovement;
+    bool mMaximizeRevenue;
+    RevenueStats mRevenue;
+    // Seniority by member position, when ordering by seniority
+    const SeniorityArchive *mSeniorityArchive;
+    SeniorityWeights mSeniorityWeights;
+    std::vector<double> mSeniority;
+    bool mNaturalOrder;
+    
+    // Members in priority order within a dock status, and each member's
+    // rank in that order by position; members that tie share a rank. Made
+    // whenever the order changes, and shared by forks.
+    struct Ranking {
+        std::vector<uint32_t> mOrder;
+        std::vector<uint32_t> mRanks;
+    };
+    
+    std::shared_ptr<const Ranking> mRanking;
+    // Member positions by priority key, and where each dock status tier
+    // starts among them; set by assign() and prepare()
+    std::vector<uint32_t> mPriorityOrder;
+    std::vector<uint32_t> mTierStarts;
+    
+    // Members and slips of one group of docks that share no members with
+    // any other group
+    struct DockGroup {
+        std::vector<uint32_t> mMembers;
+        std::vector<uint32_t> mSlips;
+    };
+    
+    explicit AssignmentEngine(std::shared_ptr<SharedInputs> inputs);
+    AssignmentEngine withInputs(std::shared_ptr<SharedInputs> inputs) const;
+    
+    std::vector<DockGroup> partitionDocks() const;
+    bool assignDockGroupsInParallel(std::vector<Assignment> &assignments);
     
     void assignPermanentMembers(std::vector<Assignment> &assignments);
     void processYearOffMembers(std::vector<Assignment> &assignments);
     void assignRemainingMembers(std::vector<Assignment> &assignments);
+    void assignByStableMatching(std::vector<Assignment> &assignments);
+    void improveAssignments();
+    void maximizeRevenue();
+    
+    // Occupancy of the slips the post-assignment passes may change, by slip
+    // and member position (NONE for a free slip or a member holding no slip
+    // in play)
+    struct Rearrangement {
+        static constexpr uint32_t NONE = 0xffffffffu;
+        
+        std::vector<bool> mInPlay;
+        std::vector<uint32_t> mOccupant;
+        std::vector<uint32_t> mSlipOf;
+        std::vector<bool> mMovable;
+        std::vector<uint32_t> mContenders;
+    };
+    
+    Rearrangement rearrangement() const;
+    bool mayLeaveSlip(const Member *member, const Slip *slip) const;
+    // Whether any of the member's ranked slips exists
+    bool hasPreferences(const Member *member) const{
+        size_t m = static_cast<size_t>(member - mMembers.data());
+        return mInputs->mPreferenceOffsets[m + 1] != mInputs->mPreferenceOffsets[m];
+    }
+    bool mayRelocate(const Member *member, const Slip *from, const Slip *to) const;
+    
+    template <typename Visit>
+    void forEachFittingSlip(const Member *member, Visit visit) const;
+    
+    void addRemainingAssignments(std::vector<Assignment> &assignments);
     
     bool canMemberEvict(const Member *member) const;
     bool canEvictMember(const Member *evictingMember, const Member *occupant) const;
@@ -26,15 +188,55 @@ class AssignmentEngine {
     
     Slip *findSlipById(const std::string &slipId) const;
     Slip *findBestAvailableSlip(const Dimensions &boatDimensions, const Member *requestingMember, const std::string &excludeSlipId = "");
+    Slip *findBestSlipInIndex(const SlipIndex &index, const Dimensions &boatDimensions, const Member *requestingMember, const std::string &excludeSlipId);
     Member *findMemberById(const std::string &memberId);
+    
+    Member::DockStatus dockStatus(const Member *member) const{
+        if (mStatusOverrides.empty()){
+            return member->dockStatus();
+        }
+        
+        auto it = mStatusOverrides.find(member);
+        return it == mStatusOverrides.end() ? member->dockStatus() : it->second;
+    }
+    
+    // A member's place in line: dock status tier in the high word and rank
+    // within the tier in the low word, so lower goes first
+    uint64_t priorityKey(const Member *member) const{
+        return static_cast<uint64_t>(getDockStatusPriority(dockStatus(member))) << 32 |
+               mRanking->mRanks[member - mMembers.data()];
+    }
+    
+    void rankMembers();
+    void orderByPriority();
+    
+    bool slipClosed(const Slip *slip) const{
+        return !mClosedSlips.empty() && mClosedSlips.count(static_cast<uint32_t>(slip - mSlips.data())) != 0;
+    }
+    
+    const Member *slipOccupant(const std::string &slipId) const;
+    int sharedSlipRoom(const Slip *slip, const Member *member, std::vector<const Member *> *evictions) const;
+    bool claimSharedSlip(const Member *member, const Slip *slip, bool canEvict, DecisionLog::Event blockedEvent, bool &changesMade);
+    void addCoTenantNotes(std::vector<Assignment> &assignments) const;
     void assignMemberToSlip(const Member *member, const std::string &slipId);
     void unassignMember(const Member *member);
+    void applyJournalEntry(const OccupancyJournal::Entry &entry, bool undo);
     bool isMemberAssigned(const Member *member) const;
-    std::string generateUnassignedComment(const Member *member) const;
+    Assignment::Reason unassignedReason(const Member *member) const;
     bool slipFits(const Slip *slip, const Dimensions &boatDimensions) const;
-    std::string generateLengthComment(const Slip *slip, const Dimensions &boatDimensions) const;
-    std::string generateWidthMarginNote(const Slip *slip, const Dimensions &boatDimensions) const;
+    bool slipFits(const Slip *slip, const Member *member) const;
+    std::optional<Assignment::Reason> lengthReason(const Slip *slip, const Dimensions &boatDimensions) const;
+    std::optional<Assignment::Reason> widthMarginReason(const Slip *slip, const Dimensions &boatDimensions) const;
     void printStatistics(const std::vector<Assignment> &assignments) const;
+    
+    void beginPhase(int phaseNumber, const std::string &name);
+    void logDecision(DecisionLog::Event event, const Member *member, const Slip *slip, const Member *other);
+    
+    void recordDecision(DecisionLog::Event event, const Member *member, const Slip *slip = nullptr, const Member *other = nullptr){
+        if (mRecordDecisions){
+            logDecision(event, member, slip, other);
+        }
+    }
 
 public:
     AssignmentEngine(std::vector<Member> members, std::vector<Slip> slips);
@@ -42,7 +244,141 @@ public:
     void setVerbose(bool verbose){ mVerbose = verbose; }
     void setIgnoreLength(bool ignoreLength){ mIgnoreLength = ignoreLength; }
     void setPricePerSqFt(double pricePerSqFt){ mPricePerSqFt = pricePerSqFt; }
+    
+    // Unassigned diagnostics scan every slip per unassigned member; disable
+    // them for bulk runs and use explain() for the members you care about
+    void setDiagnostics(bool diagnostics){ mDiagnostics = diagnostics; }
+    
+    // Record a compact decision log during assign() so explain() can be used
+    void setRecordDecisions(bool record){ mRecordDecisions = record; }
+    
+    // Worker threads for assigning independent dock groups concurrently.
+    // Groups of docks that share no members (no boat fits, holds or prefers
+    // slips in both) are assigned separately; results are identical to a
+    // serial run. Ignored in verbose mode and while recording decisions.
+    // The improvement pass searches on the same number of threads.
+    void setThreads(unsigned threads){ mThreads = threads; }
+    
+    // Assign non-permanent members by deferred acceptance over their ranked
+    // slip preferences instead of the iterative eviction passes. Slips prefer
+    // members by dock status tier, then member ID; members without a ranked
+    // list, or who exhaust it, continue with their current slip and then the
+    // best-fit order.
+    void setStableMatching(bool stableMatching){ mStableMatching = stableMatching; }
+    
+    // After the assignment phases, spend up to this many milliseconds
+    // moving boats along chains of slips to place unassigned boats and to
+    // free slip area (0, the default, skips the pass). Nobody loses a slip,
+    // and permanent members, members who kept their current slip, boats in
+    // shared slips and, in stable matching mode, members with ranked
+    // preferences are never moved. A search cut short by the budget can
+    // give different results from run to run.
+    void setImproveMs(unsigned milliseconds){ mImproveMs = milliseconds; }
+    
+    const ImprovementStats &improvementStats() const{ return mImprovement; }
+    
+    // After the assignment phases and any improvement pass, reassign the
+    // boats that may move to the slips that bill the most in total. Billing
+    // is the larger of boat and slip area, as in Assignment. The same
+    // protections apply as for the improvement pass, and unassigned boats
+    // are placed in priority order: a boat is left out only if placing it
+    // would cost a slip to someone placed or ranked ahead of it. Among
+    // equally billed results, the one moving the fewest boats is kept.
+    void setMaximizeRevenue(bool maximizeRevenue){ mMaximizeRevenue = maximizeRevenue; }
+    
+    const RevenueStats &revenueStats() const{ return mRevenue; }
+    
     std::vector<Assignment> assign();
+    
+    // Run the permanent and year-off phases only, so that the engine can be
+    // forked; each fork then finishes with assign(). Calling assign() on the
+    // engine itself finishes it the same way.
+    void prepare();
+    
+    // A copy of a prepared engine, made in constant time: the roster, slips,
+    // indexes and the occupancy left by prepare() are shared, and the fork
+    // pays only for the slips its own assignment touches. Settings and
+    // what-if changes are copied. Throws std::logic_error unless prepare()
+    // was called and the engine has not been assigned since.
+    AssignmentEngine fork() const;
+    
+    // An engine for another roster over the same slips, such as next
+    // season's: the slips and their indexes are shared rather than rebuilt.
+    // Settings and closed slips are copied; dock status overrides, which
+    // belong to members, are not.
+    AssignmentEngine withRoster(std::vector<Member> members) const;
+    
+    // An engine for other members and slips with this engine's settings
+    AssignmentEngine withInputs(std::vector<Member> members, std::vector<Slip> slips) const;
+    
+    // Order members within each dock status by seniority from an archive,
+    // most senior first, instead of by member ID alone; equal seniority
+    // falls back to member ID. Each member's seniority is looked up once,
+    // here. The archive must outlive the engine, its forks and engines made
+    // with withRoster(), which look up their own members.
+    void setSeniority(const SeniorityArchive &archive, const SeniorityWeights &weights);
+    
+    // Compare the digits in member IDs by value, so that M2 goes before
+    // M10, instead of character by character. IDs that differ only in
+    // leading zeros fall back to character order.
+    void setNaturalOrder(bool naturalOrder);
+    
+    const std::vector<Member> &members() const{ return mMembers; }
+    const std::vector<Slip> &slips() const{ return mSlips; }
+    
+    // What-if changes, usually made on forks. A closed slip is treated as if
+    // it were not in the slip list, and an overridden member as if the
+    // roster gave them that dock status; results match a fresh engine built
+    // from the changed inputs. Changes that reach the permanent or year-off
+    // phases (a slip a permanent member holds, or a status to or from
+    // permanent or year-off) make assign() rerun those phases for this
+    // engine alone. Unknown IDs and docks throw std::invalid_argument.
+    void closeSlip(const std::string &slipId);
+    void closeDock(const std::string &dock);
+    void setDockStatus(const std::string &memberId, Member::DockStatus status);
+    
+    // Assign several engines, typically forks of one prepared engine, on up
+    // to the given number of worker threads. Results are in engine order.
+    static std::vector<std::vector<Assignment>> assignAll(std::vector<AssignmentEngine> &engines, unsigned threads);
+    
+    // Journal every occupancy change so that it can be rolled back or
+    // replayed. assign() and prepare() start a new journal; a fork's journal
+    // starts from the prepared state. Independent dock groups are not
+    // assigned on threads while journaling.
+    void setJournal(bool journal){ mJournaling = journal; }
+    
+    const OccupancyJournal &journal() const{ return mJournal; }
+    
+    // Position in the journal to roll back to
+    size_t mark() const{ return mJournal.size(); }
+    
+    // Undo the occupancy changes journaled since a mark, newest first.
+    // Throws std::invalid_argument for a mark past the end of the journal.
+    void rollback(size_t mark);
+    
+    // Redo the first steps of a journal on top of the current occupancy -
+    // from a fresh engine over the same inputs, or a fork prepared the same
+    // way, this reproduces the journaled run's occupancy after those steps.
+    // Replayed steps are journaled here too when journaling is on.
+    void replay(const OccupancyJournal &journal, size_t steps);
+    
+    // Text form of the journal, and reading one back against this engine's
+    // inputs (throws std::runtime_error if it does not match them)
+    void writeJournal(std::ostream &out) const;
+    OccupancyJournal readJournal(std::istream &in) const;
+    
+    // Current occupancy: the slip a member holds, and the members holding a slip
+    std::optional<std::string> assignedSlip(const std::string &memberId) const;
+    std::vector<std::string> occupantsOf(const std::string &slipId) const;
+    
+    const DecisionLog &decisionLog() const{ return mDecisionLog; }
+    
+    // Describe why a member got its result: the decisions recorded for it, the
+    // phase and pass it was decided in, and every slip its boat fits with the
+    // occupant and whether the member could evict them. Call after assign()
+    // with decision recording enabled. Throws std::invalid_argument for an
+    // unknown member ID.
+    std::string explain(const std::string &memberId) const;
 };
 
 #endif
@@ -0,0 +1,324 @@
+#include "booking_calendar.hpp"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+BookingRequest::BookingRequest(const std::string &requestId, const Dimensions &boatDimensions, const DateRange &dates,
+                               Amenities::Mask requiredAmenities)
+    : mId(requestId), mBoatDimensions(boatDimensions), mDates(dates), mRequiredAmenities(requiredAmenities){
+}
+
+Booking::Booking(const std::string &holder, const std::string &slipId, const DateRange &dates)
+    : mHolder(holder), mSlipId(slipId), mDates(dates){
+}
+
+BookingCalendar::BookingCalendar(std::vector<Slip> slips)
+    : mSlips(std::move(slips)), mHolds(new std::atomic<const HoldList *>[mSlips.size()]), mIgnoreLength(false), mEpoch(0){
+    std::vector<uint32_t> positions;
+    
+    for (uint32_t i = 0; i < mSlips.size(); ++i){
+        mCanonical.push_back(mSlipPositions.emplace(mSlips[i].id(), i).first->second);
+        mHolds[i].store(nullptr, std::memory_order_relaxed);
+        positions.push_back(i);
+    }
+    
+    mIndex = SlipIndex(mSlips, std::move(positions));
+}
+
+BookingCalendar::~BookingCalendar(){
+    for (size_t i = 0; i < mSlips.size(); ++i){
+        delete mHolds[i].load(std::memory_order_relaxed);
+    }
+    
+    for (const auto &bag : mRetired){
+        for (const HoldList *list : bag){
+            delete list;
+        }
+    }
+}
+
+BookingCalendar::ReadGuard::ReadGuard(const BookingCalendar &calendar)
+    : mCalendar(calendar){
+    // Registering in an epoch that has just ended would not hold back
+    // its lists, so check the epoch again after registering
+    while (true){
+        mEpoch = mCalendar.mEpoch.load();
+        mCalendar.mReaders[mEpoch & 1].mCount.fetch_add(1);
+        
+        if (mCalendar.mEpoch.load() == mEpoch){
+            break;
+        }
+        
+        mCalendar.mReaders[mEpoch & 1].mCount.fetch_sub(1);
+    }
+}
+
+BookingCalendar::ReadGuard::~ReadGuard(){
+    mCalendar.mReaders[mEpoch & 1].mCount.fetch_sub(1);
+}
+
+// The epoch advances once the previous epoch's reads have ended, which
+// frees the lists replaced during it. Reads of the current epoch share the
+// counter that the next epoch will use, so the epoch moves on at most one
+// step past the oldest read in progress.
+void BookingCalendar::retire(const HoldList *list){
+    std::vector<const HoldList *> freed;
+    
+    {
+        std::lock_guard<std::mutex> lock(mRetiredMutex);
+        uint64_t epoch = mEpoch.load();
+        mRetired[epoch & 1].push_back(list);
+        
+        if (mReaders[(epoch + 1) & 1].mCount.load() == 0){
+            freed.swap(mRetired[(epoch + 1) & 1]);
+            mEpoch.store(epoch + 1);
+        }
+    }
+    
+    for (const HoldList *old : freed){
+        delete old;
+    }
+}
+
+bool BookingCalendar::isFree(const HoldList *list, const DateRange &dates){
+    if (!list){
+        return true;
+    }
+    
+    auto next = std::lower_bound(list->mHolds.begin(), list->mHolds.end(), dates.to(),
+                                 [](const Hold &hold, int day){ return hold.mFrom < day; });
+    
+    // Only the last hold starting before the range ends can overlap it
+    return next == list->mHolds.begin() || std::prev(next)->mTo <= dates.from();
+}
+
+// Callers hold a ReadGuard
+bool BookingCalendar::isFree(uint32_t position, const DateRange &dates) const{
+    return isFree(mHolds[mCanonical[position]].load(std::memory_order_acquire), dates);
+}
+
+// Publish a copy of the slip's holds with the range added, retrying if
+// another booking replaced the list first. Returns false, leaving the slip
+// unchanged, once the range is no longer free.
+bool BookingCalendar::hold(uint32_t position, const std::string &holder, const DateRange &dates){
+    std::atomic<const HoldList *> &slot = mHolds[mCanonical[position]];
+    ReadGuard guard(*this);
+    const HoldList *current = slot.load(std::memory_order_acquire);
+    
+    while (isFree(current, dates)){
+        HoldList *next = new HoldList{ current ? current->mHolds : std::vector<Hold>() };
+        auto at = std::lower_bound(next->mHolds.begin(), next->mHolds.end(), dates.from(),
+                                   [](const Hold &hold, int day){ return hold.mFrom < day; });
+        next->mHolds.insert(at, Hold{ dates.from(), dates.to(), holder });
+        
+        if (slot.compare_exchange_strong(current, next, std::memory_order_acq_rel, std::memory_order_acquire)){
+            if (current){
+                retire(current);
+            }
+            
+            return true;
+        }
+        
+        // current now holds the list that won; check against it and retry
+        delete next;
+    }
+    
+    return false;
+}
+
+bool BookingCalendar::slipFits(const Slip &slip, const Dimensions &boatDimensions, Amenities::Mask required) const{
+    if (!Amenities::provides(slip.amenities(), required)){
+        return false;
+    }
+    
+    return mIgnoreLength ? slip.fitsWidthOnly(boatDimensions) : slip.fits(boatDimensions);
+}
+
+void BookingCalendar::holdSeason(const std::vector<Member> &members, const std::vector<Assignment> &assignments,
+                                 const DateRange &season){
+    std::unordered_map<std::string, const Member *> roster;
+    
+    for (const auto &member : members){
+        roster.emplace(member.id(), &member);
+    }
+    
+    for (const auto &assignment : assignments){
+        if (!assignment.assigned()){
+            continue;
+        }
+        
+        auto slipIt = mSlipPositions.find(assignment.slipId());
+        
+        if (slipIt == mSlipPositions.end()){
+            continue;
+        }
+        
+        uint32_t position = slipIt->second;
+        auto memberIt = roster.find(assignment.memberId());
+        std::vector<DateRange> away;
+        
+        if (memberIt != roster.end() && !mSlips[position].shared()){
+            away = memberIt->second->awayDates();
+        }
+        
+        std::sort(away.begin(), away.end(), [](const DateRange &a, const DateRange &b){ return a.from() < b.from(); });
+        
+        // Hold the gaps between away ranges, clipped to the season; a gap
+        // already held (a shared slip's other boats) is left as it is
+        int start = season.from();
+        
+        for (const auto &range : away){
+            if (range.from() > start && start < season.to()){
+                hold(position, assignment.memberId(), DateRange(start, std::min(range.from(), season.to())));
+            }
+            
+            start = std::max(start, range.to());
+        }
+        
+        if (start < season.to()){
+            hold(position, assignment.memberId(), DateRange(start, season.to()));
+        }
+    }
+}
+
+bool BookingCalendar::isFree(const std::string &slipId, const DateRange &dates) const{
+    auto it = mSlipPositions.find(slipId);
+    ReadGuard guard(*this);
+    return it != mSlipPositions.end() && isFree(it->second, dates);
+}
+
+bool BookingCalendar::tryBook(const std::string &holder, const std::string &slipId, const DateRange &dates){
+    auto it = mSlipPositions.find(slipId);
+    
+    if (it == mSlipPositions.end()){
+        throw std::invalid_argument("Unknown slip: " + slipId);
+    }
+    
+    return hold(it->second, holder, dates);
+}
+
+void BookingCalendar::book(const std::string &holder, const std::string &slipId, const DateRange &dates){
+    if (!tryBook(holder, slipId, dates)){
+        throw std::runtime_error("Slip " + slipId + " is already booked during " + dates.toString());
+    }
+}
+
+// True if slip a comes before slip b in best-fit order: smaller area, then
+// wider, then earlier in the slip list.
+static bool bestFitBefore(const Slip &a, const Slip &b){
+    long long areaA = static_cast<long long>(a.maxDimensions().lengthInches()) * a.maxDimensions().widthInches();
+    long long areaB = static_cast<long long>(b.maxDimensions().lengthInches()) * b.maxDimensions().widthInches();
+    
+    if (areaA != areaB){
+        return areaA < areaB;
+    }
+    
+    if (a.maxDimensions().widthInches() != b.maxDimensions().widthInches()){
+        return a.maxDimensions().widthInches() > b.maxDimensions().widthInches();
+    }
+    
+    return &a < &b;
+}
+
+const Slip *BookingCalendar::findBestFit(const Dimensions &boatDimensions, Amenities::Mask required,
+                                         const DateRange &dates) const{
+    ReadGuard guard(*this);
+    const Slip *bestSlip = nullptr;
+    
+    if (!mIgnoreLength){
+        long long boatArea = static_cast<long long>(boatDimensions.lengthInches()) * boatDimensions.widthInches();
+        long long bestArea = 0;
+        
+        for (const auto &group : mIndex.groups()){
+            if (!group.admits(boatDimensions, required)){
+                continue;
+            }
+            
+            const std::vector<uint32_t> &order = group.mBestFitOrder;
+            
+            for (size_t i = group.firstWithArea(boatArea); i < order.size(); ++i){
+                // Later slips in this group cannot beat the best so far
+                if (bestSlip && group.mAreas[i] > bestArea){
+                    break;
+                }
+                
+                const Slip &slip = mSlips[order[i]];
+                
+                if (group.provides(slip.amenities(), required) && slip.fits(boatDimensions) && isFree(order[i], dates)){
+                    if (!bestSlip || bestFitBefore(slip, *bestSlip)){
+                        bestSlip = &slip;
+                        bestArea = group.mAreas[i];
+                    }
+                    
+                    break;
+                }
+            }
+        }
+        
+        for (uint32_t position : mIndex.sharedPositions()){
+            const Slip &slip = mSlips[position];
+            
+            if (slipFits(slip, boatDimensions, required) && isFree(position, dates) &&
+                (!bestSlip || bestFitBefore(slip, *bestSlip))){
+                bestSlip = &slip;
+            }
+        }
+        
+        return bestSlip;
+    }
+    
+    // In ignore-length mode, least overhang, then smallest area, then widest margin
+    int minOverhang = std::numeric_limits<int>::max();
+    
+    for (uint32_t position : mIndex.positions()){
+        const Slip &slip = mSlips[position];
+        
+        if (!slipFits(slip, boatDimensions, required) || !isFree(position, dates)){
+            continue;
+        }
+        
+        int overhang = std::max(0, slip.lengthDifference(boatDimensions));
+        
+        if (!bestSlip || overhang < minOverhang || (overhang == minOverhang && bestFitBefore(slip, *bestSlip))){
+            bestSlip = &slip;
+            minOverhang = overhang;
+        }
+    }
+    
+    return bestSlip;
+}
+
+Booking BookingCalendar::book(const BookingRequest &request){
+    while (true){
+        const Slip *slip = findBestFit(request.boatDimensions(), request.requiredAmenities(), request.dates());
+        
+        if (!slip){
+            return Booking(request.id(), "", request.dates());
+        }
+        
+        if (hold(static_cast<uint32_t>(slip - mSlips.data()), request.id(), request.dates())){
+            return Booking(request.id(), slip->id(), request.dates());
+        }
+    }
+}
+
+std::vector<Booking> BookingCalendar::bookings(const std::string &slipId) const{
+    std::vector<Booking> result;
+    auto it = mSlipPositions.find(slipId);
+    
+    if (it == mSlipPositions.end()){
+        return result;
+    }
+    
+    ReadGuard guard(*this);
+    const HoldList *list = mHolds[it->second].load(std::memory_order_acquire);
+    
+    if (list){
+        for (const auto &hold : list->mHolds){
+            result.emplace_back(hold.mHolder, slipId, DateRange(hold.mFrom, hold.mTo));
+        }
+    }
+    
+    return result;
+}
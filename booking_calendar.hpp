@@ -0,0 +1,172 @@
+#ifndef BOOKING_CALENDAR_H
+#define BOOKING_CALENDAR_H
+
+#include "assignment.hpp"
+#include "date_range.hpp"
+#include "member.hpp"
+#include "slip.hpp"
+#include "slip_index.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A transient boat's request for a slip over a range of days.
+class BookingRequest {
+    std::string mId;
+    Dimensions mBoatDimensions;
+    DateRange mDates;
+    Amenities::Mask mRequiredAmenities;
+
+public:
+    BookingRequest(const std::string &requestId, const Dimensions &boatDimensions, const DateRange &dates,
+                   Amenities::Mask requiredAmenities = 0);
+
+    const std::string &id() const{ return mId; }
+    const Dimensions &boatDimensions() const{ return mBoatDimensions; }
+    const DateRange &dates() const{ return mDates; }
+    Amenities::Mask requiredAmenities() const{ return mRequiredAmenities; }
+};
+
+// A slip held over a range of days, by a member or a transient request.
+// The slip ID is empty for a request that could not be booked.
+class Booking {
+    std::string mHolder;
+    std::string mSlipId;
+    DateRange mDates;
+
+public:
+    Booking(const std::string &holder, const std::string &slipId, const DateRange &dates);
+
+    const std::string &holder() const{ return mHolder; }
+    const std::string &slipId() const{ return mSlipId; }
+    const DateRange &dates() const{ return mDates; }
+    bool booked() const{ return !mSlipId.empty(); }
+};
+
+// Date-ranged occupancy of a marina's slips.
+//
+// A season's assignments hold their slips for the whole season, except the
+// days each member is away; transients are then booked into the gaps by
+// date range, best fit first, using the same fit rules as the season
+// assignment.
+//
+// Each slip's booked ranges form an immutable list sorted by first day,
+// published through an atomic pointer. Ranges on one slip never overlap,
+// so a slip is free for [from, to) when the last range starting before `to`
+// ends by `from` - one binary search. Best-fit queries walk the slip
+// index's best-fit order from the boat's area and stop at the first slip
+// that fits and is free, as the season assignment does. That walk is linear
+// in the booked slips it passes over; ignore-length mode checks every slip.
+//
+// Every member function is safe to call from several threads at once.
+// Readers load a slip's current list and never block or retry. A writer
+// copies the list with its range added and publishes it with a
+// compare-and-swap; if another booking landed on the slip first, it
+// re-checks the slip against the new list and tries again, so two
+// overlapping bookings can never both succeed.
+//
+// Replaced lists are freed by epoch: each read registers in the counter of
+// the epoch it started in, and a replaced list waits in the bag of the
+// epoch it was replaced in. The epoch only advances once no read from the
+// epoch before remains, and advancing frees that earlier epoch's bag, so a
+// list is freed only after every read that could have seen it has ended.
+// Writers advance the epoch when they can and never wait for readers.
+//
+// Shared slips are booked whole: the date ranges of boats side by side are
+// not tracked separately, so a shared slip holding season boats stays held
+// for the whole season.
+class BookingCalendar {
+    struct Hold {
+        int mFrom;
+        int mTo;
+        std::string mHolder;
+    };
+
+    // One published version of a slip's holds, sorted by first day
+    struct HoldList {
+        std::vector<Hold> mHolds;
+    };
+
+    // Registers a read in the current epoch for its lifetime
+    class ReadGuard {
+        const BookingCalendar &mCalendar;
+        uint64_t mEpoch;
+
+    public:
+        explicit ReadGuard(const BookingCalendar &calendar);
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+    };
+
+    std::vector<Slip> mSlips;
+    SlipIndex mIndex;
+    std::unordered_map<std::string, uint32_t> mSlipPositions;
+    // Holds are kept on the first slip with each ID
+    std::vector<uint32_t> mCanonical;
+    std::unique_ptr<std::atomic<const HoldList *>[]> mHolds;
+    bool mIgnoreLength;
+
+    // Reads in progress, by epoch parity, on separate cache lines
+    struct alignas(64) ReaderCount {
+        std::atomic<uint64_t> mCount{ 0 };
+    };
+
+    std::atomic<uint64_t> mEpoch;
+    mutable ReaderCount mReaders[2];
+    // Replaced lists by the parity of the epoch they were replaced in
+    std::mutex mRetiredMutex;
+    std::vector<const HoldList *> mRetired[2];
+
+    // Free a replaced list once no read can still see it
+    void retire(const HoldList *list);
+
+    static bool isFree(const HoldList *list, const DateRange &dates);
+    bool isFree(uint32_t position, const DateRange &dates) const;
+    bool hold(uint32_t position, const std::string &holder, const DateRange &dates);
+    bool slipFits(const Slip &slip, const Dimensions &boatDimensions, Amenities::Mask required) const;
+
+public:
+    explicit BookingCalendar(std::vector<Slip> slips);
+    ~BookingCalendar();
+    
+    BookingCalendar(const BookingCalendar &) = delete;
+    BookingCalendar &operator=(const BookingCalendar &) = delete;
+
+    // Check only width when fitting boats, as in the season assignment
+    void setIgnoreLength(bool ignoreLength){ mIgnoreLength = ignoreLength; }
+
+    // Hold every assigned slip for the season, less the days its member is
+    // away. Rows for members not on the roster hold the whole season.
+    void holdSeason(const std::vector<Member> &members, const std::vector<Assignment> &assignments,
+                    const DateRange &season);
+
+    // True if the slip exists and nothing is booked on it during the dates
+    bool isFree(const std::string &slipId, const DateRange &dates) const;
+
+    // Book a named slip if it is free for the dates; false if it is not.
+    // Throws std::invalid_argument for an unknown slip.
+    bool tryBook(const std::string &holder, const std::string &slipId, const DateRange &dates);
+    
+    // As tryBook(), but throws std::runtime_error if the slip is booked during the dates
+    void book(const std::string &holder, const std::string &slipId, const DateRange &dates);
+
+    // The best-fitting slip that fits the boat, provides the amenities and
+    // is free for the whole range, or nullptr
+    const Slip *findBestFit(const Dimensions &boatDimensions, Amenities::Mask required, const DateRange &dates) const;
+
+    // Book the best-fitting free slip for a request. If another booking
+    // takes that slip first, the search is repeated.
+    Booking book(const BookingRequest &request);
+
+    // Bookings on a slip in date order
+    std::vector<Booking> bookings(const std::string &slipId) const;
+
+    const std::vector<Slip> &slips() const{ return mSlips; }
+};
+
+#endif
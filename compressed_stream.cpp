@@ -0,0 +1,435 @@
+#include "compressed_stream.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <zlib.h>
+
+#ifdef SLIPPAGE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+// Large chunks keep per-call overhead negligible next to the codec itself
+const size_t INPUT_CHUNK_SIZE = 128 * 1024;
+const size_t OUTPUT_CHUNK_SIZE = 256 * 1024;
+
+Compression compressionFromMagic(const unsigned char *bytes, size_t count){
+    if (count >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b){
+        return Compression::GZIP;
+    }
+
+    if (count >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 && bytes[2] == 0x2f && bytes[3] == 0xfd){
+        return Compression::ZSTD;
+    }
+
+    return Compression::NONE;
+}
+
+bool endsWith(const std::string &str, const std::string &suffix){
+    return str.size() >= suffix.size() &&
+           str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+#ifndef SLIPPAGE_HAVE_ZSTD
+const char *const ZSTD_UNAVAILABLE = "zstd compression requires a build with zstd support";
+#endif
+
+}
+
+// Codec state is released with the codec, so a constructor that throws
+// part way through leaks nothing
+struct DecompressingStreamBuf::Codec {
+    z_stream mZlib;
+    bool mZlibActive = false;
+#ifdef SLIPPAGE_HAVE_ZSTD
+    ZSTD_DCtx *mZstd = nullptr;
+#endif
+    bool mStreamEnded = false;
+
+    ~Codec(){
+        if (mZlibActive){
+            inflateEnd(&mZlib);
+        }
+
+#ifdef SLIPPAGE_HAVE_ZSTD
+        if (mZstd){
+            ZSTD_freeDCtx(mZstd);
+        }
+#endif
+    }
+};
+
+struct CompressingStreamBuf::Codec {
+    z_stream mZlib;
+    bool mZlibActive = false;
+#ifdef SLIPPAGE_HAVE_ZSTD
+    ZSTD_CCtx *mZstd = nullptr;
+#endif
+
+    ~Codec(){
+        if (mZlibActive){
+            deflateEnd(&mZlib);
+        }
+
+#ifdef SLIPPAGE_HAVE_ZSTD
+        if (mZstd){
+            ZSTD_freeCCtx(mZstd);
+        }
+#endif
+    }
+};
+
+DecompressingStreamBuf::DecompressingStreamBuf(const std::string &filename)
+    : mFile(std::fopen(filename.c_str(), "rb")), mCompression(Compression::NONE), mCodec(new Codec()),
+      mInput(INPUT_CHUNK_SIZE), mInputPos(0), mInputEnd(0), mInputEof(false){
+
+    if (!mFile){
+        throw std::runtime_error("Cannot open input file '" + filename + "'");
+    }
+
+    fillInput();
+    mCompression = compressionFromMagic(reinterpret_cast<const unsigned char *>(mInput.data()), mInputEnd);
+
+    if (mCompression == Compression::GZIP){
+        std::memset(&mCodec->mZlib, 0, sizeof(mCodec->mZlib));
+
+        // 15 + 16 selects the gzip wrapper
+        if (inflateInit2(&mCodec->mZlib, 15 + 16) != Z_OK){
+            throw std::runtime_error("Cannot initialize gzip decompressor");
+        }
+
+        mCodec->mZlibActive = true;
+        mOutput.resize(OUTPUT_CHUNK_SIZE);
+    }
+    else if (mCompression == Compression::ZSTD){
+#ifdef SLIPPAGE_HAVE_ZSTD
+        mCodec->mZstd = ZSTD_createDCtx();
+
+        if (!mCodec->mZstd){
+            throw std::runtime_error("Cannot initialize zstd decompressor");
+        }
+
+        mOutput.resize(ZSTD_DStreamOutSize() > OUTPUT_CHUNK_SIZE ? ZSTD_DStreamOutSize() : OUTPUT_CHUNK_SIZE);
+#else
+        throw std::runtime_error(ZSTD_UNAVAILABLE);
+#endif
+    }
+
+    setg(nullptr, nullptr, nullptr);
+}
+
+// The codec and the file release themselves
+DecompressingStreamBuf::~DecompressingStreamBuf() = default;
+
+// Refill the raw input chunk. Returns false once the file is exhausted.
+bool DecompressingStreamBuf::fillInput(){
+    if (mInputEof){
+        return false;
+    }
+
+    size_t bytesRead = std::fread(mInput.data(), 1, mInput.size(), mFile.get());
+
+    if (bytesRead < mInput.size()){
+        if (std::ferror(mFile.get())){
+            throw std::runtime_error("Error reading compressed input");
+        }
+
+        mInputEof = true;
+    }
+
+    mInputPos = 0;
+    mInputEnd = bytesRead;
+    return bytesRead > 0;
+}
+
+// Produce the next chunk of decompressed bytes.
+//
+// Plain files are exposed directly from the raw input chunk so uncompressed
+// input pays no copy. Compressed files are inflated into the output chunk,
+// looping until at least one byte is produced or the input is exhausted.
+DecompressingStreamBuf::int_type DecompressingStreamBuf::underflow(){
+    if (gptr() < egptr()){
+        return traits_type::to_int_type(*gptr());
+    }
+
+    if (mCompression == Compression::NONE){
+        if (mInputPos == mInputEnd && !fillInput()){
+            return traits_type::eof();
+        }
+
+        setg(mInput.data() + mInputPos, mInput.data() + mInputPos, mInput.data() + mInputEnd);
+        mInputPos = mInputEnd;
+        return traits_type::to_int_type(*gptr());
+    }
+
+    size_t produced = 0;
+
+    while (produced == 0){
+        if (mInputPos == mInputEnd && !fillInput()){
+            if (!mCodec->mStreamEnded){
+                throw std::runtime_error("Unexpected end of compressed input");
+            }
+
+            return traits_type::eof();
+        }
+
+        if (mCompression == Compression::GZIP){
+            z_stream &zlib = mCodec->mZlib;
+
+            // Concatenated gzip members are valid gzip; start the next member
+            if (mCodec->mStreamEnded){
+                inflateReset(&zlib);
+                mCodec->mStreamEnded = false;
+            }
+
+            zlib.next_in = reinterpret_cast<Bytef *>(mInput.data() + mInputPos);
+            zlib.avail_in = static_cast<uInt>(mInputEnd - mInputPos);
+            zlib.next_out = reinterpret_cast<Bytef *>(mOutput.data());
+            zlib.avail_out = static_cast<uInt>(mOutput.size());
+
+            int result = inflate(&zlib, Z_NO_FLUSH);
+
+            if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR){
+                throw std::runtime_error(std::string("Corrupt gzip input: ") + (zlib.msg ? zlib.msg : "inflate failed"));
+            }
+
+            mInputPos = mInputEnd - zlib.avail_in;
+            produced = mOutput.size() - zlib.avail_out;
+            mCodec->mStreamEnded = (result == Z_STREAM_END);
+        }
+        else{
+#ifdef SLIPPAGE_HAVE_ZSTD
+            ZSTD_inBuffer in = { mInput.data(), mInputEnd, mInputPos };
+            ZSTD_outBuffer out = { mOutput.data(), mOutput.size(), 0 };
+            size_t result = ZSTD_decompressStream(mCodec->mZstd, &out, &in);
+
+            if (ZSTD_isError(result)){
+                throw std::runtime_error(std::string("Corrupt zstd input: ") + ZSTD_getErrorName(result));
+            }
+
+            mInputPos = in.pos;
+            produced = out.pos;
+            mCodec->mStreamEnded = (result == 0);
+#endif
+        }
+    }
+
+    setg(mOutput.data(), mOutput.data(), mOutput.data() + produced);
+    return traits_type::to_int_type(*gptr());
+}
+
+// Open a file for compressed output. zstd is refused before the file is
+// opened, so a build without it leaves an existing file untouched.
+static std::FILE *openOutputFile(const std::string &filename, Compression compression){
+#ifndef SLIPPAGE_HAVE_ZSTD
+    if (compression == Compression::ZSTD){
+        throw std::runtime_error(ZSTD_UNAVAILABLE);
+    }
+#endif
+
+    std::FILE *file = std::fopen(filename.c_str(), "wb");
+
+    if (!file){
+        throw std::runtime_error("Cannot open output file '" + filename + "'");
+    }
+
+    return file;
+}
+
+CompressingStreamBuf::CompressingStreamBuf(const std::string &filename, Compression compression, int level)
+    : mFile(openOutputFile(filename, compression)), mCompression(compression), mCodec(new Codec()),
+      mInput(INPUT_CHUNK_SIZE), mFinished(false){
+
+    if (mCompression == Compression::GZIP){
+        std::memset(&mCodec->mZlib, 0, sizeof(mCodec->mZlib));
+
+        // Level 0 selects the codec default rather than "store only"
+        int zlibLevel = (level == 0) ? Z_DEFAULT_COMPRESSION : level;
+
+        if (deflateInit2(&mCodec->mZlib, zlibLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK){
+            throw std::runtime_error("Cannot initialize gzip compressor");
+        }
+
+        mCodec->mZlibActive = true;
+        mOutput.resize(OUTPUT_CHUNK_SIZE);
+    }
+    else if (mCompression == Compression::ZSTD){
+#ifdef SLIPPAGE_HAVE_ZSTD
+        mCodec->mZstd = ZSTD_createCCtx();
+
+        if (!mCodec->mZstd){
+            throw std::runtime_error("Cannot initialize zstd compressor");
+        }
+
+        ZSTD_CCtx_setParameter(mCodec->mZstd, ZSTD_c_compressionLevel, level);
+        mOutput.resize(ZSTD_CStreamOutSize());
+#endif
+    }
+
+    setp(mInput.data(), mInput.data() + mInput.size());
+}
+
+CompressingStreamBuf::~CompressingStreamBuf(){
+    try{
+        finish();
+    }
+    catch (const std::exception &){
+        // Destructors must not throw; call finish() explicitly to see errors
+    }
+}
+
+// Push the buffered bytes through the compressor and write whatever it emits.
+// With finish set, the compressor is drained and the stream trailer written.
+void CompressingStreamBuf::compressPending(bool finish){
+    char *begin = pbase();
+    size_t pending = pptr() - pbase();
+
+    if (mCompression == Compression::NONE){
+        if (pending > 0 && std::fwrite(begin, 1, pending, mFile.get()) != pending){
+            throw std::runtime_error("Error writing output file");
+        }
+    }
+    else if (mCompression == Compression::GZIP){
+        z_stream &zlib = mCodec->mZlib;
+        zlib.next_in = reinterpret_cast<Bytef *>(begin);
+        zlib.avail_in = static_cast<uInt>(pending);
+        int result = Z_OK;
+
+        do{
+            zlib.next_out = reinterpret_cast<Bytef *>(mOutput.data());
+            zlib.avail_out = static_cast<uInt>(mOutput.size());
+            result = deflate(&zlib, finish ? Z_FINISH : Z_NO_FLUSH);
+            size_t produced = mOutput.size() - zlib.avail_out;
+
+            if (produced > 0 && std::fwrite(mOutput.data(), 1, produced, mFile.get()) != produced){
+                throw std::runtime_error("Error writing output file");
+            }
+        } while (zlib.avail_out == 0 || (finish && result != Z_STREAM_END));
+    }
+    else{
+#ifdef SLIPPAGE_HAVE_ZSTD
+        ZSTD_inBuffer in = { begin, pending, 0 };
+        size_t remaining = 0;
+
+        do{
+            ZSTD_outBuffer out = { mOutput.data(), mOutput.size(), 0 };
+            remaining = ZSTD_compressStream2(mCodec->mZstd, &out, &in, finish ? ZSTD_e_end : ZSTD_e_continue);
+
+            if (ZSTD_isError(remaining)){
+                throw std::runtime_error(std::string("zstd compression failed: ") + ZSTD_getErrorName(remaining));
+            }
+
+            if (out.pos > 0 && std::fwrite(mOutput.data(), 1, out.pos, mFile.get()) != out.pos){
+                throw std::runtime_error("Error writing output file");
+            }
+        } while (in.pos < in.size || (finish && remaining != 0));
+#endif
+    }
+
+    setp(mInput.data(), mInput.data() + mInput.size());
+}
+
+CompressingStreamBuf::int_type CompressingStreamBuf::overflow(int_type ch){
+    if (mFinished){
+        return traits_type::eof();
+    }
+
+    compressPending(false);
+
+    if (!traits_type::eq_int_type(ch, traits_type::eof())){
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+
+    return traits_type::not_eof(ch);
+}
+
+int CompressingStreamBuf::sync(){
+    if (mFinished){
+        return 0;
+    }
+
+    compressPending(false);
+    return std::fflush(mFile.get()) == 0 ? 0 : -1;
+}
+
+void CompressingStreamBuf::finish(){
+    if (mFinished){
+        return;
+    }
+
+    mFinished = true;
+    compressPending(true);
+
+    if (std::fflush(mFile.get()) != 0){
+        throw std::runtime_error("Error writing output file");
+    }
+}
+
+CompressedInputStream::CompressedInputStream(const std::string &filename)
+    : std::istream(nullptr), mBuf(filename){
+    rdbuf(&mBuf);
+
+    // Surface decompression errors instead of silently truncating the input
+    exceptions(std::ios::badbit);
+}
+
+CompressedOutputStream::CompressedOutputStream(const std::string &filename, Compression compression, int level)
+    : std::ostream(nullptr), mBuf(filename, compression, level){
+    rdbuf(&mBuf);
+    exceptions(std::ios::badbit);
+}
+
+void CompressedOutputStream::finish(){
+    flush();
+    mBuf.finish();
+}
+
+Compression detectCompression(const std::string &filename){
+    std::FILE *file = std::fopen(filename.c_str(), "rb");
+
+    if (!file){
+        throw std::runtime_error("Cannot open input file '" + filename + "'");
+    }
+
+    unsigned char magic[4] = { 0, 0, 0, 0 };
+    size_t count = std::fread(magic, 1, sizeof(magic), file);
+    std::fclose(file);
+
+    return compressionFromMagic(magic, count);
+}
+
+Compression compressionForFilename(const std::string &filename){
+    if (endsWith(filename, ".gz") || endsWith(filename, ".gzip")){
+        return Compression::GZIP;
+    }
+
+    if (endsWith(filename, ".zst") || endsWith(filename, ".zstd")){
+        return Compression::ZSTD;
+    }
+
+    return Compression::NONE;
+}
+
+Compression stringToCompression(const std::string &str){
+    if (str == "gzip" || str == "gz"){
+        return Compression::GZIP;
+    }
+    else if (str == "zstd" || str == "zst"){
+        return Compression::ZSTD;
+    }
+    else if (str == "none"){
+        return Compression::NONE;
+    }
+    else{
+        throw std::invalid_argument("Invalid compression: " + str);
+    }
+}
+
+bool zstdAvailable(){
+#ifdef SLIPPAGE_HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
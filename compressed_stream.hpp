@@ -0,0 +1,119 @@
+#ifndef COMPRESSED_STREAM_H
+#define COMPRESSED_STREAM_H
+
+#include <cstdio>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Compression formats understood by the input and output streams.
+// Input format is detected from magic bytes; output format is chosen
+// explicitly or from the file extension (.gz, .zst).
+enum class Compression {
+    NONE,
+    GZIP,
+    ZSTD
+};
+
+// Closes a file owned by a stream buffer, including one whose constructor throws
+struct FileCloser {
+    void operator()(std::FILE *file) const{ std::fclose(file); }
+};
+
+// Stream buffer that reads a file and inflates it chunk by chunk.
+// Only one input chunk and one output chunk are held in memory at a time,
+// so arbitrarily large archives can be parsed without inflating to disk.
+class DecompressingStreamBuf : public std::streambuf {
+    struct Codec;
+
+    std::unique_ptr<std::FILE, FileCloser> mFile;
+    Compression mCompression;
+    std::unique_ptr<Codec> mCodec;
+    std::vector<char> mInput;
+    std::vector<char> mOutput;
+    size_t mInputPos;
+    size_t mInputEnd;
+    bool mInputEof;
+
+    bool fillInput();
+
+protected:
+    int_type underflow() override;
+
+public:
+    explicit DecompressingStreamBuf(const std::string &filename);
+    ~DecompressingStreamBuf() override;
+
+    DecompressingStreamBuf(const DecompressingStreamBuf &) = delete;
+    DecompressingStreamBuf &operator=(const DecompressingStreamBuf &) = delete;
+
+    Compression compression() const{ return mCompression; }
+};
+
+// Stream buffer that deflates everything written to it into a file.
+class CompressingStreamBuf : public std::streambuf {
+    struct Codec;
+
+    std::unique_ptr<std::FILE, FileCloser> mFile;
+    Compression mCompression;
+    std::unique_ptr<Codec> mCodec;
+    std::vector<char> mInput;
+    std::vector<char> mOutput;
+    bool mFinished;
+
+    void compressPending(bool finish);
+
+protected:
+    int_type overflow(int_type ch) override;
+    int sync() override;
+
+public:
+    CompressingStreamBuf(const std::string &filename, Compression compression, int level = 0);
+    ~CompressingStreamBuf() override;
+
+    CompressingStreamBuf(const CompressingStreamBuf &) = delete;
+    CompressingStreamBuf &operator=(const CompressingStreamBuf &) = delete;
+
+    // Flush the compressor and write the stream trailer. Called by the destructor
+    // if not called explicitly; call it yourself to observe write errors.
+    void finish();
+};
+
+// Input file stream that transparently decompresses gzip and zstd files.
+// Plain files are passed through unchanged.
+class CompressedInputStream : public std::istream {
+    DecompressingStreamBuf mBuf;
+
+public:
+    explicit CompressedInputStream(const std::string &filename);
+
+    Compression compression() const{ return mBuf.compression(); }
+};
+
+// Output file stream that compresses everything written to it.
+class CompressedOutputStream : public std::ostream {
+    CompressingStreamBuf mBuf;
+
+public:
+    CompressedOutputStream(const std::string &filename, Compression compression, int level = 0);
+
+    void finish();
+};
+
+// Detect the compression of a file from its leading magic bytes.
+// Throws std::runtime_error if the file cannot be opened.
+Compression detectCompression(const std::string &filename);
+
+// Pick an output compression from a file name (.gz, .gzip, .zst, .zstd).
+Compression compressionForFilename(const std::string &filename);
+
+// Parse "gzip", "zstd" or "none"; throws std::invalid_argument otherwise.
+Compression stringToCompression(const std::string &str);
+
+// True if this build was linked with zstd support.
+bool zstdAvailable();
+
+#endif
@@ -1,13 +1,80 @@
 #include "csv_parser.hpp"
+#include "compressed_stream.hpp"
 #include "external/csv-parser/single_include/csv.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
+#include <memory>
 #include <stdexcept>
 #include <sstream>
 
-std::vector<Member> CsvParser::parseMembers(const std::string &filename){
+// True if the reader's header contains the named column
+static bool hasColumn(csv::CSVReader &reader, const std::string &column){
+    std::vector<std::string> columns = reader.get_col_names();
+    return std::find(columns.begin(), columns.end(), column) != columns.end();
+}
+
+// Read an optional feet/inches column pair as inches. Either column may be
+// missing and empty fields read as 0.
+static int readOptionalInches(csv::CSVRow &row, const std::string &prefix, bool hasFeet, bool hasInches){
+    int inches = 0;
+    
+    if (hasFeet){
+        std::string feet = row[prefix + "_ft"].get<>();
+        
+        if (!feet.empty()){
+            inches += std::stoi(feet) * 12;
+        }
+    }
+    
+    if (hasInches){
+        std::string extra = row[prefix + "_in"].get<>();
+        
+        if (!extra.empty()){
+            inches += std::stoi(extra);
+        }
+    }
+    
+    return inches;
+}
+
+// Split a ';'-separated list, trimming spaces and dropping empty entries
+static std::vector<std::string> splitList(const std::string &field){
+    std::vector<std::string> items;
+    size_t start = 0;
+    
+    while (start <= field.size()){
+        size_t end = field.find(';', start);
+        
+        if (end == std::string::npos){
+            end = field.size();
+        }
+        
+        size_t first = field.find_first_not_of(" \t", start);
+        size_t last = field.find_last_not_of(" \t", end == 0 ? 0 : end - 1);
+        
+        if (first != std::string::npos && first < end && last >= first){
+            items.push_back(field.substr(first, last - first + 1));
+        }
+        
+        start = end + 1;
+    }
+    
+    return items;
+}
+
+// Read member rows from an open CSV reader.
+static std::vector<Member> readMembers(csv::CSVReader &reader){
     std::vector<Member> members;
-    csv::CSVReader reader(filename);
+    bool hasPreferredDock = hasColumn(reader, "preferred_dock");
+    bool hasSlipPreferences = hasColumn(reader, "slip_preferences");
+    bool hasDraftFeet = hasColumn(reader, "boat_draft_ft");
+    bool hasDraftInches = hasColumn(reader, "boat_draft_in");
+    bool hasAirDraftFeet = hasColumn(reader, "boat_air_draft_ft");
+    bool hasAirDraftInches = hasColumn(reader, "boat_air_draft_in");
+    bool hasRequiredAmenities = hasColumn(reader, "required_amenities");
+    bool hasAway = hasColumn(reader, "away");
     
     for (csv::CSVRow &row : reader){
         std::string memberId = row["member_id"].get<>();
@@ -26,16 +93,56 @@ std::vector<Member> CsvParser::parseMembers(const std::string &filename){
         std::string dockStatusStr = row["dock_status"].get<>();
         Member::DockStatus dockStatus = Member::stringToDockStatus(dockStatusStr);
         
+        std::optional<std::string> preferredDock;
+        
+        if (hasPreferredDock){
+            std::string preferredDockStr = row["preferred_dock"].get<>();
+            
+            if (!preferredDockStr.empty()){
+                preferredDock = preferredDockStr;
+            }
+        }
+        
         members.emplace_back(memberId, boatFeetLength, boatInchesLength,
-                           boatFeetWidth, boatInchesWidth, currentSlip, dockStatus);
+                           boatFeetWidth, boatInchesWidth, currentSlip, dockStatus, preferredDock);
+        
+        if (hasSlipPreferences){
+            members.back().setSlipPreferences(splitList(row["slip_preferences"].get<>()));
+        }
+        
+        if (hasDraftFeet || hasDraftInches || hasAirDraftFeet || hasAirDraftInches){
+            members.back().setBoatDrafts(readOptionalInches(row, "boat_draft", hasDraftFeet, hasDraftInches),
+                                         readOptionalInches(row, "boat_air_draft", hasAirDraftFeet, hasAirDraftInches));
+        }
+        
+        if (hasRequiredAmenities){
+            members.back().setRequiredAmenities(Amenities::parse(row["required_amenities"].get<>()));
+        }
+        
+        if (hasAway){
+            std::vector<DateRange> away;
+            
+            for (const auto &range : splitList(row["away"].get<>())){
+                away.push_back(DateRange::parse(range));
+            }
+            
+            members.back().setAwayDates(std::move(away));
+        }
     }
     
     return members;
 }
 
-std::vector<Slip> CsvParser::parseSlips(const std::string &filename){
+// Read slip rows from an open CSV reader.
+static std::vector<Slip> readSlips(csv::CSVReader &reader){
     std::vector<Slip> slips;
-    csv::CSVReader reader(filename);
+    bool hasDock = hasColumn(reader, "dock");
+    bool hasDraftFeet = hasColumn(reader, "max_draft_ft");
+    bool hasDraftInches = hasColumn(reader, "max_draft_in");
+    bool hasAirDraftFeet = hasColumn(reader, "max_air_draft_ft");
+    bool hasAirDraftInches = hasColumn(reader, "max_air_draft_in");
+    bool hasAmenities = hasColumn(reader, "amenities");
+    bool hasCapacity = hasColumn(reader, "capacity");
     
     for (csv::CSVRow &row : reader){
         std::string slipId = row["slip_id"].get<>();
@@ -44,12 +151,238 @@ std::vector<Slip> CsvParser::parseSlips(const std::string &filename){
         int feetWidth = row["max_width_ft"].get<int>();
         int inchesWidth = row["max_width_in"].get<int>();
         
-        slips.emplace_back(slipId, feetLength, inchesLength, feetWidth, inchesWidth);
+        std::string dock = hasDock ? row["dock"].get<>() : "";
+        
+        slips.emplace_back(slipId, feetLength, inchesLength, feetWidth, inchesWidth, dock);
+        
+        if (hasDraftFeet || hasDraftInches || hasAirDraftFeet || hasAirDraftInches){
+            slips.back().setVerticalLimits(readOptionalInches(row, "max_draft", hasDraftFeet, hasDraftInches),
+                                           readOptionalInches(row, "max_air_draft", hasAirDraftFeet, hasAirDraftInches));
+        }
+        
+        if (hasAmenities){
+            slips.back().setAmenities(Amenities::parse(row["amenities"].get<>()));
+        }
+        
+        if (hasCapacity){
+            std::string capacity = row["capacity"].get<>();
+            
+            if (!capacity.empty()){
+                int boats = std::stoi(capacity);
+                
+                if (boats < 1){
+                    throw std::invalid_argument("Invalid capacity for slip " + slipId + ": " + capacity);
+                }
+                
+                slips.back().setCapacity(boats);
+            }
+        }
     }
     
     return slips;
 }
 
+// Read transient booking request rows from an open CSV reader.
+static std::vector<BookingRequest> readBookingRequests(csv::CSVReader &reader){
+    std::vector<BookingRequest> requests;
+    bool hasDraftFeet = hasColumn(reader, "boat_draft_ft");
+    bool hasDraftInches = hasColumn(reader, "boat_draft_in");
+    bool hasAirDraftFeet = hasColumn(reader, "boat_air_draft_ft");
+    bool hasAirDraftInches = hasColumn(reader, "boat_air_draft_in");
+    bool hasRequiredAmenities = hasColumn(reader, "required_amenities");
+    
+    for (csv::CSVRow &row : reader){
+        Dimensions boat(row["boat_length_ft"].get<int>(), row["boat_length_in"].get<int>(),
+                        row["boat_width_ft"].get<int>(), row["boat_width_in"].get<int>());
+        boat.setDraftInches(readOptionalInches(row, "boat_draft", hasDraftFeet, hasDraftInches));
+        boat.setAirDraftInches(readOptionalInches(row, "boat_air_draft", hasAirDraftFeet, hasAirDraftInches));
+        
+        DateRange dates(DateRange::parseDate(row["arrive"].get<>()), DateRange::parseDate(row["depart"].get<>()));
+        Amenities::Mask required = hasRequiredAmenities ? Amenities::parse(row["required_amenities"].get<>()) : 0;
+        requests.emplace_back(row["request_id"].get<>(), boat, dates, required);
+    }
+    
+    return requests;
+}
+
+std::vector<Member> CsvParser::parseMembers(const std::string &filename){
+    // Uncompressed files keep the memory-mapped reader path
+    if (detectCompression(filename) == Compression::NONE){
+        csv::CSVReader reader(filename);
+        return readMembers(reader);
+    }
+    
+    CompressedInputStream in(filename);
+    return parseMembers(in);
+}
+
+std::vector<Slip> CsvParser::parseSlips(const std::string &filename){
+    if (detectCompression(filename) == Compression::NONE){
+        csv::CSVReader reader(filename);
+        return readSlips(reader);
+    }
+    
+    CompressedInputStream in(filename);
+    return parseSlips(in);
+}
+
+std::vector<Member> CsvParser::parseMembers(std::istream &in){
+    csv::CSVReader reader(in, csv::CSVFormat());
+    return readMembers(reader);
+}
+
+std::vector<Slip> CsvParser::parseSlips(std::istream &in){
+    csv::CSVReader reader(in, csv::CSVFormat());
+    return readSlips(reader);
+}
+
+std::vector<BookingRequest> CsvParser::parseBookingRequests(const std::string &filename){
+    if (detectCompression(filename) == Compression::NONE){
+        csv::CSVReader reader(filename);
+        return readBookingRequests(reader);
+    }
+    
+    CompressedInputStream in(filename);
+    return parseBookingRequests(in);
+}
+
+std::vector<BookingRequest> CsvParser::parseBookingRequests(std::istream &in){
+    csv::CSVReader reader(in, csv::CSVFormat());
+    return readBookingRequests(reader);
+}
+
+std::vector<AssignmentRecord> CsvParser::parsePreviousAssignments(const std::string &filename){
+    std::vector<AssignmentRecord> records;
+    std::unique_ptr<CompressedInputStream> in;
+    std::unique_ptr<csv::CSVReader> reader;
+    
+    if (detectCompression(filename) == Compression::NONE){
+        reader.reset(new csv::CSVReader(filename));
+    }
+    else{
+        in.reset(new CompressedInputStream(filename));
+        reader.reset(new csv::CSVReader(*in, csv::CSVFormat()));
+    }
+    
+    bool hasPrice = hasColumn(*reader, "price");
+    bool hasDockStatus = hasColumn(*reader, "dock_status");
+    
+    for (csv::CSVRow &row : *reader){
+        double price = 0.0;
+        
+        if (hasPrice){
+            std::string priceStr = row["price"].get<>();
+            
+            if (!priceStr.empty()){
+                price = std::stod(priceStr);
+            }
+        }
+        
+        records.emplace_back(row["member_id"].get<>(), row["assigned_slip"].get<>(),
+                             row["status"].get<>(), price, hasPrice,
+                             hasDockStatus ? row["dock_status"].get<>() : "");
+    }
+    
+    return records;
+}
+
+// Read assignment rows from an open CSV reader.
+static std::vector<Assignment> readAssignments(csv::CSVReader &reader){
+    std::vector<Assignment> assignments;
+    bool hasUpgraded = hasColumn(reader, "upgraded");
+    bool hasComment = hasColumn(reader, "comment");
+    bool hasPrice = hasColumn(reader, "price");
+    
+    for (csv::CSVRow &row : reader){
+        Dimensions boat(row["boat_length_ft"].get<int>(), row["boat_length_in"].get<int>(),
+                        row["boat_width_ft"].get<int>(), row["boat_width_in"].get<int>());
+        bool upgraded = hasUpgraded && row["upgraded"].get<>() == "true";
+        
+        assignments.emplace_back(row["member_id"].get<>(), row["assigned_slip"].get<>(),
+                                 Assignment::stringToStatus(row["status"].get<>()), boat, Dimensions(0, 0, 0, 0),
+                                 Member::stringToDockStatus(row["dock_status"].get<>()),
+                                 hasComment ? row["comment"].get<>() : "", 0.0, upgraded);
+        
+        if (hasPrice){
+            std::string priceStr = row["price"].get<>();
+            
+            if (!priceStr.empty()){
+                assignments.back().setPrice(std::stod(priceStr));
+            }
+        }
+    }
+    
+    return assignments;
+}
+
+// Read rate table rows from an open CSV reader.
+static RateTable readRateTable(csv::CSVReader &reader){
+    RateTable rates;
+    
+    for (csv::CSVRow &row : reader){
+        std::string rule = row["rule"].get<>();
+        std::string key = row["key"].get<>();
+        double value = std::stod(row["value"].get<>());
+        
+        if (rule == "base"){
+            rates.setBaseRate(value);
+        }
+        else if (rule == "length"){
+            rates.addLengthTier(static_cast<int>(std::lround(std::stod(key) * 12.0)), value);
+        }
+        else if (rule == "dock"){
+            rates.setDockMultiplier(key, value);
+        }
+        else if (rule == "amenity"){
+            Amenities::Mask amenities = Amenities::parse(key);
+            
+            if (amenities == 0){
+                throw std::invalid_argument("Missing amenity for surcharge rule");
+            }
+            
+            rates.setAmenitySurcharge(amenities, value);
+        }
+        else if (rule == "status"){
+            rates.setStatusDiscount(Member::stringToDockStatus(key), value);
+        }
+        else{
+            throw std::invalid_argument("Invalid rate rule: " + rule);
+        }
+    }
+    
+    return rates;
+}
+
+std::vector<Assignment> CsvParser::parseAssignments(const std::string &filename){
+    if (detectCompression(filename) == Compression::NONE){
+        csv::CSVReader reader(filename);
+        return readAssignments(reader);
+    }
+    
+    CompressedInputStream in(filename);
+    return parseAssignments(in);
+}
+
+std::vector<Assignment> CsvParser::parseAssignments(std::istream &in){
+    csv::CSVReader reader(in, csv::CSVFormat());
+    return readAssignments(reader);
+}
+
+RateTable CsvParser::parseRateTable(const std::string &filename){
+    if (detectCompression(filename) == Compression::NONE){
+        csv::CSVReader reader(filename);
+        return readRateTable(reader);
+    }
+    
+    CompressedInputStream in(filename);
+    return parseRateTable(in);
+}
+
+RateTable CsvParser::parseRateTable(std::istream &in){
+    csv::CSVReader reader(in, csv::CSVFormat());
+    return readRateTable(reader);
+}
+
 // Escape and quote a CSV field if it contains special characters
 static std::string quoteCsvField(const std::string &field){
     if (field.empty()){
@@ -77,31 +410,114 @@ static std::string quoteCsvField(const std::string &field){
     return result.str();
 }
 
+static const char *ASSIGNMENT_HEADER = "member_id,assigned_slip,status,dock_status,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,price,upgraded,comment";
+
+// Write the assignment columns of one row, without a trailing newline.
+static void writeAssignmentFields(const Assignment &assignment, std::ostream &out){
+    const auto &dims = assignment.boatDimensions();
+    
+    int lengthFeet = dims.lengthInches() / 12;
+    int lengthInches = dims.lengthInches() % 12;
+    int widthFeet = dims.widthInches() / 12;
+    int widthInches = dims.widthInches() % 12;
+    
+    out << assignment.memberId() << ","
+        << assignment.slipId() << ","
+        << Assignment::statusToString(assignment.status()) << ","
+        << Member::dockStatusToString(assignment.dockStatus()) << ","
+        << lengthFeet << ","
+        << lengthInches << ","
+        << widthFeet << ","
+        << widthInches << ",";
+    
+    if (assignment.price() > 0.0){
+        out << std::fixed << std::setprecision(2) << assignment.price();
+    }
+    
+    out << "," << (assignment.upgraded() ? "true" : "false")
+        << "," << quoteCsvField(assignment.comment());
+}
+
 void CsvParser::writeAssignments(const std::vector<Assignment> &assignments, std::ostream &out){
-    out << "member_id,assigned_slip,status,dock_status,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,price,upgraded,comment\n";
+    out << ASSIGNMENT_HEADER << "\n";
     
     for (const auto &assignment : assignments){
-        const auto &dims = assignment.boatDimensions();
+        writeAssignmentFields(assignment, out);
+        out << "\n";
+    }
+}
+
+void CsvParser::writeChanges(const AssignmentDiff &diff, std::ostream &out){
+    out << ASSIGNMENT_HEADER << ",change,previous_slip,previous_status,previous_price\n";
+    
+    for (const auto &change : diff.changes()){
+        if (change.current()){
+            writeAssignmentFields(*change.current(), out);
+        }
+        else{
+            // Removed members only exist in the previous file
+            out << change.previous()->memberId() << ",,,,,,,,,,";
+        }
         
-        int lengthFeet = dims.lengthInches() / 12;
-        int lengthInches = dims.lengthInches() % 12;
-        int widthFeet = dims.widthInches() / 12;
-        int widthInches = dims.widthInches() % 12;
+        out << "," << AssignmentChange::kindToString(change.kind()) << ",";
         
-        out << assignment.memberId() << ","
-            << assignment.slipId() << ","
-            << Assignment::statusToString(assignment.status()) << ","
-            << Member::dockStatusToString(assignment.dockStatus()) << ","
-            << lengthFeet << ","
-            << lengthInches << ","
-            << widthFeet << ","
-            << widthInches << ",";
+        if (change.previous()){
+            out << change.previous()->slipId() << ","
+                << change.previous()->status() << ",";
+            
+            if (change.previous()->price() > 0.0){
+                out << std::fixed << std::setprecision(2) << change.previous()->price();
+            }
+        }
+        else{
+            out << ",";
+        }
+        
+        out << "\n";
+    }
+}
+
+void CsvParser::writeBookings(const std::vector<Booking> &bookings, std::ostream &out){
+    out << "request_id,assigned_slip,arrive,depart,nights\n";
+    
+    for (const auto &booking : bookings){
+        out << booking.holder() << ","
+            << booking.slipId() << ","
+            << DateRange::formatDate(booking.dates().from()) << ","
+            << DateRange::formatDate(booking.dates().to()) << ","
+            << booking.dates().days() << "\n";
+    }
+}
+
+void CsvParser::writeForecasts(const std::vector<WaitForecast> &forecasts, std::ostream &out){
+    out << "member_id,p50_seasons,p75_seasons,p90_seasons,placed_share\n";
+    
+    for (const auto &forecast : forecasts){
+        out << forecast.mMemberId;
         
-        if (assignment.price() > 0.0){
-            out << std::fixed << std::setprecision(2) << assignment.price();
+        for (double share : { 0.5, 0.75, 0.9 }){
+            unsigned season = forecast.percentile(share);
+            out << ",";
+            
+            if (season == 0){
+                out << ">" << forecast.mPlacedIn.size();
+            }
+            else{
+                out << season;
+            }
         }
         
-        out << "," << (assignment.upgraded() ? "true" : "false")
-            << "," << quoteCsvField(assignment.comment()) << "\n";
+        out << "," << std::fixed << std::setprecision(3) << forecast.placedShare() << "\n";
+    }
+}
+
+void CsvParser::writePlacements(const std::vector<FederationPlacement> &placements, std::ostream &out){
+    out << "member_id,home_marina,marina,assigned_slip\n";
+    
+    for (const auto &placement : placements){
+        out << placement.mMemberId << ","
+            << placement.mHome << ","
+            << placement.mMarina << ","
+            << placement.mSlipId << "\n";
     }
 }
@@ -4,19 +4,75 @@
 #include "member.hpp"
 #include "slip.hpp"
 #include "assignment.hpp"
+#include "assignment_diff.hpp"
+#include "booking_calendar.hpp"
+#include "pricing.hpp"
+#include "waitlist_forecast.hpp"
+#include "federation.hpp"
 #include <vector>
 #include <string>
+#include <istream>
 #include <ostream>
 
 class CsvParser {
     static void writeAssignments(const std::vector<Assignment> &assignments, std::ostream &out);
+    static void writeChanges(const AssignmentDiff &diff, std::ostream &out);
+    static void writeBookings(const std::vector<Booking> &bookings, std::ostream &out);
+    static void writeForecasts(const std::vector<WaitForecast> &forecasts, std::ostream &out);
+    static void writePlacements(const std::vector<FederationPlacement> &placements, std::ostream &out);
 
 public:
+    // File overloads detect gzip/zstd input from magic bytes and stream-decompress it
     static std::vector<Member> parseMembers(const std::string &filename);
     static std::vector<Slip> parseSlips(const std::string &filename);
+    static std::vector<Member> parseMembers(std::istream &in);
+    static std::vector<Slip> parseSlips(std::istream &in);
+    
+    // Read a previously written assignment file. Only member_id, assigned_slip
+    // and status are required; price is optional, so older files can be read.
+    static std::vector<AssignmentRecord> parsePreviousAssignments(const std::string &filename);
+    
+    // Read an assignment file back as assignments, for re-pricing without
+    // rerunning the engine. Slip dimensions are not in the file and are
+    // left at zero; prices are kept as written until re-priced.
+    static std::vector<Assignment> parseAssignments(const std::string &filename);
+    static std::vector<Assignment> parseAssignments(std::istream &in);
+    
+    // Rate table rows: rule,key,value. Rules are base (no key; rate per sq
+    // ft), length (key: minimum boat length in feet; rate per sq ft), dock
+    // (key: dock; multiplier), amenity (key: amenity list; flat surcharge
+    // when the slip has them all) and status (key: dock status as in the
+    // member file; percentage discount). Unknown rules and keys throw
+    // std::invalid_argument.
+    static RateTable parseRateTable(const std::string &filename);
+    static RateTable parseRateTable(std::istream &in);
+    
+    // Transient requests: request_id, boat dimensions, arrive and depart
+    // (YYYY-MM-DD, departure day not included), with optional draft and
+    // required_amenities columns as in the member file
+    static std::vector<BookingRequest> parseBookingRequests(const std::string &filename);
+    static std::vector<BookingRequest> parseBookingRequests(std::istream &in);
     
     // Stream output operator for writing assignments to any output stream
     friend std::ostream& operator<<(std::ostream &out, const std::vector<Assignment> &assignments);
+    
+    // Stream output operator for writing a diff; assignment columns followed by
+    // change, previous_slip, previous_status and previous_price
+    friend std::ostream& operator<<(std::ostream &out, const AssignmentDiff &diff);
+    
+    // Stream output operator for writing transient bookings; unbooked
+    // requests have an empty assigned_slip
+    friend std::ostream& operator<<(std::ostream &out, const std::vector<Booking> &bookings);
+    
+    // Stream output operator for writing waiting-time forecasts: the season
+    // by which the member had a slip in half, three quarters and nine tenths
+    // of trials (">N" past the last season), and the share of trials in
+    // which they got one at all
+    friend std::ostream& operator<<(std::ostream &out, const std::vector<WaitForecast> &forecasts);
+    
+    // Stream output operator for writing federation placements: each boat's
+    // home marina and the marina and slip it was placed in
+    friend std::ostream& operator<<(std::ostream &out, const std::vector<FederationPlacement> &placements);
 };
 
 // Inline definition of operator<< 
@@ -25,4 +81,24 @@ inline std::ostream& operator<<(std::ostream &out, const std::vector<Assignment>
     return out;
 }
 
+inline std::ostream& operator<<(std::ostream &out, const AssignmentDiff &diff) {
+    CsvParser::writeChanges(diff, out);
+    return out;
+}
+
+inline std::ostream& operator<<(std::ostream &out, const std::vector<Booking> &bookings) {
+    CsvParser::writeBookings(bookings, out);
+    return out;
+}
+
+inline std::ostream& operator<<(std::ostream &out, const std::vector<WaitForecast> &forecasts) {
+    CsvParser::writeForecasts(forecasts, out);
+    return out;
+}
+
+inline std::ostream& operator<<(std::ostream &out, const std::vector<FederationPlacement> &placements) {
+    CsvParser::writePlacements(placements, out);
+    return out;
+}
+
 #endif
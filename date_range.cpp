@@ -0,0 +1,71 @@
+#include "date_range.hpp"
+#include <cstdio>
+#include <stdexcept>
+
+// Days from 1970-01-01 to a proleptic Gregorian date. Years are shifted to
+// start in March so the leap day falls at the end of the year.
+static int daysFromCivil(int year, int month, int day){
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+static int daysInMonth(int year, int month){
+    static const int DAYS[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : DAYS[month - 1];
+}
+
+DateRange::DateRange(int fromDay, int toDay)
+    : mFrom(fromDay), mTo(toDay){
+    if (toDay <= fromDay){
+        throw std::invalid_argument("Invalid date range: " + formatDate(fromDay) + ".." + formatDate(toDay));
+    }
+}
+
+DateRange DateRange::parse(const std::string &range){
+    size_t separator = range.find("..");
+    
+    if (separator == std::string::npos){
+        throw std::invalid_argument("Invalid date range: " + range);
+    }
+    
+    return DateRange(parseDate(range.substr(0, separator)), parseDate(range.substr(separator + 2)));
+}
+
+int DateRange::parseDate(const std::string &date){
+    int year, month, day;
+    char extra;
+    
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-' ||
+        std::sscanf(date.c_str(), "%4d-%2d-%2d%c", &year, &month, &day, &extra) != 3 ||
+        month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)){
+        throw std::invalid_argument("Invalid date: " + date);
+    }
+    
+    return daysFromCivil(year, month, day);
+}
+
+std::string DateRange::formatDate(int day){
+    day += 719468;
+    int era = (day >= 0 ? day : day - 146096) / 146097;
+    int dayOfEra = day - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int shiftedMonth = (5 * dayOfYear + 2) / 153;
+    int dayOfMonth = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    int month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    int year = yearOfEra + era * 400 + (month <= 2);
+    
+    // Room for three ints of any value, such as -2147483648, two dashes and the terminator
+    char text[3 * 11 + 2 + 1];
+    std::snprintf(text, sizeof(text), "%04d-%02d-%02d", year, month, dayOfMonth);
+    return text;
+}
+
+std::string DateRange::toString() const{
+    return formatDate(mFrom) + ".." + formatDate(mTo);
+}
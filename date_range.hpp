@@ -0,0 +1,38 @@
+#ifndef DATE_RANGE_H
+#define DATE_RANGE_H
+
+#include <string>
+
+// A half-open range of calendar days [from, to), for bookings and the days
+// a member's boat is away from its slip.
+//
+// Days are counted from 1970-01-01 so ranges compare and overlap with
+// plain integer arithmetic; dates are only parsed and formatted at the
+// edges, as YYYY-MM-DD.
+class DateRange {
+    int mFrom;
+    int mTo;
+
+public:
+    // Throws std::invalid_argument unless from is before to
+    DateRange(int fromDay, int toDay);
+    
+    int from() const{ return mFrom; }
+    int to() const{ return mTo; }
+    int days() const{ return mTo - mFrom; }
+    
+    bool overlaps(const DateRange &other) const{ return mFrom < other.mTo && other.mFrom < mTo; }
+    bool contains(const DateRange &other) const{ return mFrom <= other.mFrom && other.mTo <= mTo; }
+    
+    // Parse "YYYY-MM-DD..YYYY-MM-DD"; the second date is the first day not included
+    static DateRange parse(const std::string &range);
+    
+    // Day number of a YYYY-MM-DD date. Throws std::invalid_argument for a
+    // malformed or impossible date.
+    static int parseDate(const std::string &date);
+    static std::string formatDate(int day);
+    
+    std::string toString() const;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#include "decision_log.hpp"
+
+void DecisionLog::reset(size_t memberCount){
+    mEntries.clear();
+    mLastEntry.assign(memberCount, NONE);
+}
+
+void DecisionLog::record(Event event, uint32_t member, uint32_t slip, uint32_t other, int phase, int pass){
+    uint32_t last = mLastEntry[member];
+
+    if (last != NONE){
+        const Entry &previous = mEntries[last];
+
+        if (previous.mEvent == event && previous.mSlip == slip && previous.mOther == other){
+            return;
+        }
+    }
+
+    mLastEntry[member] = static_cast<uint32_t>(mEntries.size());
+    mEntries.push_back({ member, slip, other, event, static_cast<uint8_t>(phase), static_cast<uint16_t>(pass) });
+}
+
+std::vector<DecisionLog::Entry> DecisionLog::entriesForMember(uint32_t member) const{
+    std::vector<Entry> result;
+
+    for (const auto &entry : mEntries){
+        if (entry.mMember == member){
+            result.push_back(entry);
+        }
+    }
+
+    return result;
+}
+
+std::string DecisionLog::eventToString(Event event){
+    switch (event){
+        case Event::PERMANENT_LOCKED:
+            return "locked into designated slip";
+        case Event::PERMANENT_NO_SLIP:
+            return "permanent member has no designated slip";
+        case Event::YEAR_OFF:
+            return "year off - not assigned";
+        case Event::CURRENT_SLIP_MISSING:
+            return "current slip no longer exists";
+        case Event::CURRENT_SLIP_TOO_SMALL:
+            return "boat does not fit current slip";
+        case Event::CURRENT_SLIP_LACKS_AMENITIES:
+            return "current slip lacks a required amenity";
+        case Event::CURRENT_SLIP_BLOCKED:
+            return "current slip held by member who cannot be evicted";
+        case Event::BEST_FIT_BLOCKED:
+            return "best-fit slip occupied, member cannot evict";
+        case Event::NO_CANDIDATE:
+            return "no fitting slip is free or evictable";
+        case Event::EVICTED:
+            return "evicted occupant";
+        case Event::WAS_EVICTED:
+            return "evicted";
+        case Event::ASSIGNED:
+            return "assigned";
+        case Event::IMPROVED:
+            return "moved by improvement pass";
+        case Event::REVENUE:
+            return "moved by revenue pass";
+    }
+    return "unknown";
+}
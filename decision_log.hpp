@@ -0,0 +1,64 @@
+#ifndef DECISION_LOG_H
+#define DECISION_LOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compact record of the decisions made during AssignmentEngine::assign().
+//
+// Entries refer to members and slips by their index in the engine's input
+// vectors, so each entry is 16 bytes and recording is a single push_back.
+// The log is only filled when decision recording is enabled on the engine;
+// it is turned into readable text on demand by AssignmentEngine::explain().
+class DecisionLog {
+public:
+    enum class Event : uint8_t {
+        PERMANENT_LOCKED,       // Permanent member locked into designated slip
+        PERMANENT_NO_SLIP,      // Permanent member without an existing designated slip
+        YEAR_OFF,               // Year-off member skipped
+        CURRENT_SLIP_MISSING,   // Current slip ID not in slip list
+        CURRENT_SLIP_TOO_SMALL, // Boat does not fit current slip
+        CURRENT_SLIP_LACKS_AMENITIES, // Current slip lacks a required amenity
+        CURRENT_SLIP_BLOCKED,   // Current slip held by someone who cannot be evicted
+        BEST_FIT_BLOCKED,       // Best fit occupied and member cannot evict
+        NO_CANDIDATE,           // No fitting slip is free or evictable
+        EVICTED,                // Member evicted other from slip
+        WAS_EVICTED,            // Member was evicted from slip by other
+        ASSIGNED,               // Member assigned to slip
+        IMPROVED,               // Member moved into slip by the improvement pass
+        REVENUE                 // Member moved into slip by the revenue pass
+    };
+
+    static constexpr uint32_t NONE = 0xffffffffu;
+
+    struct Entry {
+        uint32_t mMember;
+        uint32_t mSlip;
+        uint32_t mOther;
+        Event mEvent;
+        uint8_t mPhase;
+        uint16_t mPass;
+    };
+
+private:
+    std::vector<Entry> mEntries;
+    std::vector<uint32_t> mLastEntry;
+
+public:
+    // Size the per-member bookkeeping; also discards previous entries
+    void reset(size_t memberCount);
+
+    // Record an event unless it repeats the member's previous entry, which
+    // happens when an unassigned member is retried in later passes
+    void record(Event event, uint32_t member, uint32_t slip, uint32_t other, int phase, int pass);
+
+    const std::vector<Entry> &entries() const{ return mEntries; }
+
+    // Entries recorded for a member, in the order they happened
+    std::vector<Entry> entriesForMember(uint32_t member) const;
+
+    static std::string eventToString(Event event);
+};
+
+#endif
@@ -2,16 +2,26 @@
 
 Dimensions::Dimensions(int feetLength, int inchesLength, int feetWidth, int inchesWidth)
     : mLengthInches(feetLength * 12 + inchesLength),
-      mWidthInches(feetWidth * 12 + inchesWidth){
+      mWidthInches(feetWidth * 12 + inchesWidth),
+      mDraftInches(0),
+      mAirDraftInches(0){
 }
 
 bool Dimensions::fitsIn(const Dimensions &container) const{
     return mLengthInches <= container.mLengthInches && 
-           mWidthInches <= container.mWidthInches;
+           mWidthInches <= container.mWidthInches &&
+           fitsInVertically(container);
 }
 
+// Length is ignored, but depth and clearance still apply
 bool Dimensions::fitsInWidthOnly(const Dimensions &container) const{
-    return mWidthInches <= container.mWidthInches;
+    return mWidthInches <= container.mWidthInches &&
+           fitsInVertically(container);
+}
+
+bool Dimensions::fitsInVertically(const Dimensions &container) const{
+    return (container.mDraftInches == 0 || mDraftInches <= container.mDraftInches) &&
+           (container.mAirDraftInches == 0 || mAirDraftInches <= container.mAirDraftInches);
 }
 
 int Dimensions::lengthDifferenceInches(const Dimensions &container) const{
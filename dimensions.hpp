@@ -4,15 +4,26 @@
 class Dimensions {
     int mLengthInches;
     int mWidthInches;
+    // Depth below and height above the waterline; 0 when not given. For a
+    // slip these are the water depth and overhead clearance, and 0 means
+    // unrestricted.
+    int mDraftInches;
+    int mAirDraftInches;
 
 public:
     Dimensions(int feetLength, int inchesLength, int feetWidth, int inchesWidth);
     
     int lengthInches() const{ return mLengthInches; }
     int widthInches() const{ return mWidthInches; }
+    int draftInches() const{ return mDraftInches; }
+    int airDraftInches() const{ return mAirDraftInches; }
+    
+    void setDraftInches(int draftInches){ mDraftInches = draftInches; }
+    void setAirDraftInches(int airDraftInches){ mAirDraftInches = airDraftInches; }
     
     bool fitsIn(const Dimensions &container) const;
     bool fitsInWidthOnly(const Dimensions &container) const;
+    bool fitsInVertically(const Dimensions &container) const;
     int lengthDifferenceInches(const Dimensions &container) const;
 };
 
@@ -0,0 +1,836 @@
+#include "federation.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Every message is a type and a payload length, then the payload. Numbers
+// are in host byte order: workers and coordinator share a machine.
+enum MessageType : uint32_t {
+    FAILED = 0,
+    HELLO = 1,
+    OVERFLOW_BOATS = 2,
+    OFFERS = 3,
+    CLAIMS = 4,
+    STOP = 5
+};
+
+namespace {
+
+class WireWriter {
+    std::string mBuffer;
+
+    void put(const void *data, size_t size){ mBuffer.append(static_cast<const char *>(data), size); }
+
+public:
+    void u32(uint32_t value){ put(&value, sizeof(value)); }
+    void i32(int32_t value){ put(&value, sizeof(value)); }
+    void i64(int64_t value){ put(&value, sizeof(value)); }
+
+    void text(const std::string &value){
+        u32(static_cast<uint32_t>(value.size()));
+        put(value.data(), value.size());
+    }
+
+    void boat(const Dimensions &boat, Amenities::Mask required){
+        i32(boat.lengthInches());
+        i32(boat.widthInches());
+        i32(boat.draftInches());
+        i32(boat.airDraftInches());
+        u32(required);
+    }
+
+    const std::string &bytes() const{ return mBuffer; }
+};
+
+class WireReader {
+    const std::string &mBuffer;
+    size_t mOffset;
+
+    void get(void *data, size_t size){
+        if (mBuffer.size() - mOffset < size){
+            throw std::runtime_error("Federation message is truncated");
+        }
+
+        std::memcpy(data, mBuffer.data() + mOffset, size);
+        mOffset += size;
+    }
+
+public:
+    explicit WireReader(const std::string &buffer)
+        : mBuffer(buffer), mOffset(0){
+    }
+
+    uint32_t u32(){ uint32_t value; get(&value, sizeof(value)); return value; }
+    int32_t i32(){ int32_t value; get(&value, sizeof(value)); return value; }
+    int64_t i64(){ int64_t value; get(&value, sizeof(value)); return value; }
+
+    std::string text(){
+        uint32_t size = u32();
+
+        if (mBuffer.size() - mOffset < size){
+            throw std::runtime_error("Federation message is truncated");
+        }
+
+        std::string value = mBuffer.substr(mOffset, size);
+        mOffset += size;
+        return value;
+    }
+
+    Dimensions boat(Amenities::Mask &required){
+        int length = i32();
+        int width = i32();
+        Dimensions boat(0, length, 0, width);
+        boat.setDraftInches(i32());
+        boat.setAirDraftInches(i32());
+        required = u32();
+        return boat;
+    }
+};
+
+}
+
+static void sendAll(int fd, const char *data, size_t size){
+    while (size > 0){
+        ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+
+        if (sent < 0 && errno == EINTR){
+            continue;
+        }
+
+        if (sent < 0){
+            throw std::runtime_error(std::string("Federation socket write failed: ") + std::strerror(errno));
+        }
+
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+}
+
+// False when the peer closed the connection before any of the bytes
+static bool receiveAll(int fd, char *data, size_t size){
+    size_t received = 0;
+
+    while (received < size){
+        ssize_t count = ::recv(fd, data + received, size - received, 0);
+
+        if (count < 0 && errno == EINTR){
+            continue;
+        }
+
+        if (count < 0){
+            throw std::runtime_error(std::string("Federation socket read failed: ") + std::strerror(errno));
+        }
+
+        if (count == 0){
+            if (received == 0){
+                return false;
+            }
+
+            throw std::runtime_error("Federation connection closed mid-message");
+        }
+
+        received += static_cast<size_t>(count);
+    }
+
+    return true;
+}
+
+static void sendMessage(int fd, uint32_t type, const std::string &payload){
+    uint32_t header[2] = { type, static_cast<uint32_t>(payload.size()) };
+    std::string message(reinterpret_cast<const char *>(header), sizeof(header));
+    message += payload;
+    sendAll(fd, message.data(), message.size());
+}
+
+static bool receiveMessage(int fd, uint32_t &type, std::string &payload){
+    uint32_t header[2];
+
+    if (!receiveAll(fd, reinterpret_cast<char *>(header), sizeof(header))){
+        return false;
+    }
+
+    type = header[0];
+    payload.resize(header[1]);
+
+    if (header[1] > 0 && !receiveAll(fd, &payload[0], header[1])){
+        throw std::runtime_error("Federation connection closed mid-message");
+    }
+
+    return true;
+}
+
+static sockaddr_un socketAddress(const std::string &path){
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (path.size() >= sizeof(address.sun_path)){
+        throw std::runtime_error("Federation socket path is too long: " + path);
+    }
+
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+// Same order as AssignmentEngine::getDockStatusPriority()
+static int dockStatusTier(Member::DockStatus status){
+    switch (status){
+        case Member::DockStatus::PERMANENT:
+            return 0;
+        case Member::DockStatus::WAITING_LIST:
+            return 1;
+        case Member::DockStatus::TEMPORARY:
+            return 2;
+        case Member::DockStatus::UNASSIGNED:
+            return 3;
+        case Member::DockStatus::YEAR_OFF:
+            return 4;
+    }
+    return 999;
+}
+
+bool FreeSlipEnvelope::admits(const Dimensions &boat, Amenities::Mask required, bool widthOnly) const{
+    if (!Amenities::provides(mAmenities, required) || (mDraftInches != 0 && boat.draftInches() > mDraftInches) ||
+        (mAirDraftInches != 0 && boat.airDraftInches() > mAirDraftInches)){
+        return false;
+    }
+
+    // The narrowest width that still takes the boat has the longest slips
+    for (size_t i = mWidthLengths.size(); i-- > 0;){
+        if (mWidthLengths[i].first >= boat.widthInches()){
+            return widthOnly || mWidthLengths[i].second >= boat.lengthInches();
+        }
+    }
+
+    return false;
+}
+
+FederationWorker::FederationWorker(const std::string &name, const AssignmentEngine &engine,
+                                   const std::vector<Assignment> &assignments, bool ignoreLength)
+    : mName(name), mIgnoreLength(ignoreLength){
+    std::unordered_set<std::string> occupied;
+    std::unordered_map<std::string, const Member *> members;
+
+    for (const auto &member : engine.members()){
+        members.emplace(member.id(), &member);
+    }
+
+    for (const auto &assignment : assignments){
+        if (assignment.assigned()){
+            occupied.insert(assignment.slipId());
+            continue;
+        }
+
+        auto member = members.find(assignment.memberId());
+
+        if (assignment.dockStatus() == Member::DockStatus::YEAR_OFF || member == members.end()){
+            continue;
+        }
+
+        OverflowBoat boat;
+        boat.mMemberId = assignment.memberId();
+        boat.mHome = name;
+        boat.mBoat = member->second->boatDimensions();
+        boat.mRequired = member->second->requiredAmenities();
+        boat.mTier = dockStatusTier(assignment.dockStatus());
+        mOverflow.push_back(boat);
+    }
+
+    for (const auto &slip : engine.slips()){
+        if (occupied.count(slip.id()) == 0 && mPositions.emplace(slip.id(), static_cast<uint32_t>(mFreeSlips.size())).second){
+            mFreeSlips.push_back(slip);
+        }
+    }
+
+    std::vector<uint32_t> positions(mFreeSlips.size());
+
+    for (uint32_t i = 0; i < positions.size(); ++i){
+        positions[i] = i;
+    }
+
+    mIndex = SlipIndex(mFreeSlips, std::move(positions));
+    mTaken.assign(mFreeSlips.size(), false);
+}
+
+std::vector<std::pair<std::string, long long>> FederationWorker::candidates(const Dimensions &boat,
+                                                                            Amenities::Mask required,
+                                                                            size_t count) const{
+    // Slip area left over, then position
+    std::vector<std::pair<long long, uint32_t>> found;
+    long long boatArea = static_cast<long long>(boat.lengthInches()) * boat.widthInches();
+
+    auto area = [this](uint32_t position){
+        const Dimensions &limits = mFreeSlips[position].maxDimensions();
+        return static_cast<long long>(limits.lengthInches()) * limits.widthInches();
+    };
+
+    auto fits = [&](uint32_t position){
+        return mIgnoreLength ? mFreeSlips[position].fitsWidthOnly(boat) : mFreeSlips[position].fits(boat);
+    };
+
+    for (const auto &group : mIndex.groups()){
+        if (!group.admits(boat, required)){
+            continue;
+        }
+
+        size_t kept = 0;
+
+        // Best-fit order is by area, so the first fitting slips are this group's best
+        for (size_t i = mIgnoreLength ? 0 : group.firstWithArea(boatArea); i < group.mBestFitOrder.size() && kept < count; ++i){
+            uint32_t position = group.mBestFitOrder[i];
+
+            if (!mTaken[position] && group.provides(mFreeSlips[position].amenities(), required) && fits(position)){
+                found.emplace_back(area(position) - boatArea, position);
+                ++kept;
+            }
+        }
+    }
+
+    // An empty shared slip takes the boat whole
+    for (uint32_t position : mIndex.sharedPositions()){
+        const Slip &slip = mFreeSlips[position];
+
+        if (!mTaken[position] && Amenities::provides(slip.amenities(), required) && fits(position)){
+            found.emplace_back(area(position) - boatArea, position);
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    found.resize(std::min(found.size(), count));
+
+    std::vector<std::pair<std::string, long long>> result;
+
+    for (const auto &candidate : found){
+        result.emplace_back(mFreeSlips[candidate.second].id(), candidate.first);
+    }
+
+    return result;
+}
+
+std::vector<FreeSlipEnvelope> FederationWorker::summary() const{
+    std::vector<FreeSlipEnvelope> envelopes;
+
+    for (const auto &group : mIndex.groups()){
+        FreeSlipEnvelope envelope;
+        envelope.mDraftInches = group.mDraftInches;
+        envelope.mAirDraftInches = group.mAirDraftInches;
+        envelope.mAmenities = group.mAmenities;
+
+        // A width is only worth sending where its slips are longer than any
+        // wider one; equal widths share the last entry, which covers them all
+        for (size_t i = 0; i < group.mWidthsDescending.size(); ++i){
+            if (i + 1 < group.mWidthsDescending.size() && group.mWidthsDescending[i + 1] == group.mWidthsDescending[i]){
+                continue;
+            }
+
+            if (envelope.mWidthLengths.empty() || group.mLongestAtWidth[i] > envelope.mWidthLengths.back().second){
+                envelope.mWidthLengths.emplace_back(group.mWidthsDescending[i], group.mLongestAtWidth[i]);
+            }
+        }
+
+        envelopes.push_back(std::move(envelope));
+    }
+
+    for (uint32_t position : mIndex.sharedPositions()){
+        const Slip &slip = mFreeSlips[position];
+        FreeSlipEnvelope envelope;
+        envelope.mDraftInches = slip.maxDimensions().draftInches();
+        envelope.mAirDraftInches = slip.maxDimensions().airDraftInches();
+        envelope.mAmenities = slip.amenities();
+        envelope.mWidthLengths.emplace_back(slip.maxDimensions().widthInches(), slip.maxDimensions().lengthInches());
+        envelopes.push_back(std::move(envelope));
+    }
+
+    return envelopes;
+}
+
+bool FederationWorker::claim(const std::string &slipId){
+    auto it = mPositions.find(slipId);
+
+    if (it == mPositions.end() || mTaken[it->second]){
+        return false;
+    }
+
+    mTaken[it->second] = true;
+    return true;
+}
+
+void FederationWorker::serve(const std::string &socketPath){
+    sockaddr_un address = socketAddress(socketPath);
+    int listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (listener < 0){
+        throw std::runtime_error(std::string("Cannot create federation socket: ") + std::strerror(errno));
+    }
+
+    ::unlink(socketPath.c_str());
+
+    if (::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(listener, 8) != 0){
+        int error = errno;
+        ::close(listener);
+        throw std::runtime_error("Cannot listen on federation socket '" + socketPath + "': " + std::strerror(error));
+    }
+
+    bool stopping = false;
+
+    while (!stopping){
+        int fd = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+
+        if (fd < 0){
+            if (errno == EINTR || errno == ECONNABORTED){
+                continue;
+            }
+
+            int error = errno;
+            ::close(listener);
+            throw std::runtime_error(std::string("Federation accept failed: ") + std::strerror(error));
+        }
+
+        // A coordinator that goes away ends its session, not the worker
+        try{
+            uint32_t type;
+            std::string payload;
+
+            while (!stopping && receiveMessage(fd, type, payload)){
+                WireReader in(payload);
+                WireWriter out;
+
+                try{
+                    switch (type){
+                        case HELLO: {
+                            std::vector<FreeSlipEnvelope> envelopes = summary();
+                            out.text(mName);
+                            out.u32(static_cast<uint32_t>(mFreeSlips.size()));
+                            out.u32(static_cast<uint32_t>(mOverflow.size()));
+                            out.u32(mIgnoreLength ? 1 : 0);
+                            out.u32(static_cast<uint32_t>(envelopes.size()));
+
+                            for (const auto &envelope : envelopes){
+                                out.i32(envelope.mDraftInches);
+                                out.i32(envelope.mAirDraftInches);
+                                out.u32(envelope.mAmenities);
+                                out.u32(static_cast<uint32_t>(envelope.mWidthLengths.size()));
+
+                                for (const auto &widthLength : envelope.mWidthLengths){
+                                    out.i32(widthLength.first);
+                                    out.i32(widthLength.second);
+                                }
+                            }
+
+                            break;
+                        }
+                        case OVERFLOW_BOATS:
+                            out.u32(static_cast<uint32_t>(mOverflow.size()));
+
+                            for (const auto &boat : mOverflow){
+                                out.text(boat.mMemberId);
+                                out.boat(boat.mBoat, boat.mRequired);
+                                out.i32(boat.mTier);
+                            }
+
+                            break;
+                        case OFFERS: {
+                            uint32_t count = in.u32();
+                            uint32_t boats = in.u32();
+                            out.u32(boats);
+
+                            for (uint32_t b = 0; b < boats; ++b){
+                                std::string home = in.text();
+                                Amenities::Mask required;
+                                Dimensions boat = in.boat(required);
+
+                                // A boat's own marina already had no room for it
+                                auto offers = home == mName ? std::vector<std::pair<std::string, long long>>()
+                                                            : candidates(boat, required, count);
+                                out.u32(static_cast<uint32_t>(offers.size()));
+
+                                for (const auto &offer : offers){
+                                    out.text(offer.first);
+                                    out.i64(offer.second);
+                                }
+                            }
+
+                            break;
+                        }
+                        case CLAIMS: {
+                            uint32_t claims = in.u32();
+                            out.u32(claims);
+
+                            for (uint32_t c = 0; c < claims; ++c){
+                                out.u32(claim(in.text()) ? 1 : 0);
+                            }
+
+                            break;
+                        }
+                        case STOP:
+                            stopping = true;
+                            break;
+                        default:
+                            throw std::runtime_error("Unknown federation message " + std::to_string(type));
+                    }
+                }
+                catch (const std::runtime_error &e){
+                    WireWriter failure;
+                    failure.text(e.what());
+                    sendMessage(fd, FAILED, failure.bytes());
+                    continue;
+                }
+
+                sendMessage(fd, type, out.bytes());
+            }
+        }
+        catch (const std::runtime_error &){
+        }
+
+        ::close(fd);
+    }
+
+    ::close(listener);
+    ::unlink(socketPath.c_str());
+}
+
+FederationCoordinator::FederationCoordinator(std::vector<std::string> socketPaths)
+    : mSocketPaths(std::move(socketPaths)), mCandidates(8), mConnectTimeoutMs(5000){
+    if (mSocketPaths.empty()){
+        throw std::invalid_argument("Invalid federation: needs at least one worker socket");
+    }
+}
+
+void FederationCoordinator::setCandidates(unsigned candidates){
+    if (candidates == 0){
+        throw std::invalid_argument("Invalid federation: needs at least one candidate per boat");
+    }
+
+    mCandidates = candidates;
+}
+
+// Connect to a worker, retrying while it is still starting up
+static int connectWorker(const std::string &path, int timeoutMs){
+    sockaddr_un address = socketAddress(path);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    for (;;){
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+        if (fd < 0){
+            throw std::runtime_error(std::string("Cannot create federation socket: ") + std::strerror(errno));
+        }
+
+        if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0){
+            return fd;
+        }
+
+        int error = errno;
+        ::close(fd);
+
+        if ((error != ENOENT && error != ECONNREFUSED) || std::chrono::steady_clock::now() >= deadline){
+            throw std::runtime_error("Cannot reach federation worker '" + path + "': " + std::strerror(error));
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+}
+
+std::vector<FederationPlacement> FederationCoordinator::run(){
+    std::vector<int> workers;
+
+    auto closeAll = [&](){
+        for (int fd : workers){
+            ::close(fd);
+        }
+    };
+
+    // Send one request to each of some workers, then read the replies
+    auto exchange = [&](const std::vector<size_t> &targets, uint32_t type, const std::vector<std::string> &payloads){
+        std::vector<std::string> replies(workers.size());
+
+        for (size_t w : targets){
+            sendMessage(workers[w], type, payloads[w]);
+        }
+
+        for (size_t w : targets){
+            uint32_t replyType;
+
+            if (!receiveMessage(workers[w], replyType, replies[w])){
+                throw std::runtime_error("Federation worker '" + mSocketPaths[w] + "' closed the connection");
+            }
+
+            if (replyType == FAILED){
+                WireReader in(replies[w]);
+                throw std::runtime_error("Federation worker '" + mSocketPaths[w] + "': " + in.text());
+            }
+        }
+
+        return replies;
+    };
+
+    std::vector<FederationPlacement> placements;
+
+    try{
+        for (const auto &path : mSocketPaths){
+            workers.push_back(connectWorker(path, mConnectTimeoutMs));
+        }
+
+        std::vector<size_t> everyone(workers.size());
+
+        for (size_t w = 0; w < workers.size(); ++w){
+            everyone[w] = w;
+        }
+
+        std::vector<std::string> names;
+        std::vector<std::string> empty(workers.size());
+        // Each worker's free slips, as its summary describes them
+        std::vector<std::vector<FreeSlipEnvelope>> summaries;
+        std::vector<bool> widthOnly;
+
+        for (const auto &reply : exchange(everyone, HELLO, empty)){
+            WireReader in(reply);
+            std::string name = in.text();
+
+            if (std::find(names.begin(), names.end(), name) != names.end()){
+                throw std::runtime_error("Two federation workers are named " + name);
+            }
+
+            names.push_back(name);
+            in.u32();
+            in.u32();
+            widthOnly.push_back(in.u32() != 0);
+            summaries.emplace_back(in.u32());
+
+            for (auto &envelope : summaries.back()){
+                envelope.mDraftInches = in.i32();
+                envelope.mAirDraftInches = in.i32();
+                envelope.mAmenities = in.u32();
+                envelope.mWidthLengths.resize(in.u32());
+
+                for (auto &widthLength : envelope.mWidthLengths){
+                    widthLength.first = in.i32();
+                    widthLength.second = in.i32();
+                }
+            }
+        }
+
+        // Every marina's overflow, in priority order
+        std::vector<OverflowBoat> boats;
+        std::vector<size_t> homes;
+        std::vector<std::string> overflowReplies = exchange(everyone, OVERFLOW_BOATS, empty);
+
+        for (size_t w = 0; w < workers.size(); ++w){
+            WireReader in(overflowReplies[w]);
+            uint32_t count = in.u32();
+
+            for (uint32_t b = 0; b < count; ++b){
+                OverflowBoat boat;
+                boat.mMemberId = in.text();
+                boat.mHome = names[w];
+                boat.mBoat = in.boat(boat.mRequired);
+                boat.mTier = in.i32();
+                boats.push_back(boat);
+                homes.push_back(w);
+            }
+        }
+
+        std::vector<size_t> order(boats.size());
+        std::vector<size_t> rank(boats.size());
+
+        for (size_t b = 0; b < boats.size(); ++b){
+            order[b] = b;
+        }
+
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b){ return boats[a].mTier < boats[b].mTier; });
+
+        for (size_t i = 0; i < order.size(); ++i){
+            rank[order[i]] = i;
+        }
+
+        auto byRank = [&](size_t a, size_t b){ return rank[a] < rank[b]; };
+
+        // Workers worth asking about each boat: those of other marinas whose
+        // free slips may hold it. A worker that offers a boat nothing is not
+        // asked about it again, since its free slips only shrink.
+        std::vector<std::vector<size_t>> askable(boats.size());
+        std::vector<size_t> pending;
+
+        for (size_t b : order){
+            for (size_t w = 0; w < workers.size(); ++w){
+                bool admitted = std::any_of(summaries[w].begin(), summaries[w].end(), [&](const FreeSlipEnvelope &envelope){
+                    return envelope.admits(boats[b].mBoat, boats[b].mRequired, widthOnly[w]);
+                });
+
+                if (w != homes[b] && admitted){
+                    askable[b].push_back(w);
+                }
+            }
+
+            if (!askable[b].empty()){
+                pending.push_back(b);
+            }
+        }
+
+        // Placements by boat, output in priority order
+        std::vector<std::pair<size_t, FederationPlacement>> placed;
+
+        while (!pending.empty()){
+            // Each worker hears only about the pending boats it may hold
+            std::vector<std::vector<size_t>> asked(workers.size());
+
+            for (size_t i = 0; i < pending.size(); ++i){
+                for (size_t w : askable[pending[i]]){
+                    asked[w].push_back(i);
+                }
+            }
+
+            std::vector<size_t> targets;
+            std::vector<std::string> requests(workers.size());
+
+            for (size_t w = 0; w < workers.size(); ++w){
+                if (asked[w].empty()){
+                    continue;
+                }
+
+                WireWriter request;
+                request.u32(mCandidates);
+                request.u32(static_cast<uint32_t>(asked[w].size()));
+
+                for (size_t i : asked[w]){
+                    request.text(boats[pending[i]].mHome);
+                    request.boat(boats[pending[i]].mBoat, boats[pending[i]].mRequired);
+                }
+
+                requests[w] = request.bytes();
+                targets.push_back(w);
+            }
+
+            std::vector<std::string> offerReplies = exchange(targets, OFFERS, requests);
+            // Offers by pending boat, then worker
+            std::vector<std::vector<std::vector<std::pair<std::string, long long>>>> offers(
+                pending.size(), std::vector<std::vector<std::pair<std::string, long long>>>(workers.size()));
+
+            for (size_t w : targets){
+                WireReader in(offerReplies[w]);
+
+                if (in.u32() != asked[w].size()){
+                    throw std::runtime_error("Federation worker '" + mSocketPaths[w] + "' answered for the wrong boats");
+                }
+
+                for (size_t i : asked[w]){
+                    uint32_t count = in.u32();
+
+                    for (uint32_t c = 0; c < count; ++c){
+                        std::string slipId = in.text();
+                        offers[i][w].emplace_back(slipId, in.i64());
+                    }
+
+                    if (count == 0){
+                        std::vector<size_t> &ask = askable[pending[i]];
+                        ask.erase(std::find(ask.begin(), ask.end(), w));
+                    }
+                }
+            }
+
+            // Boats take the best slip not already chosen this round, in priority order
+            std::vector<std::unordered_set<std::string>> chosen(workers.size());
+            std::vector<std::vector<size_t>> claimedBoats(workers.size());
+            std::vector<WireWriter> claims(workers.size());
+            std::vector<size_t> waiting;
+
+            for (size_t i = 0; i < pending.size(); ++i){
+                size_t bestWorker = workers.size();
+                const std::pair<std::string, long long> *best = nullptr;
+                bool offered = false;
+
+                for (size_t w = 0; w < workers.size(); ++w){
+                    for (const auto &offer : offers[i][w]){
+                        offered = true;
+
+                        if (chosen[w].count(offer.first) == 0 && (!best || offer.second < best->second)){
+                            best = &offer;
+                            bestWorker = w;
+                        }
+                    }
+                }
+
+                if (best){
+                    chosen[bestWorker].insert(best->first);
+                    claimedBoats[bestWorker].push_back(pending[i]);
+                    claims[bestWorker].text(best->first);
+                }
+                else if (offered){
+                    waiting.push_back(pending[i]);
+                }
+            }
+
+            targets.clear();
+            std::vector<std::string> payloads(workers.size());
+
+            for (size_t w = 0; w < workers.size(); ++w){
+                if (!claimedBoats[w].empty()){
+                    WireWriter claim;
+                    claim.u32(static_cast<uint32_t>(claimedBoats[w].size()));
+                    payloads[w] = claim.bytes() + claims[w].bytes();
+                    targets.push_back(w);
+                }
+            }
+
+            size_t placedBefore = placed.size();
+            std::vector<std::string> claimReplies = exchange(targets, CLAIMS, payloads);
+
+            for (size_t w : targets){
+                WireReader in(claimReplies[w]);
+                WireReader sent(payloads[w]);
+                in.u32();
+                sent.u32();
+
+                for (size_t b : claimedBoats[w]){
+                    std::string slipId = sent.text();
+
+                    if (in.u32() == 0){
+                        waiting.push_back(b);
+                        continue;
+                    }
+
+                    FederationPlacement placement;
+                    placement.mMemberId = boats[b].mMemberId;
+                    placement.mHome = boats[b].mHome;
+                    placement.mMarina = names[w];
+                    placement.mSlipId = slipId;
+                    placement.mBoat = boats[b].mBoat;
+                    placed.emplace_back(b, placement);
+                }
+            }
+
+            if (placed.size() == placedBefore){
+                break;
+            }
+
+            // Refused claims rejoin in priority order
+            std::sort(waiting.begin(), waiting.end(), byRank);
+            pending = std::move(waiting);
+        }
+
+        std::sort(placed.begin(), placed.end(), [&](const std::pair<size_t, FederationPlacement> &a,
+                                                   const std::pair<size_t, FederationPlacement> &b){
+            return byRank(a.first, b.first);
+        });
+
+        for (auto &entry : placed){
+            placements.push_back(std::move(entry.second));
+        }
+
+        exchange(everyone, STOP, empty);
+    }
+    catch (...){
+        closeAll();
+        throw;
+    }
+
+    closeAll();
+    return placements;
+}
@@ -0,0 +1,134 @@
+#ifndef FEDERATION_H
+#define FEDERATION_H
+
+#include "assignment.hpp"
+#include "assignment_engine.hpp"
+#include "slip_index.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A boat its own marina could not place
+struct OverflowBoat {
+    std::string mMemberId;
+    std::string mHome;
+    Dimensions mBoat = Dimensions(0, 0, 0, 0);
+    Amenities::Mask mRequired = 0;
+    // Dock status priority, lower first, as the engine ranks it
+    int mTier = 0;
+};
+
+// An overflow boat given a free slip at another marina
+struct FederationPlacement {
+    std::string mMemberId;
+    std::string mHome;
+    std::string mMarina;
+    std::string mSlipId;
+    Dimensions mBoat = Dimensions(0, 0, 0, 0);
+};
+
+// What one fit group of a marina's free slips, or one free shared slip,
+// can hold: enough for the coordinator to tell which marinas could take a
+// boat without asking them. Claims only remove free slips, so a summary
+// taken at the start never turns away a marina that could take the boat.
+// A mixed fit group lists the amenities of all its slips, so its envelope
+// can admit a boat none of them takes; that marina then offers nothing.
+struct FreeSlipEnvelope {
+    // Depth and clearance limits, 0 = unrestricted
+    int mDraftInches = 0;
+    int mAirDraftInches = 0;
+    Amenities::Mask mAmenities = 0;
+    // Widths descending, each with the longest slip at least that wide
+    std::vector<std::pair<int, int>> mWidthLengths;
+
+    // True if some slip in the envelope may fit the boat and provide its amenities
+    bool admits(const Dimensions &boat, Amenities::Mask required, bool widthOnly) const;
+};
+
+// One marina of a federation, after its own assignment run: the slips left
+// free and the boats left without a slip.
+//
+// The free slips are indexed once with SlipIndex, so finding the best free
+// slips for a boat visits only the fit groups that admit it, from the
+// boat's own area up. Slips claimed for other marinas' boats are skipped
+// from then on.
+//
+// serve() answers a coordinator over a Unix domain socket. Requests and
+// replies are batches - every overflow boat of a round in one message - so
+// a round costs one exchange per marina however many boats it routes.
+class FederationWorker {
+    std::string mName;
+    bool mIgnoreLength;
+    std::vector<Slip> mFreeSlips;
+    SlipIndex mIndex;
+    std::vector<bool> mTaken;
+    std::unordered_map<std::string, uint32_t> mPositions;
+    std::vector<OverflowBoat> mOverflow;
+
+public:
+    // Free slips and overflow boats of an engine's result. Year-off members
+    // are not overflow.
+    FederationWorker(const std::string &name, const AssignmentEngine &engine,
+                     const std::vector<Assignment> &assignments, bool ignoreLength = false);
+
+    const std::string &name() const{ return mName; }
+    const std::vector<OverflowBoat> &overflow() const{ return mOverflow; }
+    size_t freeSlips() const{ return mFreeSlips.size(); }
+    bool ignoreLength() const{ return mIgnoreLength; }
+
+    // One envelope per fit group of the free slips and per free shared slip
+    std::vector<FreeSlipEnvelope> summary() const;
+
+    // Up to count free slips that fit the boat and provide its amenities,
+    // best fit first, with the slip area each leaves over in square inches
+    std::vector<std::pair<std::string, long long>> candidates(const Dimensions &boat, Amenities::Mask required,
+                                                              size_t count) const;
+
+    // Take a free slip for another marina's boat; false if it is taken or
+    // not free here
+    bool claim(const std::string &slipId);
+
+    // Answer coordinators on a socket at this path, one connection at a
+    // time, until one asks the worker to stop. An existing socket file at
+    // the path is replaced. Throws std::runtime_error when the socket
+    // cannot be set up.
+    void serve(const std::string &socketPath);
+};
+
+// Routes overflow boats between the marinas of a federation, each served
+// by a FederationWorker process.
+//
+// Boats go in priority order: dock status tier, then the order the marinas
+// were given, then each marina's roster order. Workers send a summary of
+// their free slips when the coordinator connects, and a boat is only ever
+// sent to the other marinas whose summary admits it. Each round sends the
+// unplaced boats to those workers at once and reads the replies after, so
+// workers search in parallel. A worker replies with the best few free
+// slips for each boat. Boats then take the slip that leaves the least area
+// over, across all marinas, in priority order. Only the boats that were
+// refused - their candidates all taken by boats ahead of them - go out
+// again for fresh candidates, and not to a worker that had none for them.
+// Rounds end when no boat is placed.
+class FederationCoordinator {
+    std::vector<std::string> mSocketPaths;
+    unsigned mCandidates;
+    int mConnectTimeoutMs;
+
+public:
+    // Throws std::invalid_argument for no sockets
+    explicit FederationCoordinator(std::vector<std::string> socketPaths);
+
+    // Candidate slips per boat and worker in each round (default 8)
+    void setCandidates(unsigned candidates);
+
+    // How long to keep retrying workers that are still starting (default 5000)
+    void setConnectTimeoutMs(int milliseconds){ mConnectTimeoutMs = milliseconds; }
+
+    // Route every overflow boat that fits a free slip elsewhere, in
+    // priority order, then ask the workers to stop. Throws
+    // std::runtime_error when a worker cannot be reached or fails.
+    std::vector<FederationPlacement> run();
+};
+
+#endif
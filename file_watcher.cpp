@@ -0,0 +1,95 @@
+#include "file_watcher.hpp"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+FileWatcher::FileWatcher(const std::vector<std::string> &paths)
+    : mFd(::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)), mPaths(paths){
+    if (mFd < 0){
+        throw std::runtime_error(std::string("Cannot watch files: ") + std::strerror(errno));
+    }
+
+    for (size_t i = 0; i < paths.size(); ++i){
+        std::filesystem::path file(paths[i]);
+        std::string directory = file.has_parent_path() ? file.parent_path().string() : ".";
+
+        // The same directory gives back the same descriptor, however it is spelled
+        int wd = ::inotify_add_watch(mFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+        if (wd < 0){
+            int error = errno;
+            ::close(mFd);
+            throw std::runtime_error("Cannot watch directory '" + directory + "': " + std::strerror(error));
+        }
+
+        mWatches[wd].emplace_back(file.filename().string(), i);
+    }
+}
+
+FileWatcher::~FileWatcher(){
+    ::close(mFd);
+}
+
+std::vector<std::string> FileWatcher::wait(int quietMs){
+    std::vector<bool> saved(mPaths.size(), false);
+    bool any = false;
+    alignas(struct inotify_event) char buffer[4096];
+
+    for (;;){
+        struct pollfd ready = { mFd, POLLIN, 0 };
+        int count = ::poll(&ready, 1, any ? quietMs : -1);
+
+        if (count < 0 && errno == EINTR){
+            continue;
+        }
+
+        if (count < 0){
+            throw std::runtime_error(std::string("Cannot watch files: ") + std::strerror(errno));
+        }
+
+        // Quiet since the last save
+        if (count == 0){
+            break;
+        }
+
+        ssize_t length;
+
+        while ((length = ::read(mFd, buffer, sizeof(buffer))) > 0){
+            for (char *p = buffer; p < buffer + length;){
+                const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(p);
+                p += sizeof(struct inotify_event) + event->len;
+
+                auto watch = mWatches.find(event->wd);
+
+                if (event->len == 0 || watch == mWatches.end()){
+                    continue;
+                }
+
+                for (const auto &file : watch->second){
+                    if (file.first == event->name){
+                        saved[file.second] = true;
+                        any = true;
+                    }
+                }
+            }
+        }
+
+        if (length < 0 && errno != EAGAIN && errno != EINTR){
+            throw std::runtime_error(std::string("Cannot watch files: ") + std::strerror(errno));
+        }
+    }
+
+    std::vector<std::string> paths;
+
+    for (size_t i = 0; i < mPaths.size(); ++i){
+        if (saved[i]){
+            paths.push_back(mPaths[i]);
+        }
+    }
+
+    return paths;
+}
@@ -0,0 +1,36 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Waits for files to be saved, using inotify.
+//
+// The files' directories are watched rather than the files, so that an
+// editor that saves by writing a new file and renaming it over the old one
+// is seen as well as one that rewrites the file in place. A save counts
+// once the file is closed after writing or renamed into place.
+class FileWatcher {
+    int mFd;
+    // Names and positions of the files in each watched directory, by
+    // watch descriptor. Two spellings of one directory, such as "." and
+    // its absolute path, share a descriptor.
+    std::unordered_map<int, std::vector<std::pair<std::string, size_t>>> mWatches;
+    std::vector<std::string> mPaths;
+
+public:
+    // Throws std::runtime_error when a directory cannot be watched
+    explicit FileWatcher(const std::vector<std::string> &paths);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    // Block until a file is saved, then keep collecting saves until none
+    // arrive for quietMs milliseconds, so that a burst of saves is one
+    // change. Returns the saved paths as given, in the order given.
+    std::vector<std::string> wait(int quietMs);
+};
+
+#endif
@@ -0,0 +1,269 @@
+#include "jsonl_writer.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+static const char HEX[] = "0123456789abcdef";
+
+// Longest text to_chars produces for a long long or a double
+static const size_t NUMBER_BYTES = 32;
+
+JsonlWriter::JsonlWriter(std::ostream &out, size_t bufferBytes)
+    : mOut(out), mUsed(0){
+    if (bufferBytes < 64){
+        throw std::invalid_argument("Invalid JSON Lines buffer size: must be at least 64 bytes");
+    }
+
+    mBuffer.resize(bufferBytes);
+
+    for (Assignment::Status status : { Assignment::Status::PERMANENT, Assignment::Status::SAME,
+                                      Assignment::Status::TEMPORARY, Assignment::Status::UNASSIGNED }){
+        mStatuses.push_back(Assignment::statusToString(status));
+    }
+
+    for (Member::DockStatus status : { Member::DockStatus::PERMANENT, Member::DockStatus::YEAR_OFF, Member::DockStatus::WAITING_LIST,
+                                      Member::DockStatus::TEMPORARY, Member::DockStatus::UNASSIGNED }){
+        mDockStatuses.push_back(Member::dockStatusToString(status));
+    }
+
+    for (unsigned bit = 0; bit < 32; ++bit){
+        mAmenityNames.push_back(Amenities::toString(Amenities::Mask(1) << bit));
+    }
+}
+
+void JsonlWriter::emit(){
+    mOut.write(mBuffer.data(), static_cast<std::streamsize>(mUsed));
+
+    if (!mOut){
+        throw std::runtime_error("Cannot write JSON Lines output");
+    }
+
+    mUsed = 0;
+}
+
+void JsonlWriter::put(char c){
+    if (mUsed == mBuffer.size()){
+        emit();
+    }
+
+    mBuffer[mUsed++] = c;
+}
+
+void JsonlWriter::put(std::string_view text){
+    while (!text.empty()){
+        if (mUsed == mBuffer.size()){
+            emit();
+        }
+
+        size_t count = std::min(text.size(), mBuffer.size() - mUsed);
+        std::memcpy(mBuffer.data() + mUsed, text.data(), count);
+        mUsed += count;
+        text.remove_prefix(count);
+    }
+}
+
+void JsonlWriter::putInteger(long long value){
+    if (mBuffer.size() - mUsed < NUMBER_BYTES){
+        emit();
+    }
+
+    char *at = mBuffer.data() + mUsed;
+    mUsed = static_cast<size_t>(std::to_chars(at, at + NUMBER_BYTES, value).ptr - mBuffer.data());
+}
+
+void JsonlWriter::putNumber(double value){
+    if (mBuffer.size() - mUsed < NUMBER_BYTES){
+        emit();
+    }
+
+    // Shortest text that reads back as the same double, so 1234.5 not 1234.500000
+    char *at = mBuffer.data() + mUsed;
+    mUsed = static_cast<size_t>(std::to_chars(at, at + NUMBER_BYTES, value).ptr - mBuffer.data());
+}
+
+void JsonlWriter::putString(std::string_view text){
+    put('"');
+
+    // Runs of plain bytes are copied whole; UTF-8 passes through unchanged
+    size_t start = 0;
+
+    for (size_t i = 0; i < text.size(); ++i){
+        unsigned char c = static_cast<unsigned char>(text[i]);
+
+        if (c >= 0x20 && c != '"' && c != '\\'){
+            continue;
+        }
+
+        put(text.substr(start, i - start));
+        start = i + 1;
+
+        switch (c){
+            case '"':
+                put("\\\"");
+                break;
+            case '\\':
+                put("\\\\");
+                break;
+            case '\n':
+                put("\\n");
+                break;
+            case '\r':
+                put("\\r");
+                break;
+            case '\t':
+                put("\\t");
+                break;
+            default: {
+                char escaped[6] = { '\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xf] };
+                put(std::string_view(escaped, sizeof(escaped)));
+            }
+        }
+    }
+
+    put(text.substr(start));
+    put('"');
+}
+
+void JsonlWriter::putAmenities(Amenities::Mask amenities){
+    put('[');
+    bool first = true;
+
+    for (unsigned bit = 0; bit < 32; ++bit){
+        if (!(amenities & (Amenities::Mask(1) << bit)) || mAmenityNames[bit].empty()){
+            continue;
+        }
+
+        if (!first){
+            put(',');
+        }
+
+        putString(mAmenityNames[bit]);
+        first = false;
+    }
+
+    put(']');
+}
+
+void JsonlWriter::putReason(const Assignment::Reason &reason){
+    using Code = Assignment::Reason::Code;
+
+    switch (reason.mCode){
+        case Code::NOTE:
+            put("{\"code\":\"note\",\"text\":");
+            putString(reason.mText);
+            put('}');
+            break;
+        case Code::DOES_NOT_FIT:
+            put("{\"code\":\"does_not_fit\"}");
+            break;
+        case Code::SLIP_LACKS_AMENITIES:
+            put("{\"code\":\"slip_lacks_amenities\",\"amenities\":");
+            putAmenities(reason.mAmenities);
+            put('}');
+            break;
+        case Code::LONGER_THAN_SLIP:
+        case Code::SHORTER_THAN_SLIP:
+            put(reason.mCode == Code::LONGER_THAN_SLIP ? "{\"code\":\"longer_than_slip\",\"inches\":"
+                                                       : "{\"code\":\"shorter_than_slip\",\"inches\":");
+            putInteger(reason.mCount);
+            put('}');
+            break;
+        case Code::TIGHT_FIT:
+            put("{\"code\":\"tight_fit\"}");
+            break;
+        case Code::YEAR_OFF:
+            put("{\"code\":\"year_off\"}");
+            break;
+        case Code::SHARES_SLIP:
+            put("{\"code\":\"shares_slip\",\"members\":[");
+
+            for (size_t i = 0; i < reason.mMembers.size(); ++i){
+                if (i > 0){
+                    put(',');
+                }
+
+                putString(reason.mMembers[i]);
+            }
+
+            put("]}");
+            break;
+        case Code::NO_SLIP_WITH_AMENITIES:
+            put("{\"code\":\"no_slip_with_amenities\",\"amenities\":");
+            putAmenities(reason.mAmenities);
+            put('}');
+            break;
+        case Code::TOO_LARGE:
+            put(reason.mEvicted ? "{\"code\":\"too_large\",\"evicted\":true}" : "{\"code\":\"too_large\",\"evicted\":false}");
+            break;
+        case Code::SLIP_REMOVED:
+            put("{\"code\":\"slip_removed\",\"evicted\":true}");
+            break;
+        case Code::SLIPS_TAKEN:
+            put(reason.mEvicted ? "{\"code\":\"slips_taken\",\"evicted\":true,\"by\":"
+                                : "{\"code\":\"slips_taken\",\"evicted\":false,\"by\":");
+            put(reason.mEvicted && reason.mByPermanent ? "\"permanent\",\"suitable_slips\":" : "\"priority\",\"suitable_slips\":");
+            putInteger(reason.mCount);
+            put('}');
+            break;
+    }
+}
+
+void JsonlWriter::write(const Assignment &assignment){
+    put("{\"member_id\":");
+    putString(assignment.memberId());
+    put(",\"assigned_slip\":");
+
+    if (assignment.assigned()){
+        putString(assignment.slipId());
+    }
+    else{
+        put("null");
+    }
+
+    put(",\"status\":");
+    putString(mStatuses[static_cast<size_t>(assignment.status())]);
+    put(",\"dock_status\":");
+    putString(mDockStatuses[static_cast<size_t>(assignment.dockStatus())]);
+    put(",\"boat_length_inches\":");
+    putInteger(assignment.boatDimensions().lengthInches());
+    put(",\"boat_width_inches\":");
+    putInteger(assignment.boatDimensions().widthInches());
+    put(",\"price\":");
+
+    if (assignment.price() > 0.0){
+        putNumber(assignment.price());
+    }
+    else{
+        put("null");
+    }
+
+    put(assignment.upgraded() ? ",\"upgraded\":true,\"reasons\":[" : ",\"upgraded\":false,\"reasons\":[");
+
+    const std::vector<Assignment::Reason> &reasons = assignment.reasons();
+
+    for (size_t i = 0; i < reasons.size(); ++i){
+        if (i > 0){
+            put(',');
+        }
+
+        putReason(reasons[i]);
+    }
+
+    put("]}\n");
+}
+
+void JsonlWriter::write(const std::vector<Assignment> &assignments){
+    for (const auto &assignment : assignments){
+        write(assignment);
+    }
+}
+
+void JsonlWriter::flush(){
+    emit();
+    mOut.flush();
+
+    if (!mOut){
+        throw std::runtime_error("Cannot write JSON Lines output");
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef JSONL_WRITER_H
+#define JSONL_WRITER_H
+
+#include "assignment.hpp"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Writes assignments as JSON Lines: one JSON object per assignment, each on
+// its own line, for log pipelines and other line-oriented consumers.
+//
+//   {"member_id":"M1","assigned_slip":"A1","status":"SAME",
+//    "dock_status":"temporary","boat_length_inches":300,
+//    "boat_width_inches":120,"price":1234.5,"upgraded":false,
+//    "reasons":[{"code":"tight_fit"}]}
+//
+// assigned_slip is null when unassigned and price is null when not priced.
+// The comment is not copied as text; each of the assignment's reasons
+// becomes an object with a "code" and the values the engine recorded, such
+// as {"code":"longer_than_slip","inches":14} or
+// {"code":"slips_taken","evicted":true,"by":"permanent","suitable_slips":3}.
+// Free text, such as a comment read back from CSV, is kept whole as
+// {"code":"note","text":"..."}.
+//
+// Rows are formatted into a fixed buffer that is handed to the stream
+// whenever it fills, so no memory is allocated per row, memory stays
+// bounded however many rows are written and the output can be a pipe.
+// flush() hands over the rest and must be called.
+class JsonlWriter {
+    std::ostream &mOut;
+    std::vector<char> mBuffer;
+    size_t mUsed;
+    // Status and dock status names, indexed by enum value
+    std::vector<std::string> mStatuses;
+    std::vector<std::string> mDockStatuses;
+    // Amenity names, indexed by bit
+    std::vector<std::string> mAmenityNames;
+
+    void emit();
+    void put(char c);
+    void put(std::string_view text);
+    void putInteger(long long value);
+    void putNumber(double value);
+    // A JSON string, quoted and escaped
+    void putString(std::string_view text);
+    // A JSON array of the names of the amenities in a mask
+    void putAmenities(Amenities::Mask amenities);
+    void putReason(const Assignment::Reason &reason);
+
+public:
+    // Throws std::invalid_argument for a buffer smaller than 64 bytes
+    explicit JsonlWriter(std::ostream &out, size_t bufferBytes = 65536);
+
+    JsonlWriter(const JsonlWriter &) = delete;
+    JsonlWriter &operator=(const JsonlWriter &) = delete;
+
+    void write(const Assignment &assignment);
+    void write(const std::vector<Assignment> &assignments);
+
+    // Hand buffered lines to the stream and flush it. Throws
+    // std::runtime_error when the output fails.
+    void flush();
+};
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef LAYERED_MAP_H
+#define LAYERED_MAP_H
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+// Hash map whose entries can be frozen into shared, read-only layers.
+//
+// Reads look at the map's own entries first and then down the frozen
+// layers. Writes only touch the map's own entries: an entry is copied up
+// from the layers the first time it is changed, and erasing a frozen entry
+// leaves a tombstone. freeze() moves the map's own entries into a new layer
+// in constant time; copies made after that share everything written so far
+// and each pays only for the entries it changes.
+//
+// Frozen layers are never modified, so copies on different threads can
+// read them concurrently.
+template <typename Key, typename Value>
+class LayeredMap {
+    using Entries = std::unordered_map<Key, std::optional<Value>>;
+
+    struct Layer {
+        Entries mEntries;
+        std::shared_ptr<const Layer> mBelow;
+    };
+
+    Entries mEntries;
+    std::shared_ptr<const Layer> mFrozen;
+    size_t mSize = 0;
+
+    // Newest frozen entry for a key, which may be a tombstone, or nullptr
+    const std::optional<Value> *findFrozen(const Key &key) const{
+        for (const Layer *layer = mFrozen.get(); layer; layer = layer->mBelow.get()){
+            auto it = layer->mEntries.find(key);
+
+            if (it != layer->mEntries.end()){
+                return &it->second;
+            }
+        }
+
+        return nullptr;
+    }
+
+public:
+    // Value for a key, or nullptr if there is none
+    const Value *find(const Key &key) const{
+        auto it = mEntries.find(key);
+
+        if (it != mEntries.end()){
+            return it->second ? &*it->second : nullptr;
+        }
+
+        const std::optional<Value> *frozen = findFrozen(key);
+        return frozen && *frozen ? &**frozen : nullptr;
+    }
+
+    // Writable value for a key, or nullptr if there is none
+    Value *findMutable(const Key &key){
+        auto it = mEntries.find(key);
+
+        if (it == mEntries.end()){
+            const std::optional<Value> *frozen = findFrozen(key);
+
+            if (!frozen || !*frozen){
+                return nullptr;
+            }
+
+            it = mEntries.emplace(key, *frozen).first;
+        }
+
+        return it->second ? &*it->second : nullptr;
+    }
+
+    // Writable value for a key, default-constructed if there is none
+    Value &operator[](const Key &key){
+        auto inserted = mEntries.try_emplace(key);
+        std::optional<Value> &entry = inserted.first->second;
+
+        if (inserted.second && mFrozen){
+            const std::optional<Value> *frozen = findFrozen(key);
+
+            if (frozen){
+                entry = *frozen;
+            }
+        }
+
+        if (!entry){
+            entry.emplace();
+            mSize++;
+        }
+
+        return *entry;
+    }
+
+    void erase(const Key &key){
+        auto it = mEntries.find(key);
+
+        if (it != mEntries.end()){
+            if (!it->second){
+                return;
+            }
+
+            mSize--;
+
+            if (mFrozen){
+                it->second.reset();
+            }
+            else{
+                mEntries.erase(it);
+            }
+
+            return;
+        }
+
+        const std::optional<Value> *frozen = findFrozen(key);
+
+        if (frozen && *frozen){
+            mSize--;
+            mEntries.emplace(key, std::nullopt);
+        }
+    }
+
+    // Number of keys with a value
+    size_t size() const{ return mSize; }
+
+    void clear(){
+        mEntries.clear();
+        mFrozen.reset();
+        mSize = 0;
+    }
+
+    // Move this map's own entries into a new shared layer
+    void freeze(){
+        if (mEntries.empty()){
+            return;
+        }
+
+        auto layer = std::make_shared<Layer>();
+        layer->mEntries = std::move(mEntries);
+        layer->mBelow = std::move(mFrozen);
+        mFrozen = std::move(layer);
+        mEntries.clear();
+    }
+};
+
+#endif
@@ -1,9 +1,29 @@
 #include "csv_parser.hpp"
 #include "assignment_engine.hpp"
+#include "arrow_writer.hpp"
+#include "jsonl_writer.hpp"
+#include "compressed_stream.hpp"
+#include "file_watcher.hpp"
+#include "federation.hpp"
+#include "pricing.hpp"
+#include "result_cache.hpp"
+#include "shared_results.hpp"
+#include "seniority_archive.hpp"
+#include "waitlist_forecast.hpp"
 #include "version.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 #include <cstring>
 
 void printVersion() {
@@ -16,6 +36,7 @@ void printHelp(const char* programName) {
   printVersion();
   std::cout << "USAGE:\n";
   std::cout << "  " << programName << " --slips <slips.csv> --members <members.csv> [OPTIONS]\n";
+  std::cout << "  " << programName << " --federate <socket>,<socket>,... [--output <file>] [--compress <codec>]\n";
   std::cout << "  " << programName << " --version\n";
   std::cout << "  " << programName << " --help\n";
   std::cout << "\n";
@@ -31,13 +52,114 @@ void printHelp(const char* programName) {
   std::cout << "  --members <file>   CSV file containing member information\n";
   std::cout << "\n";
   std::cout << "OPTIONS:\n";
-  std::cout << "  --output <file>    Write assignments to file instead of stdout\n";
+  std::cout << "  --output <file>    Write assignments to file instead of stdout; files\n";
+  std::cout << "                     ending in .gz or .zst are compressed\n";
+  std::cout << "  --format <csv|arrow|jsonl>\n";
+  std::cout << "                     Assignment table format (default csv); arrow writes\n";
+  std::cout << "                     an Arrow IPC (Feather) file, in record batches, for\n";
+  std::cout << "                     pyarrow, polars or pandas; jsonl writes one JSON\n";
+  std::cout << "                     object per line, with structured reasons in place\n";
+  std::cout << "                     of the comment\n";
+  std::cout << "  --compress <gzip|zstd|none>\n";
+  std::cout << "                     Compress --output with the given codec regardless of\n";
+  std::cout << "                     its extension; requires --output\n";
   std::cout << "  --verbose          Print detailed assignment progress (phases and passes)\n";
   std::cout << "  --ignore-length    Only check width when determining fit (show length\n";
   std::cout << "                     differences in comments)\n";
   std::cout << "  --price-per-sqft <amount>\n";
   std::cout << "                     Calculate price per square foot (uses larger of boat\n";
   std::cout << "                     or slip area); adds 'price' column to output\n";
+  std::cout << "  --previous <file>  Compare against a previous assignment file and output\n";
+  std::cout << "                     only members whose slip, status or price changed,\n";
+  std::cout << "                     with a 'change' classification column\n";
+  std::cout << "  --merged           With --previous, output every member (unchanged rows\n";
+  std::cout << "                     marked UNCHANGED) instead of only the changes\n";
+  std::cout << "  --explain <member_id>\n";
+  std::cout << "                     Print why a member got its result (decisions, pass,\n";
+  std::cout << "                     candidate slips and occupants); may be repeated.\n";
+  std::cout << "                     Assignments are only written when --output is given\n";
+  std::cout << "  --no-diagnostics   Skip the per-member unassigned diagnostics in the\n";
+  std::cout << "                     comment column (faster on large rosters)\n";
+  std::cout << "  --stable-matching  Assign by deferred acceptance over members' ranked\n";
+  std::cout << "                     slip_preferences (stable, priority-respecting)\n";
+  std::cout << "  --natural-order    Order member IDs by the value of their digits, so M2\n";
+  std::cout << "                     goes before M10 (default: character order)\n";
+  std::cout << "  --season <from..to>\n";
+  std::cout << "                     Season dates, YYYY-MM-DD..YYYY-MM-DD (end day not\n";
+  std::cout << "                     included); assigned slips are held for the season\n";
+  std::cout << "                     except the days in each member's 'away' column\n";
+  std::cout << "  --transients <file>\n";
+  std::cout << "                     Book transient requests (request_id, boat size,\n";
+  std::cout << "                     arrive, depart) into slips free for their dates,\n";
+  std::cout << "                     best fit first, in file order; requires --season\n";
+  std::cout << "  --bookings-output <file>\n";
+  std::cout << "                     Write transient bookings to file instead of stdout\n";
+  std::cout << "  --journal <file>   Write every occupancy change of the run, in order, to\n";
+  std::cout << "                     file so it can be replayed step by step\n";
+  std::cout << "  --improve-ms <n>   After assigning, spend up to n milliseconds moving\n";
+  std::cout << "                     boats along chains of slips to place unassigned boats\n";
+  std::cout << "                     and free slip area; nobody loses a slip and kept slips\n";
+  std::cout << "                     stay put (results in the --verbose summary)\n";
+  std::cout << "  --maximize-revenue Then reassign movable boats to the slips that bill the\n";
+  std::cout << "                     most in total, with the same protections (billed area\n";
+  std::cout << "                     and revenue against the greedy result in the --verbose\n";
+  std::cout << "                     summary)\n";
+  std::cout << "  --rates <file>     Price assignments from a rate table (rule,key,value rows:\n";
+  std::cout << "                     base, length tiers, dock multipliers, amenity\n";
+  std::cout << "                     surcharges, status discounts) instead of the flat\n";
+  std::cout << "                     --price-per-sqft rate, which stays the base rate\n";
+  std::cout << "                     unless the table sets one\n";
+  std::cout << "  --reprice <file>   Re-price an existing assignment file against --slips\n";
+  std::cout << "                     without rerunning the engine (no --members needed)\n";
+  std::cout << "  --forecast <seasons>\n";
+  std::cout << "                     Instead of assigning, forecast when each waiting-list\n";
+  std::cout << "                     or unassigned member gets a slip: replay the rules\n";
+  std::cout << "                     for this many seasons with random churn, over many\n";
+  std::cout << "                     trials, and output the 50th/75th/90th percentile\n";
+  std::cout << "                     season per member\n";
+  std::cout << "  --trials <n>       Forecast trials (default 1000), run on --threads\n";
+  std::cout << "  --seed <n>         Forecast random seed (default 1)\n";
+  std::cout << "  --churn <sell>,<upgrade>,<year-off>\n";
+  std::cout << "                     Yearly forecast chances that a slip holder sells,\n";
+  std::cout << "                     a boat grows 4' x 1', and a permanent member takes\n";
+  std::cout << "                     a year off (default 0.05,0.05,0.02)\n";
+  std::cout << "  --archive <file>   Seniority archive of past seasons' assignment files\n";
+  std::cout << "  --ingest <dir>     Add the assignment files in dir that --archive has not\n";
+  std::cout << "                     read yet (the year is the first four-digit number in\n";
+  std::cout << "                     the file name); without --slips and --members, only\n";
+  std::cout << "                     the archive is updated\n";
+  std::cout << "  --seniority <slip>,<waiting>,<continuous>\n";
+  std::cout << "                     Within each dock status, put members with the most\n";
+  std::cout << "                     seniority first: years in a slip, years waiting and\n";
+  std::cout << "                     continuous years in a slip from --archive, weighted;\n";
+  std::cout << "                     ties go to the lower member ID\n";
+  std::cout << "  --cache <dir>      Keep each run's output in dir, keyed by a hash of the\n";
+  std::cout << "                     input files and options; a run on unchanged inputs\n";
+  std::cout << "                     writes the stored output without assigning. Not for\n";
+  std::cout << "                     --verbose, --explain, --journal, --transients,\n";
+  std::cout << "                     --forecast, --reprice or --improve-ms runs\n";
+  std::cout << "  --cache-size <mb>  Size of the cache; least recently used outputs are\n";
+  std::cout << "                     removed beyond it (default 256)\n";
+  std::cout << "  --watch            After the first run, rerun whenever the slips, members\n";
+  std::cout << "                     or rates file is saved, until interrupted; only rows\n";
+  std::cout << "                     that changed are printed, and --output is rewritten\n";
+  std::cout << "                     when any did\n";
+  std::cout << "  --publish <name>   Also publish the assignment table in the named POSIX\n";
+  std::cout << "                     shared-memory segment (e.g. /slippage) for readers\n";
+  std::cout << "                     that map it in place; republished atomically by\n";
+  std::cout << "                     later runs and by --watch\n";
+  std::cout << "  --serve <socket>   After the run, serve this marina's free slips and\n";
+  std::cout << "                     unassigned boats to a --federate coordinator on a\n";
+  std::cout << "                     Unix socket at the given path, until it is done\n";
+  std::cout << "  --marina <name>    Name of the served marina (default: the socket's file\n";
+  std::cout << "                     name)\n";
+  std::cout << "  --federate <socket>,<socket>,...\n";
+  std::cout << "                     Instead of assigning, route the unassigned boats of\n";
+  std::cout << "                     each --serve worker to free slips at the other\n";
+  std::cout << "                     marinas, in priority order; needs no --slips or\n";
+  std::cout << "                     --members\n";
+  std::cout << "  --threads <n>      Assign docks that share no members on up to n threads\n";
+  std::cout << "                     (0 = one per CPU; default 1). Output is unchanged\n";
   std::cout << "  --help, -h         Show this help message and exit\n";
   std::cout << "  --version, -v      Show version information and exit\n";
   std::cout << "\n";
@@ -48,6 +170,9 @@ void printHelp(const char* programName) {
   std::cout << "    S1,20,0,10,0\n";
   std::cout << "    S2,25,6,12,0\n";
   std::cout << "\n";
+  std::cout << "  Input files may be gzip- or zstd-compressed; compression is detected\n";
+  std::cout << "  automatically and decompressed while streaming.\n";
+  std::cout << "\n";
   std::cout << "  members.csv format:\n";
   std::cout << "    member_id,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,current_slip,dock_status\n";
   std::cout << "    M001,18,6,8,0,S1,temporary\n";
@@ -95,6 +220,186 @@ void printHelp(const char* programName) {
   std::cout << "\n";
 }
 
+// Write either the full assignment table or, when diffing against a
+// previous file, only the changed rows.
+void writeResults(std::ostream &out, const std::vector<Assignment> &assignments, const AssignmentDiff *diff,
+                  const std::string &format) {
+  if (diff) {
+    out << *diff;
+  }
+  else if (format == "arrow") {
+    ArrowWriter writer(out);
+    writer.write(assignments);
+    writer.finish();
+  }
+  else if (format == "jsonl") {
+    JsonlWriter writer(out);
+    writer.write(assignments);
+    writer.flush();
+  }
+  else {
+    out << assignments;
+  }
+}
+
+// Write output text as the table would be written: between markers on
+// stdout, or to the output file, compressed as requested.
+void writeOutputText(const char *data, size_t size, const std::string &outputFile, const std::string &compressArg) {
+  if (outputFile.empty()) {
+    std::cout << ">>>>>>>>>>>>>>>>>>>>>>>>>>>ASSIGNMENTS START\n";
+    std::cout.write(data, static_cast<std::streamsize>(size));
+    std::cout << ">>>>>>>>>>>>>>>>>>>>>>>>>>>ASSIGNMENTS END\n";
+    return;
+  }
+
+  Compression compression = compressArg.empty() ? compressionForFilename(outputFile) : stringToCompression(compressArg);
+
+  if (compression == Compression::NONE) {
+    std::ofstream outFile(outputFile, std::ios::binary);
+
+    if (!outFile) {
+      throw std::runtime_error("Cannot open output file '" + outputFile + "'");
+    }
+
+    outFile.write(data, static_cast<std::streamsize>(size));
+  }
+  else {
+    CompressedOutputStream outFile(outputFile, compression);
+    outFile.write(data, static_cast<std::streamsize>(size));
+    outFile.finish();
+  }
+}
+
+// Rerun whenever an input file is saved, until interrupted. Saves that
+// leave the roster and slips as they were are skipped; a roster change is
+// assigned by an engine that shares the previous engine's slip indexes.
+// Only the rows that changed since the previous run are printed, and the
+// output file is replaced whole, and the table republished, when any did.
+int watchInputs(std::unique_ptr<AssignmentEngine> engine, std::vector<Assignment> assignments,
+                std::unique_ptr<PriceSchedule> schedule, const std::string &slipsFile, const std::string &membersFile,
+                const std::string &ratesFile, double pricePerSqFt, const std::string &outputFile,
+                const std::string &compressArg, SharedResultsPublisher *publisher) {
+  // Editors save in bursts of a few writes and renames
+  const int QUIET_MS = 30;
+  std::vector<std::string> files = { slipsFile, membersFile };
+
+  if (!ratesFile.empty()) {
+    files.push_back(ratesFile);
+  }
+
+  FileWatcher watcher(files);
+  std::cerr << "Watching " << slipsFile << ", " << membersFile << (ratesFile.empty() ? "" : ", " + ratesFile)
+            << " for changes (Ctrl-C to stop)\n";
+
+  for (;;) {
+    std::vector<std::string> saved = watcher.wait(QUIET_MS);
+    auto started = std::chrono::steady_clock::now();
+    auto wasSaved = [&](const std::string &file) {
+      return std::find(saved.begin(), saved.end(), file) != saved.end();
+    };
+
+    // A save can leave a file half written or invalid; report it and wait for the next
+    try {
+      bool slipsChanged = wasSaved(slipsFile) || (!ratesFile.empty() && wasSaved(ratesFile));
+      std::vector<Member> members = wasSaved(membersFile) ? CsvParser::parseMembers(membersFile) : engine->members();
+      RosterDelta delta(engine->members(), members);
+
+      if (!slipsChanged && delta.empty()) {
+        continue;
+      }
+
+      std::unique_ptr<AssignmentEngine> next;
+
+      if (slipsChanged) {
+        auto slips = CsvParser::parseSlips(slipsFile);
+
+        if (!ratesFile.empty()) {
+          RateTable rates = CsvParser::parseRateTable(ratesFile);
+
+          if (!rates.hasBaseRate()) {
+            rates.setBaseRate(pricePerSqFt);
+          }
+
+          schedule.reset(new PriceSchedule(rates, slips));
+        }
+
+        next.reset(new AssignmentEngine(engine->withInputs(std::move(members), std::move(slips))));
+      }
+      else {
+        next.reset(new AssignmentEngine(engine->withRoster(std::move(members))));
+      }
+
+      std::vector<Assignment> result = next->assign();
+
+      if (schedule) {
+        schedule->price(result);
+      }
+
+      std::vector<AssignmentRecord> previous;
+      previous.reserve(assignments.size());
+
+      for (const auto &assignment : assignments) {
+        previous.emplace_back(assignment.memberId(), assignment.slipId(),
+                              Assignment::statusToString(assignment.status()), assignment.price());
+      }
+
+      AssignmentDiff diff(previous, result);
+      auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+      std::cerr << (slipsChanged ? "Slips changed; " : "") << delta.size() << " member(s) changed, "
+                << diff.changes().size() << " assignment(s) changed in " << elapsed.count() << " ms\n";
+
+      if (!diff.changes().empty()) {
+        if (outputFile.empty()) {
+          std::cout << ">>>>>>>>>>>>>>>>>>>>>>>>>>>CHANGES START\n";
+          std::cout << diff;
+          std::cout << ">>>>>>>>>>>>>>>>>>>>>>>>>>>CHANGES END\n";
+          std::cout.flush();
+        }
+        else {
+          // Written beside the output and renamed over it, so readers never see half a file;
+          // the leading dot keeps the extension that picks the compression
+          std::filesystem::path output(outputFile);
+          std::filesystem::path temporary = output.parent_path() / ("." + output.filename().string());
+          std::ostringstream text;
+          text << result;
+          std::string table = text.str();
+          writeOutputText(table.data(), table.size(), temporary.string(), compressArg);
+          std::filesystem::rename(temporary, output);
+        }
+
+        if (publisher) {
+          publisher->publish(result);
+        }
+      }
+
+      assignments = std::move(result);
+      engine = std::move(next);
+    }
+    catch (const std::exception& e) {
+      std::cerr << "Error: " << e.what() << "\n";
+    }
+  }
+}
+
+void printDiffSummary(const AssignmentDiff &diff) {
+  AssignmentChange::Kind kinds[] = {
+    AssignmentChange::Kind::ADDED,
+    AssignmentChange::Kind::REMOVED,
+    AssignmentChange::Kind::ASSIGNED,
+    AssignmentChange::Kind::VACATED,
+    AssignmentChange::Kind::MOVED,
+    AssignmentChange::Kind::STATUS_CHANGED,
+    AssignmentChange::Kind::PRICE_CHANGED,
+    AssignmentChange::Kind::UNCHANGED
+  };
+
+  std::cout << "\n===== CHANGES FROM PREVIOUS ASSIGNMENTS =====\n";
+
+  for (AssignmentChange::Kind kind : kinds) {
+    std::cout << "  " << AssignmentChange::kindToString(kind) << ": " << diff.count(kind) << "\n";
+  }
+}
+
 void printUsage(const char* programName) {
   std::cerr << "Error: Missing required arguments\n\n";
   std::cerr << "Usage: " << programName << " --slips <slips.csv> --members <members.csv>\n";
@@ -114,6 +419,38 @@ int main(int argc, char* argv[]) {
   bool verbose = false;
   bool ignoreLength = false;
   double pricePerSqFt = 0.0;
+  std::string compressArg;
+  std::string format = "csv";
+  std::string previousFile;
+  bool merged = false;
+  bool diagnostics = true;
+  std::vector<std::string> explainIds;
+  unsigned threads = 1;
+  bool stableMatching = false;
+  bool naturalOrder = false;
+  std::string seasonArg;
+  std::string transientsFile;
+  std::string bookingsFile;
+  std::string journalFile;
+  unsigned improveMs = 0;
+  bool maximizeRevenue = false;
+  std::string ratesFile;
+  std::string repriceFile;
+  unsigned forecastSeasons = 0;
+  unsigned trials = 1000;
+  unsigned long long seed = 1;
+  ChurnRates churn;
+  std::string archiveFile;
+  std::string ingestDirectory;
+  bool useSeniority = false;
+  SeniorityWeights seniorityWeights;
+  std::string cacheDirectory;
+  bool watch = false;
+  unsigned long long cacheMegabytes = 256;
+  std::string publishName;
+  std::string serveSocket;
+  std::string marinaName;
+  std::vector<std::string> federateSockets;
 
   for (int i = 1; i < argc; ++i) {
     if (std::strcmp(argv[i], "--slips") == 0 && i + 1 < argc) {
@@ -125,6 +462,168 @@ int main(int argc, char* argv[]) {
     else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
       outputFile = argv[++i];
     }
+    else if (std::strcmp(argv[i], "--compress") == 0 && i + 1 < argc) {
+      compressArg = argv[++i];
+
+      if (compressArg != "gzip" && compressArg != "zstd" && compressArg != "none") {
+        std::cerr << "Error: --compress must be gzip, zstd or none\n";
+        return 1;
+      }
+    }
+    else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+      format = argv[++i];
+
+      if (format != "csv" && format != "arrow" && format != "jsonl") {
+        std::cerr << "Error: --format must be csv, arrow or jsonl\n";
+        return 1;
+      }
+    }
+    else if (std::strcmp(argv[i], "--previous") == 0 && i + 1 < argc) {
+      previousFile = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--explain") == 0 && i + 1 < argc) {
+      explainIds.push_back(argv[++i]);
+    }
+    else if (std::strcmp(argv[i], "--season") == 0 && i + 1 < argc) {
+      seasonArg = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--transients") == 0 && i + 1 < argc) {
+      transientsFile = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--bookings-output") == 0 && i + 1 < argc) {
+      bookingsFile = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--journal") == 0 && i + 1 < argc) {
+      journalFile = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--forecast") == 0 && i + 1 < argc) {
+      int seasons = std::atoi(argv[++i]);
+
+      if (seasons <= 0) {
+        std::cerr << "Error: --forecast needs a positive number of seasons\n";
+        return 1;
+      }
+
+      forecastSeasons = static_cast<unsigned>(seasons);
+    }
+    else if (std::strcmp(argv[i], "--trials") == 0 && i + 1 < argc) {
+      int count = std::atoi(argv[++i]);
+
+      if (count <= 0) {
+        std::cerr << "Error: --trials must be positive\n";
+        return 1;
+      }
+
+      trials = static_cast<unsigned>(count);
+    }
+    else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = std::strtoull(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--churn") == 0 && i + 1 < argc) {
+      char extra;
+
+      if (std::sscanf(argv[++i], "%lf,%lf,%lf%c", &churn.mSellRate, &churn.mUpgradeRate, &churn.mYearOffRate, &extra) != 3) {
+        std::cerr << "Error: --churn expects <sell>,<upgrade>,<year-off> rates\n";
+        return 1;
+      }
+    }
+    else if (std::strcmp(argv[i], "--archive") == 0 && i + 1 < argc) {
+      archiveFile = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--ingest") == 0 && i + 1 < argc) {
+      ingestDirectory = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--seniority") == 0 && i + 1 < argc) {
+      char extra;
+
+      if (std::sscanf(argv[++i], "%lf,%lf,%lf%c", &seniorityWeights.mSlipYears, &seniorityWeights.mWaitingYears, &seniorityWeights.mContinuousYears, &extra) != 3) {
+        std::cerr << "Error: --seniority expects <slip>,<waiting>,<continuous> weights\n";
+        return 1;
+      }
+
+      useSeniority = true;
+    }
+    else if (std::strcmp(argv[i], "--rates") == 0 && i + 1 < argc) {
+      ratesFile = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--reprice") == 0 && i + 1 < argc) {
+      repriceFile = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+      cacheDirectory = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--publish") == 0 && i + 1 < argc) {
+      publishName = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+      serveSocket = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--marina") == 0 && i + 1 < argc) {
+      marinaName = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--federate") == 0 && i + 1 < argc) {
+      std::stringstream list(argv[++i]);
+      std::string socket;
+
+      while (std::getline(list, socket, ',')) {
+        if (!socket.empty()) {
+          federateSockets.push_back(socket);
+        }
+      }
+
+      if (federateSockets.empty()) {
+        std::cerr << "Error: --federate needs at least one worker socket\n";
+        return 1;
+      }
+    }
+    else if (std::strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc) {
+      long long megabytes = std::atoll(argv[++i]);
+
+      if (megabytes <= 0) {
+        std::cerr << "Error: --cache-size must be positive\n";
+        return 1;
+      }
+
+      cacheMegabytes = static_cast<unsigned long long>(megabytes);
+    }
+    else if (std::strcmp(argv[i], "--improve-ms") == 0 && i + 1 < argc) {
+      int milliseconds = std::atoi(argv[++i]);
+
+      if (milliseconds < 0) {
+        std::cerr << "Error: --improve-ms must not be negative\n";
+        return 1;
+      }
+
+      improveMs = static_cast<unsigned>(milliseconds);
+    }
+    else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      int count = std::atoi(argv[++i]);
+
+      if (count < 0) {
+        std::cerr << "Error: --threads must not be negative\n";
+        return 1;
+      }
+
+      threads = count == 0 ? std::max(1u, std::thread::hardware_concurrency()) : static_cast<unsigned>(count);
+    }
+    else if (std::strcmp(argv[i], "--stable-matching") == 0) {
+      stableMatching = true;
+    }
+    else if (std::strcmp(argv[i], "--watch") == 0) {
+      watch = true;
+    }
+    else if (std::strcmp(argv[i], "--natural-order") == 0) {
+      naturalOrder = true;
+    }
+    else if (std::strcmp(argv[i], "--maximize-revenue") == 0) {
+      maximizeRevenue = true;
+    }
+    else if (std::strcmp(argv[i], "--no-diagnostics") == 0) {
+      diagnostics = false;
+    }
+    else if (std::strcmp(argv[i], "--merged") == 0) {
+      merged = true;
+    }
     else if (std::strcmp(argv[i], "--verbose") == 0) {
       verbose = true;
     }
@@ -142,7 +641,7 @@ int main(int argc, char* argv[]) {
       printVersion();
       return 0;
     }
-    else if (std::strcmp(argv[i], "--slips") == 0 || std::strcmp(argv[i], "--members") == 0 || std::strcmp(argv[i], "--output") == 0 || std::strcmp(argv[i], "--price-per-sqft") == 0) {
+    else if (std::strcmp(argv[i], "--slips") == 0 || std::strcmp(argv[i], "--members") == 0 || std::strcmp(argv[i], "--output") == 0 || std::strcmp(argv[i], "--price-per-sqft") == 0 || std::strcmp(argv[i], "--compress") == 0 || std::strcmp(argv[i], "--format") == 0 || std::strcmp(argv[i], "--previous") == 0 || std::strcmp(argv[i], "--explain") == 0 || std::strcmp(argv[i], "--threads") == 0 || std::strcmp(argv[i], "--season") == 0 || std::strcmp(argv[i], "--transients") == 0 || std::strcmp(argv[i], "--bookings-output") == 0 || std::strcmp(argv[i], "--journal") == 0 || std::strcmp(argv[i], "--improve-ms") == 0 || std::strcmp(argv[i], "--rates") == 0 || std::strcmp(argv[i], "--reprice") == 0 || std::strcmp(argv[i], "--forecast") == 0 || std::strcmp(argv[i], "--trials") == 0 || std::strcmp(argv[i], "--seed") == 0 || std::strcmp(argv[i], "--churn") == 0 || std::strcmp(argv[i], "--archive") == 0 || std::strcmp(argv[i], "--ingest") == 0 || std::strcmp(argv[i], "--seniority") == 0 || std::strcmp(argv[i], "--cache") == 0 || std::strcmp(argv[i], "--cache-size") == 0 || std::strcmp(argv[i], "--publish") == 0 || std::strcmp(argv[i], "--serve") == 0 || std::strcmp(argv[i], "--marina") == 0 || std::strcmp(argv[i], "--federate") == 0) {
       std::cerr << "Error: " << argv[i] << " requires an argument\n\n";
       std::cerr << "Try '" << argv[0] << " --help' for more information.\n";
       return 1;
@@ -154,48 +653,426 @@ int main(int argc, char* argv[]) {
     }
   }
 
-  if (slipsFile.empty() || membersFile.empty()) {
+  if ((!ingestDirectory.empty() || useSeniority) && archiveFile.empty()) {
+    std::cerr << "Error: --ingest and --seniority require --archive\n";
+    return 1;
+  }
+
+  if (!compressArg.empty() && outputFile.empty()) {
+    std::cerr << "Error: --compress requires --output\n";
+    return 1;
+  }
+
+  // Refused before any work, so the run is not wasted and no file is touched
+  if (!outputFile.empty() && forecastSeasons == 0 && !zstdAvailable() &&
+      (compressArg.empty() ? compressionForFilename(outputFile) : stringToCompression(compressArg)) == Compression::ZSTD) {
+    std::cerr << "Error: zstd compression requires a build with zstd support\n";
+    return 1;
+  }
+
+  if (!federateSockets.empty()) {
+    if (!slipsFile.empty() || !membersFile.empty() || !serveSocket.empty()) {
+      std::cerr << "Error: --federate routes between running workers; it cannot be combined with --slips, --members or --serve\n";
+      return 1;
+    }
+
+    // Placements are their own table, which only has a CSV form
+    if (format != "csv") {
+      std::cerr << "Error: --federate writes placements as CSV; it cannot be combined with --format " << format << "\n";
+      return 1;
+    }
+
+    try {
+      FederationCoordinator coordinator(federateSockets);
+      auto placements = coordinator.run();
+
+      if (outputFile.empty()) {
+        std::cout << ">>>>>>>>>>>>>>>>>>>>>>>>>>>PLACEMENTS START\n";
+        std::cout << placements;
+        std::cout << ">>>>>>>>>>>>>>>>>>>>>>>>>>>PLACEMENTS END\n";
+      }
+      else {
+        std::ostringstream table;
+        table << placements;
+        std::string text = table.str();
+        writeOutputText(text.data(), text.size(), outputFile, compressArg);
+      }
+
+      return 0;
+    }
+    catch (const std::exception& e) {
+      std::cerr << "Error: " << e.what() << "\n";
+      return 1;
+    }
+  }
+
+  if (!marinaName.empty() && serveSocket.empty()) {
+    std::cerr << "Error: --marina requires --serve\n";
+    return 1;
+  }
+
+  // Ingesting alone only updates the archive
+  bool ingestOnly = !ingestDirectory.empty() && slipsFile.empty() && membersFile.empty();
+
+  if (!ingestOnly && (slipsFile.empty() || (membersFile.empty() && repriceFile.empty()))) {
     printUsage(argv[0]);
     return 1;
   }
 
+  if (!repriceFile.empty() && (!membersFile.empty() || !explainIds.empty() || !journalFile.empty() || !transientsFile.empty())) {
+    std::cerr << "Error: --reprice does not run the engine; it cannot be combined with --members, --explain, --journal or --transients\n";
+    return 1;
+  }
+
+  if (forecastSeasons > 0 && (!repriceFile.empty() || !previousFile.empty() || !explainIds.empty() || !journalFile.empty() || !transientsFile.empty() || !compressArg.empty())) {
+    std::cerr << "Error: --forecast cannot be combined with --reprice, --previous, --explain, --journal, --transients or --compress\n";
+    return 1;
+  }
+
+  // Cached runs write nothing but the table, and must give the same table every time
+  if (!cacheDirectory.empty() && (verbose || !explainIds.empty() || !journalFile.empty() || !transientsFile.empty() || forecastSeasons > 0 || !repriceFile.empty() || improveMs > 0)) {
+    std::cerr << "Error: --cache cannot be combined with --verbose, --explain, --journal, --transients, --forecast, --reprice or --improve-ms\n";
+    return 1;
+  }
+
+  if (watch && (!repriceFile.empty() || forecastSeasons > 0 || !previousFile.empty() || !explainIds.empty() || !journalFile.empty() || !transientsFile.empty() || !cacheDirectory.empty())) {
+    std::cerr << "Error: --watch cannot be combined with --reprice, --forecast, --previous, --explain, --journal, --transients or --cache\n";
+    return 1;
+  }
+
+  if (!serveSocket.empty() && (!repriceFile.empty() || forecastSeasons > 0 || watch || !cacheDirectory.empty())) {
+    std::cerr << "Error: --serve cannot be combined with --reprice, --forecast, --watch or --cache\n";
+    return 1;
+  }
+
+  // A cache hit has no table to publish, only its text
+  if (!publishName.empty() && (forecastSeasons > 0 || !cacheDirectory.empty())) {
+    std::cerr << "Error: --publish cannot be combined with --forecast or --cache\n";
+    return 1;
+  }
+
+  // Changes and progress are text; Arrow and JSON Lines on stdout have no
+  // markers, so nothing else may be written there
+  if (format != "csv" && (!previousFile.empty() || watch || forecastSeasons > 0 || (outputFile.empty() && (verbose || !explainIds.empty() || !transientsFile.empty() || !cacheDirectory.empty())))) {
+    std::cerr << "Error: --format " << format << " cannot be combined with --previous, --watch or --forecast, nor with --verbose, --explain, --transients or --cache unless --output is given\n";
+    return 1;
+  }
+
+  if (merged && previousFile.empty()) {
+    std::cerr << "Error: --merged requires --previous\n";
+    return 1;
+  }
+
+  if (!transientsFile.empty() && seasonArg.empty()) {
+    std::cerr << "Error: --transients requires --season\n";
+    return 1;
+  }
+
+  if (!bookingsFile.empty() && transientsFile.empty()) {
+    std::cerr << "Error: --bookings-output requires --transients\n";
+    return 1;
+  }
+
   try {
+    std::unique_ptr<SeniorityArchive> archive;
+
+    if (!archiveFile.empty()) {
+      // A new archive is started by the first ingest
+      if (ingestDirectory.empty() || std::ifstream(archiveFile)) {
+        archive.reset(new SeniorityArchive(SeniorityArchive::load(archiveFile)));
+      }
+      else {
+        archive.reset(new SeniorityArchive());
+      }
+
+      if (!ingestDirectory.empty()) {
+        size_t read = archive->ingestDirectory(ingestDirectory);
+        archive->save(archiveFile);
+
+        if (verbose || ingestOnly) {
+          std::cout << "Archived " << read << " new file(s); " << archive->years() << " year(s), "
+                    << archive->members() << " member(s) in " << archiveFile << "\n";
+        }
+      }
+
+      if (ingestOnly) {
+        return 0;
+      }
+    }
+
+    std::unique_ptr<ResultCache> cache;
+    uint64_t cacheKey = 0;
+
+    if (!cacheDirectory.empty()) {
+      cache.reset(new ResultCache(cacheDirectory, cacheMegabytes << 20));
+
+      // Everything that changes the table; threads do not
+      ResultCache::Key key;
+      key.add(slippage::version::string()).add(format);
+      key.addFile(slipsFile).addFile(membersFile);
+      key.add(ignoreLength).add(pricePerSqFt).add(diagnostics).add(stableMatching).add(naturalOrder).add(maximizeRevenue);
+      key.add(!ratesFile.empty());
+
+      if (!ratesFile.empty()) {
+        key.addFile(ratesFile);
+      }
+
+      key.add(!previousFile.empty()).add(merged);
+
+      if (!previousFile.empty()) {
+        key.addFile(previousFile);
+      }
+
+      key.add(useSeniority);
+
+      if (useSeniority) {
+        key.addFile(archiveFile);
+        key.add(seniorityWeights.mSlipYears).add(seniorityWeights.mWaitingYears).add(seniorityWeights.mContinuousYears);
+      }
+
+      cacheKey = key.hash();
+      std::unique_ptr<MappedFile> hit = cache->find(cacheKey);
+
+      if (hit) {
+        writeOutputText(hit->data(), hit->size(), outputFile, compressArg);
+        return 0;
+      }
+    }
+
     auto slips = CsvParser::parseSlips(slipsFile);
-    auto members = CsvParser::parseMembers(membersFile);
+    std::unique_ptr<PriceSchedule> schedule;
+    std::unique_ptr<BookingCalendar> calendar;
+    std::unique_ptr<AssignmentEngine> watched;
+    std::unique_ptr<FederationWorker> worker;
+    std::vector<Member> roster;
+    std::vector<Assignment> assignments;
+
+    // Compiled before the engine takes the slips
+    if (!ratesFile.empty()) {
+      RateTable rates = CsvParser::parseRateTable(ratesFile);
+
+      if (!rates.hasBaseRate()) {
+        rates.setBaseRate(pricePerSqFt);
+      }
+
+      schedule.reset(new PriceSchedule(rates, slips));
+    }
+
+    if (!repriceFile.empty()) {
+      assignments = CsvParser::parseAssignments(repriceFile);
+      // Without --rates, a flat schedule at --price-per-sqft
+      if (!schedule) {
+        schedule.reset(new PriceSchedule(RateTable(pricePerSqFt), slips));
+      }
 
-    AssignmentEngine engine(std::move(members), std::move(slips));
-    engine.setVerbose(verbose);
-    engine.setIgnoreLength(ignoreLength);
-    engine.setPricePerSqFt(pricePerSqFt);
-    auto assignments = engine.assign();
+      schedule->price(assignments);
+    }
+    else {
+      auto members = CsvParser::parseMembers(membersFile);
+      // The calendar needs the slips and the members' away dates once the engine has taken its copies
+      if (!transientsFile.empty()) {
+        calendar.reset(new BookingCalendar(slips));
+        calendar->setIgnoreLength(ignoreLength);
+        roster = members;
+      }
+
+      AssignmentEngine engine(std::move(members), std::move(slips));
+      engine.setVerbose(verbose);
+      engine.setIgnoreLength(ignoreLength);
+      engine.setPricePerSqFt(pricePerSqFt);
+      engine.setDiagnostics(diagnostics);
+      engine.setRecordDecisions(!explainIds.empty());
+      engine.setThreads(threads);
+      engine.setStableMatching(stableMatching);
+      engine.setNaturalOrder(naturalOrder);
+      engine.setJournal(!journalFile.empty());
+      engine.setImproveMs(improveMs);
+      engine.setMaximizeRevenue(maximizeRevenue);
+
+      if (useSeniority) {
+        engine.setSeniority(*archive, seniorityWeights);
+      }
+
+      if (forecastSeasons > 0) {
+        WaitlistForecast forecast(engine);
+        forecast.setRates(churn);
+        forecast.setSeasons(forecastSeasons);
+        forecast.setTrials(trials);
+        forecast.setSeed(seed);
+        forecast.setThreads(threads);
+        auto forecasts = forecast.run();
+
+        if (outputFile.empty()) {
+          std::cout << ">>>>>>>>>>>>>>>>>>>>>>>>>>>FORECAST START\n";
+          std::cout << forecasts;
+          std::cout << ">>>>>>>>>>>>>>>>>>>>>>>>>>>FORECAST END\n";
+        }
+        else {
+          std::ofstream forecastOut(outputFile);
+
+          if (!forecastOut) {
+            std::cerr << "Error: Cannot open output file '" << outputFile << "'\n";
+            return 1;
+          }
+
+          forecastOut << forecasts;
+        }
+
+        return 0;
+      }
+
+      assignments = engine.assign();
+
+      if (!journalFile.empty()) {
+        std::ofstream journalOut(journalFile);
+
+        if (!journalOut) {
+          std::cerr << "Error: Cannot open journal file '" << journalFile << "'\n";
+          return 1;
+        }
+
+        engine.writeJournal(journalOut);
+      }
+
+      for (const auto &memberId : explainIds) {
+        std::cout << engine.explain(memberId) << "\n";
+      }
+
+      if (schedule) {
+        schedule->price(assignments);
+      }
+
+      if (!serveSocket.empty()) {
+        std::string name = marinaName.empty() ? std::filesystem::path(serveSocket).stem().string() : marinaName;
+        worker.reset(new FederationWorker(name, engine, assignments, ignoreLength));
+      }
+
+      if (watch) {
+        watched.reset(new AssignmentEngine(std::move(engine)));
+      }
+    }
+
+    std::vector<AssignmentRecord> previous;
+    std::unique_ptr<AssignmentDiff> diff;
 
-    if (outputFile.empty()) {
+    if (!previousFile.empty()) {
+      previous = CsvParser::parsePreviousAssignments(previousFile);
+      // An unpriced run has every price at zero
+      diff.reset(new AssignmentDiff(previous, assignments, merged, pricePerSqFt > 0.0 || !ratesFile.empty()));
+
+      if (verbose) {
+        printDiffSummary(*diff);
+      }
+    }
+
+    std::vector<Booking> bookings;
+
+    if (calendar) {
+      calendar->holdSeason(roster, assignments, DateRange::parse(seasonArg));
+
+      for (const auto &request : CsvParser::parseBookingRequests(transientsFile)) {
+        bookings.push_back(calendar->book(request));
+      }
+    }
+
+    if (cache) {
+      std::ostringstream text;
+      writeResults(text, assignments, diff.get(), format);
+      std::string output = text.str();
+
+      // A run that cannot store its output still writes it
+      try {
+        cache->store(cacheKey, output);
+      }
+      catch (const std::exception& e) {
+        std::cerr << "Warning: " << e.what() << "\n";
+      }
+
+      writeOutputText(output.data(), output.size(), outputFile, compressArg);
+    }
+    else if (outputFile.empty() && explainIds.empty() && format != "csv") {
+      writeResults(std::cout, assignments, diff.get(), format);
+    }
+    else if (outputFile.empty() && explainIds.empty()) {
       // Show markers only when NOT in verbose mode
       if (!verbose) {
         std::cout << ">>>>>>>>>>>>>>>>>>>>>>>>>>>ASSIGNMENTS START\n";
       }
-      std::cout << assignments;
+      writeResults(std::cout, assignments, diff.get(), format);
 
       if (!verbose) {
         std::cout << ">>>>>>>>>>>>>>>>>>>>>>>>>>>ASSIGNMENTS END\n";
       }
     }
-    else {
-      std::ofstream outFile(outputFile);
+    else if (!outputFile.empty()) {
+      Compression compression = compressArg.empty() ? compressionForFilename(outputFile) : stringToCompression(compressArg);
 
-      if (!outFile) {
-        std::cerr << "Error: Cannot open output file '" << outputFile << "'\n";
-        return 1;
-      }
+      if (compression == Compression::NONE) {
+        std::ofstream outFile(outputFile);
 
-      outFile << assignments;
-      outFile.close();
+        if (!outFile) {
+          std::cerr << "Error: Cannot open output file '" << outputFile << "'\n";
+          return 1;
+        }
+
+        writeResults(outFile, assignments, diff.get(), format);
+        outFile.close();
+      }
+      else {
+        CompressedOutputStream outFile(outputFile, compression);
+        writeResults(outFile, assignments, diff.get(), format);
+        outFile.finish();
+      }
 
       if (verbose) {
         std::cout << "\nAssignments written to: " << outputFile << "\n";
       }
     }
 
+    std::unique_ptr<SharedResultsPublisher> publisher;
+
+    if (!publishName.empty()) {
+      publisher.reset(new SharedResultsPublisher(publishName));
+      uint64_t generation = publisher->publish(assignments);
+
+      if (verbose) {
+        std::cout << "Published " << assignments.size() << " row(s) to " << publisher->name() << " (generation "
+                  << generation << ")\n";
+      }
+    }
+
+    if (calendar && !bookingsFile.empty()) {
+      std::ofstream bookingsOut(bookingsFile);
+
+      if (!bookingsOut) {
+        std::cerr << "Error: Cannot open bookings file '" << bookingsFile << "'\n";
+        return 1;
+      }
+
+      bookingsOut << bookings;
+    }
+    else if (calendar) {
+      if (!verbose) {
+        std::cout << ">>>>>>>>>>>>>>>>>>>>>>>>>>>BOOKINGS START\n";
+      }
+      std::cout << bookings;
+
+      if (!verbose) {
+        std::cout << ">>>>>>>>>>>>>>>>>>>>>>>>>>>BOOKINGS END\n";
+      }
+    }
+
+    if (worker) {
+      std::cerr << "Serving marina " << worker->name() << " on " << serveSocket << ": " << worker->freeSlips()
+                << " free slip(s), " << worker->overflow().size() << " unassigned boat(s)\n";
+      worker->serve(serveSocket);
+    }
+
+    if (watched) {
+      return watchInputs(std::move(watched), std::move(assignments), std::move(schedule), slipsFile, membersFile,
+                         ratesFile, pricePerSqFt, outputFile, compressArg, publisher.get());
+    }
+
     return 0;
   }
   catch (const std::exception& e) {
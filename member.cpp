@@ -3,11 +3,19 @@
 
 Member::Member(const std::string &memberId, int boatFeetLength, int boatInchesLength,
                int boatFeetWidth, int boatInchesWidth,
-               const std::optional<std::string> &currentSlip, DockStatus dockStatus)
+               const std::optional<std::string> &currentSlip, DockStatus dockStatus,
+               const std::optional<std::string> &preferredDock)
     : mId(memberId),
       mBoatDimensions(boatFeetLength, boatInchesLength, boatFeetWidth, boatInchesWidth),
       mCurrentSlip(currentSlip),
-      mDockStatus(dockStatus){
+      mDockStatus(dockStatus),
+      mPreferredDock(preferredDock),
+      mRequiredAmenities(0){
+}
+
+void Member::setBoatDrafts(int draftInches, int airDraftInches){
+    mBoatDimensions.setDraftInches(draftInches);
+    mBoatDimensions.setAirDraftInches(airDraftInches);
 }
 
 bool Member::operator<(const Member &other) const{
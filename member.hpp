@@ -1,9 +1,12 @@
 #ifndef MEMBER_H
 #define MEMBER_H
 
+#include "amenities.hpp"
+#include "date_range.hpp"
 #include "dimensions.hpp"
 #include <string>
 #include <optional>
+#include <vector>
 
 class Member {
 public:
@@ -20,16 +23,43 @@ private:
     Dimensions mBoatDimensions;
     std::optional<std::string> mCurrentSlip;
     DockStatus mDockStatus;
+    std::optional<std::string> mPreferredDock;
+    std::vector<std::string> mSlipPreferences;
+    Amenities::Mask mRequiredAmenities;
+    std::vector<DateRange> mAwayDates;
 
 public:
     Member(const std::string &memberId, int boatFeetLength, int boatInchesLength, 
            int boatFeetWidth, int boatInchesWidth, 
-           const std::optional<std::string> &currentSlip, DockStatus dockStatus);
+           const std::optional<std::string> &currentSlip, DockStatus dockStatus,
+           const std::optional<std::string> &preferredDock = std::nullopt);
     
     const std::string &id() const{ return mId; }
     const Dimensions &boatDimensions() const{ return mBoatDimensions; }
     const std::optional<std::string> &currentSlip() const{ return mCurrentSlip; }
+    void setCurrentSlip(const std::optional<std::string> &currentSlip){ mCurrentSlip = currentSlip; }
     DockStatus dockStatus() const{ return mDockStatus; }
+    void setDockStatus(DockStatus dockStatus){ mDockStatus = dockStatus; }
+    const std::optional<std::string> &preferredDock() const{ return mPreferredDock; }
+    
+    // A new boat, as when the member sells theirs and buys another
+    void setBoatDimensions(const Dimensions &boatDimensions){ mBoatDimensions = boatDimensions; }
+    
+    // Boat draft and air draft in inches; 0 when unknown
+    void setBoatDrafts(int draftInches, int airDraftInches);
+    
+    // Amenities a slip must provide for this boat
+    Amenities::Mask requiredAmenities() const{ return mRequiredAmenities; }
+    void setRequiredAmenities(Amenities::Mask requiredAmenities){ mRequiredAmenities = requiredAmenities; }
+    
+    // Slip IDs the member would like, most wanted first; used by stable matching
+    const std::vector<std::string> &slipPreferences() const{ return mSlipPreferences; }
+    void setSlipPreferences(std::vector<std::string> slipPreferences){ mSlipPreferences = std::move(slipPreferences); }
+    
+    // Days the boat is out of its slip during the season (cruising, hauled
+    // out); the slip can be booked to transients then
+    const std::vector<DateRange> &awayDates() const{ return mAwayDates; }
+    void setAwayDates(std::vector<DateRange> awayDates){ mAwayDates = std::move(awayDates); }
     
     static DockStatus stringToDockStatus(const std::string &str);
     static std::string dockStatusToString(DockStatus status);
@@ -0,0 +1,116 @@
+#include "occupancy_journal.hpp"
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+void OccupancyJournal::write(std::ostream &out, const std::vector<Member> &members, const std::vector<Slip> &slips) const{
+    out << "step,member_index,member_id,slip_index,slip_id,index\n";
+
+    for (const auto &entry : mEntries){
+        out << stepToString(entry.mStep) << "," << entry.mMember << "," << members[entry.mMember].id() << ","
+            << entry.mSlip << "," << slips[entry.mSlip].id() << ",";
+
+        if (entry.mIndex != NONE){
+            out << entry.mIndex;
+        }
+
+        out << "\n";
+    }
+}
+
+OccupancyJournal OccupancyJournal::read(std::istream &in, const std::vector<Member> &members, const std::vector<Slip> &slips){
+    OccupancyJournal journal;
+    std::string line;
+    size_t lineNumber = 0;
+
+    while (std::getline(in, line)){
+        lineNumber++;
+
+        if (!line.empty() && line.back() == '\r'){
+            line.pop_back();
+        }
+
+        if (lineNumber == 1 || line.empty()){
+            continue;
+        }
+
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+
+        while (std::getline(stream, field, ',')){
+            fields.push_back(field);
+        }
+
+        if (fields.size() == 5){
+            fields.emplace_back();
+        }
+
+        std::string where = "Journal line " + std::to_string(lineNumber);
+
+        if (fields.size() != 6){
+            throw std::runtime_error(where + ": expected 6 fields");
+        }
+
+        Entry entry;
+
+        try{
+            entry.mStep = stringToStep(fields[0]);
+            entry.mMember = static_cast<uint32_t>(std::stoul(fields[1]));
+            entry.mSlip = static_cast<uint32_t>(std::stoul(fields[3]));
+            entry.mIndex = fields[5].empty() ? NONE : static_cast<uint32_t>(std::stoul(fields[5]));
+        }
+        catch (const std::exception &e){
+            throw std::runtime_error(where + ": " + e.what());
+        }
+
+        if (entry.mMember >= members.size() || members[entry.mMember].id() != fields[2]){
+            throw std::runtime_error(where + ": member " + fields[2] + " is not at index " + fields[1] + " of the inputs");
+        }
+
+        if (entry.mSlip >= slips.size() || slips[entry.mSlip].id() != fields[4]){
+            throw std::runtime_error(where + ": slip " + fields[4] + " is not at index " + fields[3] + " of the inputs");
+        }
+
+        if (entry.mStep == Step::ASSIGNMENT_SET && entry.mIndex != NONE && entry.mIndex >= slips.size()){
+            throw std::runtime_error(where + ": previous slip index out of range");
+        }
+
+        journal.mEntries.push_back(entry);
+    }
+
+    return journal;
+}
+
+std::string OccupancyJournal::stepToString(Step step){
+    switch (step){
+        case Step::OCCUPANT_ADDED:
+            return "occupant-added";
+        case Step::OCCUPANT_REMOVED:
+            return "occupant-removed";
+        case Step::ASSIGNMENT_SET:
+            return "assignment-set";
+        case Step::ASSIGNMENT_CLEARED:
+            return "assignment-cleared";
+    }
+    return "unknown";
+}
+
+OccupancyJournal::Step OccupancyJournal::stringToStep(const std::string &str){
+    if (str == "occupant-added"){
+        return Step::OCCUPANT_ADDED;
+    }
+    else if (str == "occupant-removed"){
+        return Step::OCCUPANT_REMOVED;
+    }
+    else if (str == "assignment-set"){
+        return Step::ASSIGNMENT_SET;
+    }
+    else if (str == "assignment-cleared"){
+        return Step::ASSIGNMENT_CLEARED;
+    }
+    else{
+        throw std::invalid_argument("Invalid journal step: " + str);
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef OCCUPANCY_JOURNAL_H
+#define OCCUPANCY_JOURNAL_H
+
+#include "member.hpp"
+#include "slip.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Undo journal of the occupancy changes AssignmentEngine makes.
+//
+// Each change to who holds which slip is recorded as steps that can be
+// undone one at a time: a boat added to or removed from a slip, and a
+// member's assignment set or cleared. Entries refer to members and slips by
+// their index in the engine's input vectors, so each entry is 16 bytes and
+// recording is a single push_back. Undoing entries back to a mark costs time
+// proportional to the entries undone.
+//
+// The journal can be written as text and read back against the same inputs,
+// so a run's occupancy can be replayed step by step.
+class OccupancyJournal {
+public:
+    enum class Step : uint8_t {
+        OCCUPANT_ADDED,     // Member appended to the slip's occupants
+        OCCUPANT_REMOVED,   // Member removed from the slip's occupants at mIndex
+        ASSIGNMENT_SET,     // Member's assignment set to the slip; mIndex is the previous slip or NONE
+        ASSIGNMENT_CLEARED  // Member's assignment to the slip cleared
+    };
+
+    static constexpr uint32_t NONE = 0xffffffffu;
+
+    struct Entry {
+        uint32_t mMember;
+        uint32_t mSlip;
+        uint32_t mIndex;
+        Step mStep;
+    };
+
+private:
+    std::vector<Entry> mEntries;
+
+public:
+    void record(Step step, uint32_t member, uint32_t slip, uint32_t index = NONE){
+        mEntries.push_back({ member, slip, index, step });
+    }
+
+    const std::vector<Entry> &entries() const{ return mEntries; }
+    size_t size() const{ return mEntries.size(); }
+    void clear(){ mEntries.clear(); }
+
+    // Drop the entries after the first count
+    void truncate(size_t count){ mEntries.resize(count); }
+
+    // One line per entry, after a header:
+    // step,member_index,member_id,slip_index,slip_id,index
+    void write(std::ostream &out, const std::vector<Member> &members, const std::vector<Slip> &slips) const;
+
+    // Read a written journal. Throws std::runtime_error if a line is
+    // malformed or names a member or slip the inputs do not have at that index.
+    static OccupancyJournal read(std::istream &in, const std::vector<Member> &members, const std::vector<Slip> &slips);
+
+    static std::string stepToString(Step step);
+    static Step stringToStep(const std::string &str);
+};
+
+#endif
@@ -0,0 +1,182 @@
+#include "pricing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+RateTable::RateTable(double baseRatePerSqFt)
+    : mBaseRate(baseRatePerSqFt), mHasBaseRate(false){
+}
+
+// Reject a negative rate, multiplier or surcharge.
+static void requireNonNegative(double value, const std::string &what){
+    if (!(value >= 0.0)){
+        throw std::invalid_argument("Invalid " + what + ": " + std::to_string(value));
+    }
+}
+
+void RateTable::setBaseRate(double ratePerSqFt){
+    requireNonNegative(ratePerSqFt, "base rate");
+    mBaseRate = ratePerSqFt;
+    mHasBaseRate = true;
+}
+
+void RateTable::addLengthTier(int minLengthInches, double ratePerSqFt){
+    requireNonNegative(ratePerSqFt, "rate for boats from " + std::to_string(minLengthInches) + " inches");
+
+    auto it = std::lower_bound(mLengthTiers.begin(), mLengthTiers.end(), minLengthInches,
+                               [](const LengthTier &tier, int length){ return tier.mMinLengthInches < length; });
+
+    if (it != mLengthTiers.end() && it->mMinLengthInches == minLengthInches){
+        it->mRatePerSqFt = ratePerSqFt;
+    }
+    else{
+        mLengthTiers.insert(it, LengthTier{ minLengthInches, ratePerSqFt });
+    }
+}
+
+void RateTable::setDockMultiplier(const std::string &dock, double multiplier){
+    requireNonNegative(multiplier, "multiplier for dock " + dock);
+    mDockMultipliers[dock] = multiplier;
+}
+
+void RateTable::setAmenitySurcharge(Amenities::Mask amenity, double amount){
+    requireNonNegative(amount, "surcharge for " + Amenities::toString(amenity));
+
+    for (auto &surcharge : mAmenitySurcharges){
+        if (surcharge.first == amenity){
+            surcharge.second = amount;
+            return;
+        }
+    }
+
+    mAmenitySurcharges.emplace_back(amenity, amount);
+}
+
+void RateTable::setStatusDiscount(Member::DockStatus status, double percent){
+    if (!(percent >= 0.0 && percent <= 100.0)){
+        throw std::invalid_argument("Invalid discount for " + Member::dockStatusToString(status) + ": " +
+                                    std::to_string(percent));
+    }
+
+    mStatusDiscounts[status] = percent;
+}
+
+double RateTable::dockMultiplier(const std::string &dock) const{
+    auto it = mDockMultipliers.find(dock);
+    return it == mDockMultipliers.end() ? 1.0 : it->second;
+}
+
+// A surcharge keyed by several amenities applies when the slip has all of them.
+double RateTable::amenitySurcharge(Amenities::Mask amenities) const{
+    double total = 0.0;
+
+    for (const auto &surcharge : mAmenitySurcharges){
+        if (Amenities::provides(amenities, surcharge.first)){
+            total += surcharge.second;
+        }
+    }
+
+    return total;
+}
+
+double RateTable::statusDiscount(Member::DockStatus status) const{
+    auto it = mStatusDiscounts.find(status);
+    return it == mStatusDiscounts.end() ? 0.0 : it->second;
+}
+
+PriceSchedule::PriceSchedule(const RateTable &rates, const std::vector<Slip> &slips){
+    for (uint32_t i = 0; i < slips.size(); ++i){
+        if (!mSlipPositions.emplace(slips[i].id(), static_cast<uint32_t>(mSlipLength.size())).second){
+            continue;
+        }
+
+        const Slip &slip = slips[i];
+        mSlipLength.push_back(slip.maxDimensions().lengthInches());
+        mSlipWidth.push_back(slip.maxDimensions().widthInches());
+        mSlipShared.push_back(slip.shared());
+        mSlipMultiplier.push_back(rates.dockMultiplier(slip.dock()));
+        mSlipSurcharge.push_back(rates.amenitySurcharge(slip.amenities()));
+    }
+
+    // Tier 0 is the base rate, from length 0
+    mTierLengths.push_back(0);
+    mTierRates.push_back(rates.baseRate());
+
+    for (const auto &tier : rates.lengthTiers()){
+        if (tier.mMinLengthInches <= 0){
+            mTierRates[0] = tier.mRatePerSqFt;
+            continue;
+        }
+
+        mTierLengths.push_back(tier.mMinLengthInches);
+        mTierRates.push_back(tier.mRatePerSqFt);
+    }
+
+    for (Member::DockStatus status : { Member::DockStatus::PERMANENT, Member::DockStatus::YEAR_OFF,
+                                       Member::DockStatus::WAITING_LIST, Member::DockStatus::TEMPORARY,
+                                       Member::DockStatus::UNASSIGNED }){
+        mStatusFactors.push_back(1.0 - rates.statusDiscount(status) / 100.0);
+    }
+}
+
+void PriceSchedule::price(std::vector<Assignment> &assignments) const{
+    const uint32_t NONE = 0xffffffffu;
+    size_t count = assignments.size();
+    std::vector<uint32_t> slip(count, NONE);
+    std::vector<int> boatLength(count);
+    std::vector<int> boatWidth(count);
+    std::vector<uint8_t> status(count);
+
+    // Gather the columns
+    for (size_t i = 0; i < count; ++i){
+        const Assignment &assignment = assignments[i];
+        boatLength[i] = assignment.boatDimensions().lengthInches();
+        boatWidth[i] = assignment.boatDimensions().widthInches();
+        status[i] = static_cast<uint8_t>(assignment.dockStatus());
+
+        if (!assignment.assigned()){
+            continue;
+        }
+
+        auto it = mSlipPositions.find(assignment.slipId());
+
+        if (it == mSlipPositions.end()){
+            throw std::invalid_argument("Unknown slip for member " + assignment.memberId() + ": " + assignment.slipId());
+        }
+
+        slip[i] = it->second;
+    }
+
+    // Billable area in square inches: the larger of the boat and the slip,
+    // or for a shared slip its length by the boat's width
+    std::vector<double> area(count, 0.0);
+
+    for (size_t i = 0; i < count; ++i){
+        if (slip[i] == NONE){
+            continue;
+        }
+
+        uint32_t s = slip[i];
+        double slipArea = static_cast<double>(mSlipLength[s]) * (mSlipShared[s] ? boatWidth[i] : mSlipWidth[s]);
+        area[i] = std::max(static_cast<double>(boatLength[i]) * boatWidth[i], slipArea);
+    }
+
+    // Rate per square foot by length tier
+    std::vector<double> rate(count);
+
+    for (size_t i = 0; i < count; ++i){
+        size_t tier = std::upper_bound(mTierLengths.begin(), mTierLengths.end(), boatLength[i]) - mTierLengths.begin();
+        rate[i] = mTierRates[tier - 1];
+    }
+
+    for (size_t i = 0; i < count; ++i){
+        if (slip[i] == NONE){
+            assignments[i].setPrice(0.0);
+            continue;
+        }
+
+        uint32_t s = slip[i];
+        double amount = (area[i] / 144.0 * rate[i] * mSlipMultiplier[s] + mSlipSurcharge[s]) * mStatusFactors[status[i]];
+        assignments[i].setPrice(std::round(amount * 100.0) / 100.0);
+    }
+}
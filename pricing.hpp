@@ -0,0 +1,93 @@
+#ifndef PRICING_H
+#define PRICING_H
+
+#include "amenities.hpp"
+#include "assignment.hpp"
+#include "member.hpp"
+#include "slip.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The marina's rates: a base price per square foot, replaced for longer
+// boats by length tiers, scaled per dock, plus flat surcharges for slip
+// amenities and a percentage discount by member dock status.
+//
+// A boat is priced as
+//
+//     (billable sq ft * tier rate * dock multiplier + amenity surcharges)
+//         * (1 - status discount / 100)
+//
+// rounded to cents, where billable sq ft is the larger of the boat and its
+// billed slip area, as for the flat rate. Unassigned rows are not priced.
+class RateTable {
+public:
+    // Boats at least this long pay this rate instead of the base rate
+    struct LengthTier {
+        int mMinLengthInches;
+        double mRatePerSqFt;
+    };
+
+private:
+    double mBaseRate;
+    std::vector<LengthTier> mLengthTiers;
+    std::unordered_map<std::string, double> mDockMultipliers;
+    std::vector<std::pair<Amenities::Mask, double>> mAmenitySurcharges;
+    std::unordered_map<Member::DockStatus, double> mStatusDiscounts;
+    bool mHasBaseRate;
+
+public:
+    explicit RateTable(double baseRatePerSqFt = 0.0);
+
+    double baseRate() const{ return mBaseRate; }
+
+    // Whether the base rate was set by a rule rather than the constructor,
+    // so a rate table file can override the command line's flat rate
+    bool hasBaseRate() const{ return mHasBaseRate; }
+
+    const std::vector<LengthTier> &lengthTiers() const{ return mLengthTiers; }
+
+    // Rules; a later rule for the same tier, dock, amenity or status
+    // replaces the earlier one. Negative rates, multipliers and surcharges,
+    // and discounts outside 0-100, throw std::invalid_argument.
+    void setBaseRate(double ratePerSqFt);
+    void addLengthTier(int minLengthInches, double ratePerSqFt);
+    void setDockMultiplier(const std::string &dock, double multiplier);
+    void setAmenitySurcharge(Amenities::Mask amenity, double amount);
+    void setStatusDiscount(Member::DockStatus status, double percent);
+
+    double dockMultiplier(const std::string &dock) const;
+
+    // Sum of the surcharges for the amenities in a slip's mask
+    double amenitySurcharge(Amenities::Mask amenities) const;
+
+    double statusDiscount(Member::DockStatus status) const;
+};
+
+// A rate table compiled against a marina's slips.
+//
+// Everything that depends only on the slip - its billed length and width,
+// dock multiplier and amenity surcharge - is worked out once per slip, so
+// pricing a result is a slip ID lookup per row followed by arithmetic over
+// flat arrays: rows are gathered into columns (slip position, boat area and
+// length, status), priced column-wise, and the prices written back.
+class PriceSchedule {
+    std::unordered_map<std::string, uint32_t> mSlipPositions;
+    std::vector<int> mSlipLength;
+    std::vector<int> mSlipWidth;
+    std::vector<bool> mSlipShared;
+    std::vector<double> mSlipMultiplier;
+    std::vector<double> mSlipSurcharge;
+    std::vector<int> mTierLengths;
+    std::vector<double> mTierRates;
+    std::vector<double> mStatusFactors;
+
+public:
+    PriceSchedule(const RateTable &rates, const std::vector<Slip> &slips);
+
+    // Price every assigned row in place; unassigned rows get 0. A row whose
+    // slip is not in the schedule throws std::invalid_argument.
+    void price(std::vector<Assignment> &assignments) const;
+};
+
+#endif
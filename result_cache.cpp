@@ -0,0 +1,314 @@
+#include "result_cache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint64_t PRIME1 = 0x9e3779b185ebca87ull;
+static const uint64_t PRIME2 = 0xc2b2ae3d27d4eb4full;
+static const uint64_t PRIME3 = 0x165667b19e3779f9ull;
+static const uint64_t PRIME4 = 0x85ebca77c2b2ae63ull;
+static const uint64_t PRIME5 = 0x27d4eb2f165667c5ull;
+
+static uint64_t rotate(uint64_t value, int bits){
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Little-endian reads, as the reference implementation does
+static uint64_t read64(const unsigned char *p){
+    uint64_t value = 0;
+
+    for (int i = 7; i >= 0; --i){
+        value = (value << 8) | p[i];
+    }
+
+    return value;
+}
+
+static uint32_t read32(const unsigned char *p){
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 | static_cast<uint32_t>(p[2]) << 16 |
+           static_cast<uint32_t>(p[3]) << 24;
+}
+
+static uint64_t round64(uint64_t accumulator, uint64_t input){
+    accumulator += input * PRIME2;
+    return rotate(accumulator, 31) * PRIME1;
+}
+
+static uint64_t mergeRound(uint64_t hash, uint64_t accumulator){
+    hash ^= round64(0, accumulator);
+    return hash * PRIME1 + PRIME4;
+}
+
+uint64_t xxhash64(const void *data, size_t size, uint64_t seed){
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    const unsigned char *end = p + size;
+    uint64_t hash;
+
+    if (size >= 32){
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+
+        // 32-byte stripes across four lanes
+        for (; end - p >= 32; p += 32){
+            v1 = round64(v1, read64(p));
+            v2 = round64(v2, read64(p + 8));
+            v3 = round64(v3, read64(p + 16));
+            v4 = round64(v4, read64(p + 24));
+        }
+
+        hash = rotate(v1, 1) + rotate(v2, 7) + rotate(v3, 12) + rotate(v4, 18);
+        hash = mergeRound(hash, v1);
+        hash = mergeRound(hash, v2);
+        hash = mergeRound(hash, v3);
+        hash = mergeRound(hash, v4);
+    }
+    else{
+        hash = seed + PRIME5;
+    }
+
+    hash += size;
+
+    for (; end - p >= 8; p += 8){
+        hash ^= round64(0, read64(p));
+        hash = rotate(hash, 27) * PRIME1 + PRIME4;
+    }
+
+    if (end - p >= 4){
+        hash ^= read32(p) * PRIME1;
+        hash = rotate(hash, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+
+    for (; p < end; ++p){
+        hash ^= *p * PRIME5;
+        hash = rotate(hash, 11) * PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+MappedFile::MappedFile(const std::string &path)
+    : mData(nullptr), mSize(0){
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0){
+        throw std::runtime_error("Cannot open file '" + path + "': " + std::strerror(errno));
+    }
+
+    struct stat info;
+
+    if (::fstat(fd, &info) != 0){
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Cannot read file '" + path + "': " + std::strerror(error));
+    }
+
+    mSize = static_cast<size_t>(info.st_size);
+
+    // An empty file cannot be mapped, and needs no mapping
+    if (mSize > 0){
+        void *mapping = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping == MAP_FAILED){
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("Cannot map file '" + path + "': " + std::strerror(error));
+        }
+
+        mData = static_cast<const char *>(mapping);
+    }
+
+    ::close(fd);
+}
+
+MappedFile::~MappedFile(){
+    if (mData){
+        ::munmap(const_cast<char *>(mData), mSize);
+    }
+}
+
+ResultCache::Key::Key()
+    : mHash(0){
+}
+
+ResultCache::Key &ResultCache::Key::add(const void *data, size_t size){
+    uint64_t length = size;
+    mHash = xxhash64(&length, sizeof(length), mHash);
+    mHash = xxhash64(data, size, mHash);
+    return *this;
+}
+
+ResultCache::Key &ResultCache::Key::add(const std::string &text){
+    return add(text.data(), text.size());
+}
+
+ResultCache::Key &ResultCache::Key::add(bool value){
+    char byte = value ? 1 : 0;
+    return add(&byte, 1);
+}
+
+ResultCache::Key &ResultCache::Key::add(double value){
+    return add(&value, sizeof(value));
+}
+
+ResultCache::Key &ResultCache::Key::addFile(const std::string &path){
+    MappedFile file(path);
+    return add(file.data(), file.size());
+}
+
+ResultCache::ResultCache(const std::string &directory, uint64_t maxBytes)
+    : mDirectory(directory), mMaxBytes(maxBytes){
+    if (maxBytes == 0){
+        throw std::invalid_argument("Invalid cache size: must be more than zero");
+    }
+
+    std::filesystem::create_directories(directory);
+}
+
+std::string ResultCache::entryPath(uint64_t key) const{
+    static const char DIGITS[] = "0123456789abcdef";
+    std::string name(16, '0');
+
+    for (int i = 15; i >= 0; --i){
+        name[i] = DIGITS[key & 0xf];
+        key >>= 4;
+    }
+
+    return (std::filesystem::path(mDirectory) / (name + ".out")).string();
+}
+
+std::unique_ptr<MappedFile> ResultCache::find(uint64_t key) const{
+    std::string path = entryPath(key);
+
+    // Mark the entry used; a missing entry is a miss
+    if (::utimensat(AT_FDCWD, path.c_str(), nullptr, 0) != 0){
+        return nullptr;
+    }
+
+    try{
+        return std::unique_ptr<MappedFile>(new MappedFile(path));
+    }
+    catch (const std::runtime_error &){
+        // Evicted since it was marked
+        return nullptr;
+    }
+}
+
+void ResultCache::store(uint64_t key, const std::string &output) const{
+    if (output.size() > mMaxBytes){
+        return;
+    }
+
+    // Unique among processes by PID and among threads by counter
+    static std::atomic<unsigned> nextTemporary(0);
+    std::string path = entryPath(key);
+    std::string temporary = path + "." + std::to_string(::getpid()) + "." + std::to_string(nextTemporary++) + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+
+    if (fd < 0){
+        throw std::runtime_error("Cannot write cache file '" + temporary + "': " + std::strerror(errno));
+    }
+
+    const char *data = output.data();
+    size_t remaining = output.size();
+
+    while (remaining > 0){
+        ssize_t written = ::write(fd, data, remaining);
+
+        if (written < 0 && errno == EINTR){
+            continue;
+        }
+
+        if (written < 0){
+            int error = errno;
+            ::close(fd);
+            ::unlink(temporary.c_str());
+            throw std::runtime_error("Cannot write cache file '" + temporary + "': " + std::strerror(error));
+        }
+
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    ::close(fd);
+
+    if (::rename(temporary.c_str(), path.c_str()) != 0){
+        int error = errno;
+        ::unlink(temporary.c_str());
+        throw std::runtime_error("Cannot write cache file '" + path + "': " + std::strerror(error));
+    }
+
+    evict();
+}
+
+// Remove the least recently used entries until the rest fit. Other runs may
+// be evicting at the same time, so entries that vanish are skipped.
+void ResultCache::evict() const{
+    struct Entry {
+        std::filesystem::path mPath;
+        std::filesystem::file_time_type mUsed;
+        uint64_t mSize;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    std::error_code error;
+    // Temporary files this old were left by runs that died mid-write
+    auto abandoned = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+
+    for (std::filesystem::directory_iterator it(mDirectory, error), end; !error && it != end; it.increment(error)){
+        std::string name = it->path().filename().string();
+        auto used = std::filesystem::last_write_time(it->path(), error);
+        uint64_t size = error ? 0 : std::filesystem::file_size(it->path(), error);
+
+        if (error){
+            error.clear();
+            continue;
+        }
+
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0){
+            if (used < abandoned){
+                std::filesystem::remove(it->path(), error);
+                error.clear();
+            }
+
+            continue;
+        }
+
+        if (name.size() == 20 && name.compare(16, 4, ".out") == 0){
+            entries.push_back(Entry{ it->path(), used, size });
+            total += size;
+        }
+    }
+
+    if (total <= mMaxBytes){
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b){ return a.mUsed < b.mUsed; });
+
+    for (const auto &entry : entries){
+        if (total <= mMaxBytes){
+            break;
+        }
+
+        std::filesystem::remove(entry.mPath, error);
+        total -= entry.mSize;
+    }
+}
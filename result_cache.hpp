@@ -0,0 +1,83 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// 64-bit xxHash (XXH64) of a buffer
+uint64_t xxhash64(const void *data, size_t size, uint64_t seed = 0);
+
+// A whole file mapped read-only into memory. The mapping stays valid after
+// the file is replaced or removed.
+class MappedFile {
+    const char *mData;
+    size_t mSize;
+
+public:
+    // Throws std::runtime_error for a file that cannot be opened or mapped
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const{ return mData; }
+    size_t size() const{ return mSize; }
+};
+
+// Outputs of earlier runs on disk, found by a hash of everything that went
+// into them: the input files' contents and the options that change the
+// output.
+//
+// Each entry is one file named by its key in hex. Entries are written to a
+// temporary file and renamed into place, so a concurrent run sees either
+// the whole entry or none, and a run reading an entry keeps its mapping
+// when another replaces or evicts it. Finding an entry refreshes its
+// modification time, and storing one removes the least recently used
+// entries until the cache fits its size.
+class ResultCache {
+    std::string mDirectory;
+    uint64_t mMaxBytes;
+
+    std::string entryPath(uint64_t key) const;
+    void evict() const;
+
+public:
+    // Hash of a run's inputs, built up part by part. Each part is hashed
+    // with its length, so parts cannot run into each other.
+    class Key {
+        uint64_t mHash;
+
+    public:
+        Key();
+
+        Key &add(const void *data, size_t size);
+        Key &add(const std::string &text);
+        Key &add(bool value);
+        Key &add(double value);
+
+        // The contents of a file, mapped rather than read; throws
+        // std::runtime_error for a file that cannot be opened
+        Key &addFile(const std::string &path);
+
+        uint64_t hash() const{ return mHash; }
+    };
+
+    // Creates the directory if needed. Throws std::invalid_argument for a
+    // size of zero.
+    ResultCache(const std::string &directory, uint64_t maxBytes);
+
+    // The stored output for a key, or null when there is none
+    std::unique_ptr<MappedFile> find(uint64_t key) const;
+
+    // Store an output under a key, then evict down to the cache size. An
+    // output larger than the whole cache is not stored.
+    void store(uint64_t key, const std::string &output) const;
+
+    const std::string &directory() const{ return mDirectory; }
+    uint64_t maxBytes() const{ return mMaxBytes; }
+};
+
+#endif
@@ -0,0 +1,319 @@
+#include "seniority_archive.hpp"
+#include "csv_parser.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+SeniorityArchive::SeniorityArchive()
+    : mFirstYear(0), mLastYear(0){
+}
+
+int SeniorityArchive::yearOf(const std::string &filename){
+    size_t i = 0;
+
+    while (i < filename.size()){
+        if (!std::isdigit(static_cast<unsigned char>(filename[i]))){
+            ++i;
+            continue;
+        }
+
+        size_t end = i;
+
+        while (end < filename.size() && std::isdigit(static_cast<unsigned char>(filename[end]))){
+            ++end;
+        }
+
+        if (end - i == 4){
+            return std::stoi(filename.substr(i, 4));
+        }
+
+        i = end;
+    }
+
+    return 0;
+}
+
+size_t SeniorityArchive::ingestDirectory(const std::string &directory){
+    std::vector<std::filesystem::path> unread;
+
+    for (const auto &entry : std::filesystem::directory_iterator(directory)){
+        std::string name = entry.path().filename().string();
+
+        // Other files in the directory, such as the season's inputs, have no year
+        if (entry.is_regular_file() && name.find(".csv") != std::string::npos &&
+            yearOf(name) != 0 && mFiles.count(name) == 0){
+            unread.push_back(entry.path());
+        }
+    }
+
+    std::sort(unread.begin(), unread.end());
+
+    for (const auto &path : unread){
+        ingestFile(path.string(), yearOf(path.filename().string()));
+    }
+
+    return unread.size();
+}
+
+void SeniorityArchive::ingestFile(const std::string &path, int year){
+    std::string name = std::filesystem::path(path).filename().string();
+
+    for (const auto &file : mFiles){
+        if (file.second == year){
+            throw std::invalid_argument("Invalid archive file " + name + ": " + std::to_string(year) +
+                                        " is already archived from " + file.first);
+        }
+    }
+
+    std::vector<std::pair<std::string, char>> members;
+
+    for (const auto &record : CsvParser::parsePreviousAssignments(path)){
+        const std::string &dockStatus = record.dockStatus();
+        char entry = 'U';
+
+        if (!record.slipId().empty()){
+            entry = 'S';
+        }
+        else if (dockStatus.empty() || dockStatus == "waiting-list"){
+            // Files older than the dock_status column list only slips and the waiting list
+            entry = 'W';
+        }
+        else if (dockStatus == "year-off"){
+            entry = 'Y';
+        }
+
+        members.emplace_back(record.memberId(), entry);
+    }
+
+    addYear(year, members);
+    mFiles[name] = year;
+    index();
+}
+
+// Which entry wins for a member listed twice in one year
+static int rank(char entry){
+    static const char ORDER[] = "-UYWS";
+    return static_cast<int>(std::string(ORDER).find(entry));
+}
+
+void SeniorityArchive::addYear(int year, const std::vector<std::pair<std::string, char>> &members){
+    if (mFiles.empty()){
+        mFirstYear = year;
+        mLastYear = year;
+    }
+    else if (year < mFirstYear){
+        for (auto &history : mHistories){
+            history.insert(0, static_cast<size_t>(mFirstYear - year), '-');
+        }
+
+        mFirstYear = year;
+    }
+    else if (year > mLastYear){
+        for (auto &history : mHistories){
+            history.append(static_cast<size_t>(year - mLastYear), '-');
+        }
+
+        mLastYear = year;
+    }
+
+    size_t span = static_cast<size_t>(mLastYear - mFirstYear + 1);
+    size_t column = static_cast<size_t>(year - mFirstYear);
+
+    for (const auto &member : members){
+        auto inserted = mPositions.emplace(member.first, static_cast<uint32_t>(mMemberIds.size()));
+
+        if (inserted.second){
+            mMemberIds.push_back(member.first);
+            mHistories.emplace_back(span, '-');
+        }
+
+        char &entry = mHistories[inserted.first->second][column];
+
+        if (rank(member.second) > rank(entry)){
+            entry = member.second;
+        }
+    }
+}
+
+void SeniorityArchive::index(){
+    std::vector<bool> archived(static_cast<size_t>(mLastYear - mFirstYear + 1), false);
+
+    for (const auto &file : mFiles){
+        archived[file.second - mFirstYear] = true;
+    }
+
+    mTenures.assign(mHistories.size(), Tenure());
+
+    for (size_t m = 0; m < mHistories.size(); ++m){
+        const std::string &history = mHistories[m];
+        Tenure &tenure = mTenures[m];
+        bool continuous = true;
+
+        for (size_t column = history.size(); column-- > 0;){
+            if (!archived[column]){
+                continue;
+            }
+
+            if (history[column] == 'S'){
+                ++tenure.mSlipYears;
+
+                if (continuous){
+                    ++tenure.mContinuousYears;
+                }
+            }
+            else if (history[column] == 'Y'){
+                // A year off keeps the slip, so it neither counts nor breaks the run
+                continue;
+            }
+            else{
+                continuous = false;
+
+                if (history[column] == 'W'){
+                    ++tenure.mWaitingYears;
+                }
+            }
+        }
+    }
+}
+
+SeniorityArchive::Tenure SeniorityArchive::tenure(const std::string &memberId) const{
+    auto it = mPositions.find(memberId);
+    return it == mPositions.end() ? Tenure() : mTenures[it->second];
+}
+
+double SeniorityArchive::seniority(const std::string &memberId, const SeniorityWeights &weights) const{
+    Tenure years = tenure(memberId);
+    return weights.mSlipYears * years.mSlipYears + weights.mWaitingYears * years.mWaitingYears +
+           weights.mContinuousYears * years.mContinuousYears;
+}
+
+void SeniorityArchive::save(std::ostream &out) const{
+    out << "kind,key,value\n";
+
+    for (const auto &file : mFiles){
+        out << "file," << file.second << "," << file.first << "\n";
+    }
+
+    for (size_t m = 0; m < mMemberIds.size(); ++m){
+        out << "member," << mMemberIds[m] << "," << mHistories[m] << "\n";
+    }
+}
+
+void SeniorityArchive::save(const std::string &filename) const{
+    std::ofstream out(filename);
+
+    if (!out){
+        throw std::runtime_error("Cannot open archive file '" + filename + "'");
+    }
+
+    save(out);
+}
+
+SeniorityArchive SeniorityArchive::load(std::istream &in){
+    SeniorityArchive archive;
+    std::vector<std::pair<std::string, std::string>> members;
+    std::string line;
+    size_t lineNumber = 0;
+
+    while (std::getline(in, line)){
+        lineNumber++;
+
+        if (!line.empty() && line.back() == '\r'){
+            line.pop_back();
+        }
+
+        if (lineNumber == 1){
+            if (line != "kind,key,value"){
+                throw std::runtime_error("Not a seniority archive");
+            }
+
+            continue;
+        }
+
+        if (line.empty()){
+            continue;
+        }
+
+        std::string where = "Archive line " + std::to_string(lineNumber);
+        size_t kindEnd = line.find(',');
+
+        if (kindEnd == std::string::npos){
+            throw std::runtime_error(where + ": expected 3 fields");
+        }
+
+        std::string kind = line.substr(0, kindEnd);
+
+        if (kind == "file"){
+            // File names may contain commas; years do not
+            size_t keyEnd = line.find(',', kindEnd + 1);
+
+            if (keyEnd == std::string::npos){
+                throw std::runtime_error(where + ": expected 3 fields");
+            }
+
+            try{
+                archive.mFiles[line.substr(keyEnd + 1)] = std::stoi(line.substr(kindEnd + 1, keyEnd - kindEnd - 1));
+            }
+            catch (const std::exception &e){
+                throw std::runtime_error(where + ": " + e.what());
+            }
+        }
+        else if (kind == "member"){
+            // Member IDs may contain commas; histories do not
+            size_t valueStart = line.rfind(',');
+
+            if (valueStart == kindEnd){
+                throw std::runtime_error(where + ": expected 3 fields");
+            }
+
+            members.emplace_back(line.substr(kindEnd + 1, valueStart - kindEnd - 1), line.substr(valueStart + 1));
+        }
+        else{
+            throw std::runtime_error(where + ": unknown kind " + kind);
+        }
+    }
+
+    if (archive.mFiles.empty()){
+        if (!members.empty()){
+            throw std::runtime_error("Archive has members but no files");
+        }
+
+        return archive;
+    }
+
+    archive.mFirstYear = archive.mFiles.begin()->second;
+    archive.mLastYear = archive.mFirstYear;
+
+    for (const auto &file : archive.mFiles){
+        archive.mFirstYear = std::min(archive.mFirstYear, file.second);
+        archive.mLastYear = std::max(archive.mLastYear, file.second);
+    }
+
+    size_t span = static_cast<size_t>(archive.mLastYear - archive.mFirstYear + 1);
+
+    for (auto &member : members){
+        if (member.second.size() != span || member.second.find_first_not_of("SWYU-") != std::string::npos){
+            throw std::runtime_error("Archive history for member " + member.first + " does not match its years");
+        }
+
+        if (archive.mPositions.emplace(member.first, static_cast<uint32_t>(archive.mMemberIds.size())).second){
+            archive.mMemberIds.push_back(member.first);
+            archive.mHistories.push_back(std::move(member.second));
+        }
+    }
+
+    archive.index();
+    return archive;
+}
+
+SeniorityArchive SeniorityArchive::load(const std::string &filename){
+    std::ifstream in(filename);
+
+    if (!in){
+        throw std::runtime_error("Cannot open archive file '" + filename + "'");
+    }
+
+    return load(in);
+}
@@ -0,0 +1,100 @@
+#ifndef SENIORITY_ARCHIVE_H
+#define SENIORITY_ARCHIVE_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// How a member's history weighs into their priority. A member's seniority
+// is the weighted sum of their years; higher seniority goes first within a
+// dock status, and equal seniority falls back to member ID.
+struct SeniorityWeights {
+    double mSlipYears = 1.0;
+    double mWaitingYears = 1.0;
+    double mContinuousYears = 0.0;
+};
+
+// Every season's assignment output, kept as one line of history per member.
+//
+// Each archived year is a file such as "2025 Assignments.csv"; the year is
+// the first four-digit number in its name. A member listed with a slip
+// held one that year. Without a slip, the file's dock_status decides: only
+// waiting-list counts as waiting, and year-off neither counts nor breaks a
+// run of slip years. Files without a dock_status column predate it and
+// list only slips and the waiting list, so their rows without a slip
+// count as waiting. The archive
+// remembers which files it has read, so ingesting a directory again only
+// reads the new ones, and it saves as text:
+//
+//     kind,key,value
+//     file,2024,2024 Assignments.csv
+//     file,2025,2025 Assignments.csv
+//     member,1212,SS
+//     member,2036,-W
+//
+// with one character per year from the first archived year: S for a slip,
+// W for waiting, Y for a year off, U for listed with neither, - for not
+// listed.
+//
+// Tenure is indexed by member ID whenever the archive changes, so looking a
+// member up is a single hash lookup.
+class SeniorityArchive {
+public:
+    struct Tenure {
+        uint16_t mSlipYears = 0;
+        uint16_t mWaitingYears = 0;
+        // Archived years, counting back from the latest, in which the
+        // member held a slip without a break
+        uint16_t mContinuousYears = 0;
+    };
+
+private:
+    // Files read, by name, with their year
+    std::map<std::string, int> mFiles;
+    int mFirstYear;
+    int mLastYear;
+    std::unordered_map<std::string, uint32_t> mPositions;
+    std::vector<std::string> mMemberIds;
+    std::vector<std::string> mHistories;
+    std::vector<Tenure> mTenures;
+
+    void addYear(int year, const std::vector<std::pair<std::string, char>> &members);
+    void index();
+
+public:
+    SeniorityArchive();
+
+    // Read the CSV files in a directory that the archive has not read yet,
+    // skipping those without a year in their name, and return how many
+    // were read. Files are matched by name, so a file that changes after
+    // it was read must be renamed to be read again. Throws
+    // std::invalid_argument for a year already archived from another file.
+    size_t ingestDirectory(const std::string &directory);
+
+    // Read one assignment file for a year
+    void ingestFile(const std::string &path, int year);
+
+    // A file name's year: the first four-digit number in it, or 0
+    static int yearOf(const std::string &filename);
+
+    void save(std::ostream &out) const;
+    void save(const std::string &filename) const;
+
+    // Throws std::runtime_error for text that is not an archive
+    static SeniorityArchive load(std::istream &in);
+    static SeniorityArchive load(const std::string &filename);
+
+    size_t years() const{ return mFiles.size(); }
+    size_t members() const{ return mMemberIds.size(); }
+
+    // Tenure of a member; all zero for a member never archived
+    Tenure tenure(const std::string &memberId) const;
+
+    // Weighted seniority of a member
+    double seniority(const std::string &memberId, const SeniorityWeights &weights) const;
+};
+
+#endif
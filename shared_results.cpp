@@ -0,0 +1,383 @@
+#include "shared_results.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared results need lock-free 64-bit atomics");
+
+static const char MAGIC[8] = { 'S', 'L', 'I', 'P', 'P', 'A', 'G', 'E' };
+static const uint32_t VERSION = 1;
+
+static std::string segmentName(const std::string &name){
+    return !name.empty() && name[0] == '/' ? name : "/" + name;
+}
+
+static uint64_t align(uint64_t offset, uint64_t boundary){
+    return (offset + boundary - 1) / boundary * boundary;
+}
+
+static void checkLayout(const SharedResultsHeader *header, const std::string &name){
+    if (std::memcmp(header->mMagic, MAGIC, sizeof(MAGIC)) != 0){
+        throw std::runtime_error("Shared memory '" + name + "' does not hold slippage results");
+    }
+
+    if (header->mVersion != VERSION || header->mHeaderBytes != sizeof(SharedResultsHeader)){
+        throw std::runtime_error("Shared memory '" + name + "' holds results layout version " +
+                                 std::to_string(header->mVersion) + ", not " + std::to_string(VERSION));
+    }
+}
+
+SharedTable::SharedTable()
+    : mTable(nullptr), mHeader(), mBytes(0), mSequence(nullptr), mSeen(0), mGeneration(0){
+}
+
+SharedTable::SharedTable(const char *table, const SharedTableHeader &header, uint64_t bytes,
+                         const std::atomic<uint64_t> *sequence, uint64_t seen, uint64_t generation)
+    : mTable(table), mHeader(header), mBytes(bytes), mSequence(sequence), mSeen(seen), mGeneration(generation){
+}
+
+std::string_view SharedTable::text(SharedTableHeader::Column column, size_t row) const{
+    const uint32_t *offsets = data<uint32_t>(column);
+    SharedTableHeader::Column bytesColumn = static_cast<SharedTableHeader::Column>(column + 1);
+    uint32_t begin = offsets[row];
+    uint32_t end = offsets[row + 1];
+
+    // Offsets from a table being overwritten; valid() will say so
+    if (end < begin || end > mBytes - mHeader.mColumns[bytesColumn]){
+        return std::string_view();
+    }
+
+    return std::string_view(data<char>(bytesColumn) + begin, end - begin);
+}
+
+bool SharedTable::valid() const{
+    // Reads of the table happen before the sequence is checked again
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return !mSequence || mSequence->load(std::memory_order_relaxed) == mSeen;
+}
+
+SharedResultsPublisher::SharedResultsPublisher(const std::string &name)
+    : mName(segmentName(name)), mFd(::shm_open(mName.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)), mData(nullptr),
+      mSize(0){
+    if (mFd < 0){
+        throw std::runtime_error("Cannot open shared memory '" + mName + "': " + std::strerror(errno));
+    }
+
+    // Another publisher may be setting the segment up
+    ::flock(mFd, LOCK_EX);
+
+    try{
+        struct stat info;
+
+        if (::fstat(mFd, &info) != 0){
+            throw std::runtime_error("Cannot read shared memory '" + mName + "': " + std::strerror(errno));
+        }
+
+        if (info.st_size == 0){
+            size_t size = align(sizeof(SharedResultsHeader), static_cast<uint64_t>(::sysconf(_SC_PAGESIZE)));
+
+            if (::ftruncate(mFd, static_cast<off_t>(size)) != 0){
+                throw std::runtime_error("Cannot size shared memory '" + mName + "': " + std::strerror(errno));
+            }
+
+            // New memory is zero: generation 0, empty slots
+            map(size);
+            header()->mVersion = VERSION;
+            header()->mHeaderBytes = sizeof(SharedResultsHeader);
+            std::memcpy(header()->mMagic, MAGIC, sizeof(MAGIC));
+        }
+        else{
+            map(static_cast<size_t>(info.st_size));
+            checkLayout(header(), mName);
+        }
+    }
+    catch (...){
+        if (mData){
+            ::munmap(mData, mSize);
+        }
+
+        ::flock(mFd, LOCK_UN);
+        ::close(mFd);
+        throw;
+    }
+
+    ::flock(mFd, LOCK_UN);
+}
+
+SharedResultsPublisher::~SharedResultsPublisher(){
+    ::munmap(mData, mSize);
+    ::close(mFd);
+}
+
+void SharedResultsPublisher::map(size_t size){
+    if (mData){
+        ::munmap(mData, mSize);
+        mData = nullptr;
+    }
+
+    void *mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+
+    if (mapping == MAP_FAILED){
+        throw std::runtime_error("Cannot map shared memory '" + mName + "': " + std::strerror(errno));
+    }
+
+    mData = static_cast<char *>(mapping);
+    mSize = size;
+}
+
+uint64_t SharedResultsPublisher::publish(const std::vector<Assignment> &assignments){
+    using Column = SharedTableHeader::Column;
+    size_t rows = assignments.size();
+    uint64_t sizes[SharedTableHeader::COLUMN_COUNT] = {};
+
+    for (Column text : { SharedTableHeader::MEMBER_ID, SharedTableHeader::SLIP_ID, SharedTableHeader::COMMENT }){
+        sizes[text] = (rows + 1) * sizeof(uint32_t);
+    }
+
+    for (const auto &assignment : assignments){
+        sizes[SharedTableHeader::MEMBER_ID_BYTES] += assignment.memberId().size();
+        sizes[SharedTableHeader::SLIP_ID_BYTES] += assignment.slipId().size();
+        sizes[SharedTableHeader::COMMENT_BYTES] += assignment.comment().size();
+    }
+
+    for (Column bytes : { SharedTableHeader::MEMBER_ID_BYTES, SharedTableHeader::SLIP_ID_BYTES, SharedTableHeader::COMMENT_BYTES }){
+        if (sizes[bytes] > UINT32_MAX){
+            throw std::runtime_error("Too much text to publish in one table");
+        }
+    }
+
+    sizes[SharedTableHeader::STATUS] = sizes[SharedTableHeader::DOCK_STATUS] = sizes[SharedTableHeader::UPGRADED] = rows;
+
+    for (Column dimension : { SharedTableHeader::BOAT_LENGTH, SharedTableHeader::BOAT_WIDTH, SharedTableHeader::SLIP_LENGTH,
+                              SharedTableHeader::SLIP_WIDTH }){
+        sizes[dimension] = rows * sizeof(int32_t);
+    }
+
+    sizes[SharedTableHeader::PRICE] = rows * sizeof(double);
+
+    SharedTableHeader table;
+    table.mRows = rows;
+    uint64_t bytes = align(sizeof(SharedTableHeader), 8);
+
+    for (uint32_t column = 0; column < SharedTableHeader::COLUMN_COUNT; ++column){
+        table.mColumns[column] = bytes;
+        bytes = align(bytes + sizes[column], 8);
+    }
+
+    ::flock(mFd, LOCK_EX);
+
+    try{
+        // Another publisher may have grown the segment
+        struct stat info;
+
+        if (::fstat(mFd, &info) != 0){
+            throw std::runtime_error("Cannot read shared memory '" + mName + "': " + std::strerror(errno));
+        }
+
+        if (static_cast<size_t>(info.st_size) != mSize){
+            map(static_cast<size_t>(info.st_size));
+        }
+
+        uint64_t generation = header()->mGeneration.load(std::memory_order_acquire);
+        int next = static_cast<int>((generation + 1) % 2);
+
+        uint64_t offset = header()->mSlots[next].mOffset;
+        uint64_t capacity = header()->mSlots[next].mCapacity;
+
+        // A table that outgrows its slot gets new room at the end, with
+        // headroom; the room it had is not reused
+        if (capacity < bytes){
+            uint64_t page = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+            offset = align(mSize, page);
+            capacity = align(bytes + bytes / 2, page);
+
+            if (::ftruncate(mFd, static_cast<off_t>(offset + capacity)) != 0){
+                throw std::runtime_error("Cannot size shared memory '" + mName + "': " + std::strerror(errno));
+            }
+
+            map(offset + capacity);
+        }
+
+        // Odd while written: readers still holding a table in this slot
+        // see it change
+        SharedResultsHeader::Slot &slot = header()->mSlots[next];
+        uint64_t sequence = slot.mSequence.load(std::memory_order_relaxed);
+        slot.mSequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.mOffset = offset;
+        slot.mCapacity = capacity;
+
+        char *target = mData + slot.mOffset;
+        std::memcpy(target, &table, sizeof(table));
+
+        uint32_t *memberOffsets = reinterpret_cast<uint32_t *>(target + table.mColumns[SharedTableHeader::MEMBER_ID]);
+        uint32_t *slipOffsets = reinterpret_cast<uint32_t *>(target + table.mColumns[SharedTableHeader::SLIP_ID]);
+        uint32_t *commentOffsets = reinterpret_cast<uint32_t *>(target + table.mColumns[SharedTableHeader::COMMENT]);
+        char *memberBytes = target + table.mColumns[SharedTableHeader::MEMBER_ID_BYTES];
+        char *slipBytes = target + table.mColumns[SharedTableHeader::SLIP_ID_BYTES];
+        char *commentBytes = target + table.mColumns[SharedTableHeader::COMMENT_BYTES];
+        uint8_t *statuses = reinterpret_cast<uint8_t *>(target + table.mColumns[SharedTableHeader::STATUS]);
+        uint8_t *dockStatuses = reinterpret_cast<uint8_t *>(target + table.mColumns[SharedTableHeader::DOCK_STATUS]);
+        uint8_t *upgraded = reinterpret_cast<uint8_t *>(target + table.mColumns[SharedTableHeader::UPGRADED]);
+        int32_t *boatLengths = reinterpret_cast<int32_t *>(target + table.mColumns[SharedTableHeader::BOAT_LENGTH]);
+        int32_t *boatWidths = reinterpret_cast<int32_t *>(target + table.mColumns[SharedTableHeader::BOAT_WIDTH]);
+        int32_t *slipLengths = reinterpret_cast<int32_t *>(target + table.mColumns[SharedTableHeader::SLIP_LENGTH]);
+        int32_t *slipWidths = reinterpret_cast<int32_t *>(target + table.mColumns[SharedTableHeader::SLIP_WIDTH]);
+        double *prices = reinterpret_cast<double *>(target + table.mColumns[SharedTableHeader::PRICE]);
+        uint32_t memberEnd = 0;
+        uint32_t slipEnd = 0;
+        uint32_t commentEnd = 0;
+
+        for (size_t row = 0; row < rows; ++row){
+            const Assignment &assignment = assignments[row];
+            memberOffsets[row] = memberEnd;
+            slipOffsets[row] = slipEnd;
+            commentOffsets[row] = commentEnd;
+            std::memcpy(memberBytes + memberEnd, assignment.memberId().data(), assignment.memberId().size());
+            std::memcpy(slipBytes + slipEnd, assignment.slipId().data(), assignment.slipId().size());
+            std::memcpy(commentBytes + commentEnd, assignment.comment().data(), assignment.comment().size());
+            memberEnd += static_cast<uint32_t>(assignment.memberId().size());
+            slipEnd += static_cast<uint32_t>(assignment.slipId().size());
+            commentEnd += static_cast<uint32_t>(assignment.comment().size());
+            statuses[row] = static_cast<uint8_t>(assignment.status());
+            dockStatuses[row] = static_cast<uint8_t>(assignment.dockStatus());
+            upgraded[row] = assignment.upgraded() ? 1 : 0;
+            boatLengths[row] = assignment.boatDimensions().lengthInches();
+            boatWidths[row] = assignment.boatDimensions().widthInches();
+            slipLengths[row] = assignment.slipDimensions().lengthInches();
+            slipWidths[row] = assignment.slipDimensions().widthInches();
+            prices[row] = assignment.price();
+        }
+
+        memberOffsets[rows] = memberEnd;
+        slipOffsets[rows] = slipEnd;
+        commentOffsets[rows] = commentEnd;
+        slot.mBytes = bytes;
+
+        slot.mSequence.store(sequence + 2, std::memory_order_release);
+        header()->mGeneration.store(generation + 1, std::memory_order_release);
+        ::flock(mFd, LOCK_UN);
+        return generation + 1;
+    }
+    catch (...){
+        ::flock(mFd, LOCK_UN);
+        throw;
+    }
+}
+
+void SharedResultsPublisher::remove(const std::string &name){
+    std::string segment = segmentName(name);
+
+    if (::shm_unlink(segment.c_str()) != 0 && errno != ENOENT){
+        throw std::runtime_error("Cannot remove shared memory '" + segment + "': " + std::strerror(errno));
+    }
+}
+
+SharedResultsReader::SharedResultsReader(const std::string &name)
+    : mFd(-1), mData(nullptr), mSize(0){
+    std::string segment = segmentName(name);
+    mFd = ::shm_open(segment.c_str(), O_RDONLY | O_CLOEXEC, 0);
+
+    if (mFd < 0){
+        throw std::runtime_error("Cannot open shared memory '" + segment + "': " + std::strerror(errno));
+    }
+
+    try{
+        map();
+        checkLayout(header(), segment);
+    }
+    catch (...){
+        if (mData){
+            ::munmap(const_cast<char *>(mData), mSize);
+        }
+
+        ::close(mFd);
+        throw;
+    }
+}
+
+SharedResultsReader::~SharedResultsReader(){
+    for (const auto &mapping : mRetired){
+        ::munmap(const_cast<char *>(mapping.first), mapping.second);
+    }
+
+    ::munmap(const_cast<char *>(mData), mSize);
+    ::close(mFd);
+}
+
+void SharedResultsReader::map(){
+    struct stat info;
+
+    if (::fstat(mFd, &info) != 0){
+        throw std::runtime_error(std::string("Cannot read shared memory: ") + std::strerror(errno));
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+
+    if (size < sizeof(SharedResultsHeader)){
+        throw std::runtime_error("Shared memory does not hold slippage results");
+    }
+
+    void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, mFd, 0);
+
+    if (mapping == MAP_FAILED){
+        throw std::runtime_error(std::string("Cannot map shared memory: ") + std::strerror(errno));
+    }
+
+    if (mData){
+        mRetired.emplace_back(mData, mSize);
+    }
+
+    mData = static_cast<const char *>(mapping);
+    mSize = size;
+}
+
+uint64_t SharedResultsReader::generation() const{
+    return header()->mGeneration.load(std::memory_order_acquire);
+}
+
+SharedTable SharedResultsReader::current(){
+    for (;;){
+        uint64_t generation = header()->mGeneration.load(std::memory_order_acquire);
+
+        if (generation == 0){
+            return SharedTable();
+        }
+
+        const SharedResultsHeader::Slot &slot = header()->mSlots[generation % 2];
+        uint64_t seen = slot.mSequence.load(std::memory_order_acquire);
+        uint64_t offset = slot.mOffset;
+        uint64_t bytes = slot.mBytes;
+
+        // Published after the segment grew past this mapping
+        if ((seen & 1) == 0 && offset + bytes > mSize){
+            map();
+
+            if (offset + bytes > mSize){
+                throw std::runtime_error("Shared memory results are truncated");
+            }
+
+            continue;
+        }
+
+        SharedTableHeader table;
+
+        if ((seen & 1) == 0){
+            std::memcpy(&table, mData + offset, sizeof(table));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Being written for a later generation, or changed while read
+        if ((seen & 1) != 0 || slot.mSequence.load(std::memory_order_relaxed) != seen){
+            continue;
+        }
+
+        return SharedTable(mData + offset, table, bytes, &slot.mSequence, seen, generation);
+    }
+}
@@ -0,0 +1,187 @@
+#ifndef SHARED_RESULTS_H
+#define SHARED_RESULTS_H
+
+#include "assignment.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Assignment results published in a named POSIX shared-memory segment, so
+// that other programs can read the table in place instead of parsing CSV.
+//
+// Layout, version 1. Numbers are in the host's byte order and offsets are
+// in bytes. The segment starts with a SharedResultsHeader. Each of its two
+// slots holds one published table at mOffset from the segment start. The
+// table starts with a SharedTableHeader, followed by its columns, each
+// starting on an 8-byte boundary at the offset the table header gives,
+// counted from the start of the table:
+//
+//   MEMBER_ID, SLIP_ID, COMMENT    uint32 offsets[rows + 1] into the
+//                                  matching *_BYTES column, UTF-8 bytes;
+//                                  row i is bytes[offsets[i], offsets[i+1])
+//   STATUS                         uint8, Assignment::Status order
+//   DOCK_STATUS                    uint8, Member::DockStatus order
+//   UPGRADED                       uint8, 0 or 1
+//   BOAT_LENGTH .. SLIP_WIDTH      int32 inches
+//   PRICE                          float64 (0 when not priced)
+//
+// Publishing is double-buffered: a new table is written into the slot that
+// the current generation does not use, and then mGeneration is advanced,
+// so the current table is never written over. Each slot also has a
+// sequence number that is odd while the slot is being written. A reader
+// takes the slot of the generation it sees and compares that slot's
+// sequence before and after use. It has a whole publish before its slot
+// is reused, and the sequence tells it when that has happened.
+struct SharedResultsHeader {
+    struct Slot {
+        std::atomic<uint64_t> mSequence;
+        uint64_t mOffset;
+        uint64_t mBytes;
+        // Bytes reserved at mOffset
+        uint64_t mCapacity;
+    };
+
+    char mMagic[8];
+    uint32_t mVersion;
+    uint32_t mHeaderBytes;
+    // Tables published so far; the current table is in slot mGeneration % 2
+    std::atomic<uint64_t> mGeneration;
+    Slot mSlots[2];
+};
+
+struct SharedTableHeader {
+    enum Column : uint32_t {
+        MEMBER_ID,
+        MEMBER_ID_BYTES,
+        SLIP_ID,
+        SLIP_ID_BYTES,
+        COMMENT,
+        COMMENT_BYTES,
+        STATUS,
+        DOCK_STATUS,
+        UPGRADED,
+        BOAT_LENGTH,
+        BOAT_WIDTH,
+        SLIP_LENGTH,
+        SLIP_WIDTH,
+        PRICE,
+        COLUMN_COUNT
+    };
+
+    uint64_t mRows;
+    uint64_t mColumns[COLUMN_COUNT];
+};
+
+// One published table, read where it lies in the segment. Check valid()
+// after reading: once a second table has been published since this one,
+// the rows may be in the middle of being overwritten. The row count and
+// column positions are copied when the table is taken, so reads stay
+// inside the table even then.
+class SharedTable {
+    const char *mTable;
+    SharedTableHeader mHeader;
+    uint64_t mBytes;
+    const std::atomic<uint64_t> *mSequence;
+    uint64_t mSeen;
+    uint64_t mGeneration;
+
+    template <typename T>
+    T value(SharedTableHeader::Column column, size_t row) const{ return data<T>(column)[row]; }
+
+    std::string_view text(SharedTableHeader::Column column, size_t row) const;
+
+public:
+    // An empty table, before anything is published
+    SharedTable();
+    SharedTable(const char *table, const SharedTableHeader &header, uint64_t bytes, const std::atomic<uint64_t> *sequence,
+                uint64_t seen, uint64_t generation);
+
+    uint64_t generation() const{ return mGeneration; }
+    size_t rows() const{ return static_cast<size_t>(mHeader.mRows); }
+
+    std::string_view memberId(size_t row) const{ return text(SharedTableHeader::MEMBER_ID, row); }
+    std::string_view slipId(size_t row) const{ return text(SharedTableHeader::SLIP_ID, row); }
+    std::string_view comment(size_t row) const{ return text(SharedTableHeader::COMMENT, row); }
+    Assignment::Status status(size_t row) const{ return static_cast<Assignment::Status>(value<uint8_t>(SharedTableHeader::STATUS, row)); }
+    Member::DockStatus dockStatus(size_t row) const{ return static_cast<Member::DockStatus>(value<uint8_t>(SharedTableHeader::DOCK_STATUS, row)); }
+    bool upgraded(size_t row) const{ return value<uint8_t>(SharedTableHeader::UPGRADED, row) != 0; }
+    int boatLengthInches(size_t row) const{ return value<int32_t>(SharedTableHeader::BOAT_LENGTH, row); }
+    int boatWidthInches(size_t row) const{ return value<int32_t>(SharedTableHeader::BOAT_WIDTH, row); }
+    int slipLengthInches(size_t row) const{ return value<int32_t>(SharedTableHeader::SLIP_LENGTH, row); }
+    int slipWidthInches(size_t row) const{ return value<int32_t>(SharedTableHeader::SLIP_WIDTH, row); }
+    double price(size_t row) const{ return value<double>(SharedTableHeader::PRICE, row); }
+
+    // A whole column, for scanning without per-row calls
+    template <typename T>
+    const T *data(SharedTableHeader::Column column) const{
+        return reinterpret_cast<const T *>(mTable + mHeader.mColumns[column]);
+    }
+
+    // False once a later publish has started writing over this table
+    bool valid() const;
+};
+
+// Writes tables into a segment, creating it when it does not exist. The
+// segment outlives the publisher, so readers keep the last table after the
+// run exits; remove() deletes it. Publishers of one segment take turns.
+class SharedResultsPublisher {
+    std::string mName;
+    int mFd;
+    char *mData;
+    size_t mSize;
+
+    SharedResultsHeader *header() const{ return reinterpret_cast<SharedResultsHeader *>(mData); }
+    void map(size_t size);
+
+public:
+    // The name is a shared-memory object name such as "/slippage"; a
+    // leading slash is added when missing. Throws std::runtime_error when
+    // the segment cannot be opened or holds another layout version.
+    explicit SharedResultsPublisher(const std::string &name);
+    ~SharedResultsPublisher();
+
+    SharedResultsPublisher(const SharedResultsPublisher &) = delete;
+    SharedResultsPublisher &operator=(const SharedResultsPublisher &) = delete;
+
+    const std::string &name() const{ return mName; }
+
+    // Publish the table as the next generation; returns the generation
+    uint64_t publish(const std::vector<Assignment> &assignments);
+
+    // Delete a segment; readers that have it mapped keep their mapping
+    static void remove(const std::string &name);
+};
+
+// Maps a published segment read-only.
+class SharedResultsReader {
+    int mFd;
+    const char *mData;
+    size_t mSize;
+    // Mappings replaced after the segment grew, kept for tables still in use
+    std::vector<std::pair<const char *, size_t>> mRetired;
+
+    const SharedResultsHeader *header() const{ return reinterpret_cast<const SharedResultsHeader *>(mData); }
+    void map();
+
+public:
+    // Throws std::runtime_error when the segment does not exist or holds
+    // another layout version
+    explicit SharedResultsReader(const std::string &name);
+    ~SharedResultsReader();
+
+    SharedResultsReader(const SharedResultsReader &) = delete;
+    SharedResultsReader &operator=(const SharedResultsReader &) = delete;
+
+    // Generation of the latest table; 0 before anything is published
+    uint64_t generation() const;
+
+    // The latest table, without copying it. Tables stay mapped for the
+    // reader's lifetime.
+    SharedTable current();
+};
+
+#endif
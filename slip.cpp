@@ -1,7 +1,24 @@
 #include "slip.hpp"
 
-Slip::Slip(const std::string &slipId, int feetLength, int inchesLength, int feetWidth, int inchesWidth)
-    : mId(slipId), mMaxDimensions(feetLength, inchesLength, feetWidth, inchesWidth){
+Slip::Slip(const std::string &slipId, int feetLength, int inchesLength, int feetWidth, int inchesWidth,
+           const std::string &dock)
+    : mId(slipId), mMaxDimensions(feetLength, inchesLength, feetWidth, inchesWidth), mDock(dock), mAmenities(0), mCapacity(1){
+}
+
+void Slip::setVerticalLimits(int depthInches, int clearanceInches){
+    mMaxDimensions.setDraftInches(depthInches);
+    mMaxDimensions.setAirDraftInches(clearanceInches);
+}
+
+Dimensions Slip::billedDimensions(const Dimensions &boatDimensions) const{
+    if (!shared()){
+        return mMaxDimensions;
+    }
+    
+    Dimensions share(0, mMaxDimensions.lengthInches(), 0, boatDimensions.widthInches());
+    share.setDraftInches(mMaxDimensions.draftInches());
+    share.setAirDraftInches(mMaxDimensions.airDraftInches());
+    return share;
 }
 
 bool Slip::fits(const Dimensions &boatDimensions) const{
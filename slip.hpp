@@ -1,19 +1,45 @@
 #ifndef SLIP_H
 #define SLIP_H
 
+#include "amenities.hpp"
 #include "dimensions.hpp"
 #include <string>
 
 class Slip {
     std::string mId;
     Dimensions mMaxDimensions;
+    std::string mDock;
+    Amenities::Mask mAmenities;
+    int mCapacity;
 
 public:
-    Slip(const std::string &slipId, int feetLength, int inchesLength, int feetWidth, int inchesWidth);
+    Slip(const std::string &slipId, int feetLength, int inchesLength, int feetWidth, int inchesWidth,
+         const std::string &dock = "");
     
     const std::string &id() const{ return mId; }
     const Dimensions &maxDimensions() const{ return mMaxDimensions; }
     
+    // Dock or zone the slip belongs to; empty when the marina is not divided into docks
+    const std::string &dock() const{ return mDock; }
+    
+    // Water depth and overhead clearance in inches; 0 leaves that limit unrestricted
+    void setVerticalLimits(int depthInches, int clearanceInches);
+    
+    // Amenities the slip provides
+    Amenities::Mask amenities() const{ return mAmenities; }
+    void setAmenities(Amenities::Mask amenities){ mAmenities = amenities; }
+    
+    // Boats the slip can hold side by side (rafted or side-tied). Above one,
+    // the slip is shared: each boat must fit its length, and the boats'
+    // combined width must fit its width.
+    int capacity() const{ return mCapacity; }
+    void setCapacity(int capacity){ mCapacity = capacity; }
+    bool shared() const{ return mCapacity > 1; }
+    
+    // Slip dimensions a boat is billed for: the whole slip, or for a shared
+    // slip the slip's length by the boat's width
+    Dimensions billedDimensions(const Dimensions &boatDimensions) const;
+    
     bool fits(const Dimensions &boatDimensions) const;
     bool fitsWidthOnly(const Dimensions &boatDimensions) const;
     int lengthDifference(const Dimensions &boatDimensions) const;
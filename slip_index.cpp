@@ -0,0 +1,221 @@
+#include "slip_index.hpp"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
+#include <tuple>
+
+static long long slipArea(const Slip &slip){
+    return static_cast<long long>(slip.maxDimensions().lengthInches()) * slip.maxDimensions().widthInches();
+}
+
+// Build the best-fit order, width buckets and fit bounds of one group
+static void buildGroup(const std::vector<Slip> &slips, SlipIndex::FitGroup &group){
+    group.mBestFitOrder = group.mPositions;
+    std::sort(group.mBestFitOrder.begin(), group.mBestFitOrder.end(), [&slips](uint32_t a, uint32_t b){
+        long long areaA = slipArea(slips[a]);
+        long long areaB = slipArea(slips[b]);
+
+        if (areaA != areaB){
+            return areaA < areaB;
+        }
+
+        int widthA = slips[a].maxDimensions().widthInches();
+        int widthB = slips[b].maxDimensions().widthInches();
+
+        if (widthA != widthB){
+            return widthA > widthB;
+        }
+
+        return a < b;
+    });
+
+    group.mAreas.reserve(group.mBestFitOrder.size());
+
+    for (uint32_t position : group.mBestFitOrder){
+        group.mAreas.push_back(slipArea(slips[position]));
+    }
+
+    std::map<int, SlipIndex::WidthBucket, std::greater<int>> buckets;
+
+    for (uint32_t position : group.mPositions){
+        SlipIndex::WidthBucket &bucket = buckets[slips[position].maxDimensions().widthInches()];
+        bucket.mShortestFirst.push_back(position);
+    }
+
+    for (auto &entry : buckets){
+        SlipIndex::WidthBucket &bucket = entry.second;
+        bucket.mWidth = entry.first;
+        auto length = [&slips](uint32_t position){ return slips[position].maxDimensions().lengthInches(); };
+
+        bucket.mLongestFirst = bucket.mShortestFirst;
+        std::stable_sort(bucket.mShortestFirst.begin(), bucket.mShortestFirst.end(),
+                         [&length](uint32_t a, uint32_t b){ return length(a) < length(b); });
+        std::stable_sort(bucket.mLongestFirst.begin(), bucket.mLongestFirst.end(),
+                         [&length](uint32_t a, uint32_t b){ return length(a) > length(b); });
+
+        for (uint32_t position : bucket.mShortestFirst){
+            bucket.mLengthsAscending.push_back(length(position));
+        }
+
+        for (uint32_t position : bucket.mLongestFirst){
+            bucket.mLengthsDescending.push_back(length(position));
+        }
+
+        group.mWidthBuckets.push_back(std::move(bucket));
+    }
+
+    std::vector<uint32_t> byWidth(group.mPositions);
+    std::sort(byWidth.begin(), byWidth.end(), [&slips](uint32_t a, uint32_t b){
+        return slips[a].maxDimensions().widthInches() > slips[b].maxDimensions().widthInches();
+    });
+
+    int longest = 0;
+
+    for (uint32_t position : byWidth){
+        longest = std::max(longest, slips[position].maxDimensions().lengthInches());
+        group.mWidthsDescending.push_back(slips[position].maxDimensions().widthInches());
+        group.mLongestAtWidth.push_back(longest);
+    }
+}
+
+SlipIndex::SlipIndex(const std::vector<Slip> &slips, std::vector<uint32_t> positions, size_t maxGroups)
+    : mPositions(std::move(positions)){
+    std::map<std::tuple<int, int, Amenities::Mask>, FitGroup> groups;
+    std::vector<uint32_t> single;
+
+    for (uint32_t position : mPositions){
+        if (slips[position].shared()){
+            mSharedPositions.push_back(position);
+            mSharedDimensions.push_back(slips[position].maxDimensions());
+            mSharedAmenities.push_back(slips[position].amenities());
+        }
+        else{
+            single.push_back(position);
+        }
+    }
+
+    // Group by amenities too unless that makes too many groups
+    std::set<std::tuple<int, int, Amenities::Mask>> keys;
+    bool byAmenities = true;
+
+    for (uint32_t position : single){
+        const Dimensions &limits = slips[position].maxDimensions();
+        keys.emplace(limits.draftInches(), limits.airDraftInches(), slips[position].amenities());
+
+        if (keys.size() > maxGroups){
+            byAmenities = false;
+            break;
+        }
+    }
+
+    for (uint32_t position : single){
+        const Dimensions &limits = slips[position].maxDimensions();
+        Amenities::Mask amenities = slips[position].amenities();
+        auto key = std::make_tuple(limits.draftInches(), limits.airDraftInches(), byAmenities ? amenities : 0);
+        auto inserted = groups.emplace(key, FitGroup());
+        FitGroup &group = inserted.first->second;
+
+        if (inserted.second){
+            group.mDraftInches = limits.draftInches();
+            group.mAirDraftInches = limits.airDraftInches();
+            group.mAmenities = amenities;
+        }
+        else if (group.mAmenities != amenities){
+            group.mAmenities |= amenities;
+            group.mMixed = true;
+        }
+
+        group.mPositions.push_back(position);
+    }
+
+    for (auto &entry : groups){
+        FitGroup &group = entry.second;
+
+        if (group.mMixed){
+            for (uint32_t position : group.mPositions){
+                group.mSlipLimits.push_back(slips[position].maxDimensions());
+                group.mSlipAmenities.push_back(slips[position].amenities());
+            }
+        }
+
+        buildGroup(slips, group);
+        mGroups.push_back(std::move(group));
+    }
+}
+
+bool SlipIndex::anyFits(const Dimensions &boatDimensions, Amenities::Mask required, bool widthOnly) const{
+    for (const auto &group : mGroups){
+        if (group.admits(boatDimensions, required) && group.anyFits(boatDimensions, required, widthOnly)){
+            return true;
+        }
+    }
+
+    for (size_t i = 0; i < mSharedPositions.size(); ++i){
+        bool fits = widthOnly ? boatDimensions.fitsInWidthOnly(mSharedDimensions[i]) : boatDimensions.fitsIn(mSharedDimensions[i]);
+
+        if (fits && Amenities::provides(mSharedAmenities[i], required)){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SlipIndex::FitGroup::admits(const Dimensions &boatDimensions, Amenities::Mask required) const{
+    return Amenities::provides(mAmenities, required) &&
+           (mDraftInches == 0 || boatDimensions.draftInches() <= mDraftInches) &&
+           (mAirDraftInches == 0 || boatDimensions.airDraftInches() <= mAirDraftInches);
+}
+
+size_t SlipIndex::FitGroup::firstWithArea(long long area) const{
+    return std::lower_bound(mAreas.begin(), mAreas.end(), area) - mAreas.begin();
+}
+
+size_t SlipIndex::FitGroup::bucketsAtLeast(int widthInches) const{
+    size_t count = 0;
+
+    while (count < mWidthBuckets.size() && mWidthBuckets[count].mWidth >= widthInches){
+        count++;
+    }
+
+    return count;
+}
+
+bool SlipIndex::FitGroup::anyFits(const Dimensions &boatDimensions, Amenities::Mask required, bool widthOnly) const{
+    // The width and length bounds cover every slip, so a mixed group checks each one
+    if (mMixed){
+        for (size_t i = 0; i < mSlipLimits.size(); ++i){
+            bool fits = widthOnly ? boatDimensions.fitsInWidthOnly(mSlipLimits[i]) : boatDimensions.fitsIn(mSlipLimits[i]);
+
+            if (fits && Amenities::provides(mSlipAmenities[i], required)){
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Slips wide enough for the boat form a prefix of the width-descending list
+    auto end = std::upper_bound(mWidthsDescending.begin(), mWidthsDescending.end(), boatDimensions.widthInches(),
+                                [](int width, int slipWidth){ return width > slipWidth; });
+
+    if (end == mWidthsDescending.begin()){
+        return false;
+    }
+
+    if (widthOnly){
+        return true;
+    }
+
+    return mLongestAtWidth[end - mWidthsDescending.begin() - 1] >= boatDimensions.lengthInches();
+}
+
+size_t SlipIndex::WidthBucket::firstAtLeast(int lengthInches) const{
+    return std::lower_bound(mLengthsAscending.begin(), mLengthsAscending.end(), lengthInches) - mLengthsAscending.begin();
+}
+
+size_t SlipIndex::WidthBucket::firstShorterThan(int lengthInches) const{
+    return std::upper_bound(mLengthsDescending.begin(), mLengthsDescending.end(), lengthInches,
+                            [](int length, int slipLength){ return length > slipLength; }) - mLengthsDescending.begin();
+}
@@ -0,0 +1,130 @@
+#ifndef SLIP_INDEX_H
+#define SLIP_INDEX_H
+
+#include "slip.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Search index over a group of slips - one dock, or the whole marina.
+//
+// Slips are referred to by their position in the engine's slip vector, and
+// are first grouped by their depth and clearance limits and the amenities
+// they provide. A boat may use either every slip in a group or none of
+// them, so a fit query only visits the groups that admit the boat - one
+// AND and compare of amenity bits per group rather than per slip - and
+// then searches length and width there. Marinas usually have a handful of
+// distinct depths, clearances and amenity sets; inputs without them form a
+// single group.
+//
+// Amenity sets multiply the groups, and a marina where nearly every slip
+// offers something different would scan as many groups as slips. When
+// there would be more groups than the limit, slips are grouped by depth and
+// clearance alone. A group whose slips then differ in amenities is marked
+// mixed: it admits a boat when any of its slips could provide the
+// amenities, and searches check each slip with provides().
+//
+// Within a group, the best-fit order sorts slips by area ascending, then
+// width descending, then position, which is exactly the preference order of
+// the normal-mode best-fit rule: the first slip in that order that fits and
+// can be taken is the best fit in the group. A boat cannot fit a slip with a
+// smaller area, so searches start at the boat's own area.
+//
+// Slips are also bucketed by exact width, widest first. Every slip in a
+// bucket at least as wide as the boat fits it widthwise, so a fit query only
+// has to look at each such bucket's lengths.
+//
+// Shared slips (capacity above one) are kept out of the groups: the width
+// they have left changes as boats are placed, so searches rank them by
+// their free width at query time. They are few - T-heads and wide end
+// slips - and are listed separately.
+class SlipIndex {
+public:
+    // Slips of one width, by length ascending and by length descending;
+    // equal lengths keep position order in both
+    struct WidthBucket {
+        int mWidth;
+        std::vector<uint32_t> mShortestFirst;
+        std::vector<int> mLengthsAscending;
+        std::vector<uint32_t> mLongestFirst;
+        std::vector<int> mLengthsDescending;
+
+        // Offset into mShortestFirst of the first slip at least this long
+        size_t firstAtLeast(int lengthInches) const;
+
+        // Offset into mLongestFirst of the first slip shorter than this
+        size_t firstShorterThan(int lengthInches) const;
+    };
+
+    // Slips sharing one depth and clearance limit (0 = unrestricted) and,
+    // unless mixed, one set of amenities
+    struct FitGroup {
+        int mDraftInches;
+        int mAirDraftInches;
+        // Amenities of the slips; in a mixed group, those of any slip
+        Amenities::Mask mAmenities;
+        bool mMixed = false;
+        std::vector<uint32_t> mPositions;
+        std::vector<uint32_t> mBestFitOrder;
+        std::vector<long long> mAreas;
+        std::vector<WidthBucket> mWidthBuckets;
+        // Widths descending, with the longest length among slips at least that wide
+        std::vector<int> mWidthsDescending;
+        std::vector<int> mLongestAtWidth;
+        // Mixed groups only: each slip's limits and amenities, by mPositions
+        std::vector<Dimensions> mSlipLimits;
+        std::vector<Amenities::Mask> mSlipAmenities;
+
+        // True if the boat's draft and air draft clear the group's limits
+        // and the group provides every required amenity
+        bool admits(const Dimensions &boatDimensions, Amenities::Mask required) const;
+
+        // True if a slip of this group with the given amenities provides
+        // the required ones; always true unless the group is mixed
+        bool provides(Amenities::Mask slipAmenities, Amenities::Mask required) const{
+            return !mMixed || Amenities::provides(slipAmenities, required);
+        }
+
+        // Offset into mBestFitOrder of the first slip with at least the given area
+        size_t firstWithArea(long long area) const;
+
+        // Number of leading width buckets at least as wide as the given width
+        size_t bucketsAtLeast(int widthInches) const;
+
+        // True if any slip in the group is long and wide enough for the boat
+        // and provides the amenities
+        bool anyFits(const Dimensions &boatDimensions, Amenities::Mask required, bool widthOnly) const;
+    };
+
+private:
+    std::vector<uint32_t> mPositions;
+    std::vector<FitGroup> mGroups;
+    std::vector<uint32_t> mSharedPositions;
+    std::vector<Dimensions> mSharedDimensions;
+    std::vector<Amenities::Mask> mSharedAmenities;
+
+public:
+    // Most fit groups before amenities are left out of the grouping
+    static const size_t MAX_GROUPS = 64;
+
+    SlipIndex() = default;
+    SlipIndex(const std::vector<Slip> &slips, std::vector<uint32_t> positions, size_t maxGroups = MAX_GROUPS);
+
+    // Slip positions in input order
+    const std::vector<uint32_t> &positions() const{ return mPositions; }
+
+    // Fit groups of single-boat slips, by depth limit, clearance limit, then
+    // amenities unless there would be more than the limit
+    const std::vector<FitGroup> &groups() const{ return mGroups; }
+
+    // Shared slip positions in input order
+    const std::vector<uint32_t> &sharedPositions() const{ return mSharedPositions; }
+
+    // True if any slip in the index fits the boat and provides the amenities
+    bool anyFits(const Dimensions &boatDimensions, Amenities::Mask required, bool widthOnly) const;
+
+    bool empty() const{ return mPositions.empty(); }
+    size_t size() const{ return mPositions.size(); }
+};
+
+#endif
@@ -0,0 +1,374 @@
+#include "marina_generator.hpp"
+#include <algorithm>
+#include <set>
+
+namespace {
+
+// Pools chosen so that different slips share areas (20x12 = 24x10 = 30x8)
+// and boats land exactly on slip widths or within the 6" tight-fit band
+const int SLIP_LENGTHS_FT[] = { 20, 24, 25, 30, 32, 36, 40 };
+const int SLIP_WIDTHS_FT[] = { 8, 10, 11, 12, 14 };
+const int INCH_CHOICES[] = { 0, 0, 0, 6, 9 };
+
+}
+
+uint64_t scenarioSeed(uint64_t runSeed, uint64_t iteration){
+    // splitmix64 finalizer
+    uint64_t z = runSeed + 0x9e3779b97f4a7c15ULL * (iteration + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+MarinaGenerator::MarinaGenerator(uint64_t scenarioSeed)
+    : mRandom(scenarioSeed){
+}
+
+int MarinaGenerator::uniform(int low, int high){
+    return std::uniform_int_distribution<int>(low, high)(mRandom);
+}
+
+bool MarinaGenerator::chance(double probability){
+    return std::uniform_real_distribution<double>(0.0, 1.0)(mRandom) < probability;
+}
+
+// Mix ID styles so lexicographic priority is exercised ("M10" < "M2")
+std::string MarinaGenerator::memberId(int number){
+    switch (uniform(0, 2)){
+        case 0:
+            return "M" + std::to_string(number);
+        case 1:
+            return std::to_string(1000 + number);
+        default:{
+            std::string digits = std::to_string(number);
+            return "M" + std::string(digits.size() < 3 ? 3 - digits.size() : 0, '0') + digits;
+        }
+    }
+}
+
+Member::DockStatus MarinaGenerator::randomStatus(){
+    int roll = uniform(0, 99);
+
+    if (roll < 12){
+        return Member::DockStatus::PERMANENT;
+    }
+    if (roll < 20){
+        return Member::DockStatus::YEAR_OFF;
+    }
+    if (roll < 45){
+        return Member::DockStatus::WAITING_LIST;
+    }
+    if (roll < 75){
+        return Member::DockStatus::TEMPORARY;
+    }
+    return Member::DockStatus::UNASSIGNED;
+}
+
+std::optional<std::string> MarinaGenerator::randomCurrentSlip(const std::vector<Slip> &slips){
+    int roll = uniform(0, 99);
+
+    if (roll < 25 || slips.empty()){
+        return std::nullopt;
+    }
+
+    // Slips that no longer exist
+    if (roll < 30){
+        return std::string("GONE") + std::to_string(uniform(1, 3));
+    }
+
+    return slips[uniform(0, static_cast<int>(slips.size()) - 1)].id();
+}
+
+void MarinaGenerator::addRandomSlips(Marina &marina, int count){
+    for (int i = 0; i < count; ++i){
+        int length = SLIP_LENGTHS_FT[uniform(0, 6)];
+        int width = SLIP_WIDTHS_FT[uniform(0, 4)];
+        marina.mSlips.emplace_back("S" + std::to_string(marina.mSlips.size() + 1),
+                                   length, INCH_CHOICES[uniform(0, 4)], width, INCH_CHOICES[uniform(0, 4)]);
+    }
+}
+
+void MarinaGenerator::addRandomMembers(Marina &marina, int count){
+    std::set<std::string> used;
+
+    for (const auto &member : marina.mMembers){
+        used.insert(member.id());
+    }
+
+    for (int i = 0; i < count; ++i){
+        std::string id;
+
+        do{
+            id = memberId(uniform(1, 200));
+        } while (!used.insert(id).second);
+
+        // Boats cluster just under common slip sizes
+        int length = SLIP_LENGTHS_FT[uniform(0, 6)] - uniform(0, 4);
+        int width = SLIP_WIDTHS_FT[uniform(0, 4)] - uniform(0, 1);
+        marina.mMembers.emplace_back(id, length, INCH_CHOICES[uniform(0, 4)], width, INCH_CHOICES[uniform(0, 4)],
+                                     randomCurrentSlip(marina.mSlips), randomStatus());
+    }
+}
+
+void MarinaGenerator::generateRandom(Marina &marina){
+    addRandomSlips(marina, uniform(0, 30));
+    addRandomMembers(marina, uniform(0, 40));
+}
+
+// Every member's current slip is wanted by a higher-priority member, so
+// each eviction pushes the victim onto the next slip in the chain.
+void MarinaGenerator::generateEvictionChain(Marina &marina){
+    int length = uniform(1, 12);
+
+    for (int i = 0; i < length; ++i){
+        marina.mSlips.emplace_back("S" + std::to_string(i + 1), 30, 0, 12, 0);
+    }
+
+    addRandomSlips(marina, uniform(0, 4));
+
+    Member::DockStatus statuses[] = {
+        Member::DockStatus::WAITING_LIST,
+        Member::DockStatus::TEMPORARY,
+        Member::DockStatus::UNASSIGNED
+    };
+
+    int memberCount = length + uniform(0, 3);
+
+    for (int i = 0; i < memberCount; ++i){
+        std::optional<std::string> wanted;
+
+        if (i < length){
+            wanted = "S" + std::to_string(length - i);
+        }
+
+        Member::DockStatus status = statuses[uniform(0, 2)];
+        marina.mMembers.emplace_back("M" + std::to_string(i + 1), 28, uniform(0, 11), 11, uniform(0, 11), wanted, status);
+    }
+}
+
+// Slips with equal area but different widths, and duplicates of each, so
+// best-fit selection is decided by the width margin and then slip order.
+void MarinaGenerator::generateTies(Marina &marina){
+    int copies = uniform(1, 3);
+
+    for (int copy = 0; copy < copies; ++copy){
+        marina.mSlips.emplace_back("S" + std::to_string(marina.mSlips.size() + 1), 20, 0, 12, 0);
+        marina.mSlips.emplace_back("S" + std::to_string(marina.mSlips.size() + 1), 24, 0, 10, 0);
+        marina.mSlips.emplace_back("S" + std::to_string(marina.mSlips.size() + 1), 30, 0, 8, 0);
+    }
+
+    addRandomSlips(marina, uniform(0, 3));
+    addRandomMembers(marina, uniform(1, 12));
+
+    int tightCount = uniform(1, 6);
+
+    for (int i = 0; i < tightCount; ++i){
+        marina.mMembers.emplace_back("T" + std::to_string(i), uniform(15, 20), 0, uniform(7, 8), uniform(0, 11),
+                                     std::nullopt, Member::DockStatus::TEMPORARY);
+    }
+
+    if (chance(0.3)){
+        std::shuffle(marina.mSlips.begin(), marina.mSlips.end(), mRandom);
+    }
+}
+
+void MarinaGenerator::generateIgnoreLength(Marina &marina){
+    marina.mIgnoreLength = true;
+    addRandomSlips(marina, uniform(1, 20));
+    addRandomMembers(marina, uniform(1, 25));
+
+    // Boats well past every slip length so overhang decides the fit
+    int longCount = uniform(1, 6);
+
+    for (int i = 0; i < longCount; ++i){
+        marina.mMembers.emplace_back("L" + std::to_string(i), uniform(38, 50), uniform(0, 11), uniform(8, 12), 0,
+                                     randomCurrentSlip(marina.mSlips), randomStatus());
+    }
+}
+
+// Permanent members hold slips regardless of fit; several may name the
+// same slip, and some name slips that do not exist.
+void MarinaGenerator::generatePermanentMisfits(Marina &marina){
+    addRandomSlips(marina, uniform(1, 12));
+    addRandomMembers(marina, uniform(0, 15));
+
+    int permanentCount = uniform(1, 6);
+
+    for (int i = 0; i < permanentCount; ++i){
+        std::optional<std::string> slip = randomCurrentSlip(marina.mSlips);
+        marina.mMembers.emplace_back("P" + std::to_string(i), uniform(30, 50), 0, uniform(10, 16), 0,
+                                     slip, Member::DockStatus::PERMANENT);
+    }
+
+    std::shuffle(marina.mMembers.begin(), marina.mMembers.end(), mRandom);
+}
+
+// Docks of long narrow slips and docks of short wide slips, so most boats
+// fit only one kind and the marina splits into independent dock groups.
+// Slips are interleaved across docks and a few small boats that fit both
+// kinds join groups together.
+void MarinaGenerator::generateDocks(Marina &marina){
+    int dockCount = uniform(2, 6);
+    int slipCount = uniform(dockCount, 30);
+
+    for (int i = 0; i < slipCount; ++i){
+        int dock = uniform(0, dockCount - 1);
+        std::string dockName(1, static_cast<char>('A' + dock));
+        std::string id = "S" + std::to_string(marina.mSlips.size() + 1);
+
+        if (dock % 2 == 0){
+            marina.mSlips.emplace_back(id, uniform(36, 44), 0, uniform(9, 10), 0, dockName);
+        }
+        else{
+            marina.mSlips.emplace_back(id, uniform(24, 28), 0, uniform(13, 15), 0, dockName);
+        }
+    }
+
+    int memberCount = uniform(1, 35);
+
+    for (int i = 0; i < memberCount; ++i){
+        int shape = uniform(0, 19);
+        int length, width;
+
+        if (shape < 10){
+            length = uniform(30, 36);
+            width = uniform(8, 9);
+        }
+        else if (shape < 19){
+            length = uniform(20, 24);
+            width = uniform(11, 13);
+        }
+        else{
+            length = uniform(18, 22);
+            width = 8;
+        }
+
+        // Current slips in another dock tie docks together, so keep them rare
+        std::optional<std::string> current;
+
+        if (chance(0.2)){
+            current = randomCurrentSlip(marina.mSlips);
+        }
+
+        marina.mMembers.emplace_back("M" + std::to_string(i + 1), length, INCH_CHOICES[uniform(0, 4)], width, 0,
+                                     current, randomStatus());
+    }
+}
+
+// A few depth and clearance classes, some unrestricted, with boats whose
+// draft and air draft land on, under and over the limits.
+void MarinaGenerator::generateDrafts(Marina &marina){
+    const int DEPTHS_IN[] = { 0, 48, 60, 72 };
+    const int CLEARANCES_IN[] = { 0, 0, 360, 480 };
+
+    addRandomSlips(marina, uniform(1, 30));
+
+    for (auto &slip : marina.mSlips){
+        slip.setVerticalLimits(DEPTHS_IN[uniform(0, 3)], CLEARANCES_IN[uniform(0, 3)]);
+    }
+
+    addRandomMembers(marina, uniform(1, 35));
+
+    for (auto &member : marina.mMembers){
+        int draft = chance(0.2) ? 0 : DEPTHS_IN[uniform(1, 3)] + uniform(-6, 6);
+        int airDraft = chance(0.5) ? 0 : CLEARANCES_IN[uniform(2, 3)] + uniform(-24, 24);
+        member.setBoatDrafts(draft, airDraft);
+    }
+}
+
+// The dock layout with amenities on the slips and required by the boats.
+// Nothing offers a lift, so some boats are large enough for slips that
+// never have what they need.
+void MarinaGenerator::generateAmenities(Marina &marina){
+    const Amenities::Mask OFFERED[] = {
+        0,
+        Amenities::WATER,
+        Amenities::WATER | Amenities::POWER_30A,
+        Amenities::POWER_50A,
+        Amenities::WATER | Amenities::POWER_50A | Amenities::PUMP_OUT
+    };
+    const Amenities::Mask REQUIRED[] = {
+        0,
+        0,
+        Amenities::WATER,
+        Amenities::POWER_50A,
+        Amenities::WATER | Amenities::POWER_50A,
+        Amenities::PUMP_OUT,
+        Amenities::LIFT
+    };
+
+    generateDocks(marina);
+    addRandomSlips(marina, uniform(0, 4));
+
+    for (auto &slip : marina.mSlips){
+        slip.setAmenities(OFFERED[uniform(0, 4)]);
+    }
+
+    for (auto &member : marina.mMembers){
+        member.setRequiredAmenities(REQUIRED[uniform(0, 6)]);
+    }
+}
+
+Marina MarinaGenerator::generate(){
+    Marina marina;
+    Kind kind = static_cast<Kind>(uniform(0, 7));
+    marina.mKind = kindToString(kind);
+
+    switch (kind){
+        case Kind::RANDOM:
+            generateRandom(marina);
+            break;
+        case Kind::EVICTION_CHAIN:
+            generateEvictionChain(marina);
+            break;
+        case Kind::TIES:
+            generateTies(marina);
+            break;
+        case Kind::IGNORE_LENGTH:
+            generateIgnoreLength(marina);
+            break;
+        case Kind::PERMANENT_MISFITS:
+            generatePermanentMisfits(marina);
+            break;
+        case Kind::DOCKS:
+            generateDocks(marina);
+            break;
+        case Kind::DRAFTS:
+            generateDrafts(marina);
+            break;
+        case Kind::AMENITIES:
+            generateAmenities(marina);
+            break;
+    }
+
+    if (kind != Kind::IGNORE_LENGTH){
+        marina.mIgnoreLength = chance(0.25);
+    }
+
+    const double prices[] = { 0.0, 0.0, 1.0, 2.75, 3.333 };
+    marina.mPricePerSqFt = prices[uniform(0, 4)];
+
+    return marina;
+}
+
+std::string MarinaGenerator::kindToString(Kind kind){
+    switch (kind){
+        case Kind::RANDOM:
+            return "random";
+        case Kind::EVICTION_CHAIN:
+            return "eviction-chain";
+        case Kind::TIES:
+            return "ties";
+        case Kind::IGNORE_LENGTH:
+            return "ignore-length";
+        case Kind::PERMANENT_MISFITS:
+            return "permanent-misfits";
+        case Kind::DOCKS:
+            return "docks";
+        case Kind::DRAFTS:
+            return "drafts";
+        case Kind::AMENITIES:
+            return "amenities";
+    }
+    return "unknown";
+}
@@ -0,0 +1,71 @@
+#ifndef MARINA_GENERATOR_H
+#define MARINA_GENERATOR_H
+
+#include "../../member.hpp"
+#include "../../slip.hpp"
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+// A generated assignment problem: roster, slips and engine options.
+struct Marina {
+    std::vector<Member> mMembers;
+    std::vector<Slip> mSlips;
+    bool mIgnoreLength = false;
+    double mPricePerSqFt = 0.0;
+    std::string mKind;
+};
+
+// Generates random and adversarial marinas for differential testing.
+//
+// Each marina is fully determined by its scenario seed, so a failing case
+// can be replayed from the seed printed by the oracle. Dimensions are drawn
+// from small pools so equal areas, equal width margins and exact fits are
+// common rather than rare.
+class MarinaGenerator {
+public:
+    enum class Kind {
+        RANDOM,             // Mixed statuses, sizes and current slips
+        EVICTION_CHAIN,     // Members queued on each other's slips
+        TIES,               // Equal areas and width margins across slips
+        IGNORE_LENGTH,      // Boats longer than slips, ignore-length mode
+        PERMANENT_MISFITS,  // Permanent boats that do not fit or share slips
+        DOCKS,              // Docks with shapes that only some boats fit
+        DRAFTS,             // Slip depths and clearances, keels and masts
+        AMENITIES           // Docks offering different amenities, boats requiring them
+    };
+
+private:
+    std::mt19937_64 mRandom;
+
+    int uniform(int low, int high);
+    bool chance(double probability);
+    std::string memberId(int number);
+    Member::DockStatus randomStatus();
+    std::optional<std::string> randomCurrentSlip(const std::vector<Slip> &slips);
+    void addRandomSlips(Marina &marina, int count);
+    void addRandomMembers(Marina &marina, int count);
+
+    void generateRandom(Marina &marina);
+    void generateEvictionChain(Marina &marina);
+    void generateTies(Marina &marina);
+    void generateIgnoreLength(Marina &marina);
+    void generatePermanentMisfits(Marina &marina);
+    void generateDocks(Marina &marina);
+    void generateDrafts(Marina &marina);
+    void generateAmenities(Marina &marina);
+
+public:
+    explicit MarinaGenerator(uint64_t scenarioSeed);
+
+    Marina generate();
+
+    static std::string kindToString(Kind kind);
+};
+
+// Derive a well-mixed scenario seed from a run seed and iteration number.
+uint64_t scenarioSeed(uint64_t runSeed, uint64_t iteration);
+
+#endif
@@ -0,0 +1,289 @@
+// Differential oracle: runs generated marinas through the frozen reference
+// engine and every optimized AssignmentEngine mode, and fails on the first
+// difference in output. Mismatching inputs are minimized before they are
+// printed so they can be dropped straight into a regression test.
+//
+//   slippage_oracle [--iterations N] [--seed S] [--scenario SEED]
+
+#include "marina_generator.hpp"
+#include "reference_engine.hpp"
+#include "../../assignment_engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct EngineMode {
+    std::string mName;
+    std::function<void(AssignmentEngine &)> mConfigure;
+    // Modes that suppress diagnostics still have to agree on everything else
+    bool mCompareUnassignedComments;
+    // What-if modes prepare and fork the engine and make a change on the
+    // fork; the reference runs on the marina with the same change made.
+    // Null for modes that run the engine directly
+    std::function<void(Marina &, AssignmentEngine &)> mChange;
+};
+
+// Close the dock of the middle slip
+void closeMiddleDock(Marina &marina, AssignmentEngine &branch){
+    if (marina.mSlips.empty()){
+        return;
+    }
+
+    std::string dock = marina.mSlips[marina.mSlips.size() / 2].dock();
+    branch.closeDock(dock);
+    marina.mSlips.erase(std::remove_if(marina.mSlips.begin(), marina.mSlips.end(),
+                                       [&dock](const Slip &slip) { return slip.dock() == dock; }),
+                        marina.mSlips.end());
+}
+
+// Move the middle member to the next dock status, covering every transition
+void changeMiddleStatus(Marina &marina, AssignmentEngine &branch){
+    if (marina.mMembers.empty()){
+        return;
+    }
+
+    Member &member = marina.mMembers[marina.mMembers.size() / 2];
+    auto next = static_cast<Member::DockStatus>((static_cast<int>(member.dockStatus()) + 1) % 5);
+    branch.setDockStatus(member.id(), next);
+    member.setDockStatus(next);
+}
+
+// Every engine configuration that must reproduce the reference output.
+// Add new fast paths here as they are introduced.
+std::vector<EngineMode> engineModes(){
+    return {
+        { "default", [](AssignmentEngine &) {}, true, nullptr },
+        { "decision-log", [](AssignmentEngine &engine) { engine.setRecordDecisions(true); }, true, nullptr },
+        { "no-diagnostics", [](AssignmentEngine &engine) { engine.setDiagnostics(false); }, false, nullptr },
+        { "dock-threads", [](AssignmentEngine &engine) { engine.setThreads(4); }, true, nullptr },
+        { "fork", [](AssignmentEngine &) {}, true, [](Marina &, AssignmentEngine &) {} },
+        { "fork-close-dock", [](AssignmentEngine &) {}, true, closeMiddleDock },
+        { "fork-dock-status", [](AssignmentEngine &) {}, true, changeMiddleStatus },
+    };
+}
+
+std::string describe(const Assignment &assignment){
+    std::ostringstream out;
+    out << assignment.memberId() << " slip=" << assignment.slipId()
+            << " status=" << Assignment::statusToString(assignment.status())
+            << " boat=" << assignment.boatDimensions().lengthInches() << "x" << assignment.boatDimensions().widthInches()
+            << " slipDims=" << assignment.slipDimensions().lengthInches() << "x" << assignment.slipDimensions().widthInches()
+            << " dock=" << Member::dockStatusToString(assignment.dockStatus())
+            << " price=" << assignment.price()
+            << " upgraded=" << assignment.upgraded()
+            << " comment=\"" << assignment.comment() << "\"";
+    return out.str();
+}
+
+bool sameAssignment(const Assignment &expected, const Assignment &actual, bool compareUnassignedComments){
+    bool compareComment = compareUnassignedComments || expected.status() != Assignment::Status::UNASSIGNED ||
+            expected.dockStatus() == Member::DockStatus::YEAR_OFF;
+
+    return expected.memberId() == actual.memberId() &&
+            expected.slipId() == actual.slipId() &&
+            expected.status() == actual.status() &&
+            expected.boatDimensions().lengthInches() == actual.boatDimensions().lengthInches() &&
+            expected.boatDimensions().widthInches() == actual.boatDimensions().widthInches() &&
+            expected.slipDimensions().lengthInches() == actual.slipDimensions().lengthInches() &&
+            expected.slipDimensions().widthInches() == actual.slipDimensions().widthInches() &&
+            expected.dockStatus() == actual.dockStatus() &&
+            expected.price() == actual.price() &&
+            expected.upgraded() == actual.upgraded() &&
+            (!compareComment || expected.comment() == actual.comment());
+}
+
+// Returns a description of the first difference, or an empty string
+std::string compare(const Marina &marina, const EngineMode &mode){
+    Marina changed = marina;
+    AssignmentEngine engine(marina.mMembers, marina.mSlips);
+    engine.setIgnoreLength(marina.mIgnoreLength);
+    engine.setPricePerSqFt(marina.mPricePerSqFt);
+    mode.mConfigure(engine);
+    std::vector<Assignment> actual;
+
+    if (mode.mChange){
+        engine.prepare();
+        AssignmentEngine branch = engine.fork();
+        mode.mChange(changed, branch);
+        actual = branch.assign();
+    }
+    else{
+        actual = engine.assign();
+    }
+
+    ReferenceAssignmentEngine reference(changed.mMembers, changed.mSlips);
+    reference.setIgnoreLength(changed.mIgnoreLength);
+    reference.setPricePerSqFt(changed.mPricePerSqFt);
+    std::vector<Assignment> expected = reference.assign();
+
+    size_t rows = std::min(expected.size(), actual.size());
+
+    for (size_t i = 0; i < rows; ++i){
+        if (!sameAssignment(expected[i], actual[i], mode.mCompareUnassignedComments)){
+            return "row " + std::to_string(i) + "\n  expected: " + describe(expected[i]) +
+                    "\n  actual:   " + describe(actual[i]);
+        }
+    }
+
+    if (expected.size() != actual.size()){
+        return "expected " + std::to_string(expected.size()) + " rows, got " + std::to_string(actual.size());
+    }
+
+    return "";
+}
+
+// Greedily drop members, then slips, while the mismatch persists
+Marina minimize(Marina marina, const EngineMode &mode){
+    bool shrunk = true;
+
+    while (shrunk){
+        shrunk = false;
+
+        for (size_t i = marina.mMembers.size(); i-- > 0;){
+            Marina candidate = marina;
+            candidate.mMembers.erase(candidate.mMembers.begin() + i);
+
+            if (!compare(candidate, mode).empty()){
+                marina = std::move(candidate);
+                shrunk = true;
+            }
+        }
+
+        for (size_t i = marina.mSlips.size(); i-- > 0;){
+            Marina candidate = marina;
+            candidate.mSlips.erase(candidate.mSlips.begin() + i);
+
+            if (!compare(candidate, mode).empty()){
+                marina = std::move(candidate);
+                shrunk = true;
+            }
+        }
+    }
+
+    return marina;
+}
+
+void printMarina(const Marina &marina){
+    std::cout << "--- members.csv ---\n"
+            << "member_id,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,current_slip,dock_status,"
+            << "boat_draft_ft,boat_draft_in,boat_air_draft_ft,boat_air_draft_in,required_amenities\n";
+
+    for (const auto &member : marina.mMembers){
+        const Dimensions &boat = member.boatDimensions();
+        std::cout << member.id() << ","
+                << boat.lengthInches() / 12 << "," << boat.lengthInches() % 12 << ","
+                << boat.widthInches() / 12 << "," << boat.widthInches() % 12 << ","
+                << member.currentSlip().value_or("") << ","
+                << Member::dockStatusToString(member.dockStatus()) << ","
+                << boat.draftInches() / 12 << "," << boat.draftInches() % 12 << ","
+                << boat.airDraftInches() / 12 << "," << boat.airDraftInches() % 12 << ","
+                << Amenities::toString(member.requiredAmenities()) << "\n";
+    }
+
+    std::cout << "--- slips.csv ---\n"
+            << "slip_id,max_length_ft,max_length_in,max_width_ft,max_width_in,dock,"
+            << "max_draft_ft,max_draft_in,max_air_draft_ft,max_air_draft_in,amenities\n";
+
+    for (const auto &slip : marina.mSlips){
+        const Dimensions &size = slip.maxDimensions();
+        std::cout << slip.id() << ","
+                << size.lengthInches() / 12 << "," << size.lengthInches() % 12 << ","
+                << size.widthInches() / 12 << "," << size.widthInches() % 12 << "," << slip.dock() << ","
+                << size.draftInches() / 12 << "," << size.draftInches() % 12 << ","
+                << size.airDraftInches() / 12 << "," << size.airDraftInches() % 12 << ","
+                << Amenities::toString(slip.amenities()) << "\n";
+    }
+
+    std::cout << "--- options ---\n"
+            << "ignore-length: " << (marina.mIgnoreLength ? "yes" : "no") << "\n"
+            << "price-per-sqft: " << marina.mPricePerSqFt << "\n";
+}
+
+void printUsage(const char *programName){
+    std::cerr << "Usage: " << programName << " [--iterations N] [--seed S] [--scenario SEED]\n"
+            << "  --iterations N   Marinas to generate (default 10000)\n"
+            << "  --seed S         Run seed (default: time-based, always printed)\n"
+            << "  --scenario SEED  Replay a single scenario seed from a failure report\n";
+}
+
+}
+
+int main(int argc, char *argv[]){
+    uint64_t iterations = 10000;
+    uint64_t runSeed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    bool replay = false;
+    uint64_t replaySeed = 0;
+
+    try{
+        for (int i = 1; i < argc; ++i){
+            std::string arg = argv[i];
+
+            if (arg == "--iterations" && i + 1 < argc){
+                iterations = std::stoull(argv[++i]);
+            }
+            else if (arg == "--seed" && i + 1 < argc){
+                runSeed = std::stoull(argv[++i]);
+            }
+            else if (arg == "--scenario" && i + 1 < argc){
+                replay = true;
+                replaySeed = std::stoull(argv[++i]);
+            }
+            else{
+                printUsage(argv[0]);
+                return 2;
+            }
+        }
+    }
+    catch (const std::exception &e){
+        std::cerr << "Error: invalid number: " << e.what() << std::endl;
+        return 2;
+    }
+
+    std::vector<EngineMode> modes = engineModes();
+
+    if (replay){
+        iterations = 1;
+    }
+    else{
+        std::cout << "oracle: seed " << runSeed << ", " << iterations << " marinas, " << modes.size() << " modes"
+                << std::endl;
+    }
+
+    for (uint64_t iteration = 0; iteration < iterations; ++iteration){
+        uint64_t seed = replay ? replaySeed : scenarioSeed(runSeed, iteration);
+        Marina marina = MarinaGenerator(seed).generate();
+
+        for (const auto &mode : modes){
+            std::string difference = compare(marina, mode);
+
+            if (difference.empty()){
+                continue;
+            }
+
+            std::cout << "MISMATCH in mode '" << mode.mName << "' (" << marina.mKind << " marina)\n";
+
+            if (!replay){
+                std::cout << "  run seed " << runSeed << ", iteration " << iteration << "\n";
+            }
+
+            std::cout << "  replay with: --scenario " << seed << "\n";
+
+            Marina minimal = minimize(marina, mode);
+            std::cout << "minimized from " << marina.mMembers.size() << " members/" << marina.mSlips.size()
+                    << " slips to " << minimal.mMembers.size() << "/" << minimal.mSlips.size() << ":\n"
+                    << compare(minimal, mode) << "\n";
+            printMarina(minimal);
+            return 1;
+        }
+    }
+
+    std::cout << "oracle: all " << iterations << " marinas matched" << std::endl;
+    return 0;
+}
@@ -0,0 +1,54 @@
+#ifndef REFERENCE_ENGINE_H
+#define REFERENCE_ENGINE_H
+
+#include "../../member.hpp"
+#include "../../slip.hpp"
+#include "../../assignment.hpp"
+#include <map>
+#include <vector>
+
+// Reference implementation of the assignment rules in ASSIGNMENT_RULES.md,
+// kept exactly as the original AssignmentEngine was written: linear slip
+// scans, string-keyed occupancy maps and member ID comparisons.
+//
+// It covers length/width fit, depth and clearance, required amenities, dock
+// status priority, eviction, best-fit tie-breaking, ignore-length mode and
+// pricing. Inputs that use later extensions are outside its scope and are
+// not generated by the oracle.
+class ReferenceAssignmentEngine {
+    std::vector<Member> mMembers;
+    std::vector<Slip> mSlips;
+    std::map<std::string, const Member *> mSlipOccupant;
+    std::map<const Member *, std::string> mMemberAssignment;
+    bool mIgnoreLength;
+    double mPricePerSqFt;
+    
+    void assignPermanentMembers(std::vector<Assignment> &assignments);
+    void processYearOffMembers(std::vector<Assignment> &assignments);
+    void assignRemainingMembers(std::vector<Assignment> &assignments);
+    
+    bool canMemberEvict(const Member *member) const;
+    bool canEvictMember(const Member *evictingMember, const Member *occupant) const;
+    int getDockStatusPriority(Member::DockStatus status) const;
+    
+    Slip *findSlipById(const std::string &slipId) const;
+    Slip *findBestAvailableSlip(const Dimensions &boatDimensions, const Member *requestingMember, const std::string &excludeSlipId = "");
+    Member *findMemberById(const std::string &memberId);
+    void assignMemberToSlip(const Member *member, const std::string &slipId);
+    void unassignMember(const Member *member);
+    bool isMemberAssigned(const Member *member) const;
+    std::string generateUnassignedComment(const Member *member) const;
+    bool slipFits(const Slip *slip, const Dimensions &boatDimensions) const;
+    bool slipProvides(const Slip *slip, const Member *member) const;
+    std::string generateLengthComment(const Slip *slip, const Dimensions &boatDimensions) const;
+    std::string generateWidthMarginNote(const Slip *slip, const Dimensions &boatDimensions) const;
+
+public:
+    ReferenceAssignmentEngine(std::vector<Member> members, std::vector<Slip> slips);
+    
+    void setIgnoreLength(bool ignoreLength){ mIgnoreLength = ignoreLength; }
+    void setPricePerSqFt(double pricePerSqFt){ mPricePerSqFt = pricePerSqFt; }
+    std::vector<Assignment> assign();
+};
+
+#endif
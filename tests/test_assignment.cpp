@@ -5,6 +5,14 @@
 #include "../member.hpp"
 #include "../slip.hpp"
 #include "../assignment.hpp"
+#include "../booking_calendar.hpp"
+#include "../slip_index.hpp"
+#include "../waitlist_forecast.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <map>
+#include <thread>
 
 TEST_CASE("Basic slip assignment", "[assignment]") {
     std::vector<Slip> slips;
@@ -802,3 +810,1201 @@ TEST_CASE("Upgrade status: Mixed scenario", "[assignment][upgrade]") {
     REQUIRE(m3Found);
     REQUIRE(m4Found);
 }
+
+TEST_CASE("Explain reports eviction, pass and blocked candidates", "[assignment][explain]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 20, 0, 10, 0);
+    
+    std::vector<Member> members;
+    members.emplace_back("M2", 18, 0, 8, 0, std::optional<std::string>("S1"), Member::DockStatus::TEMPORARY);
+    members.emplace_back("M1", 18, 0, 8, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    
+    AssignmentEngine engine(std::move(members), std::move(slips));
+    engine.setRecordDecisions(true);
+    engine.assign();
+    
+    std::string explanation = engine.explain("M2");
+    
+    REQUIRE(explanation.find("Result: not assigned") != std::string::npos);
+    REQUIRE(explanation.find("evicted - slip S1, member M1 (waiting-list)") != std::string::npos);
+    REQUIRE(explanation.find("Decided in phase 4 (temporary), pass 1") != std::string::npos);
+    REQUIRE(explanation.find("S1 20' 0\" x 10' 0\" - occupied by M1 (waiting-list), cannot evict") != std::string::npos);
+    REQUIRE(engine.explain("M1").find("Result: assigned to slip S1") != std::string::npos);
+    REQUIRE_THROWS_AS(engine.explain("M9"), std::invalid_argument);
+}
+
+TEST_CASE("Decision log records nothing unless enabled", "[assignment][explain]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 20, 0, 10, 0);
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 18, 0, 8, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    
+    AssignmentEngine engine(std::move(members), std::move(slips));
+    engine.assign();
+    
+    REQUIRE(engine.decisionLog().entries().empty());
+}
+
+TEST_CASE("Disabling diagnostics leaves unassigned comments empty", "[assignment][explain][unassigned]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 20, 0, 10, 0);
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 30, 0, 12, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    
+    AssignmentEngine engine(std::move(members), std::move(slips));
+    engine.setDiagnostics(false);
+    auto assignments = engine.assign();
+    
+    REQUIRE(assignments.size() == 1);
+    REQUIRE(assignments[0].status() == Assignment::Status::UNASSIGNED);
+    REQUIRE(assignments[0].comment().empty());
+}
+
+TEST_CASE("Best-fit search stays in the preferred dock", "[assignment][dock]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("A1", 20, 0, 10, 0, "A");
+    slips.emplace_back("B1", 30, 0, 12, 0, "B");
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 18, 0, 8, 0, std::nullopt, Member::DockStatus::TEMPORARY, std::optional<std::string>("B"));
+    members.emplace_back("M2", 18, 0, 8, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    
+    AssignmentEngine engine(std::move(members), std::move(slips));
+    auto assignments = engine.assign();
+    
+    REQUIRE(assignments.size() == 2);
+    REQUIRE(assignments[0].memberId() == "M1");
+    REQUIRE(assignments[0].slipId() == "B1");
+    REQUIRE(assignments[1].memberId() == "M2");
+    REQUIRE(assignments[1].slipId() == "A1");
+}
+
+TEST_CASE("Preferred dock falls back to other docks on a miss", "[assignment][dock]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("A1", 20, 0, 10, 0, "A");
+    slips.emplace_back("B1", 16, 0, 12, 0, "B");
+    slips.emplace_back("B2", 30, 0, 12, 0, "B");
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 25, 0, 11, 0, std::optional<std::string>("B2"), Member::DockStatus::PERMANENT);
+    members.emplace_back("M2", 18, 0, 8, 0, std::nullopt, Member::DockStatus::TEMPORARY, std::optional<std::string>("B"));
+    members.emplace_back("M3", 18, 0, 8, 0, std::nullopt, Member::DockStatus::TEMPORARY, std::optional<std::string>("Z"));
+    
+    AssignmentEngine engine(std::move(members), std::move(slips));
+    auto assignments = engine.assign();
+    
+    REQUIRE(assignments.size() == 3);
+    REQUIRE(assignments[1].memberId() == "M2");
+    REQUIRE(assignments[1].slipId() == "A1");
+    REQUIRE(assignments[2].memberId() == "M3");
+    REQUIRE(assignments[2].status() == Assignment::Status::UNASSIGNED);
+}
+
+TEST_CASE("Deep keels and tall masts skip slips they do not clear", "[assignment][draft]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 30, 0, 12, 0);
+    slips.emplace_back("S2", 32, 0, 12, 0);
+    slips.emplace_back("S3", 40, 0, 14, 0);
+    slips[0].setVerticalLimits(48, 0);
+    slips[1].setVerticalLimits(0, 360);
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 28, 0, 10, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    members.emplace_back("M2", 28, 0, 10, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members.emplace_back("M3", 28, 0, 10, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members[0].setBoatDrafts(60, 400);
+    members[1].setBoatDrafts(60, 0);
+    
+    AssignmentEngine engine(std::move(members), std::move(slips));
+    auto assignments = engine.assign();
+    
+    // M1 clears neither the shallow S1 nor the low S2; M2 clears S2 only
+    REQUIRE(assignments.size() == 3);
+    REQUIRE(assignments[0].slipId() == "S3");
+    REQUIRE(assignments[1].slipId() == "S2");
+    REQUIRE(assignments[2].slipId() == "S1");
+}
+
+TEST_CASE("Best fit only considers slips providing required amenities", "[assignment][amenities]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 30, 0, 12, 0);
+    slips.emplace_back("S2", 40, 0, 14, 0);
+    slips.emplace_back("S3", 50, 0, 16, 0);
+    slips[0].setAmenities(Amenities::WATER);
+    slips[1].setAmenities(Amenities::WATER | Amenities::POWER_50A);
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 28, 0, 10, 0, std::optional<std::string>("S1"), Member::DockStatus::WAITING_LIST);
+    members.emplace_back("M2", 28, 0, 10, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members.emplace_back("M3", 28, 0, 10, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members[0].setRequiredAmenities(Amenities::POWER_50A);
+    members[2].setRequiredAmenities(Amenities::PUMP_OUT);
+    
+    AssignmentEngine engine(std::move(members), std::move(slips));
+    auto assignments = engine.assign();
+    
+    // M1's current slip has no 50A power; nothing offers a pump-out for M3
+    REQUIRE(assignments.size() == 3);
+    REQUIRE(assignments[0].memberId() == "M1");
+    REQUIRE(assignments[0].slipId() == "S2");
+    REQUIRE(assignments[1].memberId() == "M2");
+    REQUIRE(assignments[1].slipId() == "S1");
+    REQUIRE(assignments[2].memberId() == "M3");
+    REQUIRE(assignments[2].status() == Assignment::Status::UNASSIGNED);
+    REQUIRE(assignments[2].comment() == "No large enough slip provides pump-out");
+}
+
+TEST_CASE("Slips with too many amenity sets are grouped by depth and clearance", "[assignment][amenities]") {
+    std::vector<Slip> slips;
+    std::vector<uint32_t> positions;
+    
+    // One slip per amenity set, in mask order; slips with a lift are short
+    for (Amenities::Mask mask = 0; mask < 256; ++mask){
+        slips.emplace_back("S" + std::to_string(mask), (mask & Amenities::LIFT) ? 20 : 30, 0, 12, 0);
+        slips.back().setAmenities(mask);
+        positions.push_back(mask);
+    }
+    
+    REQUIRE(SlipIndex(slips, positions, 256).groups().size() == 256);
+    
+    SlipIndex index(slips, positions);
+    REQUIRE(index.groups().size() == 1);
+    REQUIRE(index.groups()[0].mMixed);
+    REQUIRE(index.groups()[0].mAmenities == 255);
+    
+    // The group has a lift and a 30' slip, but no 30' slip with a lift
+    Dimensions boat(28, 0, 10, 0);
+    REQUIRE(index.anyFits(boat, Amenities::WATER, false));
+    REQUIRE_FALSE(index.anyFits(boat, Amenities::LIFT, false));
+    REQUIRE(index.anyFits(boat, Amenities::LIFT, true));
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 28, 0, 10, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members.emplace_back("M2", 28, 0, 10, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members.emplace_back("M3", 28, 0, 10, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members.emplace_back("M4", 28, 0, 10, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members.emplace_back("M5", 18, 0, 10, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members[0].setRequiredAmenities(Amenities::WATER | Amenities::PUMP_OUT);
+    members[1].setRequiredAmenities(Amenities::WATER);
+    members[2].setRequiredAmenities(Amenities::WATER);
+    members[3].setRequiredAmenities(Amenities::LIFT);
+    
+    for (bool stableMatching : { false, true }){
+        AssignmentEngine engine(members, slips);
+        engine.setStableMatching(stableMatching);
+        auto assignments = engine.assign();
+        
+        // Equal slips go by position, so each boat takes the lowest mask
+        // providing its amenities that is still free
+        REQUIRE(assignments.size() == 5);
+        REQUIRE(assignments[0].slipId() == "S24");
+        REQUIRE(assignments[1].slipId() == "S8");
+        REQUIRE(assignments[2].slipId() == "S9");
+        REQUIRE(assignments[3].memberId() == "M5");
+        REQUIRE(assignments[3].slipId() == "S128");
+        REQUIRE(assignments[4].memberId() == "M4");
+        REQUIRE(assignments[4].status() == Assignment::Status::UNASSIGNED);
+        REQUIRE(assignments[4].comment() == "No large enough slip provides lift");
+    }
+    
+    AssignmentEngine engine(members, slips);
+    engine.setIgnoreLength(true);
+    auto assignments = engine.assign();
+    
+    // Only short slips have a lift, so M4 overhangs one
+    REQUIRE(assignments[1].slipId() == "S8");
+    REQUIRE(assignments[3].slipId() == "S128");
+    REQUIRE(assignments[4].slipId() == "S129");
+}
+
+TEST_CASE("Shared slips hold boats side by side up to their width and capacity", "[assignment][shared]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 30, 0, 10, 0);
+    slips.emplace_back("T1", 40, 0, 24, 0);
+    slips[1].setCapacity(2);
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 28, 0, 10, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    members.emplace_back("M2", 28, 0, 10, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members.emplace_back("M3", 28, 0, 10, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members.emplace_back("M4", 20, 0, 8, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    
+    for (bool stableMatching : { false, true }){
+        AssignmentEngine engine(members, slips);
+        engine.setPricePerSqFt(1.0);
+        engine.setStableMatching(stableMatching);
+        auto assignments = engine.assign();
+        
+        // S1 is the tighter fit for M1; T1 then takes two boats and is full
+        REQUIRE(assignments.size() == 4);
+        REQUIRE(assignments[0].slipId() == "S1");
+        REQUIRE(assignments[1].memberId() == "M2");
+        REQUIRE(assignments[1].slipId() == "T1");
+        REQUIRE(assignments[1].comment() == "Shares slip with M3");
+        REQUIRE(assignments[2].memberId() == "M3");
+        REQUIRE(assignments[2].slipId() == "T1");
+        REQUIRE(assignments[2].comment() == "Shares slip with M2");
+        REQUIRE(assignments[3].memberId() == "M4");
+        REQUIRE(assignments[3].status() == Assignment::Status::UNASSIGNED);
+        
+        // Each boat is billed for the slip's length by its own width
+        REQUIRE(assignments[1].slipDimensions().widthInches() == 120);
+        REQUIRE(assignments[1].price() == 400.00);
+    }
+}
+
+TEST_CASE("A shared slip too narrow for another boat blocks it", "[assignment][shared]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("T1", 40, 0, 20, 0);
+    slips[0].setCapacity(3);
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 30, 0, 12, 0, std::optional<std::string>("T1"), Member::DockStatus::PERMANENT);
+    members.emplace_back("M2", 30, 0, 9, 0, std::optional<std::string>("T1"), Member::DockStatus::WAITING_LIST);
+    members.emplace_back("M3", 30, 0, 8, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    
+    AssignmentEngine engine(std::move(members), std::move(slips));
+    auto assignments = engine.assign();
+    
+    // 12' beside a permanent 12' beam leaves 8': room for M3 but not M2
+    REQUIRE(assignments.size() == 3);
+    REQUIRE(assignments[0].memberId() == "M1");
+    REQUIRE(assignments[0].comment() == "Shares slip with M3");
+    REQUIRE(assignments[1].memberId() == "M3");
+    REQUIRE(assignments[1].slipId() == "T1");
+    REQUIRE(assignments[2].memberId() == "M2");
+    REQUIRE(assignments[2].status() == Assignment::Status::UNASSIGNED);
+    REQUIRE(assignments[2].comment() == "Evicted - previous slip taken by permanent member, all 1 suitable slips taken");
+}
+
+TEST_CASE("Independent docks assigned on threads match a serial run", "[assignment][dock]") {
+    // Dock A has long narrow slips and dock B short wide ones; no boat fits both
+    std::vector<Slip> slips;
+    std::vector<Member> members;
+    
+    for (int i = 0; i < 20; ++i){
+        std::string dock = i % 2 == 0 ? "A" : "B";
+        slips.emplace_back(dock + std::to_string(i), i % 2 == 0 ? 40 : 25, 0, i % 2 == 0 ? 9 : 14, 0, dock);
+    }
+    
+    for (int i = 0; i < 30; ++i){
+        std::optional<std::string> current;
+        
+        if (i % 3 == 0){
+            current = (i % 2 == 0 ? "A" : "B") + std::to_string(i % 20);
+        }
+        
+        Member::DockStatus status = i % 5 == 0 ? Member::DockStatus::PERMANENT :
+                                    i % 4 == 0 ? Member::DockStatus::WAITING_LIST : Member::DockStatus::TEMPORARY;
+        members.emplace_back("M" + std::to_string(i), i % 2 == 0 ? 35 : 22, 0, i % 2 == 0 ? 8 : 13, 0, current, status);
+    }
+    
+    AssignmentEngine serial(members, slips);
+    auto expected = serial.assign();
+    
+    AssignmentEngine threaded(members, slips);
+    threaded.setThreads(4);
+    auto actual = threaded.assign();
+    
+    REQUIRE(actual.size() == expected.size());
+    
+    for (size_t i = 0; i < expected.size(); ++i){
+        REQUIRE(actual[i].memberId() == expected[i].memberId());
+        REQUIRE(actual[i].slipId() == expected[i].slipId());
+        REQUIRE(actual[i].status() == expected[i].status());
+        REQUIRE(actual[i].comment() == expected[i].comment());
+    }
+}
+
+TEST_CASE("Dock threads report missing amenities like a serial run", "[assignment][threads][amenities]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("B1", 20, 0, 8, 0, "B");
+    slips.emplace_back("A1", 50, 0, 16, 0, "A");
+    slips[0].setAmenities(Amenities::WATER);
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 40, 0, 12, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members.emplace_back("M2", 18, 0, 7, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members[0].setRequiredAmenities(Amenities::POWER_50A);
+    members[1].setRequiredAmenities(Amenities::WATER);
+    
+    // M1 fits no slip with 50A power but is large enough for dock A's
+    for (unsigned threads : { 1u, 2u }){
+        AssignmentEngine engine(members, slips);
+        engine.setThreads(threads);
+        auto assignments = engine.assign();
+        
+        REQUIRE(assignments.size() == 2);
+        REQUIRE(assignments[0].memberId() == "M2");
+        REQUIRE(assignments[0].slipId() == "B1");
+        REQUIRE(assignments[1].memberId() == "M1");
+        REQUIRE(assignments[1].comment() == "No large enough slip provides power-50a");
+    }
+}
+
+TEST_CASE("Forks of a prepared engine match fresh runs on the changed inputs", "[assignment][fork]") {
+    std::vector<Slip> slips;
+    std::vector<Member> members;
+    
+    for (int i = 0; i < 12; ++i){
+        std::string dock = i % 3 == 0 ? "A" : "B";
+        slips.emplace_back("S" + std::to_string(i), 30 + i % 4 * 2, 0, 10 + i % 3, 0, dock);
+    }
+    
+    for (int i = 0; i < 16; ++i){
+        std::optional<std::string> current;
+        
+        if (i % 2 == 0){
+            current = "S" + std::to_string(i % 12);
+        }
+        
+        Member::DockStatus status = i % 7 == 0 ? Member::DockStatus::PERMANENT :
+                                    i % 5 == 0 ? Member::DockStatus::YEAR_OFF :
+                                    i % 3 == 0 ? Member::DockStatus::WAITING_LIST : Member::DockStatus::TEMPORARY;
+        members.emplace_back("M" + std::to_string(i), 28 + i % 5, 0, 9 + i % 3, 0, current, status);
+    }
+    
+    AssignmentEngine engine(members, slips);
+    REQUIRE_THROWS_AS(engine.fork(), std::logic_error);
+    engine.prepare();
+    
+    std::vector<AssignmentEngine> forks;
+    forks.push_back(engine.fork());
+    forks.push_back(engine.fork());
+    forks.back().closeDock("A");
+    forks.push_back(engine.fork());
+    forks.back().setDockStatus("M4", Member::DockStatus::PERMANENT);
+    forks.back().setDockStatus("M7", Member::DockStatus::TEMPORARY);
+    REQUIRE_THROWS_AS(forks.back().closeDock("Z"), std::invalid_argument);
+    
+    auto results = AssignmentEngine::assignAll(forks, 3);
+    
+    // The same changes made to the inputs of fresh engines
+    std::vector<Slip> openSlips;
+    std::copy_if(slips.begin(), slips.end(), std::back_inserter(openSlips), [](const Slip &slip){ return slip.dock() != "A"; });
+    std::vector<Member> changedMembers(members);
+    changedMembers[4].setDockStatus(Member::DockStatus::PERMANENT);
+    changedMembers[7].setDockStatus(Member::DockStatus::TEMPORARY);
+    
+    std::vector<std::vector<Assignment>> expected;
+    expected.push_back(AssignmentEngine(members, slips).assign());
+    expected.push_back(AssignmentEngine(members, openSlips).assign());
+    expected.push_back(AssignmentEngine(changedMembers, slips).assign());
+    
+    for (size_t f = 0; f < expected.size(); ++f){
+        REQUIRE(results[f].size() == expected[f].size());
+        
+        for (size_t i = 0; i < expected[f].size(); ++i){
+            REQUIRE(results[f][i].memberId() == expected[f][i].memberId());
+            REQUIRE(results[f][i].slipId() == expected[f][i].slipId());
+            REQUIRE(results[f][i].status() == expected[f][i].status());
+            REQUIRE(results[f][i].dockStatus() == expected[f][i].dockStatus());
+            REQUIRE(results[f][i].comment() == expected[f][i].comment());
+        }
+    }
+    
+    // No slip in the closed dock is handed out
+    for (const auto &assignment : results[1]){
+        auto slip = std::find_if(slips.begin(), slips.end(), [&assignment](const Slip &candidate){
+            return candidate.id() == assignment.slipId();
+        });
+        REQUIRE((slip == slips.end() || slip->dock() != "A"));
+    }
+    
+    // Assigning the prepared engine itself uses up its snapshot
+    engine.assign();
+    REQUIRE_THROWS_AS(engine.fork(), std::logic_error);
+}
+
+TEST_CASE("The occupancy journal rolls back and replays a run exactly", "[assignment][journal]") {
+    std::vector<Slip> slips;
+    std::vector<Member> members;
+    
+    for (int i = 0; i < 8; ++i){
+        slips.emplace_back("S" + std::to_string(i), 26 + i % 3 * 4, 0, 10 + i % 2, 0);
+    }
+    
+    slips.emplace_back("T1", 40, 0, 20, 0);
+    slips.back().setCapacity(2);
+    
+    Member::DockStatus statuses[] = {
+        Member::DockStatus::PERMANENT,
+        Member::DockStatus::WAITING_LIST,
+        Member::DockStatus::TEMPORARY,
+        Member::DockStatus::UNASSIGNED
+    };
+    
+    for (int i = 0; i < 14; ++i){
+        // Several boats hold the same slip, so later ones are moved elsewhere
+        std::optional<std::string> current = "S" + std::to_string(i % 9 == 8 ? 0 : 7 - i % 8);
+        
+        if (i % 5 == 4){
+            current = "T1";
+        }
+        
+        members.emplace_back("M" + std::to_string(13 - i), 24 + i % 4 * 2, 0, 8 + i % 3, 0, current, statuses[i % 4]);
+    }
+    
+    AssignmentEngine engine(members, slips);
+    engine.setJournal(true);
+    auto assignments = engine.assign();
+    size_t steps = engine.mark();
+    REQUIRE(steps > 0);
+    
+    // Everyone's slip and every slip's occupants, in order
+    auto occupancy = [&members, &slips](const AssignmentEngine &target){
+        std::vector<std::string> state;
+        
+        for (const auto &member : members){
+            state.push_back(member.id() + "=" + target.assignedSlip(member.id()).value_or("-"));
+        }
+        
+        for (const auto &slip : slips){
+            std::string occupants;
+            
+            for (const auto &occupant : target.occupantsOf(slip.id())){
+                occupants += occupant + " ";
+            }
+            
+            state.push_back(slip.id() + ":" + occupants);
+        }
+        
+        return state;
+    };
+    
+    for (const auto &assignment : assignments){
+        REQUIRE(engine.assignedSlip(assignment.memberId()).value_or("") == assignment.slipId());
+    }
+    
+    OccupancyJournal journal = engine.journal();
+    
+    for (size_t mark : { steps, steps * 2 / 3, steps / 3, size_t(1), size_t(0) }){
+        engine.rollback(mark);
+        REQUIRE(engine.mark() == mark);
+        
+        AssignmentEngine replayed(members, slips);
+        replayed.replay(journal, mark);
+        REQUIRE(occupancy(replayed) == occupancy(engine));
+    }
+    
+    REQUIRE(engine.occupantsOf("S0").empty());
+    REQUIRE_THROWS_AS(engine.rollback(1), std::invalid_argument);
+    
+    // An eviction: M12 takes S0 and is then removed from it
+    OccupancyJournal eviction;
+    eviction.record(OccupancyJournal::Step::OCCUPANT_ADDED, 1, 0);
+    eviction.record(OccupancyJournal::Step::ASSIGNMENT_SET, 1, 0);
+    eviction.record(OccupancyJournal::Step::OCCUPANT_REMOVED, 1, 0, 0);
+    eviction.record(OccupancyJournal::Step::ASSIGNMENT_CLEARED, 1, 0);
+    engine.replay(eviction, eviction.size());
+    REQUIRE_FALSE(engine.assignedSlip("M12"));
+    REQUIRE(engine.occupantsOf("S0").empty());
+    
+    engine.rollback(2);
+    REQUIRE(engine.assignedSlip("M12").value_or("") == "S0");
+    REQUIRE(engine.occupantsOf("S0") == std::vector<std::string>{ "M12" });
+    
+    engine.rollback(0);
+    REQUIRE_FALSE(engine.assignedSlip("M12"));
+}
+
+TEST_CASE("The improvement pass places boats and frees area along chains of moves", "[assignment][improve]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 20, 0, 13, 0);
+    slips.emplace_back("S2", 25, 0, 10, 0);
+    slips.emplace_back("S3", 30, 0, 12, 0);
+    slips.emplace_back("S4", 40, 0, 14, 0);
+    
+    // W1 takes S2, the smallest slip by area, which leaves W2 in S3 and no
+    // room for U9; T5 keeps S4
+    std::vector<Member> members;
+    members.emplace_back("W1", 19, 0, 9, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    members.emplace_back("W2", 24, 0, 9, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    members.emplace_back("T5", 19, 0, 9, 0, "S4", Member::DockStatus::TEMPORARY);
+    members.emplace_back("U9", 29, 0, 11, 0, std::nullopt, Member::DockStatus::UNASSIGNED);
+    
+    auto slipsOf = [](const std::vector<Assignment> &assignments){
+        std::map<std::string, std::string> result;
+        
+        for (const auto &assignment : assignments){
+            result[assignment.memberId()] = assignment.slipId();
+        }
+        
+        return result;
+    };
+    
+    AssignmentEngine greedy(members, slips);
+    auto before = slipsOf(greedy.assign());
+    REQUIRE(before == std::map<std::string, std::string>{ { "W1", "S2" }, { "W2", "S3" }, { "T5", "S4" }, { "U9", "" } });
+    
+    AssignmentEngine engine(members, slips);
+    engine.setImproveMs(10000);
+    auto assignments = engine.assign();
+    
+    // U9 takes S3, W2 moves to S2 and W1 to S1
+    REQUIRE(slipsOf(assignments) == std::map<std::string, std::string>{ { "W1", "S1" }, { "W2", "S2" }, { "T5", "S4" }, { "U9", "S3" } });
+    REQUIRE(engine.improvementStats().mBoatsPlaced == 1);
+    REQUIRE(engine.improvementStats().mChains == 1);
+    REQUIRE_FALSE(engine.improvementStats().mTimedOut);
+    
+    for (const auto &assignment : assignments){
+        REQUIRE(assignment.status() != Assignment::Status::UNASSIGNED);
+    }
+    
+    // Without U9, moving W2 to S2 and W1 to S1 trades S3 for S1: 100 sq ft
+    members.pop_back();
+    AssignmentEngine areaEngine(members, slips);
+    areaEngine.setImproveMs(10000);
+    areaEngine.setThreads(3);
+    REQUIRE(slipsOf(areaEngine.assign()) == std::map<std::string, std::string>{ { "W1", "S1" }, { "W2", "S2" }, { "T5", "S4" } });
+    REQUIRE(areaEngine.improvementStats().mBoatsPlaced == 0);
+    REQUIRE(areaEngine.improvementStats().mAreaRecoveredSquareInches == 100 * 144);
+    
+    // Random marinas: nobody loses a slip, kept and permanent slips stay put
+    // and every moved boat fits its new slip
+    unsigned seed = 7;
+    auto next = [&seed](unsigned bound){
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) % bound;
+    };
+    
+    Member::DockStatus statuses[] = {
+        Member::DockStatus::PERMANENT,
+        Member::DockStatus::WAITING_LIST,
+        Member::DockStatus::TEMPORARY,
+        Member::DockStatus::UNASSIGNED
+    };
+    
+    for (int trial = 0; trial < 40; ++trial){
+        std::vector<Slip> randomSlips;
+        std::vector<Member> randomMembers;
+        
+        for (int i = 0; i < 12; ++i){
+            randomSlips.emplace_back("S" + std::to_string(i), 18 + static_cast<int>(next(16)), 0, 8 + static_cast<int>(next(6)), 0);
+        }
+        
+        for (int i = 0; i < 16; ++i){
+            std::optional<std::string> current;
+            
+            if (next(3) == 0){
+                current = "S" + std::to_string(next(12));
+            }
+            
+            randomMembers.emplace_back("M" + std::to_string(10 + i), 16 + static_cast<int>(next(16)), 0, 7 + static_cast<int>(next(6)), 0,
+                                       current, statuses[next(4)]);
+        }
+        
+        AssignmentEngine plain(randomMembers, randomSlips);
+        auto plainSlips = slipsOf(plain.assign());
+        AssignmentEngine improved(randomMembers, randomSlips);
+        improved.setImproveMs(10000);
+        auto improvedRows = improved.assign();
+        auto improvedSlips = slipsOf(improvedRows);
+        size_t plainPlaced = 0;
+        size_t improvedPlaced = 0;
+        // Permanent members may share a slip; the pass never adds a boat to one
+        std::map<std::string, int> plainHolders;
+        std::map<std::string, int> improvedHolders;
+        
+        for (const auto &member : randomMembers){
+            const std::string &was = plainSlips[member.id()];
+            const std::string &now = improvedSlips[member.id()];
+            plainPlaced += !was.empty();
+            improvedPlaced += !now.empty();
+            
+            if (!was.empty()){
+                REQUIRE_FALSE(now.empty());
+            }
+            
+            if (!was.empty() && (member.dockStatus() == Member::DockStatus::PERMANENT || member.currentSlip() == was)){
+                REQUIRE(now == was);
+            }
+            
+            plainHolders[was]++;
+            improvedHolders[now]++;
+            
+            if (!now.empty() && now != was){
+                REQUIRE(randomSlips[std::stoi(now.substr(1))].fits(member.boatDimensions()));
+            }
+        }
+        
+        for (const auto &entry : improvedHolders){
+            if (!entry.first.empty()){
+                REQUIRE(entry.second <= std::max(plainHolders[entry.first], 1));
+            }
+        }
+        
+        REQUIRE(improvedPlaced == plainPlaced + improved.improvementStats().mBoatsPlaced);
+    }
+}
+
+TEST_CASE("Revenue mode bills the most without costing anyone a slip", "[assignment][revenue]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 20, 0, 10, 0);
+    slips.emplace_back("S2", 30, 0, 12, 0);
+    slips.emplace_back("S3", 40, 0, 14, 0);
+    
+    std::vector<Member> members;
+    members.emplace_back("W1", 18, 0, 8, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    members.emplace_back("W2", 25, 0, 10, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    
+    auto slipsOf = [](const std::vector<Assignment> &assignments){
+        std::map<std::string, std::string> result;
+        
+        for (const auto &assignment : assignments){
+            result[assignment.memberId()] = assignment.slipId();
+        }
+        
+        return result;
+    };
+    
+    auto revenueOf = [](const std::vector<Assignment> &assignments){
+        double total = 0.0;
+        
+        for (const auto &assignment : assignments){
+            total += assignment.price();
+        }
+        
+        return total;
+    };
+    
+    // Best fit leaves the largest slip empty
+    AssignmentEngine greedy(members, slips);
+    greedy.setPricePerSqFt(2.0);
+    auto greedyRows = greedy.assign();
+    REQUIRE(slipsOf(greedyRows) == std::map<std::string, std::string>{ { "W1", "S1" }, { "W2", "S2" } });
+    REQUIRE(revenueOf(greedyRows) == 1120.0);
+    
+    // W1 moving to S3 bills 560 sq ft instead of 200; W2 stays put
+    AssignmentEngine engine(members, slips);
+    engine.setPricePerSqFt(2.0);
+    engine.setMaximizeRevenue(true);
+    engine.setRecordDecisions(true);
+    auto assignments = engine.assign();
+    REQUIRE(slipsOf(assignments) == std::map<std::string, std::string>{ { "W1", "S3" }, { "W2", "S2" } });
+    REQUIRE(revenueOf(assignments) == 1840.0);
+    REQUIRE(engine.revenueStats().mMembersMoved == 1);
+    REQUIRE(engine.revenueStats().mBoatsPlaced == 0);
+    REQUIRE(engine.revenueStats().mGreedyBilledSquareInches == 560 * 144);
+    REQUIRE(engine.revenueStats().mBilledSquareInches == 920 * 144);
+    REQUIRE(engine.revenueStats().mRevenue - engine.revenueStats().mGreedyRevenue == 720.0);
+    REQUIRE(engine.explain("W1").find("moved by revenue pass") != std::string::npos);
+    
+    // Greedy leaves U9 out; placing it takes moving W2 and W1 down a slip
+    std::vector<Slip> chainSlips;
+    chainSlips.emplace_back("S1", 20, 0, 13, 0);
+    chainSlips.emplace_back("S2", 25, 0, 10, 0);
+    chainSlips.emplace_back("S3", 30, 0, 12, 0);
+    chainSlips.emplace_back("S4", 40, 0, 14, 0);
+    
+    std::vector<Member> chainMembers;
+    chainMembers.emplace_back("W1", 19, 0, 9, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    chainMembers.emplace_back("W2", 24, 0, 9, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    chainMembers.emplace_back("T5", 19, 0, 9, 0, "S4", Member::DockStatus::TEMPORARY);
+    chainMembers.emplace_back("U9", 29, 0, 11, 0, std::nullopt, Member::DockStatus::UNASSIGNED);
+    
+    AssignmentEngine chain(chainMembers, chainSlips);
+    chain.setMaximizeRevenue(true);
+    REQUIRE(slipsOf(chain.assign()) == std::map<std::string, std::string>{ { "W1", "S1" }, { "W2", "S2" }, { "T5", "S4" }, { "U9", "S3" } });
+    REQUIRE(chain.revenueStats().mMembersMoved == 2);
+    REQUIRE(chain.revenueStats().mBoatsPlaced == 1);
+    
+    // Random marinas: revenue never falls, nobody loses a slip, kept and
+    // permanent slips stay put and every moved boat fits its new slip
+    unsigned seed = 11;
+    auto next = [&seed](unsigned bound){
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) % bound;
+    };
+    
+    Member::DockStatus statuses[] = {
+        Member::DockStatus::PERMANENT,
+        Member::DockStatus::WAITING_LIST,
+        Member::DockStatus::TEMPORARY,
+        Member::DockStatus::UNASSIGNED
+    };
+    
+    for (int trial = 0; trial < 40; ++trial){
+        std::vector<Slip> randomSlips;
+        std::vector<Member> randomMembers;
+        
+        for (int i = 0; i < 12; ++i){
+            randomSlips.emplace_back("S" + std::to_string(i), 18 + static_cast<int>(next(16)), 0, 8 + static_cast<int>(next(6)), 0);
+        }
+        
+        for (int i = 0; i < 14; ++i){
+            std::optional<std::string> current;
+            
+            if (next(3) == 0){
+                current = "S" + std::to_string(next(12));
+            }
+            
+            randomMembers.emplace_back("M" + std::to_string(10 + i), 16 + static_cast<int>(next(16)), 0, 7 + static_cast<int>(next(6)), 0,
+                                       current, statuses[next(4)]);
+        }
+        
+        AssignmentEngine plain(randomMembers, randomSlips);
+        plain.setPricePerSqFt(1.5);
+        auto plainRows = plain.assign();
+        AssignmentEngine revenue(randomMembers, randomSlips);
+        revenue.setPricePerSqFt(1.5);
+        revenue.setMaximizeRevenue(true);
+        auto revenueRows = revenue.assign();
+        auto plainSlips = slipsOf(plainRows);
+        auto revenueSlips = slipsOf(revenueRows);
+        size_t plainPlaced = 0;
+        size_t revenuePlaced = 0;
+        
+        for (const auto &member : randomMembers){
+            const std::string &was = plainSlips[member.id()];
+            const std::string &now = revenueSlips[member.id()];
+            plainPlaced += !was.empty();
+            revenuePlaced += !now.empty();
+            
+            if (!was.empty()){
+                REQUIRE_FALSE(now.empty());
+            }
+            
+            if (!was.empty() && (member.dockStatus() == Member::DockStatus::PERMANENT || member.currentSlip() == was)){
+                REQUIRE(now == was);
+            }
+            
+            if (!now.empty() && now != was){
+                REQUIRE(randomSlips[std::stoi(now.substr(1))].fits(member.boatDimensions()));
+            }
+        }
+        
+        const RevenueStats &stats = revenue.revenueStats();
+        REQUIRE(revenuePlaced == plainPlaced + stats.mBoatsPlaced);
+        REQUIRE(stats.mBilledSquareInches >= stats.mGreedyBilledSquareInches);
+        REQUIRE(revenueOf(revenueRows) - revenueOf(plainRows) == Approx(stats.mRevenue - stats.mGreedyRevenue));
+    }
+}
+
+TEST_CASE("Stable matching honours ranked slip preferences", "[assignment][stable]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 20, 0, 10, 0);
+    slips.emplace_back("S2", 30, 0, 12, 0);
+    slips.emplace_back("S3", 25, 0, 11, 0);
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 18, 0, 8, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    members.back().setSlipPreferences({ "S2", "S1" });
+    members.emplace_back("M2", 18, 0, 8, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    members.back().setSlipPreferences({ "S2", "S3" });
+    members.emplace_back("M3", 18, 0, 8, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    
+    AssignmentEngine engine(std::move(members), std::move(slips));
+    engine.setStableMatching(true);
+    auto assignments = engine.assign();
+    
+    REQUIRE(assignments.size() == 3);
+    // Waiting list outranks temporary for S2; M1 takes its second choice
+    REQUIRE(assignments[0].memberId() == "M1");
+    REQUIRE(assignments[0].slipId() == "S1");
+    REQUIRE(assignments[1].memberId() == "M2");
+    REQUIRE(assignments[1].slipId() == "S2");
+    // Unranked members fall back to best fit among what is left
+    REQUIRE(assignments[2].memberId() == "M3");
+    REQUIRE(assignments[2].slipId() == "S3");
+}
+
+TEST_CASE("Stable matching leaves no blocking pairs", "[assignment][stable]") {
+    std::vector<Slip> slips;
+    std::vector<Member> members;
+    std::vector<std::string> slipIds;
+    unsigned seed = 12345;
+    auto next = [&seed](unsigned bound){
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) % bound;
+    };
+    
+    for (int i = 0; i < 15; ++i){
+        slipIds.push_back("S" + std::to_string(i));
+        slips.emplace_back(slipIds.back(), 20 + static_cast<int>(next(15)), 0, 9 + static_cast<int>(next(4)), 0);
+    }
+    
+    Member::DockStatus statuses[] = {
+        Member::DockStatus::WAITING_LIST, Member::DockStatus::TEMPORARY, Member::DockStatus::UNASSIGNED
+    };
+    
+    for (int i = 0; i < 25; ++i){
+        members.emplace_back("M" + std::to_string(i), 18 + static_cast<int>(next(15)), 0, 8 + static_cast<int>(next(4)), 0,
+                             std::nullopt, statuses[next(3)]);
+        std::vector<std::string> ranking = slipIds;
+        
+        for (size_t k = ranking.size(); k > 1; --k){
+            std::swap(ranking[k - 1], ranking[next(static_cast<unsigned>(k))]);
+        }
+        
+        members.back().setSlipPreferences(ranking);
+    }
+    
+    AssignmentEngine engine(members, slips);
+    engine.setStableMatching(true);
+    auto assignments = engine.assign();
+    
+    std::map<std::string, std::string> slipOf;
+    std::map<std::string, std::string> holderOf;
+    
+    for (const auto &assignment : assignments){
+        if (assignment.assigned()){
+            slipOf[assignment.memberId()] = assignment.slipId();
+            REQUIRE(holderOf.emplace(assignment.slipId(), assignment.memberId()).second);
+        }
+    }
+    
+    auto tier = [](Member::DockStatus status){ return static_cast<int>(status); };
+    auto outranks = [&](const Member &a, const Member &b){
+        return tier(a.dockStatus()) != tier(b.dockStatus()) ? tier(a.dockStatus()) < tier(b.dockStatus()) : a < b;
+    };
+    
+    for (const auto &member : members){
+        for (const auto &slipId : member.slipPreferences()){
+            // Slips ranked no higher than the member's own are not blocking
+            if (slipOf.count(member.id()) && slipOf[member.id()] == slipId){
+                break;
+            }
+            
+            const Slip &slip = slips[std::stoi(slipId.substr(1))];
+            
+            if (!slip.fits(member.boatDimensions())){
+                continue;
+            }
+            
+            auto holderIt = holderOf.find(slipId);
+            REQUIRE(holderIt != holderOf.end());
+            
+            const Member &holder = *std::find_if(members.begin(), members.end(),
+                                                 [&](const Member &m){ return m.id() == holderIt->second; });
+            REQUIRE(outranks(holder, member));
+        }
+    }
+}
+
+TEST_CASE("Natural order ranks member IDs by the value of their digits", "[assignment][priority]") {
+    auto slipOf = [](const std::vector<Assignment> &assignments, const std::string &memberId){
+        for (const auto &assignment : assignments){
+            if (assignment.memberId() == memberId){
+                return assignment.slipId();
+            }
+        }
+        
+        return std::string("missing");
+    };
+    
+    auto run = [](bool naturalOrder, const std::vector<std::string> &ids){
+        std::vector<Slip> slips;
+        slips.emplace_back("S1", 20, 0, 10, 0);
+        
+        std::vector<Member> members;
+        
+        for (const auto &id : ids){
+            members.emplace_back(id, 18, 0, 8, 0, std::string("S1"), Member::DockStatus::WAITING_LIST);
+        }
+        
+        AssignmentEngine engine(std::move(members), std::move(slips));
+        engine.setNaturalOrder(naturalOrder);
+        return engine.assign();
+    };
+    
+    // Character order puts M10 first
+    auto assignments = run(false, { "M2", "M10" });
+    REQUIRE(slipOf(assignments, "M10") == "S1");
+    REQUIRE(slipOf(assignments, "M2") == "");
+    
+    assignments = run(true, { "M2", "M10" });
+    REQUIRE(slipOf(assignments, "M2") == "S1");
+    REQUIRE(slipOf(assignments, "M10") == "");
+    
+    // Digit runs longer than any integer still compare by value
+    assignments = run(true, { "M123456789012345678901234567890", "M99999999999999999999999999999" });
+    REQUIRE(slipOf(assignments, "M99999999999999999999999999999") == "S1");
+    
+    // Leading zeros make no difference to the value, so character order decides
+    assignments = run(true, { "M2", "M02" });
+    REQUIRE(slipOf(assignments, "M02") == "S1");
+    REQUIRE(slipOf(assignments, "M2") == "");
+    
+    // Engines for another roster or other slips keep the order
+    std::vector<Member> members;
+    members.emplace_back("M2", 18, 0, 8, 0, std::string("S1"), Member::DockStatus::WAITING_LIST);
+    members.emplace_back("M10", 18, 0, 8, 0, std::string("S1"), Member::DockStatus::WAITING_LIST);
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 20, 0, 10, 0);
+    
+    AssignmentEngine natural(members, slips);
+    natural.setNaturalOrder(true);
+    REQUIRE(slipOf(natural.withRoster(members).assign(), "M2") == "S1");
+    REQUIRE(slipOf(natural.withInputs(members, slips).assign(), "M2") == "S1");
+}
+
+TEST_CASE("Transients are booked into slips free for their dates", "[booking]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 30, 0, 12, 0);
+    slips.emplace_back("S2", 30, 0, 12, 0);
+    slips.emplace_back("S3", 40, 0, 14, 0);
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 28, 0, 10, 0, std::optional<std::string>("S1"), Member::DockStatus::PERMANENT);
+    members.emplace_back("M2", 28, 0, 10, 0, std::optional<std::string>("S2"), Member::DockStatus::TEMPORARY);
+    members[0].setAwayDates({ DateRange::parse("2025-07-01..2025-07-15") });
+    
+    AssignmentEngine engine(members, slips);
+    auto assignments = engine.assign();
+    
+    BookingCalendar calendar(slips);
+    calendar.holdSeason(members, assignments, DateRange::parse("2025-05-01..2025-10-01"));
+    
+    Dimensions boat(26, 0, 9, 0);
+    DateRange july(DateRange::parseDate("2025-07-02"), DateRange::parseDate("2025-07-05"));
+    
+    // M1's slip is free while M1 is away, and is the better fit than S3
+    REQUIRE(calendar.isFree("S1", july));
+    REQUIRE_FALSE(calendar.isFree("S2", july));
+    
+    Booking first = calendar.book(BookingRequest("T1", boat, july));
+    REQUIRE(first.slipId() == "S1");
+    
+    // Overlapping dates go to the next best fit, then nowhere
+    Booking second = calendar.book(BookingRequest("T2", boat, DateRange::parse("2025-07-04..2025-07-06")));
+    REQUIRE(second.slipId() == "S3");
+    
+    Booking third = calendar.book(BookingRequest("T3", boat, DateRange::parse("2025-07-04..2025-07-05")));
+    REQUIRE_FALSE(third.booked());
+    
+    // Back-to-back stays share a slip; a stay running past M1's return does not fit S1
+    REQUIRE(calendar.book(BookingRequest("T4", boat, DateRange::parse("2025-07-05..2025-07-15"))).slipId() == "S1");
+    REQUIRE(calendar.book(BookingRequest("T5", boat, DateRange::parse("2025-07-06..2025-07-20"))).slipId() == "S3");
+    
+    auto onS1 = calendar.bookings("S1");
+    REQUIRE(onS1.size() == 4);
+    REQUIRE(onS1[1].holder() == "T1");
+    REQUIRE(onS1[2].holder() == "T4");
+    REQUIRE_THROWS_AS(calendar.book("T6", "S2", july), std::runtime_error);
+}
+
+TEST_CASE("Concurrent bookings never double-book a slip", "[booking][concurrency]") {
+    std::vector<Slip> slips;
+    
+    for (int i = 0; i < 40; ++i){
+        slips.emplace_back("S" + std::to_string(i), 25 + i % 4 * 5, 0, 10 + i % 3, 0);
+    }
+    
+    BookingCalendar calendar(slips);
+    const int THREADS = 8;
+    const int REQUESTS = 400;
+    std::vector<std::vector<Booking>> results(THREADS);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> terminals;
+    
+    for (int t = 0; t < THREADS; ++t){
+        terminals.emplace_back([&, t](){
+            unsigned seed = 7919u * (t + 1);
+            auto next = [&seed](unsigned bound){
+                seed = seed * 1103515245u + 12345u;
+                return static_cast<int>((seed >> 16) % bound);
+            };
+            
+            while (!go.load()){
+            }
+            
+            for (int r = 0; r < REQUESTS; ++r){
+                int arrive = 20000 + next(60);
+                BookingRequest request("T" + std::to_string(t) + "-" + std::to_string(r),
+                                       Dimensions(20 + next(20), 0, 8 + next(4), 0),
+                                       DateRange(arrive, arrive + 1 + next(7)));
+                results[t].push_back(calendar.book(request));
+                
+                // Availability searches run alongside the writers
+                calendar.findBestFit(request.boatDimensions(), 0, request.dates());
+            }
+        });
+    }
+    
+    go.store(true);
+    
+    for (auto &terminal : terminals){
+        terminal.join();
+    }
+    
+    size_t booked = 0;
+    
+    for (const auto &result : results){
+        for (const auto &booking : result){
+            booked += booking.booked();
+        }
+    }
+    
+    size_t held = 0;
+    
+    for (const auto &slip : slips){
+        auto onSlip = calendar.bookings(slip.id());
+        held += onSlip.size();
+        
+        for (size_t i = 1; i < onSlip.size(); ++i){
+            REQUIRE(onSlip[i - 1].dates().to() <= onSlip[i].dates().from());
+        }
+    }
+    
+    // Every successful booking is on the calendar, and nothing else is
+    REQUIRE(booked > 0);
+    REQUIRE(held == booked);
+}
+
+TEST_CASE("Replaced hold lists are freed while readers walk them", "[booking][concurrency]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 30, 0, 12, 0);
+    slips.emplace_back("S2", 30, 0, 12, 0);
+    
+    BookingCalendar calendar(slips);
+    const int DAYS = 3000;
+    std::atomic<bool> done(false);
+    std::atomic<int> badReads(0);
+    std::vector<std::thread> readers;
+    
+    // Every booking replaces its slip's list; readers check each list they
+    // see, so one freed early would show up as garbage (or under ASan)
+    for (int t = 0; t < 4; ++t){
+        readers.emplace_back([&, t](){
+            const std::string slipId = t % 2 ? "S1" : "S2";
+            
+            while (!done.load()){
+                auto onSlip = calendar.bookings(slipId);
+                
+                for (size_t i = 0; i < onSlip.size(); ++i){
+                    if (onSlip[i].dates().to() != onSlip[i].dates().from() + 1 ||
+                        (i > 0 && onSlip[i - 1].dates().to() > onSlip[i].dates().from())){
+                        badReads++;
+                    }
+                }
+                
+                calendar.isFree(slipId, DateRange(20000, 20000 + DAYS));
+            }
+        });
+    }
+    
+    for (int day = 0; day < DAYS; ++day){
+        calendar.book("M" + std::to_string(day), day % 2 ? "S1" : "S2", DateRange(20000 + day, 20001 + day));
+    }
+    
+    done.store(true);
+    
+    for (auto &reader : readers){
+        reader.join();
+    }
+    
+    REQUIRE(badReads.load() == 0);
+    REQUIRE(calendar.bookings("S1").size() == DAYS / 2);
+    REQUIRE(calendar.bookings("S2").size() == DAYS / 2);
+}
+
+TEST_CASE("Only one terminal wins a race for the same slip and dates", "[booking][concurrency]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 30, 0, 12, 0);
+    
+    for (int round = 0; round < 50; ++round){
+        BookingCalendar calendar(slips);
+        std::atomic<int> winners(0);
+        std::atomic<bool> go(false);
+        std::vector<std::thread> terminals;
+        
+        for (int t = 0; t < 8; ++t){
+            terminals.emplace_back([&, t](){
+                while (!go.load()){
+                }
+                
+                // Overlapping stays: any two conflict on day 20005
+                DateRange stay(20000 + t % 3, 20006 + t % 2);
+                
+                if (calendar.tryBook("T" + std::to_string(t), "S1", stay)){
+                    winners++;
+                }
+            });
+        }
+        
+        go.store(true);
+        
+        for (auto &terminal : terminals){
+            terminal.join();
+        }
+        
+        REQUIRE(winners.load() == 1);
+        REQUIRE(calendar.bookings("S1").size() == 1);
+    }
+}
+
+TEST_CASE("Waitlist forecast replays seasons with churn", "[forecast]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 30, 0, 12, 0);
+    slips.emplace_back("S2", 30, 0, 12, 0);
+    slips.emplace_back("S3", 30, 0, 12, 0);
+    
+    std::vector<Member> members;
+    members.emplace_back("P1", 25, 0, 10, 0, std::string("S1"), Member::DockStatus::PERMANENT);
+    members.emplace_back("P2", 25, 0, 10, 0, std::string("S2"), Member::DockStatus::PERMANENT);
+    members.emplace_back("P3", 25, 0, 10, 0, std::string("S3"), Member::DockStatus::PERMANENT);
+    members.emplace_back("W1", 25, 0, 10, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    members.emplace_back("W2", 25, 0, 10, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    members.emplace_back("W3", 25, 0, 10, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    members.emplace_back("W4", 25, 0, 10, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    
+    AssignmentEngine engine(members, slips);
+    WaitlistForecast forecast(engine);
+    forecast.setSeasons(5);
+    forecast.setTrials(50);
+    
+    SECTION("Nobody waiting gets a slip while nobody leaves"){
+        ChurnRates rates;
+        rates.mSellRate = 0.0;
+        rates.mUpgradeRate = 0.0;
+        rates.mYearOffRate = 0.0;
+        forecast.setRates(rates);
+        auto forecasts = forecast.run();
+        
+        REQUIRE(forecasts.size() == 4);
+        REQUIRE(forecasts[0].mMemberId == "W1");
+        REQUIRE(forecasts[0].trials() == 50);
+        REQUIRE(forecasts[0].percentile(0.5) == 0);
+        REQUIRE(forecasts[0].placedShare() == 0.0);
+    }
+    
+    SECTION("Slips sold after the first season go to the front of the list"){
+        ChurnRates rates;
+        rates.mSellRate = 1.0;
+        rates.mUpgradeRate = 0.0;
+        rates.mYearOffRate = 0.0;
+        forecast.setRates(rates);
+        auto forecasts = forecast.run();
+        
+        REQUIRE(forecasts[0].percentile(0.9) == 2);
+        REQUIRE(forecasts[2].percentile(0.9) == 2);
+        // W4 waits for W1's buyer to sell in turn
+        REQUIRE(forecasts[3].percentile(0.5) == 3);
+        REQUIRE(forecasts[3].placedShare() == 1.0);
+    }
+    
+    SECTION("Results depend on the seed, not the number of threads"){
+        forecast.setTrials(200);
+        forecast.setSeed(7);
+        auto single = forecast.run();
+        forecast.setThreads(3);
+        auto threaded = forecast.run();
+        
+        for (size_t i = 0; i < single.size(); ++i){
+            REQUIRE(single[i].mPlacedIn == threaded[i].mPlacedIn);
+            REQUIRE(single[i].mNeverPlaced == threaded[i].mNeverPlaced);
+        }
+        
+        // The head of the list is placed at least as often as the tail
+        REQUIRE(single[0].placedShare() > 0.0);
+        REQUIRE(single[0].placedShare() >= single[3].placedShare());
+    }
+    
+    ChurnRates invalid;
+    invalid.mSellRate = 1.5;
+    REQUIRE_THROWS_AS(forecast.setRates(invalid), std::invalid_argument);
+    REQUIRE_THROWS_AS(forecast.setTrials(0), std::invalid_argument);
+}
@@ -0,0 +1,1266 @@
+#include <catch.hpp>
+
+#include "../csv_parser.hpp"
+#include "../arrow_writer.hpp"
+#include "../jsonl_writer.hpp"
+#include "../compressed_stream.hpp"
+#include "../assignment_engine.hpp"
+#include "../pricing.hpp"
+#include "../seniority_archive.hpp"
+#include "../result_cache.hpp"
+#include "../file_watcher.hpp"
+#include "../federation.hpp"
+#include "../shared_results.hpp"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static std::string tempPath(const std::string &name){
+    return (std::filesystem::temp_directory_path() / ("slippage_test_" + name)).string();
+}
+
+// Start the slippage command line with output discarded
+static pid_t spawnCli(std::vector<std::string> args){
+    std::vector<char *> argv;
+    args.insert(args.begin(), SLIPPAGE_CLI);
+    
+    for (auto &arg : args){
+        argv.push_back(&arg[0]);
+    }
+    
+    argv.push_back(nullptr);
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, 2, "/dev/null", O_WRONLY, 0);
+    pid_t pid = 0;
+    int result = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    REQUIRE(result == 0);
+    return pid;
+}
+
+static int exitStatus(pid_t pid){
+    int status = 0;
+    REQUIRE(::waitpid(pid, &status, 0) == pid);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static const char *MEMBERS_CSV =
+    "member_id,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,current_slip,dock_status\n"
+    "M1,18,6,8,0,S1,temporary\n"
+    "M2,22,0,10,0,,waiting-list\n";
+
+TEST_CASE("Gzip output round-trips through compressed member parsing", "[io][compression]") {
+    std::string path = tempPath("members.csv.gz");
+
+    {
+        CompressedOutputStream out(path, compressionForFilename(path));
+        out << MEMBERS_CSV;
+        out.finish();
+    }
+
+    REQUIRE(detectCompression(path) == Compression::GZIP);
+
+    auto members = CsvParser::parseMembers(path);
+
+    REQUIRE(members.size() == 2);
+    REQUIRE(members[0].id() == "M1");
+    REQUIRE(members[0].currentSlip().value() == "S1");
+    REQUIRE(members[1].dockStatus() == Member::DockStatus::WAITING_LIST);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Plain input passes through the decompressing stream unchanged", "[io][compression]") {
+    std::string path = tempPath("plain.csv");
+
+    {
+        std::ofstream out(path);
+        out << MEMBERS_CSV;
+    }
+
+    CompressedInputStream in(path);
+    std::ostringstream contents;
+    contents << in.rdbuf();
+
+    REQUIRE(in.compression() == Compression::NONE);
+    REQUIRE(contents.str() == MEMBERS_CSV);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Large gzip stream decompresses across chunk boundaries", "[io][compression]") {
+    std::string path = tempPath("large.txt.gz");
+    std::string line = "0123456789abcdefghijklmnopqrstuvwxyz\n";
+    const int lineCount = 50000;
+
+    {
+        CompressedOutputStream out(path, Compression::GZIP);
+
+        for (int i = 0; i < lineCount; ++i){
+            out << line;
+        }
+
+        out.finish();
+    }
+
+    CompressedInputStream in(path);
+    std::string readLine;
+    int count = 0;
+
+    while (std::getline(in, readLine)){
+        REQUIRE(readLine + "\n" == line);
+        count++;
+    }
+
+    REQUIRE(count == lineCount);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Truncated gzip input is reported instead of silently accepted", "[io][compression]") {
+    std::string path = tempPath("truncated.csv.gz");
+
+    {
+        CompressedOutputStream out(path, Compression::GZIP);
+
+        for (int i = 0; i < 1000; ++i){
+            out << MEMBERS_CSV;
+        }
+
+        out.finish();
+    }
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+    CompressedInputStream in(path);
+    std::string readLine;
+
+    REQUIRE_THROWS_AS([&](){ while (std::getline(in, readLine)){} }(), std::runtime_error);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("A stream that fails while opening closes its file", "[io][compression]") {
+    auto openFiles = [](){
+        return std::distance(std::filesystem::directory_iterator("/proc/self/fd"), std::filesystem::directory_iterator());
+    };
+    
+    // A directory opens as a file but cannot be read
+    std::string directory = tempPath("unreadable_input");
+    std::filesystem::create_directories(directory);
+    auto before = openFiles();
+    
+    for (int i = 0; i < 16; ++i){
+        REQUIRE_THROWS_AS(CompressedInputStream(directory), std::runtime_error);
+    }
+    
+    REQUIRE(openFiles() == before);
+    std::filesystem::remove(directory);
+}
+
+TEST_CASE("A build without zstd leaves an existing output file untouched", "[io][compression]") {
+    if (zstdAvailable()){
+        return;
+    }
+    
+    std::string path = tempPath("kept.zst");
+    {
+        std::ofstream out(path);
+        out << "previous run\n";
+    }
+    
+    REQUIRE_THROWS_AS(CompressedOutputStream(path, Compression::ZSTD), std::runtime_error);
+    REQUIRE(std::filesystem::file_size(path) == 13);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Output compression is chosen from the file extension", "[io][compression]") {
+    REQUIRE(compressionForFilename("out.csv") == Compression::NONE);
+    REQUIRE(compressionForFilename("out.csv.gz") == Compression::GZIP);
+    REQUIRE(compressionForFilename("out.csv.zst") == Compression::ZSTD);
+    REQUIRE(stringToCompression("gzip") == Compression::GZIP);
+    REQUIRE_THROWS_AS(stringToCompression("lzma"), std::invalid_argument);
+}
+
+TEST_CASE("The command line rejects --compress it cannot honour before running", "[io][compression]") {
+    std::string members = tempPath("cli_members.csv");
+    std::string slips = tempPath("cli_slips.csv");
+    std::string output = tempPath("cli_out.csv");
+    std::ofstream(members) << MEMBERS_CSV;
+    std::ofstream(slips) << "slip_id,max_length_ft,max_length_in,max_width_ft,max_width_in\nS1,20,0,10,0\n";
+    
+    REQUIRE(exitStatus(spawnCli({ "--slips", slips, "--members", members, "--compress", "bogus", "--output", output })) == 1);
+    REQUIRE(exitStatus(spawnCli({ "--slips", slips, "--members", members, "--compress", "gzip" })) == 1);
+    REQUIRE_FALSE(std::filesystem::exists(output));
+    
+    // Without zstd, an existing output file is left as it was
+    if (!zstdAvailable()){
+        std::string zstdOutput = tempPath("cli_out.csv.zst");
+        std::ofstream(zstdOutput) << "previous run\n";
+        REQUIRE(exitStatus(spawnCli({ "--slips", slips, "--members", members, "--output", zstdOutput })) == 1);
+        REQUIRE(exitStatus(spawnCli({ "--slips", slips, "--members", members, "--compress", "zstd", "--output", output })) == 1);
+        REQUIRE(std::filesystem::file_size(zstdOutput) == 13);
+        REQUIRE_FALSE(std::filesystem::exists(output));
+        std::filesystem::remove(zstdOutput);
+    }
+    
+    REQUIRE(exitStatus(spawnCli({ "--slips", slips, "--members", members, "--compress", "none", "--output", output })) == 0);
+    REQUIRE(std::filesystem::exists(output));
+    
+    std::filesystem::remove(members);
+    std::filesystem::remove(slips);
+    std::filesystem::remove(output);
+}
+
+TEST_CASE("Diff classifies slip, status and price changes by member ID", "[io][diff]") {
+    std::vector<AssignmentRecord> previous;
+    previous.emplace_back("M1", "S1", "PERMANENT", 550.0);
+    previous.emplace_back("M2", "S2", "TEMPORARY", 600.0);
+    previous.emplace_back("M3", "", "UNASSIGNED", 0.0);
+    previous.emplace_back("M4", "S4", "TEMPORARY", 400.0);
+    previous.emplace_back("M5", "S5", "TEMPORARY", 300.0);
+    previous.emplace_back("M6", "S6", "TEMPORARY", 300.0);
+
+    Dimensions boat(20, 0, 10, 0);
+    Dimensions slip(20, 0, 10, 0);
+    Dimensions none(0, 0, 0, 0);
+
+    std::vector<Assignment> current;
+    current.emplace_back("M1", "S1", Assignment::Status::PERMANENT, boat, slip, Member::DockStatus::PERMANENT, "", 2.75);
+    current.emplace_back("M2", "S3", Assignment::Status::TEMPORARY, boat, slip, Member::DockStatus::TEMPORARY);
+    current.emplace_back("M3", "S7", Assignment::Status::TEMPORARY, boat, slip, Member::DockStatus::UNASSIGNED);
+    current.emplace_back("M4", "", Assignment::Status::UNASSIGNED, boat, none, Member::DockStatus::TEMPORARY);
+    current.emplace_back("M5", "S5", Assignment::Status::PERMANENT, boat, slip, Member::DockStatus::TEMPORARY);
+    current.emplace_back("M7", "S8", Assignment::Status::TEMPORARY, boat, slip, Member::DockStatus::UNASSIGNED);
+
+    AssignmentDiff diff(previous, current);
+
+    REQUIRE(diff.changes().size() == 6);
+    REQUIRE(diff.unchangedCount() == 1);
+    REQUIRE(diff.changes()[0].kind() == AssignmentChange::Kind::MOVED);
+    REQUIRE(diff.changes()[1].kind() == AssignmentChange::Kind::ASSIGNED);
+    REQUIRE(diff.changes()[2].kind() == AssignmentChange::Kind::VACATED);
+    REQUIRE(diff.changes()[3].kind() == AssignmentChange::Kind::STATUS_CHANGED);
+    REQUIRE(diff.changes()[4].kind() == AssignmentChange::Kind::ADDED);
+    REQUIRE(diff.changes()[5].kind() == AssignmentChange::Kind::REMOVED);
+    REQUIRE(diff.changes()[5].previous()->memberId() == "M6");
+}
+
+TEST_CASE("Diff detects price-only changes and merged mode keeps unchanged rows", "[io][diff]") {
+    std::vector<AssignmentRecord> previous;
+    previous.emplace_back("M1", "S1", "PERMANENT", 500.0);
+    previous.emplace_back("M2", "S2", "PERMANENT", 550.0);
+
+    Dimensions boat(20, 0, 10, 0);
+    Dimensions slip(20, 0, 10, 0);
+
+    // 200 sqft at $2.75 = $550.00
+    std::vector<Assignment> current;
+    current.emplace_back("M1", "S1", Assignment::Status::PERMANENT, boat, slip, Member::DockStatus::PERMANENT, "", 2.75);
+    current.emplace_back("M2", "S2", Assignment::Status::PERMANENT, boat, slip, Member::DockStatus::PERMANENT, "", 2.75);
+
+    AssignmentDiff changesOnly(previous, current);
+    AssignmentDiff merged(previous, current, true);
+
+    REQUIRE(changesOnly.changes().size() == 1);
+    REQUIRE(changesOnly.changes()[0].kind() == AssignmentChange::Kind::PRICE_CHANGED);
+    REQUIRE(merged.changes().size() == 2);
+    REQUIRE(merged.changes()[1].kind() == AssignmentChange::Kind::UNCHANGED);
+
+    std::ostringstream out;
+    out << changesOnly;
+
+    REQUIRE(out.str().find("M1,S1,PERMANENT,permanent,20,0,10,0,550.00,false,,PRICE,S1,PERMANENT,500.00\n") != std::string::npos);
+}
+
+TEST_CASE("Previous assignment files without dock_status or price columns can be read", "[io][diff]") {
+    std::string path = tempPath("previous.csv");
+
+    {
+        std::ofstream out(path);
+        out << "member_id,assigned_slip,status,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,upgraded,comment\n";
+        out << "1212,A-00,PERMANENT,46,11,13,10,false,\"NOTE: boat is 8' 6\"\" longer than slip\"\n";
+        out << "2036,,UNASSIGNED,46,0,13,0,false,\n";
+    }
+
+    auto records = CsvParser::parsePreviousAssignments(path);
+
+    REQUIRE(records.size() == 2);
+    REQUIRE(records[0].slipId() == "A-00");
+    REQUIRE(records[0].price() == 0.0);
+    REQUIRE_FALSE(records[0].priced());
+    REQUIRE(records[1].status() == "UNASSIGNED");
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Diff ignores prices when either run is unpriced", "[io][diff]") {
+    Dimensions boat(20, 0, 10, 0);
+    Dimensions slip(20, 0, 10, 0);
+
+    // A priced previous file against an unpriced run
+    std::vector<AssignmentRecord> priced;
+    priced.emplace_back("M1", "S1", "PERMANENT", 550.0);
+    priced.emplace_back("M2", "S2", "TEMPORARY", 600.0);
+
+    std::vector<Assignment> unpriced;
+    unpriced.emplace_back("M1", "S1", Assignment::Status::PERMANENT, boat, slip, Member::DockStatus::PERMANENT);
+    unpriced.emplace_back("M2", "S3", Assignment::Status::TEMPORARY, boat, slip, Member::DockStatus::TEMPORARY);
+
+    AssignmentDiff againstUnpriced(priced, unpriced, false, false);
+
+    REQUIRE(againstUnpriced.changes().size() == 1);
+    REQUIRE(againstUnpriced.changes()[0].kind() == AssignmentChange::Kind::MOVED);
+    REQUIRE(againstUnpriced.unchangedCount() == 1);
+
+    // A previous file with no price column against a priced run
+    std::vector<AssignmentRecord> noPrices;
+    noPrices.emplace_back("M1", "S1", "PERMANENT", 0.0, false);
+
+    std::vector<Assignment> current;
+    current.emplace_back("M1", "S1", Assignment::Status::PERMANENT, boat, slip, Member::DockStatus::PERMANENT, "", 2.75);
+
+    AssignmentDiff againstNoPrices(noPrices, current);
+
+    REQUIRE(againstNoPrices.changes().empty());
+    REQUIRE(againstNoPrices.unchangedCount() == 1);
+}
+
+TEST_CASE("Dock columns are optional in member and slip files", "[io][dock]") {
+    std::istringstream membersIn(
+        "member_id,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,current_slip,dock_status,preferred_dock\n"
+        "M1,18,6,8,0,S1,temporary,North\n"
+        "M2,22,0,10,0,,waiting-list,\n");
+    auto members = CsvParser::parseMembers(membersIn);
+    
+    REQUIRE(members.size() == 2);
+    REQUIRE(members[0].preferredDock() == std::optional<std::string>("North"));
+    REQUIRE_FALSE(members[1].preferredDock().has_value());
+    
+    std::istringstream slipsIn(
+        "slip_id,max_length_ft,max_length_in,max_width_ft,max_width_in,dock\n"
+        "S1,20,0,10,0,North\n");
+    auto slips = CsvParser::parseSlips(slipsIn);
+    
+    REQUIRE(slips.size() == 1);
+    REQUIRE(slips[0].dock() == "North");
+    
+    std::istringstream plainIn(
+        "slip_id,max_length_ft,max_length_in,max_width_ft,max_width_in\n"
+        "S1,20,0,10,0\n");
+    REQUIRE(CsvParser::parseSlips(plainIn)[0].dock().empty());
+}
+
+TEST_CASE("Draft and air draft columns are optional and read in feet and inches", "[io][draft]") {
+    std::istringstream membersIn(
+        "member_id,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,current_slip,dock_status,boat_draft_ft,boat_draft_in,boat_air_draft_ft\n"
+        "M1,30,0,10,0,,temporary,5,6,40\n"
+        "M2,22,0,10,0,,waiting-list,,,\n");
+    auto members = CsvParser::parseMembers(membersIn);
+    
+    REQUIRE(members.size() == 2);
+    REQUIRE(members[0].boatDimensions().draftInches() == 66);
+    REQUIRE(members[0].boatDimensions().airDraftInches() == 480);
+    REQUIRE(members[1].boatDimensions().draftInches() == 0);
+    REQUIRE(members[1].boatDimensions().airDraftInches() == 0);
+    
+    std::istringstream slipsIn(
+        "slip_id,max_length_ft,max_length_in,max_width_ft,max_width_in,max_draft_ft,max_draft_in\n"
+        "S1,40,0,12,0,4,0\n"
+        "S2,40,0,12,0,,\n");
+    auto slips = CsvParser::parseSlips(slipsIn);
+    
+    REQUIRE(slips[0].maxDimensions().draftInches() == 48);
+    REQUIRE(slips[0].maxDimensions().airDraftInches() == 0);
+    REQUIRE(slips[1].maxDimensions().draftInches() == 0);
+    REQUIRE_FALSE(slips[0].fits(members[0].boatDimensions()));
+    REQUIRE(slips[1].fits(members[0].boatDimensions()));
+}
+
+TEST_CASE("Amenity columns are parsed into bitmasks", "[io][amenities]") {
+    std::istringstream membersIn(
+        "member_id,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,current_slip,dock_status,required_amenities\n"
+        "M1,30,0,10,0,,temporary,Power-50A; water\n"
+        "M2,22,0,10,0,,waiting-list,\n");
+    auto members = CsvParser::parseMembers(membersIn);
+    
+    REQUIRE(members[0].requiredAmenities() == (Amenities::POWER_50A | Amenities::WATER));
+    REQUIRE(members[1].requiredAmenities() == 0);
+    REQUIRE(Amenities::toString(members[0].requiredAmenities()) == "power-50a;water");
+    
+    std::istringstream slipsIn(
+        "slip_id,max_length_ft,max_length_in,max_width_ft,max_width_in,amenities\n"
+        "S1,40,0,12,0,water;pump-out;power-50a\n");
+    auto slips = CsvParser::parseSlips(slipsIn);
+    
+    REQUIRE(Amenities::provides(slips[0].amenities(), members[0].requiredAmenities()));
+    
+    std::istringstream badIn(
+        "slip_id,max_length_ft,max_length_in,max_width_ft,max_width_in,amenities\n"
+        "S1,40,0,12,0,helipad\n");
+    REQUIRE_THROWS_AS(CsvParser::parseSlips(badIn), std::invalid_argument);
+}
+
+TEST_CASE("Capacity column marks shared slips", "[io][shared]") {
+    std::istringstream slipsIn(
+        "slip_id,max_length_ft,max_length_in,max_width_ft,max_width_in,capacity\n"
+        "S1,40,0,12,0,\n"
+        "T1,60,0,30,0,3\n");
+    auto slips = CsvParser::parseSlips(slipsIn);
+    
+    REQUIRE(slips[0].capacity() == 1);
+    REQUIRE_FALSE(slips[0].shared());
+    REQUIRE(slips[1].capacity() == 3);
+    REQUIRE(slips[1].shared());
+    
+    std::istringstream badIn(
+        "slip_id,max_length_ft,max_length_in,max_width_ft,max_width_in,capacity\n"
+        "S1,40,0,12,0,0\n");
+    REQUIRE_THROWS_AS(CsvParser::parseSlips(badIn), std::invalid_argument);
+}
+
+TEST_CASE("Away dates and transient requests are read as date ranges", "[io][booking]") {
+    std::istringstream membersIn(
+        "member_id,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,current_slip,dock_status,away\n"
+        "M1,30,0,10,0,S1,permanent,2025-07-01..2025-07-15; 2025-08-20..2025-09-01\n"
+        "M2,22,0,10,0,,waiting-list,\n");
+    auto members = CsvParser::parseMembers(membersIn);
+    
+    REQUIRE(members[0].awayDates().size() == 2);
+    REQUIRE(members[0].awayDates()[0].days() == 14);
+    REQUIRE(members[0].awayDates()[1].toString() == "2025-08-20..2025-09-01");
+    REQUIRE(members[1].awayDates().empty());
+    
+    std::istringstream requestsIn(
+        "request_id,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,arrive,depart,required_amenities\n"
+        "T1,26,6,9,0,2024-02-28,2024-03-01,water\n");
+    auto requests = CsvParser::parseBookingRequests(requestsIn);
+    
+    REQUIRE(requests.size() == 1);
+    REQUIRE(requests[0].boatDimensions().lengthInches() == 318);
+    REQUIRE(requests[0].dates().days() == 2);
+    REQUIRE(requests[0].requiredAmenities() == Amenities::WATER);
+    
+    std::vector<Booking> bookings = { Booking("T1", "S3", requests[0].dates()), Booking("T2", "", requests[0].dates()) };
+    std::ostringstream out;
+    out << bookings;
+    REQUIRE(out.str() == "request_id,assigned_slip,arrive,depart,nights\n"
+                         "T1,S3,2024-02-28,2024-03-01,2\n"
+                         "T2,,2024-02-28,2024-03-01,2\n");
+    
+    REQUIRE_THROWS_AS(DateRange::parseDate("2025-02-29"), std::invalid_argument);
+    REQUIRE_THROWS_AS(DateRange::parse("2025-07-15..2025-07-01"), std::invalid_argument);
+}
+
+TEST_CASE("Occupancy journals are written as text and read back against the inputs", "[io][journal]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 30, 0, 12, 0);
+    slips.emplace_back("S2", 30, 0, 12, 0);
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 25, 0, 10, 0, std::string("S2"), Member::DockStatus::WAITING_LIST);
+    members.emplace_back("M2", 25, 0, 10, 0, std::string("S2"), Member::DockStatus::TEMPORARY);
+    
+    AssignmentEngine engine(members, slips);
+    engine.setJournal(true);
+    engine.assign();
+    
+    std::stringstream text;
+    engine.writeJournal(text);
+    
+    std::string header;
+    std::getline(text, header);
+    REQUIRE(header == "step,member_index,member_id,slip_index,slip_id,index");
+    
+    std::string line;
+    std::getline(text, line);
+    REQUIRE(line == "occupant-added,0,M1,1,S2,");
+    std::getline(text, line);
+    REQUIRE(line == "assignment-set,0,M1,1,S2,");
+    
+    text.clear();
+    text.seekg(0);
+    OccupancyJournal journal = engine.readJournal(text);
+    REQUIRE(journal.size() == engine.journal().size());
+    
+    AssignmentEngine replayed(members, slips);
+    replayed.replay(journal, journal.size());
+    REQUIRE(replayed.assignedSlip("M1") == std::optional<std::string>("S2"));
+    REQUIRE(replayed.assignedSlip("M2") == std::optional<std::string>("S1"));
+    
+    // A journal from other inputs is rejected
+    std::vector<Member> others(members.rbegin(), members.rend());
+    AssignmentEngine mismatched(others, slips);
+    text.clear();
+    text.seekg(0);
+    REQUIRE_THROWS_AS(mismatched.readJournal(text), std::runtime_error);
+}
+
+TEST_CASE("Rate tables price assignment files without the engine", "[io][pricing]") {
+    std::istringstream slipsIn(
+        "slip_id,max_length_ft,max_length_in,max_width_ft,max_width_in,dock,amenities,capacity\n"
+        "S1,20,0,10,0,North,water,\n"
+        "S2,40,0,12,0,South,,\n"
+        "T1,60,0,30,0,North,,3\n");
+    auto slips = CsvParser::parseSlips(slipsIn);
+    
+    std::istringstream ratesIn(
+        "rule,key,value\n"
+        "base,,2\n"
+        "length,30,3\n"
+        "dock,North,1.5\n"
+        "amenity,water,10\n"
+        "status,waiting-list,25\n");
+    RateTable rates = CsvParser::parseRateTable(ratesIn);
+    
+    REQUIRE(rates.hasBaseRate());
+    REQUIRE(rates.lengthTiers().size() == 1);
+    REQUIRE(rates.lengthTiers()[0].mMinLengthInches == 360);
+    REQUIRE(rates.dockMultiplier("South") == 1.0);
+    
+    std::istringstream assignmentsIn(
+        "member_id,assigned_slip,status,dock_status,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,price,upgraded,comment\n"
+        "M1,S1,PERMANENT,permanent,18,0,8,0,1.00,false,\n"
+        "M2,S2,TEMPORARY,waiting-list,32,0,10,0,1.00,false,\n"
+        "M3,T1,TEMPORARY,temporary,25,0,9,0,1.00,false,\n"
+        "M4,,UNASSIGNED,waiting-list,50,0,15,0,99.00,false,\"No slip fits\"\n");
+    auto assignments = CsvParser::parseAssignments(assignmentsIn);
+    
+    REQUIRE(assignments.size() == 4);
+    REQUIRE(assignments[1].dockStatus() == Member::DockStatus::WAITING_LIST);
+    REQUIRE(assignments[3].comment() == "No slip fits");
+    
+    PriceSchedule(rates, slips).price(assignments);
+    
+    // 200 sq ft slip on North at the base rate, plus water
+    REQUIRE(assignments[0].price() == 610.0);
+    // 480 sq ft at the 30 ft tier, less the waiting list discount
+    REQUIRE(assignments[1].price() == 1080.0);
+    // Shared slip: 60 ft by the boat's 9 ft beam
+    REQUIRE(assignments[2].price() == 1620.0);
+    REQUIRE(assignments[3].price() == 0.0);
+    
+    // A base rate alone prices as the flat rate does
+    PriceSchedule(RateTable(2.75), slips).price(assignments);
+    REQUIRE(assignments[1].price() == Assignment::price(480.0, 2.75));
+    
+    // Written assignments read back unchanged
+    std::stringstream written;
+    written << assignments;
+    auto reread = CsvParser::parseAssignments(written);
+    std::stringstream rewritten;
+    rewritten << reread;
+    REQUIRE(rewritten.str() == written.str());
+    
+    std::istringstream unknownSlipIn(
+        "member_id,assigned_slip,status,dock_status,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in\n"
+        "M1,Z9,PERMANENT,permanent,18,0,8,0\n");
+    auto unknown = CsvParser::parseAssignments(unknownSlipIn);
+    REQUIRE_THROWS_AS(PriceSchedule(rates, slips).price(unknown), std::invalid_argument);
+    
+    std::istringstream badRuleIn("rule,key,value\ncolor,blue,5\n");
+    REQUIRE_THROWS_AS(CsvParser::parseRateTable(badRuleIn), std::invalid_argument);
+    std::istringstream badDiscountIn("rule,key,value\nstatus,permanent,120\n");
+    REQUIRE_THROWS_AS(CsvParser::parseRateTable(badDiscountIn), std::invalid_argument);
+    std::istringstream badStatusIn("member_id,assigned_slip,status,dock_status,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in\n"
+                                   "M1,S1,MAYBE,permanent,18,0,8,0\n");
+    REQUIRE_THROWS_AS(CsvParser::parseAssignments(badStatusIn), std::invalid_argument);
+}
+
+TEST_CASE("Assignment history is archived incrementally into a seniority index", "[io][seniority]") {
+    std::filesystem::path directory = tempPath("archive");
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    
+    auto writeSeason = [&](const std::string &name, const std::string &rows){
+        std::ofstream out(directory / name);
+        out << "member_id,assigned_slip,status,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,upgraded,comment\n" << rows;
+    };
+    
+    writeSeason("2023 Assignments.csv", "M1,S1,PERMANENT,25,0,10,0,false,\nM2,,UNASSIGNED,25,0,10,0,false,\n");
+    writeSeason("2024 Assignments.csv", "M1,S1,PERMANENT,25,0,10,0,false,\nM2,,UNASSIGNED,25,0,10,0,false,\nM3,S2,TEMPORARY,25,0,10,0,false,\n");
+    writeSeason("Slips.csv", "not an assignment file\n");
+    
+    SeniorityArchive archive;
+    REQUIRE(archive.ingestDirectory(directory.string()) == 2);
+    REQUIRE(archive.ingestDirectory(directory.string()) == 0);
+    
+    writeSeason("2025 Assignments.csv", "M1,,UNASSIGNED,25,0,10,0,false,\nM2,S1,TEMPORARY,25,0,10,0,false,\nM3,S2,PERMANENT,25,0,10,0,false,\n");
+    REQUIRE(archive.ingestDirectory(directory.string()) == 1);
+    REQUIRE(archive.years() == 3);
+    
+    SeniorityArchive::Tenure m1 = archive.tenure("M1");
+    REQUIRE(m1.mSlipYears == 2);
+    REQUIRE(m1.mWaitingYears == 1);
+    REQUIRE(m1.mContinuousYears == 0);
+    
+    SeniorityArchive::Tenure m3 = archive.tenure("M3");
+    REQUIRE(m3.mSlipYears == 2);
+    REQUIRE(m3.mContinuousYears == 2);
+    REQUIRE(archive.tenure("M9").mSlipYears == 0);
+    
+    // An older season added later slots in before the others
+    writeSeason("Assignments 2021.csv", "M3,S2,PERMANENT,25,0,10,0,false,\n");
+    REQUIRE(archive.ingestDirectory(directory.string()) == 1);
+    REQUIRE(archive.tenure("M3").mSlipYears == 3);
+    REQUIRE(archive.tenure("M3").mContinuousYears == 2);
+    
+    std::stringstream saved;
+    archive.save(saved);
+    SeniorityArchive loaded = SeniorityArchive::load(saved);
+    REQUIRE(loaded.years() == 4);
+    REQUIRE(loaded.tenure("M2").mWaitingYears == 2);
+    REQUIRE(loaded.seniority("M2", SeniorityWeights()) == 3.0);
+    REQUIRE(loaded.ingestDirectory(directory.string()) == 0);
+    
+    std::istringstream notArchive("member_id,slip\n");
+    REQUIRE_THROWS_AS(SeniorityArchive::load(notArchive), std::runtime_error);
+    REQUIRE(SeniorityArchive::yearOf("2025 Assignments.csv") == 2025);
+    REQUIRE(SeniorityArchive::yearOf("Ray Slippage SLIPS.csv") == 0);
+    
+    // Seniority orders members within a dock status ahead of member ID
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 30, 0, 12, 0);
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 25, 0, 10, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    members.emplace_back("M2", 25, 0, 10, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    
+    AssignmentEngine byId(members, slips);
+    REQUIRE(byId.assign()[0].memberId() == "M1");
+    
+    SeniorityWeights waiting;
+    waiting.mSlipYears = 0.0;
+    AssignmentEngine bySeniority(members, slips);
+    bySeniority.setSeniority(loaded, waiting);
+    bySeniority.assign();
+    REQUIRE(bySeniority.assignedSlip("M2") == std::optional<std::string>("S1"));
+    REQUIRE_FALSE(bySeniority.assignedSlip("M1").has_value());
+    
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Seniority archive counts waiting and year-off rows by dock status", "[io][seniority]") {
+    std::filesystem::path directory = tempPath("archive_dock_status");
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    
+    auto writeSeason = [&](const std::string &name, const std::string &rows){
+        std::ofstream out(directory / name);
+        out << "member_id,assigned_slip,status,dock_status,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,upgraded,comment\n" << rows;
+    };
+    
+    writeSeason("2022 Assignments.csv", "M1,S1,SAME,permanent,25,0,10,0,false,\nM2,,UNASSIGNED,temporary,25,0,10,0,false,\n");
+    writeSeason("2023 Assignments.csv", "M1,,UNASSIGNED,year-off,25,0,10,0,false,\nM2,,UNASSIGNED,waiting-list,25,0,10,0,false,\n"
+                                        "M3,S2,PERMANENT,permanent,25,0,10,0,false,\n");
+    writeSeason("2024 Assignments.csv", "M1,S1,SAME,permanent,25,0,10,0,false,\nM2,,UNASSIGNED,waiting-list,25,0,10,0,false,\n"
+                                        "M3,,UNASSIGNED,temporary,25,0,10,0,false,\n");
+    
+    SeniorityArchive archive;
+    REQUIRE(archive.ingestDirectory(directory.string()) == 3);
+    
+    // A year off neither counts as waiting nor breaks the run of slip years
+    SeniorityArchive::Tenure m1 = archive.tenure("M1");
+    REQUIRE(m1.mSlipYears == 2);
+    REQUIRE(m1.mWaitingYears == 0);
+    REQUIRE(m1.mContinuousYears == 2);
+    
+    // Only waiting-list rows count as waiting
+    REQUIRE(archive.tenure("M2").mWaitingYears == 2);
+    
+    // Listed without a slip and not waiting breaks the run
+    SeniorityArchive::Tenure m3 = archive.tenure("M3");
+    REQUIRE(m3.mSlipYears == 1);
+    REQUIRE(m3.mWaitingYears == 0);
+    REQUIRE(m3.mContinuousYears == 0);
+    
+    std::stringstream saved;
+    archive.save(saved);
+    REQUIRE(saved.str().find("member,M1,SYS\n") != std::string::npos);
+    REQUIRE(saved.str().find("member,M2,UWW\n") != std::string::npos);
+    
+    SeniorityArchive loaded = SeniorityArchive::load(saved);
+    REQUIRE(loaded.tenure("M1").mContinuousYears == 2);
+    REQUIRE(loaded.tenure("M3").mContinuousYears == 0);
+    
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Result cache finds stored outputs by content hash and evicts the least recently used", "[io][cache]") {
+    // Reference XXH64 values
+    REQUIRE(xxhash64("", 0) == 0xef46db3751d8e999ull);
+    REQUIRE(xxhash64("abc", 3) == 0x44bc2cf5ad770999ull);
+    REQUIRE(xxhash64("Nobody inspects the spammish repetition", 39) == 0xfbcea83c8a378bf1ull);
+    
+    std::filesystem::path directory = tempPath("cache");
+    std::filesystem::remove_all(directory);
+    
+    std::string membersFile = tempPath("cache_members.csv");
+    std::ofstream(membersFile) << MEMBERS_CSV;
+    
+    auto keyFor = [&](bool ignoreLength){
+        return ResultCache::Key().addFile(membersFile).add(ignoreLength).add(0.0).hash();
+    };
+    
+    uint64_t key = keyFor(false);
+    REQUIRE(key == keyFor(false));
+    REQUIRE(key != keyFor(true));
+    // Parts are hashed with their lengths, so splitting them differently changes the key
+    REQUIRE(ResultCache::Key().add(std::string("ab")).add(std::string("c")).hash() !=
+            ResultCache::Key().add(std::string("a")).add(std::string("bc")).hash());
+    
+    ResultCache cache(directory.string(), 100);
+    REQUIRE(cache.find(key) == nullptr);
+    
+    std::string first(40, 'a');
+    cache.store(key, first);
+    auto hit = cache.find(key);
+    REQUIRE(hit != nullptr);
+    REQUIRE(std::string(hit->data(), hit->size()) == first);
+    
+    // Replacing an entry leaves a reader's mapping intact
+    cache.store(key, std::string(40, 'b'));
+    REQUIRE(std::string(hit->data(), hit->size()) == first);
+    REQUIRE(std::string(cache.find(key)->data(), 40) == std::string(40, 'b'));
+    
+    // Age both entries, then use the first: the second is evicted
+    cache.store(2, std::string(40, 'c'));
+    auto past = std::filesystem::file_time_type::clock::now() - std::chrono::minutes(5);
+    
+    for (const auto &entry : std::filesystem::directory_iterator(directory)){
+        std::filesystem::last_write_time(entry.path(), past);
+    }
+    
+    REQUIRE(cache.find(key) != nullptr);
+    cache.store(3, std::string(40, 'd'));
+    REQUIRE(cache.find(key) != nullptr);
+    REQUIRE(cache.find(2) == nullptr);
+    REQUIRE(cache.find(3) != nullptr);
+    
+    // Outputs larger than the cache are not kept
+    cache.store(4, std::string(101, 'e'));
+    REQUIRE(cache.find(4) == nullptr);
+    
+    REQUIRE_THROWS_AS(ResultCache(directory.string(), 0), std::invalid_argument);
+    
+    std::filesystem::remove_all(directory);
+    std::remove(membersFile.c_str());
+}
+
+TEST_CASE("Watch mode sees saves in place and by rename, and diffs the roster", "[io][watch]") {
+    std::vector<Member> before;
+    before.emplace_back("M1", 20, 0, 8, 0, std::string("S1"), Member::DockStatus::PERMANENT);
+    before.emplace_back("M2", 20, 0, 8, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    before.emplace_back("M3", 20, 0, 8, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    
+    REQUIRE(RosterDelta(before, before).empty());
+    
+    std::vector<Member> after = before;
+    after[1].setBoatDimensions(Dimensions(22, 0, 8, 0));
+    after.erase(after.begin() + 2);
+    after.emplace_back("M4", 20, 0, 8, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+    
+    RosterDelta delta(before, after);
+    REQUIRE(delta.changed() == std::vector<std::string>{ "M2" });
+    REQUIRE(delta.removed() == std::vector<std::string>{ "M3" });
+    REQUIRE(delta.added() == std::vector<std::string>{ "M4" });
+    REQUIRE(delta.size() == 3);
+    
+    std::vector<Member> reordered = { before[2], before[0], before[1] };
+    RosterDelta moved(before, reordered);
+    REQUIRE(moved.size() == 0);
+    REQUIRE(moved.reordered());
+    REQUIRE_FALSE(moved.empty());
+    
+    std::filesystem::path directory = tempPath("watch");
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::string members = (directory / "members.csv").string();
+    std::string slips = (directory / "slips.csv").string();
+    std::ofstream(members) << MEMBERS_CSV;
+    std::ofstream(slips) << "slip_id\n";
+    
+    FileWatcher watcher({ slips, members });
+    
+    // A burst of saves, in place and by rename, is one change
+    std::ofstream(members) << MEMBERS_CSV;
+    std::ofstream(members) << MEMBERS_CSV;
+    std::ofstream(directory / "other.csv") << "not watched\n";
+    std::ofstream(directory / "slips.new") << "slip_id\n";
+    std::filesystem::rename(directory / "slips.new", slips);
+    
+    REQUIRE(watcher.wait(20) == std::vector<std::string>{ slips, members });
+    
+    std::ofstream(members) << MEMBERS_CSV;
+    REQUIRE(watcher.wait(20) == std::vector<std::string>{ members });
+    
+    // One directory named two ways is one watch; saves to either file count
+    std::filesystem::path working = std::filesystem::current_path();
+    std::filesystem::current_path(directory);
+    
+    {
+        FileWatcher spellings({ members, "slips.csv" });
+        std::ofstream(members) << MEMBERS_CSV;
+        REQUIRE(spellings.wait(20) == std::vector<std::string>{ members });
+        std::ofstream("slips.csv") << "slip_id\n";
+        REQUIRE(spellings.wait(20) == std::vector<std::string>{ "slips.csv" });
+    }
+    
+    std::filesystem::current_path(working);
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Federation routes overflow boats to the best free slips at other marinas", "[io][federation]") {
+    auto north = [](){
+        std::vector<Member> members;
+        members.emplace_back("P1", 28, 0, 11, 0, std::string("N1"), Member::DockStatus::PERMANENT);
+        members.emplace_back("T1", 22, 0, 9, 0, std::nullopt, Member::DockStatus::TEMPORARY);
+        members.emplace_back("W1", 22, 0, 9, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+        members.emplace_back("BIG", 40, 0, 14, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+        members.emplace_back("OFF", 20, 0, 8, 0, std::nullopt, Member::DockStatus::YEAR_OFF);
+        std::vector<Slip> slips;
+        slips.emplace_back("N1", 30, 0, 12, 0);
+        AssignmentEngine engine(members, slips);
+        return FederationWorker("north", engine, engine.assign());
+    };
+    
+    auto south = [](){
+        std::vector<Member> members;
+        members.emplace_back("Q1", 28, 0, 11, 0, std::string("S1"), Member::DockStatus::PERMANENT);
+        std::vector<Slip> slips;
+        slips.emplace_back("S1", 30, 0, 12, 0);
+        slips.emplace_back("S3", 25, 0, 10, 0);
+        slips.emplace_back("S2", 23, 0, 10, 0);
+        AssignmentEngine engine(members, slips);
+        return FederationWorker("south", engine, engine.assign());
+    };
+    
+    FederationWorker overflowing = north();
+    REQUIRE(overflowing.freeSlips() == 0);
+    REQUIRE(overflowing.overflow().size() == 3);
+    REQUIRE(overflowing.overflow()[0].mMemberId == "T1");
+    REQUIRE(overflowing.overflow()[0].mTier == 2);
+    REQUIRE(overflowing.overflow()[1].mTier == 1);
+    
+    // Best fit first; claimed slips are no longer offered
+    FederationWorker free = south();
+    auto offers = free.candidates(Dimensions(22, 0, 9, 0), 0, 8);
+    REQUIRE(offers.size() == 2);
+    REQUIRE(offers[0].first == "S2");
+    REQUIRE(offers[0].second == 23 * 12 * 10 * 12 - 22 * 12 * 9 * 12);
+    REQUIRE(offers[1].first == "S3");
+    REQUIRE(free.claim("S2"));
+    REQUIRE_FALSE(free.claim("S2"));
+    REQUIRE_FALSE(free.claim("S1"));
+    REQUIRE(free.candidates(Dimensions(22, 0, 9, 0), 0, 8).size() == 1);
+    REQUIRE(free.candidates(Dimensions(40, 0, 14, 0), 0, 8).empty());
+    
+    // The summary keeps only the widths that take longer boats
+    std::vector<FreeSlipEnvelope> summary = free.summary();
+    REQUIRE(summary.size() == 1);
+    REQUIRE(summary[0].mWidthLengths == std::vector<std::pair<int, int>>{ { 10 * 12, 25 * 12 } });
+    REQUIRE(summary[0].admits(Dimensions(25, 0, 10, 0), 0, false));
+    REQUIRE_FALSE(summary[0].admits(Dimensions(26, 0, 9, 0), 0, false));
+    REQUIRE(summary[0].admits(Dimensions(26, 0, 9, 0), 0, true));
+    REQUIRE_FALSE(summary[0].admits(Dimensions(20, 0, 9, 0), Amenities::WATER, false));
+    
+    std::string northSocket = tempPath("north.sock");
+    std::string southSocket = tempPath("south.sock");
+    FederationWorker northWorker = north();
+    FederationWorker southWorker = south();
+    std::thread northThread([&](){ northWorker.serve(northSocket); });
+    std::thread southThread([&](){ southWorker.serve(southSocket); });
+    
+    // The waiting-list boat goes first and takes the closer fit
+    FederationCoordinator coordinator({ northSocket, southSocket });
+    auto placements = coordinator.run();
+    northThread.join();
+    southThread.join();
+    
+    REQUIRE(placements.size() == 2);
+    REQUIRE(placements[0].mMemberId == "W1");
+    REQUIRE(placements[0].mHome == "north");
+    REQUIRE(placements[0].mMarina == "south");
+    REQUIRE(placements[0].mSlipId == "S2");
+    REQUIRE(placements[1].mMemberId == "T1");
+    REQUIRE(placements[1].mSlipId == "S3");
+    REQUIRE_FALSE(std::filesystem::exists(northSocket));
+    
+    std::ostringstream out;
+    out << placements;
+    REQUIRE(out.str() == "member_id,home_marina,marina,assigned_slip\nW1,north,south,S2\nT1,north,south,S3\n");
+    
+    REQUIRE_THROWS_AS(FederationCoordinator({}), std::invalid_argument);
+    
+    FederationCoordinator nobody({ tempPath("nobody.sock") });
+    nobody.setConnectTimeoutMs(50);
+    REQUIRE_THROWS_AS(nobody.run(), std::runtime_error);
+}
+
+TEST_CASE("Federation summaries keep a middle width that alone fits a boat", "[io][federation]") {
+    std::vector<Slip> slips;
+    slips.emplace_back("A1", 30, 0, 20, 0);
+    slips.emplace_back("A2", 50, 0, 15, 0);
+    slips.emplace_back("A3", 50, 0, 10, 0);
+    AssignmentEngine engine(std::vector<Member>(), slips);
+    FederationWorker worker("east", engine, engine.assign());
+    
+    // The 10' width adds no length over 15', so only the wider entry is kept
+    std::vector<FreeSlipEnvelope> summary = worker.summary();
+    REQUIRE(summary.size() == 1);
+    REQUIRE(summary[0].mWidthLengths == std::vector<std::pair<int, int>>{ { 20 * 12, 30 * 12 }, { 15 * 12, 50 * 12 } });
+    
+    Dimensions boat(40, 0, 12, 0);
+    auto offers = worker.candidates(boat, 0, 8);
+    REQUIRE(offers.size() == 1);
+    REQUIRE(offers[0].first == "A2");
+    REQUIRE(summary[0].admits(boat, 0, false));
+    REQUIRE(summary[0].admits(Dimensions(45, 0, 9, 0), 0, false));
+    REQUIRE_FALSE(summary[0].admits(Dimensions(45, 0, 16, 0), 0, false));
+}
+
+TEST_CASE("Federation routes between --serve worker processes", "[io][federation]") {
+    struct Marina {
+        std::string mName;
+        std::string mSlips;
+        std::string mMembers;
+    };
+    
+    const char *memberHeader = "member_id,boat_length_ft,boat_length_in,boat_width_ft,boat_width_in,current_slip,dock_status\n";
+    const char *slipHeader = "slip_id,max_length_ft,max_length_in,max_width_ft,max_width_in\n";
+    
+    // BIG fits no free slip anywhere, so no worker is asked about it
+    std::vector<Marina> marinas = {
+        { "north", "N1,30,0,12,0\n", "P1,28,0,11,0,N1,permanent\nT1,22,0,9,0,,temporary\nW1,22,0,9,0,,waiting-list\n"
+                                     "BIG,40,0,14,0,,waiting-list\n" },
+        { "south", "S1,30,0,12,0\nS3,25,0,10,0\nS2,23,0,10,0\n", "Q1,28,0,11,0,S1,permanent\n" },
+        { "east", "E0,36,0,13,0\nE1,23,0,9,6\n", "Z1,35,0,12,0,E0,permanent\n" }
+    };
+    
+    std::vector<pid_t> workers;
+    std::vector<std::string> sockets;
+    
+    // Stop any worker left serving if a check below fails
+    struct Reaper {
+        std::vector<pid_t> &mPids;
+        ~Reaper(){
+            for (pid_t pid : mPids){
+                ::kill(pid, SIGTERM);
+                ::waitpid(pid, nullptr, 0);
+            }
+        }
+    } reaper{ workers };
+    
+    for (const auto &marina : marinas){
+        std::string slips = tempPath(marina.mName + "_slips.csv");
+        std::string members = tempPath(marina.mName + "_members.csv");
+        std::ofstream(slips) << slipHeader << marina.mSlips;
+        std::ofstream(members) << memberHeader << marina.mMembers;
+        sockets.push_back(tempPath(marina.mName + "_worker.sock"));
+        workers.push_back(spawnCli({ "--slips", slips, "--members", members, "--output", tempPath(marina.mName + "_out.csv"),
+                                  "--serve", sockets.back(), "--marina", marina.mName }));
+    }
+    
+    // Placements only come as CSV; this is refused before any worker is contacted
+    REQUIRE(exitStatus(spawnCli({ "--federate", sockets[0], "--format", "jsonl" })) == 1);
+    
+    // The coordinator is a process of its own too, and compresses like any output
+    std::string placementsFile = tempPath("federation_placements.csv.gz");
+    pid_t coordinator = spawnCli({ "--federate", sockets[0] + "," + sockets[1] + "," + sockets[2], "--output", placementsFile });
+    REQUIRE(exitStatus(coordinator) == 0);
+    
+    while (!workers.empty()){
+        REQUIRE(exitStatus(workers.back()) == 0);
+        workers.pop_back();
+    }
+    
+    // W1 goes first and takes the closest fit across both other marinas
+    CompressedInputStream in(placementsFile);
+    REQUIRE(in.compression() == Compression::GZIP);
+    std::stringstream placements;
+    placements << in.rdbuf();
+    REQUIRE(placements.str() == "member_id,home_marina,marina,assigned_slip\nW1,north,east,E1\nT1,north,south,S2\n");
+    
+    for (const auto &socket : sockets){
+        REQUIRE_FALSE(std::filesystem::exists(socket));
+    }
+    
+    for (const auto &marina : marinas){
+        std::filesystem::remove(tempPath(marina.mName + "_slips.csv"));
+        std::filesystem::remove(tempPath(marina.mName + "_members.csv"));
+        std::filesystem::remove(tempPath(marina.mName + "_out.csv"));
+    }
+    
+    std::filesystem::remove(placementsFile);
+}
+
+TEST_CASE("Shared results are read in place and republished without tearing", "[io][shared]") {
+    const std::string name = "/slippage_test_results";
+    SharedResultsPublisher::remove(name);
+    REQUIRE_THROWS_AS(SharedResultsReader(name), std::runtime_error);
+    
+    auto table = [](size_t rows, double price, const std::string &comment){
+        std::vector<Assignment> assignments;
+        
+        for (size_t i = 0; i < rows; ++i){
+            assignments.emplace_back("M" + std::to_string(i), i % 2 ? "" : "S" + std::to_string(i),
+                                     i % 2 ? Assignment::Status::UNASSIGNED : Assignment::Status::SAME,
+                                     Dimensions(20, 6, 8, 0), Dimensions(24, 0, 10, 0), Member::DockStatus::WAITING_LIST,
+                                     comment, 0.0, i == 0);
+            assignments.back().setPrice(price);
+        }
+        
+        return assignments;
+    };
+    
+    SharedResultsPublisher publisher(name);
+    SharedResultsReader reader(name);
+    REQUIRE(reader.generation() == 0);
+    REQUIRE(reader.current().rows() == 0);
+    
+    REQUIRE(publisher.publish(table(2, 1.5, "first")) == 1);
+    SharedTable first = reader.current();
+    REQUIRE(first.generation() == 1);
+    REQUIRE(first.rows() == 2);
+    REQUIRE(first.memberId(1) == "M1");
+    REQUIRE(first.slipId(0) == "S0");
+    REQUIRE(first.slipId(1).empty());
+    REQUIRE(first.comment(0) == "first");
+    REQUIRE(first.status(0) == Assignment::Status::SAME);
+    REQUIRE(first.status(1) == Assignment::Status::UNASSIGNED);
+    REQUIRE(first.dockStatus(1) == Member::DockStatus::WAITING_LIST);
+    REQUIRE(first.upgraded(0));
+    REQUIRE_FALSE(first.upgraded(1));
+    REQUIRE(first.boatLengthInches(0) == 246);
+    REQUIRE(first.slipWidthInches(1) == 120);
+    REQUIRE(first.data<double>(SharedTableHeader::PRICE)[1] == 1.5);
+    REQUIRE(first.valid());
+    
+    // The next publish goes to the other buffer; the one after reuses this one
+    publisher.publish(table(2, 2.5, "second"));
+    REQUIRE(first.valid());
+    REQUIRE(first.comment(0) == "first");
+    REQUIRE(reader.current().comment(0) == "second");
+    publisher.publish(table(3, 3.5, "third"));
+    REQUIRE_FALSE(first.valid());
+    
+    // Outgrowing the segment remaps the reader; earlier tables stay readable
+    SharedTable third = reader.current();
+    publisher.publish(table(5000, 4.5, std::string(100, 'x')));
+    SharedTable grown = reader.current();
+    REQUIRE(grown.generation() == 4);
+    REQUIRE(grown.rows() == 5000);
+    REQUIRE(grown.memberId(4999) == "M4999");
+    REQUIRE(grown.price(4999) == 4.5);
+    REQUIRE(third.valid());
+    REQUIRE(third.comment(2) == "third");
+    
+    // Another publisher carries on the generations
+    {
+        SharedResultsPublisher again(name);
+        REQUIRE(again.publish(table(1, 5.5, "again")) == 5);
+    }
+    REQUIRE(reader.current().price(0) == 5.5);
+    
+    // A reader racing a publisher sees whole tables or knows it did not
+    std::atomic<bool> done(false);
+    std::thread writer([&](){
+        for (int i = 0; i < 2000; ++i){
+            publisher.publish(table(64 + i % 3, i, std::to_string(i)));
+        }
+        
+        done = true;
+    });
+    
+    size_t whole = 0;
+    
+    while (!done){
+        SharedTable current = reader.current();
+        bool consistent = true;
+        
+        for (size_t row = 1; row < current.rows(); ++row){
+            consistent = consistent && current.price(row) == current.price(0) && current.comment(row) == current.comment(0);
+        }
+        
+        if (current.valid()){
+            REQUIRE(consistent);
+            ++whole;
+        }
+    }
+    
+    writer.join();
+    REQUIRE(whole > 0);
+    REQUIRE(reader.generation() == 2005);
+    
+    SharedResultsPublisher::remove(name);
+    REQUIRE_THROWS_AS(SharedResultsReader(name), std::runtime_error);
+}
+
+TEST_CASE("Arrow output streams record batches into an IPC file", "[io][arrow]") {
+    std::ostringstream out;
+    REQUIRE_THROWS_AS(ArrowWriter(out, 0), std::invalid_argument);
+    
+    ArrowWriter writer(out, 2);
+    REQUIRE(out.str().compare(0, 8, std::string("ARROW1\0\0", 8)) == 0);
+    
+    // Schema and dictionaries come first; each full batch is written at once
+    size_t header = out.str().size();
+    Assignment assigned("M1", "S1", Assignment::Status::SAME, Dimensions(20, 0, 8, 0), Dimensions(24, 0, 10, 0),
+                        Member::DockStatus::PERMANENT, "kept", 2.0);
+    Assignment unassigned("M2", "", Assignment::Status::UNASSIGNED, Dimensions(40, 0, 14, 0), Dimensions(0, 0, 0, 0),
+                          Member::DockStatus::WAITING_LIST, "Boat too large for all available slips");
+    writer.write(assigned);
+    REQUIRE(out.str().size() == header);
+    writer.write(unassigned);
+    size_t firstBatch = out.str().size();
+    REQUIRE(firstBatch > header);
+    REQUIRE(firstBatch % 8 == 0);
+    
+    writer.write(assigned);
+    writer.finish();
+    std::string file = out.str();
+    REQUIRE(file.size() > firstBatch);
+    REQUIRE(file.compare(file.size() - 6, 6, "ARROW1") == 0);
+    
+    int32_t footer;
+    std::memcpy(&footer, file.data() + file.size() - 10, sizeof(footer));
+    REQUIRE(footer > 0);
+    REQUIRE(static_cast<size_t>(footer) < file.size() - firstBatch);
+    
+    // Finishing again writes nothing more
+    writer.finish();
+    REQUIRE(out.str().size() == file.size());
+}
+
+TEST_CASE("JSON Lines output writes one object per assignment with structured reasons", "[io][jsonl]") {
+    using Reason = Assignment::Reason;
+    std::ostringstream out;
+    REQUIRE_THROWS_AS(JsonlWriter(out, 16), std::invalid_argument);
+    
+    // A small buffer is written out as it fills, before flush()
+    JsonlWriter writer(out, 64);
+    Assignment assigned("M1", "S1", Assignment::Status::SAME, Dimensions(20, 0, 8, 0), Dimensions(24, 0, 10, 0),
+                        Member::DockStatus::PERMANENT, "", 2.0);
+    Reason longer(Reason::Code::LONGER_THAN_SLIP);
+    longer.mCount = 14;
+    Reason shares(Reason::Code::SHARES_SLIP);
+    shares.mMembers = { "M3", "M; 4" };
+    assigned.addReason(longer);
+    assigned.addReason(Reason(Reason::Code::TIGHT_FIT));
+    assigned.addReason(shares);
+    REQUIRE(assigned.comment() == "NOTE: boat is 1' 2\" longer than slip; TIGHT FIT; Shares slip with M3, M; 4");
+    
+    Assignment unassigned("M\"2\"", "", Assignment::Status::UNASSIGNED, Dimensions(40, 0, 14, 0), Dimensions(0, 0, 0, 0),
+                          Member::DockStatus::WAITING_LIST);
+    Reason taken(Reason::Code::SLIPS_TAKEN);
+    taken.mEvicted = true;
+    taken.mByPermanent = true;
+    taken.mCount = 3;
+    unassigned.addReason(taken);
+    writer.write(assigned);
+    REQUIRE_FALSE(out.str().empty());
+    writer.write(unassigned);
+    
+    // A comment given as text, such as one read back from CSV, stays one note
+    Assignment edited("M5", "", Assignment::Status::UNASSIGNED, Dimensions(40, 0, 14, 0), Dimensions(0, 0, 0, 0),
+                      Member::DockStatus::UNASSIGNED, "Year off - not assigned; hand\\edited\ttext");
+    Reason amenities(Reason::Code::NO_SLIP_WITH_AMENITIES);
+    amenities.mAmenities = Amenities::POWER_30A | Amenities::WATER;
+    edited.addReason(amenities);
+    writer.write(edited);
+    
+    Assignment yearOff("M6", "", Assignment::Status::UNASSIGNED, Dimensions(30, 0, 10, 0), Dimensions(0, 0, 0, 0),
+                       Member::DockStatus::YEAR_OFF);
+    yearOff.addReason(Reason(Reason::Code::YEAR_OFF));
+    writer.write(yearOff);
+    writer.flush();
+    
+    std::istringstream lines(out.str());
+    std::string line;
+    std::vector<std::string> rows;
+    
+    while (std::getline(lines, line)){
+        rows.push_back(line);
+    }
+    
+    REQUIRE(rows.size() == 4);
+    REQUIRE(rows[0] == "{\"member_id\":\"M1\",\"assigned_slip\":\"S1\",\"status\":\"SAME\",\"dock_status\":\"permanent\","
+                       "\"boat_length_inches\":240,\"boat_width_inches\":96,\"price\":480,\"upgraded\":false,\"reasons\":[{\"code\":\"longer_than_slip\",\"inches\":14},{\"code\":\"tight_fit\"},"
+                       "{\"code\":\"shares_slip\",\"members\":[\"M3\",\"M; 4\"]}]}");
+    REQUIRE(rows[1] == "{\"member_id\":\"M\\\"2\\\"\",\"assigned_slip\":null,\"status\":\"UNASSIGNED\",\"dock_status\":\"waiting-list\","
+                       "\"boat_length_inches\":480,\"boat_width_inches\":168,\"price\":null,\"upgraded\":false,"
+                       "\"reasons\":[{\"code\":\"slips_taken\",\"evicted\":true,\"by\":\"permanent\",\"suitable_slips\":3}]}");
+    REQUIRE(rows[2].find("\"reasons\":[{\"code\":\"note\",\"text\":\"Year off - not assigned; hand\\\\edited\\ttext\"},"
+                         "{\"code\":\"no_slip_with_amenities\",\"amenities\":[\"power-30a\",\"water\"]}]}") != std::string::npos);
+    REQUIRE(rows[3].find("\"reasons\":[{\"code\":\"year_off\"}]}") != std::string::npos);
+}
+
+TEST_CASE("Every reason code reads as the engine's comment text", "[io][jsonl]") {
+    using Reason = Assignment::Reason;
+    using Code = Reason::Code;
+    
+    auto reason = [](Code code, bool evicted, bool byPermanent, int count){
+        Reason made(code);
+        made.mEvicted = evicted;
+        made.mByPermanent = byPermanent;
+        made.mCount = count;
+        made.mAmenities = Amenities::WATER | Amenities::LIFT;
+        made.mMembers = { "M2", "M3" };
+        made.mText = "free text";
+        return made;
+    };
+    
+    // The CSV comment column, diffs and the oracle all compare this text
+    REQUIRE(reason(Code::NOTE, false, false, 0).text() == "free text");
+    REQUIRE(reason(Code::DOES_NOT_FIT, false, false, 0).text() == "NOTE: Boat does not fit in assigned slip");
+    REQUIRE(reason(Code::SLIP_LACKS_AMENITIES, false, false, 0).text() == "NOTE: Assigned slip lacks water;lift");
+    REQUIRE(reason(Code::LONGER_THAN_SLIP, false, false, 15).text() == "NOTE: boat is 1' 3\" longer than slip");
+    REQUIRE(reason(Code::LONGER_THAN_SLIP, false, false, 24).text() == "NOTE: boat is 2' longer than slip");
+    REQUIRE(reason(Code::SHORTER_THAN_SLIP, false, false, 5).text() == "NOTE: boat is 5\" shorter than slip");
+    REQUIRE(reason(Code::TIGHT_FIT, false, false, 0).text() == "TIGHT FIT");
+    REQUIRE(reason(Code::YEAR_OFF, false, false, 0).text() == "Year off - not assigned");
+    REQUIRE(reason(Code::SHARES_SLIP, false, false, 0).text() == "Shares slip with M2, M3");
+    REQUIRE(reason(Code::NO_SLIP_WITH_AMENITIES, false, false, 0).text() == "No large enough slip provides water;lift");
+    REQUIRE(reason(Code::TOO_LARGE, false, false, 0).text() == "Boat too large for all available slips");
+    REQUIRE(reason(Code::TOO_LARGE, true, false, 0).text() == "Evicted - boat too large for all available slips");
+    REQUIRE(reason(Code::SLIP_REMOVED, true, false, 0).text() == "Evicted - previous slip no longer exists");
+    REQUIRE(reason(Code::SLIPS_TAKEN, false, false, 4).text() == "All 4 suitable slips taken by higher priority members");
+    REQUIRE(reason(Code::SLIPS_TAKEN, true, true, 3).text() == "Evicted - previous slip taken by permanent member, all 3 suitable slips taken");
+    REQUIRE(reason(Code::SLIPS_TAKEN, true, false, 2).text() == "Evicted - outranked by higher priority member(s), all 2 suitable slips taken");
+    
+    // The engine records its reasons rather than only their text
+    std::vector<Slip> slips;
+    slips.emplace_back("S1", 30, 0, 12, 0);
+    
+    std::vector<Member> members;
+    members.emplace_back("M1", 25, 0, 11, 8, std::nullopt, Member::DockStatus::TEMPORARY);
+    members.emplace_back("M2", 45, 0, 10, 0, std::nullopt, Member::DockStatus::WAITING_LIST);
+    members.emplace_back("M3", 25, 0, 10, 0, std::nullopt, Member::DockStatus::YEAR_OFF);
+    
+    AssignmentEngine engine(members, slips);
+    std::map<std::string, Code> codes;
+    
+    for (const auto &assignment : engine.assign()){
+        REQUIRE(assignment.reasons().size() == 1);
+        REQUIRE(assignment.reasons()[0].text() == assignment.comment());
+        codes[assignment.memberId()] = assignment.reasons()[0].mCode;
+    }
+    
+    REQUIRE(codes["M1"] == Code::TIGHT_FIT);
+    REQUIRE(codes["M2"] == Code::TOO_LARGE);
+    REQUIRE(codes["M3"] == Code::YEAR_OFF);
+}
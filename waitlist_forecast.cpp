@@ -0,0 +1,262 @@
+#include "waitlist_forecast.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+uint32_t WaitForecast::trials() const{
+    uint32_t total = mNeverPlaced;
+
+    for (uint32_t count : mPlacedIn){
+        total += count;
+    }
+
+    return total;
+}
+
+unsigned WaitForecast::percentile(double share) const{
+    double needed = share * trials();
+    uint32_t placed = 0;
+
+    for (size_t season = 0; season < mPlacedIn.size(); ++season){
+        placed += mPlacedIn[season];
+
+        if (placed > 0 && placed >= needed){
+            return static_cast<unsigned>(season + 1);
+        }
+    }
+
+    return 0;
+}
+
+double WaitForecast::placedShare() const{
+    uint32_t total = trials();
+    return total == 0 ? 0.0 : static_cast<double>(total - mNeverPlaced) / total;
+}
+
+WaitlistForecast::WaitlistForecast(const AssignmentEngine &prototype)
+    : mPrototype(prototype), mSeasons(10), mTrials(1000), mSeed(1), mThreads(1){
+}
+
+// Reject a chance outside 0-1.
+static void requireChance(double rate, const std::string &what){
+    if (!(rate >= 0.0 && rate <= 1.0)){
+        throw std::invalid_argument("Invalid " + what + " rate: " + std::to_string(rate));
+    }
+}
+
+void WaitlistForecast::setRates(const ChurnRates &rates){
+    requireChance(rates.mSellRate, "sell");
+    requireChance(rates.mUpgradeRate, "upgrade");
+    requireChance(rates.mYearOffRate, "year-off");
+
+    if (rates.mUpgradeLengthInches < 0 || rates.mUpgradeWidthInches < 0){
+        throw std::invalid_argument("Invalid upgrade size: boats only grow");
+    }
+
+    mRates = rates;
+}
+
+void WaitlistForecast::setSeasons(unsigned seasons){
+    if (seasons == 0){
+        throw std::invalid_argument("Invalid forecast: needs at least one season");
+    }
+
+    mSeasons = seasons;
+}
+
+void WaitlistForecast::setTrials(unsigned trials){
+    if (trials == 0){
+        throw std::invalid_argument("Invalid forecast: needs at least one trial");
+    }
+
+    mTrials = trials;
+}
+
+// Seed for one trial's generator, spread from the forecast seed by splitmix64
+static uint64_t trialSeed(uint64_t seed, uint64_t trial){
+    uint64_t z = seed + (trial + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+std::vector<WaitForecast> WaitlistForecast::run() const{
+    const std::vector<Member> &initial = mPrototype.members();
+    uint32_t memberCount = static_cast<uint32_t>(initial.size());
+    std::unordered_map<std::string, uint32_t> positions;
+    std::vector<int32_t> trackedSlot(memberCount, -1);
+    std::vector<WaitForecast> forecasts;
+
+    for (uint32_t i = 0; i < memberCount; ++i){
+        positions.emplace(initial[i].id(), i);
+
+        Member::DockStatus status = initial[i].dockStatus();
+
+        if (status == Member::DockStatus::WAITING_LIST || status == Member::DockStatus::UNASSIGNED){
+            trackedSlot[i] = static_cast<int32_t>(forecasts.size());
+            forecasts.emplace_back();
+            forecasts.back().mMemberId = initial[i].id();
+        }
+    }
+
+    // Counts per worker, merged once all trials are done: placed counts are
+    // by tracked member, then season
+    struct Counts {
+        std::vector<uint32_t> mPlacedIn;
+        std::vector<uint32_t> mNeverPlaced;
+    };
+
+    unsigned threadCount = std::min(std::max(mThreads, 1u), mTrials);
+    std::vector<Counts> counts(threadCount);
+    std::vector<std::exception_ptr> errors(threadCount);
+    std::atomic<unsigned> nextTrial(0);
+
+    auto worker = [&](unsigned w){
+        try{
+            Counts &own = counts[w];
+            own.mPlacedIn.assign(forecasts.size() * mSeasons, 0);
+            own.mNeverPlaced.assign(forecasts.size(), 0);
+
+            // Kept from trial to trial
+            std::vector<Member> members;
+            std::vector<Member> roster;
+            std::vector<bool> gone;
+            std::vector<bool> holds;
+            std::vector<bool> placed;
+
+            for (unsigned trial = nextTrial++; trial < mTrials; trial = nextTrial++){
+                std::mt19937_64 random(trialSeed(mSeed, trial));
+                std::uniform_real_distribution<double> chance(0.0, 1.0);
+                members = initial;
+                gone.assign(memberCount, false);
+                placed.assign(forecasts.size(), false);
+
+                for (unsigned season = 0; season < mSeasons; ++season){
+                    roster.clear();
+
+                    for (uint32_t i = 0; i < memberCount; ++i){
+                        if (!gone[i]){
+                            roster.push_back(members[i]);
+                        }
+                    }
+
+                    AssignmentEngine engine = mPrototype.withRoster(roster);
+                    engine.setVerbose(false);
+                    engine.setDiagnostics(false);
+                    engine.setRecordDecisions(false);
+                    engine.setJournal(false);
+                    engine.setThreads(1);
+
+                    // The result becomes next season's roster
+                    holds.assign(memberCount, false);
+
+                    for (const Assignment &row : engine.assign()){
+                        uint32_t i = positions.find(row.memberId())->second;
+                        Member &member = members[i];
+
+                        if (row.assigned()){
+                            holds[i] = true;
+                            member.setCurrentSlip(row.slipId());
+
+                            if (row.status() == Assignment::Status::PERMANENT){
+                                member.setDockStatus(Member::DockStatus::PERMANENT);
+                            }
+
+                            int32_t slot = trackedSlot[i];
+
+                            if (slot >= 0 && !placed[slot]){
+                                placed[slot] = true;
+                                ++own.mPlacedIn[slot * mSeasons + season];
+                            }
+                        }
+                        else if (member.dockStatus() == Member::DockStatus::YEAR_OFF){
+                            member.setDockStatus(Member::DockStatus::WAITING_LIST);
+                        }
+                        else{
+                            if (member.dockStatus() == Member::DockStatus::PERMANENT){
+                                member.setDockStatus(Member::DockStatus::WAITING_LIST);
+                            }
+
+                            member.setCurrentSlip(std::nullopt);
+                        }
+                    }
+
+                    // Churn, drawn in roster order
+                    for (uint32_t i = 0; i < memberCount; ++i){
+                        if (gone[i]){
+                            continue;
+                        }
+
+                        Member &member = members[i];
+
+                        if (holds[i] && chance(random) < mRates.mSellRate){
+                            gone[i] = true;
+                            continue;
+                        }
+
+                        if (member.dockStatus() == Member::DockStatus::PERMANENT && chance(random) < mRates.mYearOffRate){
+                            member.setDockStatus(Member::DockStatus::YEAR_OFF);
+                        }
+
+                        if (chance(random) < mRates.mUpgradeRate){
+                            const Dimensions &boat = member.boatDimensions();
+                            Dimensions bigger(0, boat.lengthInches() + mRates.mUpgradeLengthInches,
+                                              0, boat.widthInches() + mRates.mUpgradeWidthInches);
+                            bigger.setDraftInches(boat.draftInches());
+                            bigger.setAirDraftInches(boat.airDraftInches());
+                            member.setBoatDimensions(bigger);
+                        }
+                    }
+                }
+
+                for (size_t slot = 0; slot < placed.size(); ++slot){
+                    if (!placed[slot]){
+                        ++own.mNeverPlaced[slot];
+                    }
+                }
+            }
+        }
+        catch (...){
+            errors[w] = std::current_exception();
+            // Stop the other workers taking more trials
+            nextTrial = mTrials;
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 1; t < threadCount; ++t){
+        workers.emplace_back(worker, t);
+    }
+
+    worker(0);
+
+    for (auto &thread : workers){
+        thread.join();
+    }
+
+    for (const auto &error : errors){
+        if (error){
+            std::rethrow_exception(error);
+        }
+    }
+
+    for (size_t slot = 0; slot < forecasts.size(); ++slot){
+        WaitForecast &forecast = forecasts[slot];
+        forecast.mPlacedIn.assign(mSeasons, 0);
+
+        for (const Counts &own : counts){
+            for (unsigned season = 0; season < mSeasons; ++season){
+                forecast.mPlacedIn[season] += own.mPlacedIn[slot * mSeasons + season];
+            }
+
+            forecast.mNeverPlaced += own.mNeverPlaced[slot];
+        }
+    }
+
+    return forecasts;
+}
@@ -0,0 +1,83 @@
+#ifndef WAITLIST_FORECAST_H
+#define WAITLIST_FORECAST_H
+
+#include "assignment_engine.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Yearly chances of the changes that open and close slips between seasons
+struct ChurnRates {
+    // A member holding a slip sells their boat and leaves the club
+    double mSellRate = 0.05;
+    // A member buys a bigger boat, this much longer and wider
+    double mUpgradeRate = 0.05;
+    int mUpgradeLengthInches = 48;
+    int mUpgradeWidthInches = 12;
+    // A permanent member takes the next season off
+    double mYearOffRate = 0.02;
+};
+
+// When one waiting member got a slip, over all trials
+struct WaitForecast {
+    std::string mMemberId;
+    // Trials in which the member first held a slip after each season,
+    // season 1 first
+    std::vector<uint32_t> mPlacedIn;
+    // Trials that ended with the member still waiting
+    uint32_t mNeverPlaced = 0;
+
+    uint32_t trials() const;
+
+    // The season by which the member had a slip in at least this share of
+    // trials (0-1), or 0 if that is beyond the forecast
+    unsigned percentile(double share) const;
+
+    // Share of trials in which the member got a slip within the forecast
+    double placedShare() const;
+};
+
+// Monte Carlo forecast of how long members wait for a slip: those on the
+// waiting list or unassigned when the forecast starts.
+//
+// Each trial plays the assignment rules season after season. After each
+// season the result becomes the next season's roster: members keep the
+// slips they were given as their current slips, those who kept or were
+// upgraded to a permanent slip become permanent, year-off members come
+// back on the waiting list with their old slip, and permanent members who
+// lost their slip go on the waiting list. Then churn is drawn: slip holders
+// sell and leave, boats grow, and permanent members take a year off.
+//
+// Every season's engine is made from the prototype with withRoster(), so
+// the slips and their indexes are built once for all trials. Trials run on
+// worker threads that each take the next trial as they finish, keeping
+// their roster buffers and counts from trial to trial. Each trial draws
+// from its own generator seeded from the forecast seed and the trial
+// number, so results do not depend on the number of threads.
+class WaitlistForecast {
+    const AssignmentEngine &mPrototype;
+    ChurnRates mRates;
+    unsigned mSeasons;
+    unsigned mTrials;
+    uint64_t mSeed;
+    unsigned mThreads;
+
+public:
+    // Forecast from the prototype's roster, slips and settings. The
+    // prototype must outlive the forecast.
+    explicit WaitlistForecast(const AssignmentEngine &prototype);
+
+    // Rates outside 0-1, negative upgrade sizes, and zero seasons or
+    // trials throw std::invalid_argument
+    void setRates(const ChurnRates &rates);
+    void setSeasons(unsigned seasons);
+    void setTrials(unsigned trials);
+    void setSeed(uint64_t seed){ mSeed = seed; }
+    void setThreads(unsigned threads){ mThreads = threads; }
+
+    // One forecast per waiting-list or unassigned member of the prototype's
+    // roster, in roster order
+    std::vector<WaitForecast> run() const;
+};
+
+#endif